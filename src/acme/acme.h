@@ -5,6 +5,7 @@
 #ifndef ACME_ACME_H
 #define ACME_ACME_H
 
+#include "table/table.h"
 #include "propeller/propeller.h"
 #include "rudder/rudder.h"
 #include "tunnel/tunnel.h"
@@ -12,6 +13,9 @@
 #include "propeller_rudder/MMGPropellerRudder.h"
 #include "propeller_rudder/BrixPropellerRudder.h"
 #include "sail/sail.h"
+#include "fleet/fleet.h"
+#include "operating_map/OperatingMap.h"
+#include "factory/factory.h"
 
 
 #endif //ACME_ACME_H
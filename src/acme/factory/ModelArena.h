@@ -0,0 +1,94 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#ifndef ACME_MODELARENA_H
+#define ACME_MODELARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace acme {
+
+  /// Contiguous block of models of the same type, constructed in place.
+  ///
+  /// Models built one by one are scattered over the heap, each one with its tables' handles and caches. Built in an
+  /// arena, the models of a fleet stepped together are adjacent in memory, in the order of the units. A propeller rudder
+  /// model holds its propeller and rudder by value, so that they are in the arena too. The models are never moved : the
+  /// arena only requires them to be constructible, and they are destroyed with it.
+  template<class Model>
+  class ModelArena {
+
+   public:
+    explicit ModelArena(std::size_t capacity) :
+        m_models(std::allocator<Model>().allocate(capacity)),
+        m_size(0),
+        m_capacity(capacity) {}
+
+    ModelArena(const ModelArena &) = delete;
+
+    ModelArena &operator=(const ModelArena &) = delete;
+
+    ~ModelArena() {
+      for (std::size_t i = 0; i < m_size; i++) m_models[i].~Model();
+      std::allocator<Model>().deallocate(m_models, m_capacity);
+    }
+
+    /// Construct a model at the next free slot
+    /// \throws std::length_error if the arena is full
+    template<class... Args>
+    Model &Emplace(Args &&... args) {
+      if (m_size == m_capacity) throw std::length_error("ModelArena : capacity exceeded");
+      new(m_models + m_size) Model(std::forward<Args>(args)...);
+      return m_models[m_size++];
+    }
+
+    std::size_t GetSize() const { return m_size; }
+
+    std::size_t GetCapacity() const { return m_capacity; }
+
+    Model &operator[](std::size_t i) { return m_models[i]; }
+
+    const Model &operator[](std::size_t i) const { return m_models[i]; }
+
+   private:
+    Model *m_models;
+    std::size_t m_size;
+    std::size_t m_capacity;
+
+  };
+
+  /// Build count models of the same type in a single arena, from the same constructor arguments.
+  /// The first model is built from the arguments and the others are copies of it, not initialized either : they share
+  /// its performance data until their initialization instead of each holding a copy of possibly several MB of json.
+  /// Each model is given as a shared pointer to Base sharing the ownership of the whole arena, which is released with
+  /// the last of them.
+  template<class Base, class Model, class... Args>
+  std::vector<std::shared_ptr<Base>> MakeModels(std::size_t count, const Args &... args) {
+    auto arena = std::make_shared<ModelArena<Model>>(count);
+    std::vector<std::shared_ptr<Base>> models;
+    models.reserve(count);
+    if (count == 0) return models;
+
+    Model &first = arena->Emplace(args...);
+    models.emplace_back(arena, &first);
+    for (std::size_t i = 1; i < count; i++) {
+      models.emplace_back(arena, &arena->Emplace(first));
+    }
+    return models;
+  }
+
+}  // end namespace acme
+
+#endif //ACME_MODELARENA_H
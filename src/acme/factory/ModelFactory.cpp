@@ -0,0 +1,332 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#include "ModelFactory.h"
+
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+#include <nlohmann/json.hpp>
+
+#include "ModelArena.h"
+#include "acme/propeller/FPP1Q.h"
+#include "acme/propeller/FPP4Q.h"
+#include "acme/propeller/CPP.h"
+#include "acme/rudder/SimpleRudderModel.h"
+#include "acme/rudder/FlapRudderModel.h"
+#include "acme/rudder/FujiiRudderModel.h"
+#include "acme/rudder/BrixRudderModel.h"
+#include "acme/propeller_rudder/BrixPropellerRudder.h"
+#include "acme/propeller_rudder/MMGPropellerRudder.h"
+#include "acme/table/CurveFile.h"
+
+using json = nlohmann::json;
+
+namespace acme {
+
+  namespace {
+
+    template<class Model>
+    struct ModelTag {
+      using type = Model;
+    };
+
+    // The visitors are called with the ModelTag of the concrete model class of the types, so that the dispatch on the
+    // types is written once for the single and the bulk builders
+
+    template<class Visitor>
+    auto VisitPropeller(PropellerModelType type, Visitor &&visitor) -> decltype(visitor(ModelTag<FPP1Q>())) {
+      switch (type) {
+        case E_FPP1Q:
+          return visitor(ModelTag<FPP1Q>());
+        case E_FPP4Q:
+          return visitor(ModelTag<FPP4Q>());
+        case E_CPP:
+          return visitor(ModelTag<CPP>());
+      }
+      throw std::invalid_argument("Unknown propeller model type");
+    }
+
+    template<class Visitor>
+    auto VisitRudder(RudderModelType type, Visitor &&visitor) -> decltype(visitor(ModelTag<SimpleRudderModel>())) {
+      switch (type) {
+        case E_SIMPLE_RUDDER:
+          return visitor(ModelTag<SimpleRudderModel>());
+        case E_FLAP_RUDDER:
+          return visitor(ModelTag<FlapRudderModel>());
+        case E_FUJII_RUDDER:
+          return visitor(ModelTag<FujiiRudderModel>());
+        case E_BRIX_RUDDER:
+          return visitor(ModelTag<BrixRudderModel>());
+      }
+      throw std::invalid_argument("Unknown rudder model type");
+    }
+
+    template<class Visitor>
+    auto VisitPropellerRudder(PropellerRudderModelType type, PropellerModelType propeller_type,
+                              RudderModelType rudder_type, Visitor &&visitor)
+    -> decltype(visitor(ModelTag<MMGPropellerRudder<SimpleRudderModel>>())) {
+
+      return VisitRudder(rudder_type, [&](auto rudder_tag) {
+        using Rudder = typename decltype(rudder_tag)::type;
+
+        switch (type) {
+          case E_MMG:
+            if (propeller_type != E_FPP1Q) {
+              throw std::invalid_argument("MMG propeller rudder model : only available with a FPP1Q propeller");
+            }
+            return visitor(ModelTag<MMGPropellerRudder<Rudder>>());
+          case E_BRIX:
+            return VisitPropeller(propeller_type, [&](auto propeller_tag) {
+              using Propeller = typename decltype(propeller_tag)::type;
+              return visitor(ModelTag<BrixPropellerRudder<Propeller, Rudder>>());
+            });
+        }
+        throw std::invalid_argument("Unknown propeller rudder model type");
+      });
+    }
+
+    // Performance data given inline, or as the path of a json file
+    std::string PerfData(const json &node) {
+      if (!node.is_string()) return node.dump();
+      auto path = node.get<std::string>();
+      std::ifstream file(path);
+      if (!file) throw std::runtime_error("Model configuration : can not read " + path);
+      std::stringstream buffer;
+      buffer << file.rdbuf();
+      return buffer.str();
+    }
+
+    // Performance data given as the path of a binary curve file (see CurveFile)
+    bool IsCurveFile(const json &node) {
+      return node.is_string() && CurveFile::IsCurveFile(node.get<std::string>());
+    }
+
+    PropellerParams ParsePropellerParams(const json &node) {
+      PropellerParams params{};
+      params.m_diameter_m = node.at("diameter_m");
+      params.m_screw_direction = node.value("screw_direction", "right") == "left" ? LEFT_HANDED : RIGHT_HANDED;
+      params.m_hull_wake_fraction_0 = node.value("hull_wake_fraction_0", 0.);
+      params.m_thrust_deduction_factor_0 = node.value("thrust_deduction_factor_0", 0.);
+      params.m_thrust_coefficient_correction = node.value("thrust_coefficient_correction", 0.);
+      params.m_torque_coefficient_correction = node.value("torque_coefficient_correction", 0.);
+      params.m_table_interpolation = ParseInterpolationType(node.value("interpolation", "linear"));
+      params.m_table_simplification_tolerance = node.value("table_simplification_tolerance", 0.);
+      params.m_table_single_precision = node.value("table_single_precision", false);
+      params.m_chebyshev_degree = node.value("chebyshev_degree", 0u);
+      params.m_out_of_range_policy = ParseOutOfRangePolicy(node.value("out_of_range", "throw"));
+      if (IsCurveFile(node.at("perf_data"))) {
+        params.m_thruster_perf_data_curve_file = node.at("perf_data").get<std::string>();
+      } else {
+        params.m_thruster_perf_data_json_string = PerfData(node.at("perf_data"));
+      }
+      return params;
+    }
+
+    RudderParams ParseRudderParams(const json &node) {
+      RudderParams params{};
+      params.m_lateral_area_m2 = node.at("lateral_area_m2");
+      params.m_chord_m = node.at("chord_m");
+      params.m_height_m = node.at("height_m");
+      params.m_has_hull_influence = node.value("has_hull_influence", true);
+      params.m_has_hull_influence_transverse_velocity = node.value("has_hull_influence_transverse_velocity", false);
+      params.m_tR = node.value("tR", 0.);
+      params.m_aH = node.value("aH", 0.);
+      params.m_xR = node.value("xR", 0.);
+      params.m_xH = node.value("xH", 0.);
+      params.m_hull_wake_fraction_0 = node.value("hull_wake_fraction_0", 0.);
+      params.m_flap_slope = node.value("flap_slope", 0.);
+      params.m_distance_nose_stock_m = node.value("distance_nose_stock_m", 0.25 * params.m_chord_m);
+      params.m_Cf = node.value("Cf", 0.);
+      params.m_Cq = node.value("Cq", 1.);
+      params.m_flow_straightening = node.value("flow_straightening", 0.);
+      params.m_table_interpolation = ParseInterpolationType(node.value("interpolation", "linear"));
+      params.m_table_simplification_tolerance = node.value("table_simplification_tolerance", 0.);
+      params.m_table_single_precision = node.value("table_single_precision", false);
+      params.m_symmetric_table = node.value("symmetric", false);
+      params.m_out_of_range_policy = ParseOutOfRangePolicy(node.value("out_of_range", "throw"));
+      if (node.contains("perf_data")) {
+        if (IsCurveFile(node.at("perf_data"))) {
+          params.m_perf_data_curve_file = node.at("perf_data").get<std::string>();
+        } else {
+          params.m_perf_data_json_string = PerfData(node.at("perf_data"));
+        }
+      }
+      return params;
+    }
+
+    ModelConfig ReadModelConfig(const json &node) {
+      ModelConfig config{};
+      if (node.contains("propeller")) {
+        config.m_has_propeller = true;
+        config.m_propeller_type = ParsePropellerModelType(node.at("propeller").at("type"));
+        config.m_propeller_params = ParsePropellerParams(node.at("propeller"));
+      }
+      if (node.contains("rudder")) {
+        config.m_has_rudder = true;
+        config.m_rudder_type = ParseRudderModelType(node.at("rudder").at("type"));
+        config.m_rudder_params = ParseRudderParams(node.at("rudder"));
+      }
+      if (!config.m_has_propeller && !config.m_has_rudder) {
+        throw std::runtime_error("Model configuration : no propeller nor rudder");
+      }
+      config.m_interaction = ParsePropellerRudderModelType(node.value("interaction", "brix"));
+      return config;
+    }
+
+    json Parse(const std::string &json_string) {
+      try {
+        return json::parse(json_string);
+      } catch (const json::exception &e) {
+        throw std::runtime_error(std::string("Model configuration : ") + e.what());
+      }
+    }
+
+  }  // end anonymous namespace
+
+  PropellerModelType ParsePropellerModelType(const std::string &name) {
+    if (name == "FPP1Q") return E_FPP1Q;
+    if (name == "FPP4Q") return E_FPP4Q;
+    if (name == "CPP") return E_CPP;
+    throw std::runtime_error("Unknown propeller model type " + name + ", expected FPP1Q, FPP4Q or CPP");
+  }
+
+  RudderModelType ParseRudderModelType(const std::string &name) {
+    if (name == "simple") return E_SIMPLE_RUDDER;
+    if (name == "flap") return E_FLAP_RUDDER;
+    if (name == "fujii") return E_FUJII_RUDDER;
+    if (name == "brix") return E_BRIX_RUDDER;
+    throw std::runtime_error("Unknown rudder model type " + name + ", expected simple, flap, fujii or brix");
+  }
+
+  PropellerRudderModelType ParsePropellerRudderModelType(const std::string &name) {
+    if (name == "brix") return E_BRIX;
+    if (name == "mmg") return E_MMG;
+    throw std::runtime_error("Unknown propeller rudder model type " + name + ", expected brix or mmg");
+  }
+
+  std::shared_ptr<PropellerBaseModel> BuildPropeller(PropellerModelType type, const PropellerParams &params) {
+    return VisitPropeller(type, [&](auto tag) -> std::shared_ptr<PropellerBaseModel> {
+      return std::make_shared<typename decltype(tag)::type>(params);
+    });
+  }
+
+  std::shared_ptr<RudderBaseModel> BuildRudder(RudderModelType type, const RudderParams &params) {
+    return VisitRudder(type, [&](auto tag) -> std::shared_ptr<RudderBaseModel> {
+      return std::make_shared<typename decltype(tag)::type>(params);
+    });
+  }
+
+  std::shared_ptr<PropellerRudderBase> BuildPropellerRudder(PropellerRudderModelType type,
+                                                            PropellerModelType propeller_type,
+                                                            const PropellerParams &propeller_params,
+                                                            RudderModelType rudder_type,
+                                                            const RudderParams &rudder_params) {
+    return VisitPropellerRudder(type, propeller_type, rudder_type,
+                                [&](auto tag) -> std::shared_ptr<PropellerRudderBase> {
+                                  return std::make_shared<typename decltype(tag)::type>(propeller_params,
+                                                                                         rudder_params);
+                                });
+  }
+
+  std::vector<std::shared_ptr<PropellerBaseModel>> BuildPropellers(PropellerModelType type,
+                                                                   const PropellerParams &params,
+                                                                   std::size_t count) {
+    return VisitPropeller(type, [&](auto tag) {
+      return MakeModels<PropellerBaseModel, typename decltype(tag)::type>(count, params);
+    });
+  }
+
+  std::vector<std::shared_ptr<RudderBaseModel>> BuildRudders(RudderModelType type, const RudderParams &params,
+                                                             std::size_t count) {
+    return VisitRudder(type, [&](auto tag) {
+      return MakeModels<RudderBaseModel, typename decltype(tag)::type>(count, params);
+    });
+  }
+
+  std::vector<std::shared_ptr<PropellerRudderBase>> BuildPropellerRudders(PropellerRudderModelType type,
+                                                                          PropellerModelType propeller_type,
+                                                                          const PropellerParams &propeller_params,
+                                                                          RudderModelType rudder_type,
+                                                                          const RudderParams &rudder_params,
+                                                                          std::size_t count) {
+    return VisitPropellerRudder(type, propeller_type, rudder_type, [&](auto tag) {
+      return MakeModels<PropellerRudderBase, typename decltype(tag)::type>(count, propeller_params, rudder_params);
+    });
+  }
+
+  std::shared_ptr<PropellerRudderBase>
+  build_MMG_pr(PropellerModelType prop_type,
+               PropellerParams prop_params,
+               RudderModelType rudder_type,
+               RudderParams rudder_params) {
+    return BuildPropellerRudder(E_MMG, prop_type, prop_params, rudder_type, rudder_params);
+  }
+
+  std::shared_ptr<PropellerRudderBase>
+  build_Brix_pr(PropellerModelType prop_type,
+                PropellerParams prop_params,
+                RudderModelType rudder_type,
+                RudderParams rudder_params) {
+    return BuildPropellerRudder(E_BRIX, prop_type, prop_params, rudder_type, rudder_params);
+  }
+
+  ModelConfig ParseModelConfig(const std::string &json_string) {
+    try {
+      return ReadModelConfig(Parse(json_string));
+    } catch (const json::exception &e) {
+      throw std::runtime_error(std::string("Model configuration : ") + e.what());
+    }
+  }
+
+  Scenario BuildScenario(const std::string &json_string) {
+
+    std::map<std::string, ModelConfig> models;
+    std::vector<std::pair<std::string, std::size_t>> units;
+    try {
+      auto scenario = Parse(json_string);
+      const auto &models_node = scenario.at("models");
+      for (auto model = models_node.begin(); model != models_node.end(); ++model) {
+        models[model.key()] = ReadModelConfig(model.value());
+      }
+      for (const auto &unit : scenario.at("units")) {
+        units.emplace_back(unit.at("model").get<std::string>(), unit.value("count", std::size_t(1)));
+      }
+    } catch (const json::exception &e) {
+      throw std::runtime_error(std::string("Scenario : ") + e.what());
+    }
+
+    Scenario result;
+    for (const auto &unit : units) {
+      auto model = models.find(unit.first);
+      if (model == models.end()) throw std::runtime_error("Scenario : unknown model " + unit.first);
+      const auto &config = model->second;
+
+      if (config.m_has_propeller && config.m_has_rudder) {
+        auto propeller_rudders = BuildPropellerRudders(config.m_interaction, config.m_propeller_type,
+                                                       config.m_propeller_params, config.m_rudder_type,
+                                                       config.m_rudder_params, unit.second);
+        result.m_propeller_rudders.insert(result.m_propeller_rudders.end(), propeller_rudders.begin(),
+                                          propeller_rudders.end());
+      } else if (config.m_has_propeller) {
+        auto propellers = BuildPropellers(config.m_propeller_type, config.m_propeller_params, unit.second);
+        result.m_propellers.insert(result.m_propellers.end(), propellers.begin(), propellers.end());
+      } else {
+        auto rudders = BuildRudders(config.m_rudder_type, config.m_rudder_params, unit.second);
+        result.m_rudders.insert(result.m_rudders.end(), rudders.begin(), rudders.end());
+      }
+    }
+    return result;
+  }
+
+}  // end namespace acme
@@ -0,0 +1,119 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#ifndef ACME_MODELFACTORY_H
+#define ACME_MODELFACTORY_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "acme/propeller/PropellerBaseModel.h"
+#include "acme/propeller/PropellerModelType.h"
+#include "acme/rudder/RudderBaseModel.h"
+#include "acme/rudder/RudderModelType.h"
+#include "acme/propeller_rudder/PropellerRudderBase.h"
+
+namespace acme {
+
+  /// Get the model types from their names in the json configurations
+  /// \throws std::runtime_error for unknown names
+  PropellerModelType ParsePropellerModelType(const std::string &name);  // "FPP1Q", "FPP4Q" or "CPP"
+
+  RudderModelType ParseRudderModelType(const std::string &name);  // "simple", "flap", "fujii" or "brix"
+
+  PropellerRudderModelType ParsePropellerRudderModelType(const std::string &name);  // "brix" or "mmg"
+
+
+  /// Build a model of any type. The models are not initialized.
+  std::shared_ptr<PropellerBaseModel> BuildPropeller(PropellerModelType type, const PropellerParams &params);
+
+  std::shared_ptr<RudderBaseModel> BuildRudder(RudderModelType type, const RudderParams &params);
+
+  /// Any combination of propeller and rudder models for the Brix interactions. The MMG interactions are only available
+  /// with a FPP1Q propeller.
+  /// \throws std::invalid_argument for a MMG propeller rudder with another propeller type
+  std::shared_ptr<PropellerRudderBase> BuildPropellerRudder(PropellerRudderModelType type,
+                                                            PropellerModelType propeller_type,
+                                                            const PropellerParams &propeller_params,
+                                                            RudderModelType rudder_type,
+                                                            const RudderParams &rudder_params);
+
+  /// Build count models of the same type and parameters, contiguous in memory (see ModelArena)
+  std::vector<std::shared_ptr<PropellerBaseModel>> BuildPropellers(PropellerModelType type,
+                                                                   const PropellerParams &params,
+                                                                   std::size_t count);
+
+  std::vector<std::shared_ptr<RudderBaseModel>> BuildRudders(RudderModelType type, const RudderParams &params,
+                                                             std::size_t count);
+
+  std::vector<std::shared_ptr<PropellerRudderBase>> BuildPropellerRudders(PropellerRudderModelType type,
+                                                                          PropellerModelType propeller_type,
+                                                                          const PropellerParams &propeller_params,
+                                                                          RudderModelType rudder_type,
+                                                                          const RudderParams &rudder_params,
+                                                                          std::size_t count);
+
+
+  /// Model of a json configuration : a propeller, a rudder or a propeller rudder, with their parameters
+  struct ModelConfig {
+    bool m_has_propeller = false;
+    PropellerModelType m_propeller_type = E_FPP1Q;
+    PropellerParams m_propeller_params;
+
+    bool m_has_rudder = false;
+    RudderModelType m_rudder_type = E_SIMPLE_RUDDER;
+    RudderParams m_rudder_params;
+
+    PropellerRudderModelType m_interaction = E_BRIX;  // for a propeller rudder
+  };
+
+  /// Parse the json configuration of a model :
+  ///
+  ///   {
+  ///     "propeller": {"type": "FPP1Q" | "FPP4Q" | "CPP", "diameter_m": 4.0, "screw_direction": "right" | "left",
+  ///                   "hull_wake_fraction_0": 0.2, "thrust_deduction_factor_0": 0.15,
+  ///                   "out_of_range": "throw" | "clamp" | "extrapolate" | "zero",
+  ///                   "perf_data": {...} | "<path to the open water json file or curve file>"},
+  ///     "rudder": {"type": "simple" | "flap" | "fujii" | "brix", "lateral_area_m2": 12.0, "chord_m": 3.0,
+  ///                "height_m": 4.0, ..., "out_of_range": "clamp", "perf_data": {...} | "<path>"},
+  ///     "interaction": "brix" | "mmg"                  (propeller rudder, brix by default)
+  ///   }
+  ///
+  /// with a propeller, a rudder or both (propeller rudder). The optional parameters not given keep the defaults of
+  /// PropellerParams and RudderParams, or zero for those without default.
+  /// \throws std::runtime_error for invalid json, missing entries, unknown names and unreadable data files
+  ModelConfig ParseModelConfig(const std::string &json_string);
+
+
+  /// Units of a scenario, in the order of the scenario file
+  struct Scenario {
+    std::vector<std::shared_ptr<PropellerBaseModel>> m_propellers;
+    std::vector<std::shared_ptr<RudderBaseModel>> m_rudders;
+    std::vector<std::shared_ptr<PropellerRudderBase>> m_propeller_rudders;
+  };
+
+  /// Build the units of a json scenario :
+  ///
+  ///   {
+  ///     "models": {"<name>": <model configuration, see ParseModelConfig>, ...},
+  ///     "units": [{"model": "<name>", "count": 1000}, ...]
+  ///   }
+  ///
+  /// Each unit is a model of its own, the units of an entry being built in a single arena (see ModelArena). The models
+  /// are not initialized : the units sharing the same data share their curves once initialized (see InitializeModels).
+  /// \throws std::runtime_error for invalid configurations and unknown model names
+  Scenario BuildScenario(const std::string &json_string);
+
+}  // end namespace acme
+
+#endif //ACME_MODELFACTORY_H
@@ -0,0 +1,18 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#ifndef ACME_FACTORY_H
+#define ACME_FACTORY_H
+
+#include "ModelArena.h"
+#include "ModelFactory.h"
+
+#endif //ACME_FACTORY_H
@@ -0,0 +1,96 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#include "BulkInitialization.h"
+
+#include <algorithm>
+#include <chrono>
+#include <unordered_set>
+
+#include "acme/table/CurveRegistry.h"
+
+namespace acme {
+
+  namespace {
+
+    /// Initialization of a distinct model : its type (propeller, rudder, propeller rudder) and its first index
+    struct InitializationTask {
+      unsigned int m_type;
+      std::size_t m_index;
+    };
+
+    template<class Model>
+    void AddTasks(unsigned int type, const std::vector<std::shared_ptr<Model>> &models,
+                  std::unordered_set<const void *> &distinct_models, std::vector<InitializationTask> &tasks) {
+      for (std::size_t i = 0; i < models.size(); i++) {
+        if (distinct_models.insert(models[i].get()).second) tasks.push_back({type, i});
+      }
+    }
+
+  }  // end anonymous namespace
+
+  InitializationStats InitializeModels(WorkStealingPool &pool,
+                                       const std::vector<std::shared_ptr<PropellerBaseModel>> &propellers,
+                                       const std::vector<std::shared_ptr<RudderBaseModel>> &rudders,
+                                       const std::vector<std::shared_ptr<PropellerRudderBase>> &propeller_rudders) {
+    auto start = std::chrono::steady_clock::now();
+    auto &registry = CurveRegistry::GetInstance();
+    auto nb_builds = registry.GetStats().m_nb_builds;
+
+    InitializationStats stats;
+    stats.m_nb_threads = pool.GetNbThreads();
+    stats.m_propeller_times_ms.assign(propellers.size(), 0.);
+    stats.m_rudder_times_ms.assign(rudders.size(), 0.);
+    stats.m_propeller_rudder_times_ms.assign(propeller_rudders.size(), 0.);
+
+    std::unordered_set<const void *> distinct_models;
+    std::vector<InitializationTask> tasks;
+    AddTasks(0, propellers, distinct_models, tasks);
+    AddTasks(1, rudders, distinct_models, tasks);
+    AddTasks(2, propeller_rudders, distinct_models, tasks);
+
+    // Each task writes the time of its own model only
+    pool.Run(tasks.size(), [&](std::size_t i, unsigned int) {
+      const auto &task = tasks[i];
+      auto model_start = std::chrono::steady_clock::now();
+
+      double *time_ms;
+      switch (task.m_type) {
+        case 0:
+          propellers[task.m_index]->Initialize();
+          time_ms = &stats.m_propeller_times_ms[task.m_index];
+          break;
+        case 1:
+          rudders[task.m_index]->Initialize();
+          time_ms = &stats.m_rudder_times_ms[task.m_index];
+          break;
+        default:
+          propeller_rudders[task.m_index]->Initialize();
+          time_ms = &stats.m_propeller_rudder_times_ms[task.m_index];
+          break;
+      }
+      *time_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - model_start).count();
+    });
+
+    stats.m_nb_models = tasks.size();
+    stats.m_nb_curve_builds = registry.GetStats().m_nb_builds - nb_builds;
+    for (const auto *times : {&stats.m_propeller_times_ms, &stats.m_rudder_times_ms,
+                              &stats.m_propeller_rudder_times_ms}) {
+      for (const auto &time_ms : *times) {
+        stats.m_max_model_time_ms = std::max(stats.m_max_model_time_ms, time_ms);
+        stats.m_sum_model_time_ms += time_ms;
+      }
+    }
+    stats.m_total_time_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+  }
+
+}  // end namespace acme
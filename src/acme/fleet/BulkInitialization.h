@@ -0,0 +1,57 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#ifndef ACME_BULKINITIALIZATION_H
+#define ACME_BULKINITIALIZATION_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "WorkStealingPool.h"
+#include "acme/propeller/PropellerBaseModel.h"
+#include "acme/rudder/RudderBaseModel.h"
+#include "acme/propeller_rudder/PropellerRudderBase.h"
+
+namespace acme {
+
+  /// Timing of a bulk initialization
+  struct InitializationStats {
+    double m_total_time_ms = 0.;        // wall clock time of the whole initialization
+    double m_max_model_time_ms = 0.;    // longest model initialization
+    double m_sum_model_time_ms = 0.;    // sum of the model initialization times (serial initialization estimate)
+    std::size_t m_nb_models = 0;        // distinct models initialized
+    std::size_t m_nb_curve_builds = 0;  // curve sets built : performance data parsed, once per distinct data
+    unsigned int m_nb_threads = 0;
+
+    // Initialization time of each model, in the order of the given collections. Zero for the repeated occurrences of
+    // a model given several times, which is initialized once.
+    std::vector<double> m_propeller_times_ms;
+    std::vector<double> m_rudder_times_ms;
+    std::vector<double> m_propeller_rudder_times_ms;
+  };
+
+  /// Initialize a collection of models in parallel on a pool.
+  ///
+  /// Each distinct model is initialized once by one task, however many times it is given. Models built from identical
+  /// performance data share their curves through the CurveRegistry, which parses each data once : a model whose data
+  /// are being parsed by another worker waits for them instead of parsing them again.
+  ///
+  /// The first exception thrown by a model initialization is rethrown once all the workers are done, the models not
+  /// yet initialized being then skipped.
+  InitializationStats InitializeModels(WorkStealingPool &pool,
+                                       const std::vector<std::shared_ptr<PropellerBaseModel>> &propellers,
+                                       const std::vector<std::shared_ptr<RudderBaseModel>> &rudders = {},
+                                       const std::vector<std::shared_ptr<PropellerRudderBase>> &propeller_rudders = {});
+
+}  // end namespace acme
+
+#endif //ACME_BULKINITIALIZATION_H
@@ -0,0 +1,143 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#include "FleetEngine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace acme {
+
+  namespace {
+
+    std::size_t NbChunks(std::size_t nb_units, std::size_t chunk_size) {
+      return (nb_units + chunk_size - 1) / chunk_size;
+    }
+
+  }  // end anonymous namespace
+
+  FleetEngine::FleetEngine(unsigned int nb_threads, std::size_t chunk_size) :
+      m_pool(nb_threads), m_chunk_size(chunk_size) {
+    if (chunk_size == 0) throw std::invalid_argument("FleetEngine : chunk size must be positive");
+  }
+
+  std::size_t FleetEngine::AddPropeller(std::shared_ptr<PropellerBaseModel> model, const PropellerInput &input) {
+    m_propellers.push_back(std::move(model));
+    m_propeller_inputs.push_back(input);
+    m_propeller_outputs.emplace_back();
+    m_propeller_hints.emplace_back();
+    return m_propellers.size() - 1;
+  }
+
+  std::size_t FleetEngine::AddRudder(std::shared_ptr<RudderBaseModel> model, const RudderInput &input) {
+    m_rudders.push_back(std::move(model));
+    m_rudder_inputs.push_back(input);
+    m_rudder_outputs.emplace_back();
+    m_rudder_hints.emplace_back();
+    return m_rudders.size() - 1;
+  }
+
+  std::size_t
+  FleetEngine::AddPropellerRudder(std::shared_ptr<PropellerRudderBase> model, const PropellerRudderInput &input) {
+    m_propeller_rudders.push_back(std::move(model));
+    m_propeller_rudder_inputs.push_back(input);
+    m_propeller_rudder_outputs.emplace_back();
+    m_propeller_rudder_hints.emplace_back();
+    return m_propeller_rudders.size() - 1;
+  }
+
+  void FleetEngine::Initialize() {
+    m_initialization_stats = InitializeModels(m_pool, m_propellers, m_rudders, m_propeller_rudders);
+  }
+
+  std::size_t FleetEngine::ReleaseRetiredCurves() {
+    // Models shared by several units release their curves at their first occurrence
+    std::size_t nb_released = 0;
+    for (const auto &propeller : m_propellers) nb_released += propeller->ReleaseRetiredCurves();
+    for (const auto &rudder : m_rudders) nb_released += rudder->ReleaseRetiredCurves();
+    for (const auto &propeller_rudder : m_propeller_rudders) nb_released += propeller_rudder->ReleaseRetiredCurves();
+    return nb_released;
+  }
+
+  void FleetEngine::Step() {
+    auto start = std::chrono::steady_clock::now();
+
+    auto nb_chunks = NbChunks(m_propellers.size(), m_chunk_size) + NbChunks(m_rudders.size(), m_chunk_size) +
+                     NbChunks(m_propeller_rudders.size(), m_chunk_size);
+
+    auto update_stats = [this, start, nb_chunks]() {
+      auto stop = std::chrono::steady_clock::now();
+      m_stats = FleetStepStats();
+      m_stats.m_step_time_ms = std::chrono::duration<double, std::milli>(stop - start).count();
+      m_stats.m_nb_chunks = nb_chunks;
+      m_stats.m_nb_threads = m_pool.GetNbThreads();
+
+      double total_busy_time_ms = 0.;
+      for (const auto &worker : m_pool.GetWorkerStats()) {
+        m_stats.m_max_busy_time_ms = std::max(m_stats.m_max_busy_time_ms, worker.m_busy_time_ms);
+        total_busy_time_ms += worker.m_busy_time_ms;
+        m_stats.m_nb_steals += worker.m_nb_steals;
+      }
+      m_stats.m_mean_busy_time_ms = total_busy_time_ms / m_stats.m_nb_threads;
+      if (m_stats.m_mean_busy_time_ms > 0.) {
+        m_stats.m_load_imbalance = m_stats.m_max_busy_time_ms / m_stats.m_mean_busy_time_ms - 1.;
+      }
+    };
+
+    try {
+      m_pool.Run(nb_chunks, [this](std::size_t chunk, unsigned int) { ComputeChunk(chunk); });
+    } catch (...) {
+      update_stats();
+      throw;
+    }
+    update_stats();
+  }
+
+  void FleetEngine::ComputeChunk(std::size_t chunk) {
+
+    // Chunks are numbered propellers first, then rudders, then propeller rudders
+    auto nb_propeller_chunks = NbChunks(m_propellers.size(), m_chunk_size);
+    if (chunk < nb_propeller_chunks) {
+      auto begin = chunk * m_chunk_size;
+      auto end = std::min(begin + m_chunk_size, m_propellers.size());
+      for (auto unit = begin; unit < end; unit++) {
+        auto input = m_propeller_inputs[unit];
+        input.m_hints = &m_propeller_hints[unit];
+        m_propeller_outputs[unit] = m_propellers[unit]->Compute(input);
+      }
+      return;
+    }
+    chunk -= nb_propeller_chunks;
+
+    auto nb_rudder_chunks = NbChunks(m_rudders.size(), m_chunk_size);
+    if (chunk < nb_rudder_chunks) {
+      auto begin = chunk * m_chunk_size;
+      auto end = std::min(begin + m_chunk_size, m_rudders.size());
+      for (auto unit = begin; unit < end; unit++) {
+        auto input = m_rudder_inputs[unit];
+        input.m_hints = &m_rudder_hints[unit];
+        m_rudder_outputs[unit] = m_rudders[unit]->Compute(input);
+      }
+      return;
+    }
+    chunk -= nb_rudder_chunks;
+
+    auto begin = chunk * m_chunk_size;
+    auto end = std::min(begin + m_chunk_size, m_propeller_rudders.size());
+    for (auto unit = begin; unit < end; unit++) {
+      auto input = m_propeller_rudder_inputs[unit];
+      input.m_hints = &m_propeller_rudder_hints[unit];
+      m_propeller_rudder_outputs[unit] = m_propeller_rudders[unit]->Compute(input);
+    }
+  }
+
+}  // end namespace acme
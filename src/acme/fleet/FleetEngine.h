@@ -0,0 +1,134 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#ifndef ACME_FLEETENGINE_H
+#define ACME_FLEETENGINE_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "WorkStealingPool.h"
+#include "BulkInitialization.h"
+#include "acme/propeller/PropellerBaseModel.h"
+#include "acme/rudder/RudderBaseModel.h"
+#include "acme/propeller_rudder/PropellerRudderBase.h"
+
+namespace acme {
+
+  /// Timing of the last fleet step
+  struct FleetStepStats {
+    double m_step_time_ms = 0.;       // wall clock time of the step
+    double m_max_busy_time_ms = 0.;   // busy time of the most loaded worker
+    double m_mean_busy_time_ms = 0.;  // mean busy time of the workers
+    double m_load_imbalance = 0.;     // max / mean busy time - 1 : 0 for a perfectly balanced step
+    std::size_t m_nb_chunks = 0;      // chunks of units the step was split into
+    std::size_t m_nb_steals = 0;      // chunk ranges stolen by idle workers
+    unsigned int m_nb_threads = 0;
+  };
+
+
+  /// Actuators of a fleet of vessels, stepped together in parallel.
+  ///
+  /// The engine holds any number of propeller, rudder and propeller rudder units, each one being a model and its
+  /// current operating point. Models may be shared by several units (sister ships), they are evaluated with the const
+  /// Compute(input) that leaves them untouched. Inputs and outputs are stored contiguously per unit type, and units are
+  /// stepped by chunks of consecutive units spread over a work-stealing pool : a step is a single parallel loop
+  /// ending with a single barrier. Each unit keeps its own table interval hints (see TableHints), the hints given with
+  /// the inputs being ignored.
+  ///
+  /// The user sets the operating points (GetXXXInput), calls Step and reads the loads (GetXXXOutput). Units must not
+  /// be added while a step is running.
+  class FleetEngine {
+
+   public:
+    /// \param nb_threads number of threads stepping the fleet, calling thread included. 0 for the number of hardware
+    ///        threads
+    /// \param chunk_size number of consecutive units of the same type evaluated by a task
+    explicit FleetEngine(unsigned int nb_threads = 0, std::size_t chunk_size = 256);
+
+    /// Add a unit and get back its index among the units of the same type
+    std::size_t AddPropeller(std::shared_ptr<PropellerBaseModel> model, const PropellerInput &input = {});
+
+    std::size_t AddRudder(std::shared_ptr<RudderBaseModel> model, const RudderInput &input = {});
+
+    std::size_t AddPropellerRudder(std::shared_ptr<PropellerRudderBase> model, const PropellerRudderInput &input = {});
+
+    std::size_t GetNbPropellers() const { return m_propellers.size(); }
+
+    std::size_t GetNbRudders() const { return m_rudders.size(); }
+
+    std::size_t GetNbPropellerRudders() const { return m_propeller_rudders.size(); }
+
+    unsigned int GetNbThreads() const { return m_pool.GetNbThreads(); }
+
+    /// Initialize every model in parallel, once per model whatever the number of units sharing it (see
+    /// InitializeModels)
+    void Initialize();
+
+    const InitializationStats &GetInitializationStats() const { return m_initialization_stats; }
+
+    /// Compute the outputs of all the units from their current inputs.
+    /// An exception thrown by a model is rethrown once all the workers are done, the outputs of the step being then
+    /// partially updated.
+    void Step();
+
+    const FleetStepStats &GetLastStepStats() const { return m_stats; }
+
+    /// Release the curves replaced in the models of the fleet by ReloadPerformanceData since the last call. The models
+    /// may be reloaded from other threads while the fleet steps : this is the point where the former curves are known
+    /// to be no longer in use by the fleet, to be called from the stepping thread between two steps.
+    /// \return the number of curve sets released
+    std::size_t ReleaseRetiredCurves();
+
+    PropellerInput &GetPropellerInput(std::size_t unit) { return m_propeller_inputs[unit]; }
+
+    const PropellerOutput &GetPropellerOutput(std::size_t unit) const { return m_propeller_outputs[unit]; }
+
+    RudderInput &GetRudderInput(std::size_t unit) { return m_rudder_inputs[unit]; }
+
+    const RudderOutput &GetRudderOutput(std::size_t unit) const { return m_rudder_outputs[unit]; }
+
+    PropellerRudderInput &GetPropellerRudderInput(std::size_t unit) { return m_propeller_rudder_inputs[unit]; }
+
+    const PropellerRudderOutput &GetPropellerRudderOutput(std::size_t unit) const {
+      return m_propeller_rudder_outputs[unit];
+    }
+
+   private:
+    void ComputeChunk(std::size_t chunk);
+
+   private:
+    WorkStealingPool m_pool;
+    std::size_t m_chunk_size;
+    FleetStepStats m_stats;
+    InitializationStats m_initialization_stats;
+
+    std::vector<std::shared_ptr<PropellerBaseModel>> m_propellers;
+    std::vector<PropellerInput> m_propeller_inputs;
+    std::vector<PropellerOutput> m_propeller_outputs;
+    std::vector<TableHints> m_propeller_hints;
+
+    std::vector<std::shared_ptr<RudderBaseModel>> m_rudders;
+    std::vector<RudderInput> m_rudder_inputs;
+    std::vector<RudderOutput> m_rudder_outputs;
+    std::vector<TableHints> m_rudder_hints;
+
+    std::vector<std::shared_ptr<PropellerRudderBase>> m_propeller_rudders;
+    std::vector<PropellerRudderInput> m_propeller_rudder_inputs;
+    std::vector<PropellerRudderOutput> m_propeller_rudder_outputs;
+    std::vector<PropellerRudderHints> m_propeller_rudder_hints;
+
+  };
+
+}  // end namespace acme
+
+#endif //ACME_FLEETENGINE_H
@@ -0,0 +1,155 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace acme {
+
+  WorkStealingPool::WorkStealingPool(unsigned int nb_threads) {
+    if (nb_threads == 0) nb_threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (unsigned int worker = 0; worker < nb_threads; worker++) {
+      m_workers.push_back(std::make_unique<Worker>());
+    }
+    m_stats.resize(nb_threads);
+
+    // Worker 0 is the thread calling Run
+    for (unsigned int worker = 1; worker < nb_threads; worker++) {
+      m_threads.emplace_back(&WorkStealingPool::WorkerLoop, this, worker);
+    }
+  }
+
+  WorkStealingPool::~WorkStealingPool() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_start.notify_all();
+    for (auto &thread : m_threads) thread.join();
+  }
+
+  void WorkStealingPool::Run(std::size_t nb_tasks, const std::function<void(std::size_t, unsigned int)> &task) {
+
+    auto nb_workers = m_workers.size();
+    for (std::size_t worker = 0; worker < nb_workers; worker++) {
+      m_workers[worker]->m_begin = nb_tasks * worker / nb_workers;
+      m_workers[worker]->m_end = nb_tasks * (worker + 1) / nb_workers;
+      m_stats[worker] = WorkerStats();
+    }
+    if (nb_tasks == 0) return;
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_task = &task;
+      m_exception = nullptr;
+      m_cancelled = false;
+      m_nb_running = static_cast<unsigned int>(m_threads.size());
+      m_generation++;
+    }
+    m_start.notify_all();
+
+    Execute(0);
+
+    // Single barrier : wait for the other workers to run out of tasks
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_nb_running == 0; });
+    m_task = nullptr;
+
+    if (m_exception) {
+      auto exception = m_exception;
+      m_exception = nullptr;
+      std::rethrow_exception(exception);
+    }
+  }
+
+  void WorkStealingPool::WorkerLoop(unsigned int worker) {
+    std::size_t generation = 0;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_start.wait(lock, [this, generation] { return m_stop || m_generation != generation; });
+        if (m_stop) return;
+        generation = m_generation;
+      }
+
+      Execute(worker);
+
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (--m_nb_running == 0) m_done.notify_one();
+    }
+  }
+
+  void WorkStealingPool::Execute(unsigned int worker) {
+    auto start = std::chrono::steady_clock::now();
+    std::size_t nb_tasks = 0;  // counted locally, the stats of the workers sharing cache lines
+
+    std::size_t task;
+    while (true) {
+      if (!PopTask(worker, task)) {
+        if (Steal(worker)) continue;
+        break;
+      }
+      if (m_cancelled) continue;
+      try {
+        (*m_task)(task, worker);
+        nb_tasks++;
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_exception) m_exception = std::current_exception();
+        m_cancelled = true;
+      }
+    }
+
+    auto stop = std::chrono::steady_clock::now();
+    m_stats[worker].m_nb_tasks = nb_tasks;
+    m_stats[worker].m_busy_time_ms = std::chrono::duration<double, std::milli>(stop - start).count();
+  }
+
+  bool WorkStealingPool::PopTask(unsigned int worker, std::size_t &task) {
+    auto &own = *m_workers[worker];
+    std::lock_guard<std::mutex> lock(own.m_mutex);
+    if (own.m_begin == own.m_end) return false;
+    task = own.m_begin++;
+    return true;
+  }
+
+  bool WorkStealingPool::Steal(unsigned int worker) {
+    auto nb_workers = static_cast<unsigned int>(m_workers.size());
+
+    // Victims are visited from the next worker on, so that thieves spread over the pool
+    for (unsigned int k = 1; k < nb_workers; k++) {
+      auto &victim = *m_workers[(worker + k) % nb_workers];
+      std::size_t begin, end;
+      {
+        std::lock_guard<std::mutex> lock(victim.m_mutex);
+        auto remaining = victim.m_end - victim.m_begin;
+        if (remaining == 0) continue;
+        end = victim.m_end;
+        begin = end - (remaining + 1) / 2;
+        victim.m_end = begin;
+      }
+
+      auto &own = *m_workers[worker];
+      {
+        std::lock_guard<std::mutex> lock(own.m_mutex);
+        own.m_begin = begin;
+        own.m_end = end;
+      }
+      m_stats[worker].m_nb_steals++;
+      return true;
+    }
+    return false;
+  }
+
+}  // end namespace acme
@@ -0,0 +1,99 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#ifndef ACME_WORKSTEALINGPOOL_H
+#define ACME_WORKSTEALINGPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace acme {
+
+  /// Activity of a worker during the last call to WorkStealingPool::Run
+  struct WorkerStats {
+    double m_busy_time_ms = 0.;   // time spent executing tasks
+    std::size_t m_nb_tasks = 0;   // tasks executed
+    std::size_t m_nb_steals = 0;  // successful steals from the other workers
+  };
+
+
+  /// Fixed size pool of threads executing parallel loops over a number of independent tasks.
+  ///
+  /// The tasks of a loop are first split into contiguous ranges, one per worker. A worker executes its range from the
+  /// front, and once it is empty steals the back half of the next non-empty range : uneven tasks are balanced without
+  /// any scheduling cost while the load is even. The calling thread takes part as worker 0, and Run returns
+  /// once every task has been executed (a single barrier per loop).
+  class WorkStealingPool {
+
+   public:
+    /// \param nb_threads number of workers, calling thread included. 0 for the number of hardware threads.
+    explicit WorkStealingPool(unsigned int nb_threads = 0);
+
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    unsigned int GetNbThreads() const { return static_cast<unsigned int>(m_workers.size()); }
+
+    /// Execute task(i, worker) for every i in [0, nb_tasks), worker being the index of the executing worker.
+    /// The first exception thrown by a task is rethrown once all the workers are done, the tasks not yet started
+    /// being skipped. Not reentrant : a single loop runs at a time.
+    void Run(std::size_t nb_tasks, const std::function<void(std::size_t task, unsigned int worker)> &task);
+
+    /// Activity of each worker during the last loop
+    const std::vector<WorkerStats> &GetWorkerStats() const { return m_stats; }
+
+   private:
+    /// Range of tasks owned by a worker, on its own cache line
+    struct alignas(64) Worker {
+      std::mutex m_mutex;
+      std::size_t m_begin = 0;
+      std::size_t m_end = 0;
+    };
+
+    void WorkerLoop(unsigned int worker);
+
+    void Execute(unsigned int worker);
+
+    bool PopTask(unsigned int worker, std::size_t &task);
+
+    bool Steal(unsigned int worker);
+
+   private:
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread> m_threads;
+    std::vector<WorkerStats> m_stats;
+
+    // Current loop, published to the threads under m_mutex
+    std::mutex m_mutex;
+    std::condition_variable m_start;
+    std::condition_variable m_done;
+    const std::function<void(std::size_t, unsigned int)> *m_task = nullptr;
+    std::size_t m_generation = 0;
+    unsigned int m_nb_running = 0;
+    bool m_stop = false;
+    std::atomic<bool> m_cancelled{false}; // set by the first failing task, the remaining tasks being skipped
+    std::exception_ptr m_exception;
+
+  };
+
+}  // end namespace acme
+
+#endif //ACME_WORKSTEALINGPOOL_H
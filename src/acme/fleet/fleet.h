@@ -0,0 +1,19 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#ifndef ACME_FLEET_H
+#define ACME_FLEET_H
+
+#include "WorkStealingPool.h"
+#include "BulkInitialization.h"
+#include "FleetEngine.h"
+
+#endif //ACME_FLEET_H
@@ -0,0 +1,286 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#include "OperatingMap.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "acme/fleet/WorkStealingPool.h"
+
+namespace acme {
+
+  namespace {
+
+    const char c_magic[8] = {'A', 'C', 'M', 'E', 'M', 'A', 'P', '\0'};
+    const std::uint32_t c_version = 1;
+
+    // Grid points evaluated by a task
+    const std::size_t c_chunk_size = 1024;
+
+    template<class T>
+    void WriteValue(std::ofstream &file, const T &value) {
+      file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    void WriteString(std::ofstream &file, const std::string &string) {
+      WriteValue(file, static_cast<std::uint32_t>(string.size()));
+      file.write(string.data(), static_cast<std::streamsize>(string.size()));
+    }
+
+    template<class T>
+    T ReadValue(std::ifstream &file) {
+      T value;
+      file.read(reinterpret_cast<char *>(&value), sizeof(T));
+      return value;
+    }
+
+    std::string ReadString(std::ifstream &file) {
+      std::string string(ReadValue<std::uint32_t>(file), '\0');
+      file.read(&string[0], static_cast<std::streamsize>(string.size()));
+      return string;
+    }
+
+    /// Fields of the model input set by each axis
+    template<class Input>
+    using AxisFields = std::vector<std::vector<double Input::*>>;
+
+    template<class Input>
+    AxisFields<Input> GetAxisFields(const std::vector<GridAxis> &axes,
+                                    const std::vector<std::pair<std::string, std::vector<double Input::*>>> &fields) {
+      AxisFields<Input> axis_fields;
+      for (const auto &axis : axes) {
+        auto field = std::find_if(fields.begin(), fields.end(),
+                                  [&axis](const auto &named_field) { return named_field.first == axis.m_name; });
+        if (field == fields.end()) {
+          throw std::invalid_argument("Operating map : unknown axis " + axis.m_name);
+        }
+        axis_fields.push_back(field->second);
+      }
+      return axis_fields;
+    }
+
+    template<class Input>
+    Input GetInput(const Input &operating_point, const AxisFields<Input> &axis_fields, const double *coordinates) {
+      Input input = operating_point;
+      for (std::size_t axis = 0; axis < axis_fields.size(); axis++) {
+        for (auto field : axis_fields[axis]) input.*field = coordinates[axis];
+      }
+      return input;
+    }
+
+  }  // end anonymous namespace
+
+  GridAxis GridAxis::Linspace(const std::string &name, double min, double max, std::size_t nb_values) {
+    GridAxis axis{name, std::vector<double>(nb_values)};
+    for (std::size_t i = 0; i < nb_values; i++) {
+      axis.m_values[i] = nb_values > 1 ? min + (max - min) * double(i) / double(nb_values - 1) : min;
+    }
+    return axis;
+  }
+
+  OperatingMap::OperatingMap(std::vector<GridAxis> axes, std::vector<std::string> column_names) :
+      m_axes(std::move(axes)), m_column_names(std::move(column_names)), m_nb_points(1) {
+    for (const auto &axis : m_axes) {
+      if (axis.m_values.empty()) throw std::invalid_argument("Operating map : no value on axis " + axis.m_name);
+      m_nb_points *= axis.m_values.size();
+    }
+    m_data.resize(m_column_names.size() * m_nb_points);
+  }
+
+  void OperatingMap::GetCoordinates(std::size_t point, double *coordinates) const {
+    for (auto axis = m_axes.size(); axis-- > 0;) {
+      const auto &values = m_axes[axis].m_values;
+      coordinates[axis] = values[point % values.size()];
+      point /= values.size();
+    }
+  }
+
+  std::size_t OperatingMap::GetColumnIndex(const std::string &name) const {
+    auto column = std::find(m_column_names.begin(), m_column_names.end(), name);
+    if (column == m_column_names.end()) throw std::out_of_range("Operating map : no column " + name);
+    return static_cast<std::size_t>(column - m_column_names.begin());
+  }
+
+  void OperatingMap::Write(const std::string &path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) throw std::runtime_error("Operating map : can not write " + path);
+
+    file.write(c_magic, sizeof(c_magic));
+    WriteValue(file, c_version);
+    WriteValue(file, static_cast<std::uint32_t>(m_axes.size()));
+    WriteValue(file, static_cast<std::uint32_t>(m_column_names.size()));
+    WriteValue(file, std::uint32_t(0));
+    WriteValue(file, static_cast<std::uint64_t>(m_nb_points));
+
+    for (const auto &axis : m_axes) {
+      WriteString(file, axis.m_name);
+      WriteValue(file, static_cast<std::uint64_t>(axis.m_values.size()));
+      file.write(reinterpret_cast<const char *>(axis.m_values.data()),
+                 static_cast<std::streamsize>(axis.m_values.size() * sizeof(double)));
+    }
+    for (const auto &name : m_column_names) WriteString(file, name);
+
+    // Columns aligned on 8 bytes, so that the file may be mapped in memory
+    auto padding = (8 - static_cast<std::size_t>(file.tellp()) % 8) % 8;
+    file.write("\0\0\0\0\0\0\0", static_cast<std::streamsize>(padding));
+
+    file.write(reinterpret_cast<const char *>(m_data.data()),
+               static_cast<std::streamsize>(m_data.size() * sizeof(double)));
+    if (!file) throw std::runtime_error("Operating map : can not write " + path);
+  }
+
+  OperatingMap OperatingMap::Read(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) throw std::runtime_error("Operating map : can not read " + path);
+
+    char magic[sizeof(c_magic)];
+    file.read(magic, sizeof(magic));
+    if (!file || std::memcmp(magic, c_magic, sizeof(c_magic)) != 0) {
+      throw std::runtime_error("Operating map : " + path + " is not an operating map file");
+    }
+    if (ReadValue<std::uint32_t>(file) != c_version) {
+      throw std::runtime_error("Operating map : unsupported format version in " + path);
+    }
+    auto nb_axes = ReadValue<std::uint32_t>(file);
+    auto nb_columns = ReadValue<std::uint32_t>(file);
+    ReadValue<std::uint32_t>(file);
+    auto nb_points = ReadValue<std::uint64_t>(file);
+
+    std::vector<GridAxis> axes(nb_axes);
+    for (auto &axis : axes) {
+      axis.m_name = ReadString(file);
+      axis.m_values.resize(ReadValue<std::uint64_t>(file));
+      file.read(reinterpret_cast<char *>(axis.m_values.data()),
+                static_cast<std::streamsize>(axis.m_values.size() * sizeof(double)));
+    }
+    std::vector<std::string> column_names(nb_columns);
+    for (auto &name : column_names) name = ReadString(file);
+    if (!file) throw std::runtime_error("Operating map : truncated file " + path);
+
+    file.seekg((8 - file.tellg() % 8) % 8, std::ios::cur);
+
+    OperatingMap map(std::move(axes), std::move(column_names));
+    if (map.m_nb_points != nb_points) throw std::runtime_error("Operating map : inconsistent grid in " + path);
+    file.read(reinterpret_cast<char *>(map.m_data.data()),
+              static_cast<std::streamsize>(map.m_data.size() * sizeof(double)));
+    if (!file) throw std::runtime_error("Operating map : truncated file " + path);
+
+    return map;
+  }
+
+  OperatingMap BuildOperatingMap(std::vector<GridAxis> axes, std::vector<std::string> column_names,
+                                 const GridPointFunction &function, unsigned int nb_threads) {
+
+    OperatingMap map(std::move(axes), std::move(column_names));
+    auto nb_points = map.GetNbPoints();
+    auto nb_axes = map.GetAxes().size();
+    auto nb_columns = map.GetColumnNames().size();
+
+    WorkStealingPool pool(nb_threads);
+    pool.Run((nb_points + c_chunk_size - 1) / c_chunk_size, [&](std::size_t chunk, unsigned int) {
+      std::vector<double> coordinates(nb_axes);
+      std::vector<double> values(nb_columns);
+      auto end = std::min(nb_points, (chunk + 1) * c_chunk_size);
+      for (auto point = chunk * c_chunk_size; point < end; point++) {
+        map.GetCoordinates(point, coordinates.data());
+        function(coordinates.data(), values.data());
+        for (std::size_t column = 0; column < nb_columns; column++) map.GetColumn(column)[point] = values[column];
+      }
+    });
+
+    return map;
+  }
+
+  OperatingMap BuildPropellerMap(const PropellerBaseModel &propeller, const PropellerInput &operating_point,
+                                 std::vector<GridAxis> axes, unsigned int nb_threads) {
+
+    auto axis_fields = GetAxisFields<PropellerInput>(axes, {
+        {"water_density", {&PropellerInput::m_water_density}},
+        {"u_NWU",         {&PropellerInput::m_u_NWU}},
+        {"v_NWU",         {&PropellerInput::m_v_NWU}},
+        {"rpm",           {&PropellerInput::m_rpm}},
+        {"pitch_ratio",   {&PropellerInput::m_pitch_ratio}}
+    });
+
+    return BuildOperatingMap(std::move(axes), {"advance_ratio", "thrust_N", "torque_Nm", "power_W", "efficiency"},
+                             [&](const double *coordinates, double *values) {
+                               // Interval hints of the worker thread, the successive grid points of a chunk being
+                               // close operating points
+                               thread_local TableHints hints;
+                               auto input = GetInput(operating_point, axis_fields, coordinates);
+                               input.m_hints = &hints;
+                               PropellerOutput output;
+                               try {
+                                 output = propeller.Compute(input);
+                               } catch (const std::exception &) {
+                                 std::fill(values, values + 5, std::numeric_limits<double>::quiet_NaN());
+                                 return;
+                               }
+                               values[0] = output.m_advance_ratio;
+                               values[1] = output.m_thrust_N;
+                               values[2] = output.m_torque_Nm;
+                               values[3] = output.m_power_W;
+                               values[4] = output.m_efficiency;
+                             }, nb_threads);
+  }
+
+  OperatingMap BuildPropellerRudderMap(const PropellerRudderBase &propeller_rudder,
+                                       const PropellerRudderInput &operating_point,
+                                       std::vector<GridAxis> axes, unsigned int nb_threads) {
+
+    using Input = PropellerRudderInput;
+    auto axis_fields = GetAxisFields<Input>(axes, {
+        {"water_density",      {&Input::m_water_density}},
+        {"u_NWU_propeller_ms", {&Input::m_u_NWU_propeller_ms}},
+        {"v_NWU_propeller_ms", {&Input::m_v_NWU_propeller_ms}},
+        {"u_NWU_ship_ms",      {&Input::m_u_NWU_ship_ms}},
+        {"v_NWU_ship_ms",      {&Input::m_v_NWU_ship_ms}},
+        {"speed_ms",           {&Input::m_u_NWU_propeller_ms, &Input::m_u_NWU_ship_ms}},
+        {"r_rads",             {&Input::m_r_rads}},
+        {"x_pr_m",             {&Input::m_x_pr_m}},
+        {"x_gr_m",             {&Input::m_x_gr_m}},
+        {"rpm",                {&Input::m_rpm}},
+        {"pitch_ratio",        {&Input::m_pitch_ratio}},
+        {"rudder_angle_deg",   {&Input::m_rudder_angle_deg}}
+    });
+
+    return BuildOperatingMap(std::move(axes), {"thrust_N", "torque_Nm", "power_W", "rudder_fx_N", "rudder_fy_N",
+                                               "rudder_torque_Nm", "fx_N", "fy_N", "mz_Nm"},
+                             [&](const double *coordinates, double *values) {
+                               thread_local PropellerRudderHints hints;
+                               auto input = GetInput(operating_point, axis_fields, coordinates);
+                               input.m_hints = &hints;
+                               PropellerRudderOutput output;
+                               try {
+                                 output = propeller_rudder.Compute(input);
+                               } catch (const std::exception &) {
+                                 std::fill(values, values + 9, std::numeric_limits<double>::quiet_NaN());
+                                 return;
+                               }
+                               values[0] = output.m_propeller.m_thrust_N;
+                               values[1] = output.m_propeller.m_torque_Nm;
+                               values[2] = output.m_propeller.m_power_W;
+                               values[3] = output.m_rudder.m_fx_N;
+                               values[4] = output.m_rudder.m_fy_N;
+                               values[5] = output.m_rudder.m_torque_Nm;
+                               values[6] = output.m_fx_N;
+                               values[7] = output.m_fy_N;
+                               values[8] = output.m_mz_Nm;
+                             }, nb_threads);
+  }
+
+}  // end namespace acme
@@ -0,0 +1,120 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#ifndef ACME_OPERATINGMAP_H
+#define ACME_OPERATINGMAP_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "acme/propeller/PropellerBaseModel.h"
+#include "acme/propeller_rudder/PropellerRudderBase.h"
+
+namespace acme {
+
+  /// Axis of an operating map grid : name of the gridded quantity and its values
+  struct GridAxis {
+    std::string m_name;
+    std::vector<double> m_values;
+
+    /// nb_values uniformly spaced values from min to max, both included
+    static GridAxis Linspace(const std::string &name, double min, double max, std::size_t nb_values);
+  };
+
+
+  /// Results of a model over a N-dimensional grid, stored by column : one contiguous array of values per output
+  /// quantity, the grid points being ordered with the last axis varying fastest.
+  ///
+  /// Binary file layout (Write / Read), native little endian :
+  ///
+  ///   char[8]   "ACMEMAP" followed by a zero byte
+  ///   uint32    format version (1)
+  ///   uint32    number of axes
+  ///   uint32    number of columns
+  ///   uint32    zero
+  ///   uint64    number of grid points
+  ///   per axis    : uint32 name size, name characters, uint64 number of values, float64 values
+  ///   per column  : uint32 name size, name characters
+  ///   zero padding up to a multiple of 8 bytes
+  ///   per column  : float64 values of all the grid points
+  class OperatingMap {
+
+   public:
+    OperatingMap() = default;
+
+    /// \throws std::invalid_argument if an axis has no value
+    OperatingMap(std::vector<GridAxis> axes, std::vector<std::string> column_names);
+
+    const std::vector<GridAxis> &GetAxes() const { return m_axes; }
+
+    const std::vector<std::string> &GetColumnNames() const { return m_column_names; }
+
+    std::size_t GetNbPoints() const { return m_nb_points; }
+
+    /// Coordinates of a grid point, one per axis
+    void GetCoordinates(std::size_t point, double *coordinates) const;
+
+    /// \throws std::out_of_range if there is no column with that name
+    std::size_t GetColumnIndex(const std::string &name) const;
+
+    /// Values of a column at all the grid points
+    const double *GetColumn(std::size_t column) const { return m_data.data() + column * m_nb_points; }
+
+    double *GetColumn(std::size_t column) { return m_data.data() + column * m_nb_points; }
+
+    /// \throws std::runtime_error if the file can not be written
+    void Write(const std::string &path) const;
+
+    /// \throws std::runtime_error if the file can not be read or is not an operating map
+    static OperatingMap Read(const std::string &path);
+
+   private:
+    std::vector<GridAxis> m_axes;
+    std::vector<std::string> m_column_names;
+    std::size_t m_nb_points = 0;
+    std::vector<double> m_data;
+
+  };
+
+
+  /// Function evaluated at every grid point : values of the columns (output) at the given coordinates
+  using GridPointFunction = std::function<void(const double *coordinates, double *values)>;
+
+  /// Evaluate a function over a grid, in parallel by chunks of consecutive grid points.
+  /// \param function must be safe to call concurrently
+  /// \param nb_threads number of threads, calling thread included. 0 for the number of hardware threads
+  OperatingMap BuildOperatingMap(std::vector<GridAxis> axes, std::vector<std::string> column_names,
+                                 const GridPointFunction &function, unsigned int nb_threads = 0);
+
+  /// Operating map of a propeller : advance_ratio, thrust_N, torque_Nm, power_W and efficiency.
+  /// Grid points the model rejects (Compute throwing, e.g. out of the range of its performance data) get NaN values.
+  /// Axes are named after the fields of PropellerInput (water_density, u_NWU, v_NWU, rpm, pitch_ratio), the fields
+  /// not gridded keeping their value of operating_point.
+  /// \throws std::invalid_argument for an unknown axis name
+  OperatingMap BuildPropellerMap(const PropellerBaseModel &propeller, const PropellerInput &operating_point,
+                                 std::vector<GridAxis> axes, unsigned int nb_threads = 0);
+
+  /// Operating map of a propeller rudder : thrust_N, torque_Nm, power_W (propeller), rudder_fx_N, rudder_fy_N,
+  /// rudder_torque_Nm (rudder, torque at the rudder position) and fx_N, fy_N, mz_Nm (total, see
+  /// PropellerRudderOutput), with NaN values at the grid points the model rejects.
+  /// Axes are named after the fields of PropellerRudderInput (water_density, u_NWU_propeller_ms, ..., rpm,
+  /// pitch_ratio, rudder_angle_deg), or speed_ms for the longitudinal velocity of both the propeller and the ship. The
+  /// fields not gridded keep their value of operating_point.
+  /// \throws std::invalid_argument for an unknown axis name
+  OperatingMap BuildPropellerRudderMap(const PropellerRudderBase &propeller_rudder,
+                                       const PropellerRudderInput &operating_point,
+                                       std::vector<GridAxis> axes, unsigned int nb_threads = 0);
+
+}  // end namespace acme
+
+#endif //ACME_OPERATINGMAP_H
@@ -3,9 +3,10 @@
 //
 
 #include "CPP.h"
-#include <nlohmann/json.hpp>
 
-using json = nlohmann::json;
+#include <stdexcept>
+
+#include "acme/table/PerformanceDataParser.h"
 
 namespace acme {
 
@@ -14,39 +15,115 @@ namespace acme {
     m_type = PropellerModelType::E_CPP;  // Overrides the type E_FPP4Q
   }
 
-  void CPP::GetCtCq(const double &gamma,
-                    const double &pitch_ratio,
-                    double &ct,
-                    double &cq) const {
-    ct = m_ct_ct_coeffs.Eval("ct", gamma, pitch_ratio);
-    cq = m_ct_ct_coeffs.Eval("cq", gamma, pitch_ratio);
+  unsigned int CPP::GetCtCq(const double &gamma,
+                            const double &pitch_ratio,
+                            TableHints &hints,
+                            double &ct,
+                            double &cq) const {
+    // Single cell location for both coefficients
+    const auto &curves = *m_curves;
+    auto policy = m_params.m_out_of_range_policy;
+    bool is_out_of_range;
+    auto cell = curves.m_ct_cq_coeffs.Locate(gamma, pitch_ratio, hints.m_x, hints.m_y,
+                                             policy == E_OUT_OF_RANGE_EXTRAPOLATE, is_out_of_range);
+    ct = curves.m_ct_cq_coeffs.Eval(cell, curves.m_ct_column);
+    cq = curves.m_ct_cq_coeffs.Eval(cell, curves.m_cq_column);
+    if (!is_out_of_range) return E_STATUS_OK;
+
+    const auto &beta_axis = curves.m_ct_cq_coeffs.GetXAxis();
+    if (gamma >= beta_axis.GetMin() && gamma <= beta_axis.GetMax()) {
+      return HandleOutOfRange(policy, c_status_counters, "CPP : pitch ratio", pitch_ratio, {&ct, &cq});
+    }
+    return HandleOutOfRange(policy, c_status_counters, "CPP : blade advance angle (rad)", gamma, {&ct, &cq});
+  }
+
+  void CPP::GetCtCqBatch(std::size_t size,
+                         const double *gamma,
+                         const double *pitch_ratio,
+                         double *ct,
+                         double *cq,
+                         unsigned int *status) const {
+    if (!pitch_ratio) {
+      throw std::invalid_argument("CPP : the pitch ratios of the batch are required");
+    }
+    TableHints hints;
+    for (std::size_t i = 0; i < size; i++) {
+      auto status_i = CPP::GetCtCq(gamma[i], pitch_ratio[i], hints, ct[i], cq[i]);
+      if (status) status[i] = status_i;
+    }
   }
 
   void CPP::ParsePropellerPerformanceCurveJsonString() {
 
+    if (m_params.m_table_interpolation != E_LINEAR) {
+      throw std::runtime_error("CPP : only linear interpolation is available for 2D tables");
+    }
+
+    m_curves = LoadCurves(GetPerformanceDataJsonString(), m_params.m_thruster_perf_data_curve_file);
+    m_perf_data_json_string.reset();
+
+    m_table_simplification_report = m_curves->m_table_simplification_report;
+
+  }
+
+  void CPP::ReloadPerformanceCurves(const std::string &json_string, const std::string &curve_file) {
+    m_retired_curves.Add(m_curves.Publish(LoadCurves(json_string, curve_file)));
+  }
+
+  std::shared_ptr<const CPPCurves> CPP::LoadCurves(const std::string &json_string,
+                                                   const std::string &curve_file) const {
+    // Propellers built from the same data share the same curves
+    auto key = CurveRegistryKey("CPP", {m_params.m_table_simplification_tolerance,
+                                        double(m_params.m_table_single_precision)},
+                                json_string, curve_file);
+    return CurveRegistry::GetInstance().Get<CPPCurves>(key, [&]() {
+      auto file = curve_file.empty() ? nullptr : CurveFile::Open(curve_file);
+      return BuildCurves(json_string, file.get());
+    });
+  }
+
+  CPPCurves CPP::BuildCurves(const std::string &json_string, const CurveFile *file) const {
+
+    CPPCurves curves;
     std::vector<double> beta, pitch_ratio, ct, cq;
-    ParseCPPJsonString(m_params.m_thruster_perf_data_json_string, beta, pitch_ratio, ct, cq);
-    m_params.m_thruster_perf_data_json_string.clear();
-    m_ct_ct_coeffs.SetX(beta);
-    m_ct_ct_coeffs.SetY(pitch_ratio);
-    m_ct_ct_coeffs.AddData("ct", ct);
-    m_ct_ct_coeffs.AddData("cq", cq);
 
+    if (file) {
+      file->CheckModel("CPP");
+
+      if (m_params.m_table_simplification_tolerance <= 0.) {
+        // Table used in place in the mapped file
+        curves.m_ct_cq_coeffs.SetSinglePrecision(m_params.m_table_single_precision);
+        file->SetTable(curves.m_ct_cq_coeffs);
+        curves.m_ct_column = curves.m_ct_cq_coeffs.GetColumnHandle("ct");
+        curves.m_cq_column = curves.m_ct_cq_coeffs.GetColumnHandle("cq");
+        return curves;
+      }
+
+      beta = file->GetAxis(0);
+      pitch_ratio = file->GetAxis(1);
+      ct = file->GetColumn("ct");
+      cq = file->GetColumn("cq");
+    } else {
+      ParseCPPJsonString(json_string, beta, pitch_ratio, ct, cq);
+    }
+
+    if (m_params.m_table_simplification_tolerance > 0.) {
+      curves.m_table_simplification_report = SimplifyTable2D(beta, pitch_ratio, {&ct, &cq},
+                                                             m_params.m_table_simplification_tolerance);
+    }
+
+    curves.m_ct_cq_coeffs.SetX(beta);
+    curves.m_ct_cq_coeffs.SetY(pitch_ratio);
+    curves.m_ct_cq_coeffs.SetSinglePrecision(m_params.m_table_single_precision);
+    curves.m_ct_column = curves.m_ct_cq_coeffs.AddData("ct", ct);
+    curves.m_cq_column = curves.m_ct_cq_coeffs.AddData("cq", cq);
+    return curves;
   }
 
   void ParseCPPJsonString(const std::string &json_string, std::vector<double> &beta,
                           std::vector<double> &pitch_ratio, std::vector<double> &ct,
                           std::vector<double> &cq) {
 
-    auto jnode = json::parse(json_string);
-
-    beta = jnode["beta_deg"].get<std::vector<double>>();
-    pitch_ratio = jnode["p_d"].get<std::vector<double>>();
-    auto ct_tmp = jnode["ct"].get<std::vector<std::vector<double>>>();
-    auto cq_tmp = jnode["cq"].get<std::vector<std::vector<double>>>();
-
-    for (auto &b : beta) b *= DEG2RAD;
-
     //FIXME
 //    // Only one
 //    if (screw_direction == "LEFT_HANDED") {
@@ -60,17 +137,24 @@ namespace acme {
 //      exit(EXIT_FAILURE);
 //    }
 
-    // Transform ct to fit in AddData
-    Eigen::MatrixXd mat(pitch_ratio.size(), beta.size());
-    for (int i = 0; i < pitch_ratio.size(); i++) {
-      mat.row(i) = Eigen::VectorXd::Map(&ct_tmp[i][0], ct_tmp[i].size());
-    }
-    ct = {mat.data(), mat.data() + mat.rows() * mat.cols()};
+    // ct and cq rows are given for each pitch ratio, and stored as expected by AddData (pitch ratio varying fastest)
+    PerformanceDataParser parser("CPP parser");
+    parser.AddAxis("beta_deg", beta, DEG2RAD);
+    parser.AddAxis("p_d", pitch_ratio);
+    parser.AddMatrix("ct", ct, "beta_deg", "p_d");
+    parser.AddMatrix("cq", cq, "beta_deg", "p_d");
+    parser.Parse(json_string);
+  }
 
-    // Transform cq to fit in AddData
-    for (int i = 0; i < pitch_ratio.size(); i++) {
-      mat.row(i) = Eigen::VectorXd::Map(&cq_tmp[i][0], cq_tmp[i].size());
-    }
-    cq = {mat.data(), mat.data() + mat.rows() * mat.cols()};
+  CurveData CPPCurveData(const std::string &json_string) {
+    std::vector<double> beta, pitch_ratio, ct, cq;
+    ParseCPPJsonString(json_string, beta, pitch_ratio, ct, cq);
+
+    CurveData data;
+    data.m_model = "CPP";
+    data.m_axes = {{"beta_rad", beta}, {"p_d", pitch_ratio}};
+    data.m_columns = {{"ct", ct}, {"cq", cq}};
+    return data;
   }
-}  // end namespace acme
\ No newline at end of file
+
+}  // end namespace acme
@@ -5,13 +5,29 @@
 #ifndef ACME_CPP_H
 #define ACME_CPP_H
 
+#include <memory>
 #include <string>
-#include "MathUtils/LookupTable2D.h"
+#include "acme/table/PerformanceTable2D.h"
+#include "acme/table/CurveRegistry.h"
+#include "acme/table/CurvePointer.h"
+#include "acme/table/CurveFile.h"
 
 #include "FPP4Q.h"
 
 namespace acme {
 
+  /// Four quadrant curves of a CPP, shared by the propellers built from the same data (see CurveRegistry)
+  struct CPPCurves {
+    PerformanceTable2D m_ct_cq_coeffs;
+    ColumnHandle m_ct_column = 0;
+    ColumnHandle m_cq_column = 0;
+
+    TableSimplificationReport m_table_simplification_report;
+
+    std::size_t GetMemoryUsage() const { return m_ct_cq_coeffs.GetMemoryUsage(); }
+  };
+
+
   class CPP : public FPP4Q {
 
    public:
@@ -19,15 +35,30 @@ namespace acme {
 
    private:
 
-    void GetCtCq(const double &gamma,
-                 const double &pitch_ratio,
-                 double &ct,
-                 double &cq) const override;
+    unsigned int GetCtCq(const double &gamma,
+                         const double &pitch_ratio,
+                         TableHints &hints,
+                         double &ct,
+                         double &cq) const override;
+
+    void GetCtCqBatch(std::size_t size,
+                      const double *gamma,
+                      const double *pitch_ratio,
+                      double *ct,
+                      double *cq,
+                      unsigned int *status) const override;
 
     void ParsePropellerPerformanceCurveJsonString() override;
 
+    void ReloadPerformanceCurves(const std::string &json_string, const std::string &curve_file) override;
+
+    /// Curves of the performance data, shared with the propellers built from the same data and options
+    std::shared_ptr<const CPPCurves> LoadCurves(const std::string &json_string, const std::string &curve_file) const;
+
+    CPPCurves BuildCurves(const std::string &json_string, const CurveFile *file) const;
+
    private:
-    mathutils::LookupTable2d<double> m_ct_ct_coeffs;
+    CurvePointer<CPPCurves> m_curves;
 
   };
 
@@ -37,6 +68,9 @@ namespace acme {
                           std::vector<double> &ct,
                           std::vector<double> &cq);
 
+  /// Four quadrant tables of a json string, advance angles in radians, as written in a curve file (see CurveFile)
+  CurveData CPPCurveData(const std::string &json_string);
+
 }  // end namespace acme
 
 #endif //ACME_CPP_H
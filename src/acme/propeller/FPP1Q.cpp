@@ -4,44 +4,58 @@
 
 #include "FPP1Q.h"
 
-#include <iostream>
+#include <algorithm>
+#include <cmath>
 #include <vector>
-#include <nlohmann/json.hpp>
 
-using json = nlohmann::json;
+#include "acme/table/PerformanceDataParser.h"
 
 namespace acme {
 
+  namespace {
+
+    /// Streaming parse of the open water data, the options being overridden by the json entries if any
+    void ParseFPP1QPerformanceData(PerformanceDataParser &parser, const std::string &json_string,
+                                   std::vector<double> &j, std::vector<double> &kt, std::vector<double> &kq,
+                                   InterpolationType &interpolation, unsigned int &chebyshev_degree) {
+      std::string interpolation_name;
+      parser.AddOption("interpolation", interpolation_name);
+      parser.AddOption("chebyshev_degree", chebyshev_degree);
+      parser.AddAxis("j", j);
+      parser.AddArray("kt", kt, "j");
+      parser.AddArray("kq", kq, "j");
+      parser.Parse(json_string);
+
+      if (parser.Has("interpolation")) interpolation = ParseInterpolationType(interpolation_name);
+    }
+
+  }  // end anonymous namespace
+
   FPP1Q::FPP1Q(const PropellerParams &params) :
-      PropellerBaseModel(params, PropellerModelType::E_FPP1Q),
-      m_kt_kq_coeffs(mathutils::LINEAR){
+      PropellerBaseModel(params, PropellerModelType::E_FPP1Q) {
   }
 
 //  void FPP1Q::Initialize() {
 //    PropellerBaseModel::Initialize();
 //  }
 
-  void FPP1Q::Compute(const double &water_density,
-                      const double &u_NWU,
-                      const double &v_NWU,
-                      const double &rpm,
-                      const double &pitch_ratio) const {
+  PropellerOutput FPP1Q::Compute(const PropellerInput &input) const {
 
-    if (!m_is_initialized) {
-      std::cerr << "Propulsion model MUST be initialized before being used." << std::endl;
-      exit(EXIT_FAILURE);
-    }
+    CheckInitialized();
 
-    if (u_NWU < 0.) {
-      std::cerr << "This first quadrant model is only applicable for positive vessel forward speed" << std::endl;
-      exit(EXIT_FAILURE);
-    }
+    PropellerOutput output;
 
     // Propeller advance velocity
-    double uPA = GetPropellerAdvanceVelocity(u_NWU, v_NWU);
+    output.m_uPA = GetPropellerAdvanceVelocity(input.m_u_NWU, input.m_v_NWU, output.m_sidewash_angle_rad);
+
+    if (input.m_u_NWU < 0. || input.m_rpm < 0.) {
+      // Outside of the first quadrant : zero loads
+      output.m_status = InvalidInput();
+      return output;
+    }
 
     // propeller rotation frequency in Hz
-    double n = rpm / 60.;
+    double n = input.m_rpm / 60.;
 
     // Advance ratio
 
@@ -51,47 +65,84 @@ namespace acme {
     //    becomes only resistive and gives no thrust despite its direction of rotation that has not changed. For
     //    simulations requiring this kind of regime to be taken into account, a FPP4 model would be best required.
 
-    double kt, kq;
-    bool is_out_of_range = false;
+    double kt = 0., kq = 0.;
     if (n > 0.) {
-      c_J = uPA / (n * m_params.m_diameter_m);
-      try {
-        GetKtKq(c_J, kt, kq);
-      } catch (std::exception &e) {
-        // J > Jmax
-        std::string error(e.what());
-        throw std::runtime_error(
-            "FPP1Q : advance ratio not in the correct range, try using FPP4Q if necessary : " + error);
-      }
-    } else if (n == 0) {
-      // Bof bof...
-      kt = 0.;
-      kq = 0.;
-      is_out_of_range = true;
-    } else {
-      throw std::runtime_error("FPP1Q : negative propeller rotational velocity are not supported");
+      output.m_advance_ratio = output.m_uPA / (n * m_params.m_diameter_m);
+      TableHints hints;
+      output.m_status = GetKtKq(output.m_advance_ratio, input.m_hints ? input.m_hints->m_x : hints.m_x, kt, kq);
     }
 
     // Propeller Thrust
     double n2 = n * n;
     double D4 = std::pow(m_params.m_diameter_m, 4);
     double _kt = kt + m_params.m_thrust_coefficient_correction;
-    double propeller_thrust = water_density * n2 * D4 * _kt;
+    double propeller_thrust = input.m_water_density * n2 * D4 * _kt;
 
     // Effective propeller thrust
-    c_thrust_N = propeller_thrust * (1 - m_params.m_thrust_deduction_factor_0);
+    output.m_thrust_N = propeller_thrust * (1 - m_params.m_thrust_deduction_factor_0);
 
     // Torque
     double _kq = kq + m_params.m_torque_coefficient_correction;
-//    c_torque_Nm = water_density * n2 * std::pow(m_params.m_diameter_m, 5) * _kq * GetScrewDirectionSign();
-    c_torque_Nm = water_density * n2 * D4 * m_params.m_diameter_m * _kq;
+//    output.m_torque_Nm = water_density * n2 * std::pow(m_params.m_diameter_m, 5) * _kq * GetScrewDirectionSign();
+    output.m_torque_Nm = input.m_water_density * n2 * D4 * m_params.m_diameter_m * _kq;
 
     // Efficiency
-    c_efficiency = is_out_of_range ? 0. : c_J * _kt / (MU_2PI * _kq);
+    output.m_efficiency = (n == 0. || _kq == 0.) ? 0. : output.m_advance_ratio * _kt / (MU_2PI * _kq);
 
     // Power
-    c_power_W = MU_2PI * n * c_torque_Nm;
+    output.m_power_W = MU_2PI * n * output.m_torque_Nm;
+
+    return output;
+  }
+
+  void FPP1Q::ComputeBatch(const PropellerBatchInput &input, const PropellerBatchOutput &output) const {
+
+    CheckInitialized();
+
+    auto size = input.m_size;
 
+    // Kinematics
+    GetPropellerAdvanceVelocities(size, input.m_u_NWU, input.m_v_NWU, output.m_uPA, output.m_sidewash_angle_rad);
+
+    auto D = m_params.m_diameter_m;
+    for (std::size_t i = 0; i < size; i++) {
+      double n = input.m_rpm[i] / 60.;
+      output.m_advance_ratio[i] = (n > 0. && input.m_u_NWU[i] >= 0.) ? output.m_uPA[i] / (n * D) : 0.;
+    }
+
+    // Coefficients, kt and kq being held in the thrust and torque arrays until the loads are computed
+    auto kt = output.m_thrust_N;
+    auto kq = output.m_torque_Nm;
+    AxisHint hint;  // the propellers of a batch usually have close advance ratios
+    for (std::size_t i = 0; i < size; i++) {
+      unsigned int status = E_STATUS_OK;
+      kt[i] = 0.;
+      kq[i] = 0.;
+      if (input.m_u_NWU[i] < 0. || input.m_rpm[i] < 0.) {
+        status = InvalidInput();
+      } else if (input.m_rpm[i] > 0.) {
+        status = GetKtKq(output.m_advance_ratio[i], hint, kt[i], kq[i]);
+      }
+      if (output.m_status) output.m_status[i] = status;
+    }
+
+    // Loads
+    double D4 = std::pow(D, 4);
+    for (std::size_t i = 0; i < size; i++) {
+      // Zero loads outside of the first quadrant
+      bool is_valid = input.m_u_NWU[i] >= 0. && input.m_rpm[i] >= 0.;
+      double n = is_valid ? input.m_rpm[i] / 60. : 0.;
+      double n2 = n * n;
+      double _kt = kt[i] + m_params.m_thrust_coefficient_correction;
+      double _kq = kq[i] + m_params.m_torque_coefficient_correction;
+      double propeller_thrust = input.m_water_density[i] * n2 * D4 * _kt;
+      double torque = input.m_water_density[i] * n2 * D4 * D * _kq;
+      double efficiency = output.m_advance_ratio[i] * _kt / (MU_2PI * _kq);
+      output.m_thrust_N[i] = propeller_thrust * (1 - m_params.m_thrust_deduction_factor_0);
+      output.m_torque_Nm[i] = torque;
+      output.m_efficiency[i] = (n == 0. || _kq == 0.) ? 0. : efficiency;
+      output.m_power_W[i] = MU_2PI * n * torque;
+    }
   }
 
   void FPP1Q::ParsePropellerPerformanceCurveJsonString() {
@@ -114,12 +165,82 @@ namespace acme {
      *
      */
 
-    auto jnode = json::parse(m_params.m_thruster_perf_data_json_string);
-    m_params.m_thruster_perf_data_json_string.clear();
+    m_curves = LoadCurves(GetPerformanceDataJsonString(), m_params.m_thruster_perf_data_curve_file);
+    m_perf_data_json_string.reset();
+
+    m_params.m_table_interpolation = m_curves->m_interpolation;
+    m_params.m_chebyshev_degree = m_curves->m_chebyshev_degree;
+    m_table_simplification_report = m_curves->m_table_simplification_report;
+  }
+
+  void FPP1Q::ReloadPerformanceCurves(const std::string &json_string, const std::string &curve_file) {
+    m_retired_curves.Add(m_curves.Publish(LoadCurves(json_string, curve_file)));
+  }
+
+  std::shared_ptr<const FPP1QCurves> FPP1Q::LoadCurves(const std::string &json_string,
+                                                       const std::string &curve_file) const {
+    // Propellers built from the same data share the same curves
+    auto key = CurveRegistryKey("FPP1Q", {double(m_params.m_table_interpolation),
+                                          m_params.m_table_simplification_tolerance,
+                                          double(m_params.m_table_single_precision),
+                                          double(m_params.m_chebyshev_degree)},
+                                json_string, curve_file);
+    return CurveRegistry::GetInstance().Get<FPP1QCurves>(key, [&]() {
+      auto file = curve_file.empty() ? nullptr : CurveFile::Open(curve_file);
+      return BuildCurves(json_string, file.get());
+    });
+  }
+
+  FPP1QCurves FPP1Q::BuildCurves(const std::string &json_string, const CurveFile *file) const {
+
+    if (file) {
+      return BuildCurves(*file);
+    }
+
+    FPP1QCurves curves;
+    curves.m_interpolation = m_params.m_table_interpolation;
+    curves.m_chebyshev_degree = m_params.m_chebyshev_degree;
 
-    auto j = jnode["j"].get<std::vector<double>>();
-    auto kt = jnode["kt"].get<std::vector<double>>();
-    auto kq = jnode["kq"].get<std::vector<double>>();
+    std::vector<double> j, kt, kq;
+    PerformanceDataParser parser("FPP1Q parser");
+    ParseFPP1QPerformanceData(parser, json_string, j, kt, kq, curves.m_interpolation, curves.m_chebyshev_degree);
+
+    FillCurves(curves, std::move(j), std::move(kt), std::move(kq));
+    return curves;
+  }
+
+  FPP1QCurves FPP1Q::BuildCurves(const CurveFile &file) const {
+
+    file.CheckModel("FPP1Q");
+
+    FPP1QCurves curves;
+    curves.m_interpolation = InterpolationType(file.GetOption("interpolation", m_params.m_table_interpolation));
+    curves.m_chebyshev_degree = static_cast<unsigned int>(file.GetOption("chebyshev_degree",
+                                                                         m_params.m_chebyshev_degree));
+
+    if (curves.m_chebyshev_degree == 0 && m_params.m_table_simplification_tolerance <= 0.) {
+      // Table used in place in the mapped file
+      curves.m_kt_kq_coeffs.SetInterpolation(curves.m_interpolation);
+      curves.m_kt_kq_coeffs.SetSinglePrecision(m_params.m_table_single_precision);
+      file.SetTable(curves.m_kt_kq_coeffs);
+      curves.m_kt_column = curves.m_kt_kq_coeffs.GetColumnHandle("kt");
+      curves.m_kq_column = curves.m_kt_kq_coeffs.GetColumnHandle("kq");
+      return curves;
+    }
+
+    FillCurves(curves, file.GetAxis(0), file.GetColumn("kt"), file.GetColumn("kq"));
+    return curves;
+  }
+
+  void FPP1Q::FillCurves(FPP1QCurves &curves, std::vector<double> j, std::vector<double> kt,
+                         std::vector<double> kq) const {
+
+    if (curves.m_chebyshev_degree > 0) {
+      curves.m_kt_column = curves.m_kt_kq_chebyshev_series.Fit("kt", j, kt, curves.m_chebyshev_degree);
+      curves.m_kq_column = curves.m_kt_kq_chebyshev_series.Fit("kq", j, kq, curves.m_chebyshev_degree);
+      curves.m_use_chebyshev_series = true;
+      return;
+    }
 
 //    // Only one
 //    if (screw_direction == "LEFT_HANDED") {
@@ -133,26 +254,103 @@ namespace acme {
 //      exit(EXIT_FAILURE);
 //    }
 
-    m_kt_kq_coeffs.SetX(j);
-    m_kt_kq_coeffs.AddY("kt", kt);
-    m_kt_kq_coeffs.AddY("kq", kq);
+    if (m_params.m_table_simplification_tolerance > 0.) {
+      curves.m_table_simplification_report = SimplifyTable1D(j, {&kt, &kq}, m_params.m_table_simplification_tolerance,
+                                                             curves.m_interpolation);
+    }
+
+    curves.m_kt_kq_coeffs.SetX(j);
+    curves.m_kt_kq_coeffs.SetInterpolation(curves.m_interpolation);
+    curves.m_kt_kq_coeffs.SetSinglePrecision(m_params.m_table_single_precision);
+    curves.m_kt_column = curves.m_kt_kq_coeffs.AddY("kt", kt);
+    curves.m_kq_column = curves.m_kt_kq_coeffs.AddY("kq", kq);
+  }
+
+  unsigned int FPP1Q::GetKtKq(const double &J, AxisHint &hint, double &kt, double &kq) const {
+    const auto &curves = *m_curves;
+    auto policy = m_params.m_out_of_range_policy;
+
+    if (curves.m_use_chebyshev_series) {
+      const auto &series = curves.m_kt_kq_chebyshev_series;
+      if (J >= series.GetMin() && J <= series.GetMax()) {
+        kt = series.Eval(J, curves.m_kt_column);
+        kq = series.Eval(J, curves.m_kq_column);
+        return E_STATUS_OK;
+      }
+
+      // Same behaviour as the table : values at the nearest bound, extrapolated with the slope at the bound
+      double bound = (J > series.GetMax()) ? series.GetMax() : series.GetMin();
+      kt = series.Eval(bound, curves.m_kt_column);
+      kq = series.Eval(bound, curves.m_kq_column);
+      if (policy == E_OUT_OF_RANGE_EXTRAPOLATE && !std::isnan(J)) {
+        double h = (J > bound ? 1e-6 : -1e-6) * (series.GetMax() - series.GetMin());
+        double ratio = (J - bound) / h;
+        kt += (kt - series.Eval(bound - h, curves.m_kt_column)) * ratio;
+        kq += (kq - series.Eval(bound - h, curves.m_kq_column)) * ratio;
+      }
+
+    } else {
+      // Single search on the J axis for both coefficients
+      bool is_out_of_range;
+      auto interval = curves.m_kt_kq_coeffs.Locate(J, hint, policy == E_OUT_OF_RANGE_EXTRAPOLATE, is_out_of_range);
+      kt = curves.m_kt_kq_coeffs.Eval(interval, curves.m_kt_column);
+      kq = curves.m_kt_kq_coeffs.Eval(interval, curves.m_kq_column);
+      if (!is_out_of_range) return E_STATUS_OK;
+    }
+
+    return HandleOutOfRange(policy, c_status_counters, "FPP1Q : advance ratio J", J, {&kt, &kq});
   }
 
-  void FPP1Q::GetKtKq(const double &J, double &kt, double &kq) const {
-    kt = m_kt_kq_coeffs.Eval("kt", J);
-    kq = m_kt_kq_coeffs.Eval("kq", J);
+  unsigned int FPP1Q::InvalidInput() const {
+    if (m_params.m_out_of_range_policy == E_OUT_OF_RANGE_THROW) {
+      throw std::runtime_error("FPP1Q : only applicable for positive vessel forward speed and propeller rotational "
+                               "velocity, try using FPP4Q if necessary");
+    }
+    c_status_counters.Count(E_STATUS_INVALID_INPUT);
+    return E_STATUS_INVALID_INPUT;
   }
 
   double FPP1Q::J() const {
-    return c_J;
+    return c_output.m_advance_ratio;
   }
 
   double FPP1Q::kt(const double J) const {
-    return m_kt_kq_coeffs.Eval("kt", J);;
+    double kt, kq;
+    AxisHint hint;
+    GetKtKq(J, hint, kt, kq);
+    return kt;
   }
 
   double FPP1Q::kq(const double J) const {
-    return m_kt_kq_coeffs.Eval("kq", J);;
+    double kt, kq;
+    AxisHint hint;
+    GetKtKq(J, hint, kt, kq);
+    return kq;
+  }
+
+  double FPP1Q::GetChebyshevMaxResidual() const {
+    const auto *curves = m_curves.Load();
+    if (!curves || !curves->m_use_chebyshev_series) return 0.;
+    return std::max(curves->m_kt_kq_chebyshev_series.GetMaxResidual(curves->m_kt_column),
+                    curves->m_kt_kq_chebyshev_series.GetMaxResidual(curves->m_kq_column));
+  }
+
+  CurveData FPP1QCurveData(const std::string &json_string) {
+
+    std::vector<double> j, kt, kq;
+    InterpolationType interpolation = E_LINEAR;
+    unsigned int chebyshev_degree = 0;
+    PerformanceDataParser parser("FPP1Q parser");
+    ParseFPP1QPerformanceData(parser, json_string, j, kt, kq, interpolation, chebyshev_degree);
+
+    CurveData data;
+    data.m_model = "FPP1Q";
+    data.m_axes = {{"j", j}};
+    data.m_columns = {{"kt", kt}, {"kq", kq}};
+
+    if (parser.Has("interpolation")) data.m_options["interpolation"] = interpolation;
+    if (parser.Has("chebyshev_degree")) data.m_options["chebyshev_degree"] = chebyshev_degree;
+    return data;
   }
 
 }  // end namespace acme
@@ -5,45 +5,99 @@
 #ifndef ACME_FPP1Q_H
 #define ACME_FPP1Q_H
 
+#include <memory>
 #include <string>
 
-#include "MathUtils/LookupTable1D.h"
+#include "acme/table/PerformanceTable1D.h"
+#include "acme/table/ChebyshevSeries.h"
+#include "acme/table/CurveRegistry.h"
+#include "acme/table/CurvePointer.h"
+#include "acme/table/CurveFile.h"
 
 #include "PropellerBaseModel.h"
 
 namespace acme {
 
+  /// Open water curves of a FPP1Q, shared by the propellers built from the same data (see CurveRegistry)
+  struct FPP1QCurves {
+    PerformanceTable1D m_kt_kq_coeffs;
+    ColumnHandle m_kt_column = 0;
+    ColumnHandle m_kq_column = 0;
+
+    bool m_use_chebyshev_series = false;
+    ChebyshevSeries m_kt_kq_chebyshev_series;
+
+    // Options as resolved from the parameters and the json
+    InterpolationType m_interpolation = E_LINEAR;
+    unsigned int m_chebyshev_degree = 0;
+
+    TableSimplificationReport m_table_simplification_report;
+
+    std::size_t GetMemoryUsage() const {
+      return m_kt_kq_coeffs.GetMemoryUsage() + m_kt_kq_chebyshev_series.GetMemoryUsage();
+    }
+  };
+
+
   /// First quadrant model for Fixed Pitch Propeller
+  ///
+  /// kt(J) and kq(J) are interpolated in the open water table, or evaluated from Chebyshev expansions fitted on the
+  /// table at initialization (see PropellerParams::m_chebyshev_degree).
   class FPP1Q : public PropellerBaseModel {
 
    public:
     FPP1Q(const PropellerParams &params);
 
-    void Compute(const double &water_density,
-                 const double &u_NWU,
-                 const double &v_NWU,
-                 const double &rpm,
-                 const double &pitch_ratio) const override; // pitch ratio not used in this model, may be any value
+    using PropellerBaseModel::Compute;
+
+    PropellerOutput Compute(const PropellerInput &input) const override; // pitch ratio not used in this model
+
+    void ComputeBatch(const PropellerBatchInput &input, const PropellerBatchOutput &output) const override;
 
+    /// Advance ratio of the last call to Compute with the getters API
     double J() const;
 
     double kt(const double J) const;
 
     double kq(const double J) const;
 
+    /// Max absolute deviation of the Chebyshev expansions of kt and kq from the open water data, zero when the table
+    /// is used
+    double GetChebyshevMaxResidual() const;
+
    private:
 
-    void GetKtKq(const double &J, double &kt, double &kq) const;
+    /// kt and kq at J, J outside of the open water data being handled by the out of range policy
+    /// \param hint interval hint of the caller on the J axis
+    /// \return the status of the lookup, see ComputeStatus
+    unsigned int GetKtKq(const double &J, AxisHint &hint, double &kt, double &kq) const;
+
+    /// Status of an operating point outside of the first quadrant (negative speed or rotational velocity)
+    /// \throws std::runtime_error for E_OUT_OF_RANGE_THROW
+    unsigned int InvalidInput() const;
 
     void ParsePropellerPerformanceCurveJsonString() override;
 
-   private:
-    mathutils::LookupTable1D<double, double> m_kt_kq_coeffs;
+    void ReloadPerformanceCurves(const std::string &json_string, const std::string &curve_file) override;
+
+    /// Curves of the performance data, shared with the propellers built from the same data and options
+    std::shared_ptr<const FPP1QCurves> LoadCurves(const std::string &json_string, const std::string &curve_file) const;
+
+    FPP1QCurves BuildCurves(const std::string &json_string, const CurveFile *file) const;
 
-    mutable double c_J;
+    FPP1QCurves BuildCurves(const CurveFile &file) const;
+
+    /// Build the Chebyshev expansions or the table from the open water data, the options being set in curves
+    void FillCurves(FPP1QCurves &curves, std::vector<double> j, std::vector<double> kt, std::vector<double> kq) const;
+
+   private:
+    CurvePointer<FPP1QCurves> m_curves;
 
   };
 
+  /// Open water data of a json string, as written in a curve file (see CurveFile)
+  CurveData FPP1QCurveData(const std::string &json_string);
+
 }  // end namespace acme
 
 #endif //ACME_FPP1Q_H
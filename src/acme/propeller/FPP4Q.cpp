@@ -3,33 +3,70 @@
 //
 
 #include "FPP4Q.h"
-#include <nlohmann/json.hpp>
 
-using json = nlohmann::json;
+#include <algorithm>
+#include <stdexcept>
+
+#include "acme/table/PerformanceDataParser.h"
 
 namespace acme {
 
+  namespace {
+
+    /// Four quadrant data, either tabulated or as Fourier series
+    struct FPP4QPerformanceData {
+      std::vector<double> m_beta_rad, m_ct, m_cq;
+      std::vector<double> m_ct_a, m_ct_b, m_cq_a, m_cq_b;  // Fourier series coefficients
+      bool m_fourier = false;
+    };
+
+    /// Streaming parse of the four quadrant data, the interpolation being overridden by the json entry if any
+    FPP4QPerformanceData ParseFPP4QPerformanceData(PerformanceDataParser &parser, const std::string &json_string,
+                                                   InterpolationType &interpolation) {
+      FPP4QPerformanceData data;
+      std::string interpolation_name;
+      parser.AddOption("interpolation", interpolation_name);
+      parser.AddArray("fourier/ct/a", data.m_ct_a, "", false);
+      parser.AddArray("fourier/ct/b", data.m_ct_b, "", false);
+      parser.AddArray("fourier/cq/a", data.m_cq_a, "", false);
+      parser.AddArray("fourier/cq/b", data.m_cq_b, "", false);
+      parser.AddAxis("beta_deg", data.m_beta_rad, DEG2RAD, false);
+      parser.AddArray("ct", data.m_ct, "beta_deg", false);
+      parser.AddArray("cq", data.m_cq, "beta_deg", false);
+      parser.Parse(json_string);
+
+      // Either the Fourier series or the table are required
+      data.m_fourier = parser.Has("fourier/ct/a") || parser.Has("fourier/ct/b") || parser.Has("fourier/cq/a") ||
+                       parser.Has("fourier/cq/b");
+      auto required = data.m_fourier ? std::vector<std::string>{"fourier/ct/a", "fourier/ct/b", "fourier/cq/a",
+                                                                "fourier/cq/b"} :
+                      std::vector<std::string>{"beta_deg", "ct", "cq"};
+      for (const auto &key : required) {
+        if (!parser.Has(key)) throw std::runtime_error("FPP4Q parser : no " + key);
+      }
+
+      if (parser.Has("interpolation")) interpolation = ParseInterpolationType(interpolation_name);
+      return data;
+    }
+
+  }  // end anonymous namespace
+
   FPP4Q::FPP4Q(const PropellerParams &params) :
-      PropellerBaseModel(params, PropellerModelType::E_FPP4Q),
-      m_ct_ct_coeffs(mathutils::LINEAR){
+      PropellerBaseModel(params, PropellerModelType::E_FPP4Q) {
   }
 
-  void FPP4Q::Compute(const double &water_density,
-                      const double &u_NWU,
-                      const double &v_NWU,
-                      const double &rpm,
-                      const double &pitch_ratio) const {
+  PropellerOutput FPP4Q::Compute(const PropellerInput &input) const {
 
-    if (!m_is_initialized) {
-      std::cerr << "Propulsion model MUST be initialized before being used." << std::endl;
-      exit(EXIT_FAILURE);
-    }
+    CheckInitialized();
+
+    PropellerOutput output;
 
     // Propeller advance velocity
-    double uPA = GetPropellerAdvanceVelocity(u_NWU, v_NWU);
+    double uPA = GetPropellerAdvanceVelocity(input.m_u_NWU, input.m_v_NWU, output.m_sidewash_angle_rad);
+    output.m_uPA = uPA;
 
     // propeller rotation frequency in rps
-    double n = rpm / 60.;
+    double n = input.m_rpm / 60.;
 
     // tangential blade velocity at 0.7R
     double vp = 0.7 * MU_PI * n * m_params.m_diameter_m;
@@ -45,39 +82,128 @@ namespace acme {
 
     // Get Coefficients
     double ct, cq;
-    GetCtCq(gamma, pitch_ratio, ct, cq);
+    TableHints hints;
+    output.m_status = GetCtCq(gamma, input.m_pitch_ratio, input.m_hints ? *input.m_hints : hints, ct, cq);
 
     // Propeller Thrust
     double _ct = ct + m_params.m_thrust_coefficient_correction;
-    double propeller_thrust = 0.5 * water_density * vB2 * Ad * _ct;
+    double propeller_thrust = 0.5 * input.m_water_density * vB2 * Ad * _ct;
 
     // Effective propeller thrust
-    c_thrust_N = propeller_thrust * (1 - m_params.m_thrust_deduction_factor_0);
+    output.m_thrust_N = propeller_thrust * (1 - m_params.m_thrust_deduction_factor_0);
 
     // Torque
     double _cq = cq + m_params.m_torque_coefficient_correction;
-    c_torque_Nm = 0.5 * water_density * vB2 * Ad * m_params.m_diameter_m * _cq;
+    output.m_torque_Nm = 0.5 * input.m_water_density * vB2 * Ad * m_params.m_diameter_m * _cq;
 
     // Efficiency
     if (n != 0.) {
-      double J = uPA / (n * m_params.m_diameter_m);
-      c_efficiency = J * _ct / (MU_2PI * _cq);
+      output.m_advance_ratio = uPA / (n * m_params.m_diameter_m);
+      output.m_efficiency = (_cq != 0.) ? output.m_advance_ratio * _ct / (MU_2PI * _cq) : 0.;
     } else {
-      c_efficiency = 0.; // TODO: voir si on met 0 ou 1...
+      output.m_efficiency = 0.; // TODO: voir si on met 0 ou 1...
     }
 
     // Power
-    c_power_W = MU_2PI * n * c_torque_Nm;
+    output.m_power_W = MU_2PI * n * output.m_torque_Nm;
 
+    return output;
   }
 
-  void FPP4Q::GetCtCq(const double &gamma,
-                      const double &pitch_ratio,
-                      double &ct,
-                      double &cq) const {
+  void FPP4Q::ComputeBatch(const PropellerBatchInput &input, const PropellerBatchOutput &output) const {
+
+    CheckInitialized();
+
+    auto size = input.m_size;
+
+    // Kinematics
+    GetPropellerAdvanceVelocities(size, input.m_u_NWU, input.m_v_NWU, output.m_uPA, output.m_sidewash_angle_rad);
+
+    // Effective blade advance angles, held in the advance ratio array until the loads are computed
+    auto D = m_params.m_diameter_m;
+    auto gamma = output.m_advance_ratio;
+    for (std::size_t i = 0; i < size; i++) {
+      double vp = 0.7 * MU_PI * (input.m_rpm[i] / 60.) * D;
+      gamma[i] = std::atan2(output.m_uPA[i], vp);
+    }
 
-    ct = m_ct_ct_coeffs.Eval("ct", gamma);
-    cq = m_ct_ct_coeffs.Eval("cq", gamma);
+    // Coefficients, held in the thrust and torque arrays until the loads are computed
+    auto ct = output.m_thrust_N;
+    auto cq = output.m_torque_Nm;
+    GetCtCqBatch(size, gamma, input.m_pitch_ratio, ct, cq, output.m_status);
+
+    // Loads
+    double Ad = MU_PI * D * D / 4.;
+    for (std::size_t i = 0; i < size; i++) {
+      double uPA = output.m_uPA[i];
+      double n = input.m_rpm[i] / 60.;
+      double vp = 0.7 * MU_PI * n * D;
+      double vB2 = uPA * uPA + vp * vp;
+      double _ct = ct[i] + m_params.m_thrust_coefficient_correction;
+      double _cq = cq[i] + m_params.m_torque_coefficient_correction;
+      double propeller_thrust = 0.5 * input.m_water_density[i] * vB2 * Ad * _ct;
+      double torque = 0.5 * input.m_water_density[i] * vB2 * Ad * D * _cq;
+      double advance_ratio = uPA / (n * D);
+      double efficiency = advance_ratio * _ct / (MU_2PI * _cq);
+      output.m_thrust_N[i] = propeller_thrust * (1 - m_params.m_thrust_deduction_factor_0);
+      output.m_torque_Nm[i] = torque;
+      output.m_advance_ratio[i] = (n != 0.) ? advance_ratio : 0.;
+      output.m_efficiency[i] = (n != 0. && _cq != 0.) ? efficiency : 0.;
+      output.m_power_W[i] = MU_2PI * n * torque;
+    }
+  }
+
+  unsigned int FPP4Q::GetCtCq(const double &gamma,
+                              const double &pitch_ratio,
+                              TableHints &hints,
+                              double &ct,
+                              double &cq) const {
+
+    const auto &curves = *m_curves;
+    if (curves.m_use_fourier_series) {
+      // Periodic in beta, never out of range
+      double coeffs[2];
+      curves.m_ct_cq_fourier_series.Eval(gamma, coeffs);
+      ct = coeffs[curves.m_ct_column];
+      cq = coeffs[curves.m_cq_column];
+      return E_STATUS_OK;
+    }
+
+    // Single search on the beta axis for both coefficients
+    auto policy = m_params.m_out_of_range_policy;
+    bool is_out_of_range;
+    auto interval = curves.m_ct_cq_coeffs.Locate(gamma, hints.m_x, policy == E_OUT_OF_RANGE_EXTRAPOLATE,
+                                                 is_out_of_range);
+    ct = curves.m_ct_cq_coeffs.Eval(interval, curves.m_ct_column);
+    cq = curves.m_ct_cq_coeffs.Eval(interval, curves.m_cq_column);
+    if (!is_out_of_range) return E_STATUS_OK;
+    return HandleOutOfRange(policy, c_status_counters, "FPP4Q : blade advance angle (rad)", gamma, {&ct, &cq});
+  }
+
+  void FPP4Q::GetCtCqBatch(std::size_t size,
+                           const double *gamma,
+                           const double * /*pitch_ratio*/,
+                           double *ct,
+                           double *cq,
+                           unsigned int *status) const {
+
+    const auto &curves = *m_curves;
+    if (curves.m_use_fourier_series) {
+      double coeffs[2];
+      for (std::size_t i = 0; i < size; i++) {
+        curves.m_ct_cq_fourier_series.Eval(gamma[i], coeffs);
+        ct[i] = coeffs[curves.m_ct_column];
+        cq[i] = coeffs[curves.m_cq_column];
+      }
+      if (status) std::fill(status, status + size, E_STATUS_OK);
+      return;
+    }
+
+    TableHints hints;
+    for (std::size_t i = 0; i < size; i++) {
+      auto status_i = FPP4Q::GetCtCq(gamma[i], 0., hints, ct[i], cq[i]);
+      if (status) status[i] = status_i;
+    }
   }
 
   void FPP4Q::ParsePropellerPerformanceCurveJsonString() {
@@ -100,14 +226,76 @@ namespace acme {
      *
      */
 
-    auto jnode = json::parse(m_params.m_thruster_perf_data_json_string);
-    m_params.m_thruster_perf_data_json_string.clear();
+    m_curves = LoadCurves(GetPerformanceDataJsonString(), m_params.m_thruster_perf_data_curve_file);
+    m_perf_data_json_string.reset();
 
-    auto beta = jnode["beta_deg"].get<std::vector<double>>();
-    auto ct = jnode["ct"].get<std::vector<double>>();
-    auto cq = jnode["cq"].get<std::vector<double>>();
+    m_params.m_table_interpolation = m_curves->m_interpolation;
+    m_table_simplification_report = m_curves->m_table_simplification_report;
+  }
 
-    for (auto& b : beta) b *= DEG2RAD;
+  void FPP4Q::ReloadPerformanceCurves(const std::string &json_string, const std::string &curve_file) {
+    m_retired_curves.Add(m_curves.Publish(LoadCurves(json_string, curve_file)));
+  }
+
+  std::shared_ptr<const FPP4QCurves> FPP4Q::LoadCurves(const std::string &json_string,
+                                                       const std::string &curve_file) const {
+    // Propellers built from the same data share the same curves
+    auto key = CurveRegistryKey("FPP4Q", {double(m_params.m_table_interpolation),
+                                          m_params.m_table_simplification_tolerance,
+                                          double(m_params.m_table_single_precision)},
+                                json_string, curve_file);
+    return CurveRegistry::GetInstance().Get<FPP4QCurves>(key, [&]() {
+      auto file = curve_file.empty() ? nullptr : CurveFile::Open(curve_file);
+      return BuildCurves(json_string, file.get());
+    });
+  }
+
+  FPP4QCurves FPP4Q::BuildCurves(const std::string &json_string, const CurveFile *file) const {
+
+    if (file) {
+      return BuildCurves(*file);
+    }
+
+    FPP4QCurves curves;
+    curves.m_interpolation = m_params.m_table_interpolation;
+
+    PerformanceDataParser parser("FPP4Q parser");
+    auto data = ParseFPP4QPerformanceData(parser, json_string, curves.m_interpolation);
+
+    if (data.m_fourier) {
+      curves.m_ct_column = curves.m_ct_cq_fourier_series.AddSeries("ct", data.m_ct_a, data.m_ct_b);
+      curves.m_cq_column = curves.m_ct_cq_fourier_series.AddSeries("cq", data.m_cq_a, data.m_cq_b);
+      curves.m_use_fourier_series = true;
+      return curves;
+    }
+
+    FillCurves(curves, std::move(data.m_beta_rad), std::move(data.m_ct), std::move(data.m_cq));
+    return curves;
+  }
+
+  FPP4QCurves FPP4Q::BuildCurves(const CurveFile &file) const {
+
+    file.CheckModel("FPP4Q");
+
+    FPP4QCurves curves;
+    curves.m_interpolation = InterpolationType(file.GetOption("interpolation", m_params.m_table_interpolation));
+
+    if (m_params.m_table_simplification_tolerance <= 0.) {
+      // Table used in place in the mapped file
+      curves.m_ct_cq_coeffs.SetInterpolation(curves.m_interpolation);
+      curves.m_ct_cq_coeffs.SetSinglePrecision(m_params.m_table_single_precision);
+      file.SetTable(curves.m_ct_cq_coeffs);
+      curves.m_ct_column = curves.m_ct_cq_coeffs.GetColumnHandle("ct");
+      curves.m_cq_column = curves.m_ct_cq_coeffs.GetColumnHandle("cq");
+      return curves;
+    }
+
+    FillCurves(curves, file.GetAxis(0), file.GetColumn("ct"), file.GetColumn("cq"));
+    return curves;
+  }
+
+  void FPP4Q::FillCurves(FPP4QCurves &curves, std::vector<double> beta, std::vector<double> ct,
+                         std::vector<double> cq) const {
 
 //    // Only one
 //    if (screw_direction == "LEFT_HANDED") {
@@ -121,9 +309,35 @@ namespace acme {
 //      exit(EXIT_FAILURE);
 //    }
 
-    m_ct_ct_coeffs.SetX(beta);
-    m_ct_ct_coeffs.AddY("ct", ct);
-    m_ct_ct_coeffs.AddY("cq", cq);
+    if (m_params.m_table_simplification_tolerance > 0.) {
+      curves.m_table_simplification_report = SimplifyTable1D(beta, {&ct, &cq},
+                                                             m_params.m_table_simplification_tolerance,
+                                                             curves.m_interpolation);
+    }
+
+    curves.m_ct_cq_coeffs.SetX(beta);
+    curves.m_ct_cq_coeffs.SetInterpolation(curves.m_interpolation);
+    curves.m_ct_cq_coeffs.SetSinglePrecision(m_params.m_table_single_precision);
+    curves.m_ct_column = curves.m_ct_cq_coeffs.AddY("ct", ct);
+    curves.m_cq_column = curves.m_ct_cq_coeffs.AddY("cq", cq);
+  }
+
+  CurveData FPP4QCurveData(const std::string &json_string) {
+
+    InterpolationType interpolation = E_LINEAR;
+    PerformanceDataParser parser("FPP4Q parser");
+    auto fpp4q_data = ParseFPP4QPerformanceData(parser, json_string, interpolation);
+    if (fpp4q_data.m_fourier) {
+      throw std::runtime_error("FPP4Q : Fourier series performance data are not tabulated, no curve file for them");
+    }
+
+    CurveData data;
+    data.m_model = "FPP4Q";
+    data.m_axes = {{"beta_rad", std::move(fpp4q_data.m_beta_rad)}};
+    data.m_columns = {{"ct", std::move(fpp4q_data.m_ct)}, {"cq", std::move(fpp4q_data.m_cq)}};
+
+    if (parser.Has("interpolation")) data.m_options["interpolation"] = interpolation;
+    return data;
   }
 
 }  // end namespace acme
\ No newline at end of file
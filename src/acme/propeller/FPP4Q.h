@@ -5,39 +5,98 @@
 #ifndef ACME_FPP4Q_H
 #define ACME_FPP4Q_H
 
+#include <memory>
 #include <string>
-#include "MathUtils/LookupTable1D.h"
+#include "acme/table/PerformanceTable1D.h"
+#include "acme/table/FourierSeries.h"
+#include "acme/table/CurveRegistry.h"
+#include "acme/table/CurvePointer.h"
+#include "acme/table/CurveFile.h"
 
 #include "PropellerBaseModel.h"
 
 namespace acme {
 
+  /// Four quadrant curves of a FPP4Q, shared by the propellers built from the same data (see CurveRegistry)
+  struct FPP4QCurves {
+    bool m_use_fourier_series = false;
+    PerformanceTable1D m_ct_cq_coeffs;
+    FourierSeries m_ct_cq_fourier_series;
+    ColumnHandle m_ct_column = 0; // column handles in the table or in the Fourier series
+    ColumnHandle m_cq_column = 0;
+
+    InterpolationType m_interpolation = E_LINEAR; // as resolved from the parameters and the json
+
+    TableSimplificationReport m_table_simplification_report;
+
+    std::size_t GetMemoryUsage() const {
+      return m_ct_cq_coeffs.GetMemoryUsage() + m_ct_cq_fourier_series.GetMemoryUsage();
+    }
+  };
+
+
   /// Four Quadrant model for Fixed Pitch Propeller
+  ///
+  /// The ct and cq curves are given either as tables over beta :
+  ///   {"beta_deg": [...], "ct": [...], "cq": [...]}
+  /// or as Fourier series of beta, as published for the Wageningen B-series :
+  ///   {"fourier": {"ct": {"a": [...], "b": [...]}, "cq": {"a": [...], "b": [...]}}}
+  /// where a and b are the cosine and sine coefficients of the harmonics 0..N.
   class FPP4Q : public PropellerBaseModel {
 
    public:
     FPP4Q(const PropellerParams &params);
 
-    void Compute(const double &water_density,
-                 const double &u_NWU,
-                 const double &v_NWU,
-                 const double &rpm,
-                 const double &pitch_ratio) const override; // pitch ratio not used in this model, may be any value
+    using PropellerBaseModel::Compute;
+
+    PropellerOutput Compute(const PropellerInput &input) const override; // pitch ratio only used by CPP
+
+    void ComputeBatch(const PropellerBatchInput &input, const PropellerBatchOutput &output) const override;
 
    private:
 
-    virtual void GetCtCq(const double &gamma,
-                         const double &pitch_ratio,
-                         double &ct,
-                         double &cq) const;
+    /// ct and cq at the blade advance angle and pitch ratio, inputs outside of the performance data being handled by
+    /// the out of range policy
+    /// \param hints interval hints of the caller
+    /// \return the status of the lookup, see ComputeStatus
+    virtual unsigned int GetCtCq(const double &gamma,
+                                 const double &pitch_ratio,
+                                 TableHints &hints,
+                                 double &ct,
+                                 double &cq) const;
+
+    /// Batch version of GetCtCq, pitch_ratio may be null when not used, as well as status when not wanted
+    virtual void GetCtCqBatch(std::size_t size,
+                              const double *gamma,
+                              const double *pitch_ratio,
+                              double *ct,
+                              double *cq,
+                              unsigned int *status) const;
 
     void ParsePropellerPerformanceCurveJsonString() override;
 
+    void ReloadPerformanceCurves(const std::string &json_string, const std::string &curve_file) override;
+
+    /// Curves of the performance data, shared with the propellers built from the same data and options
+    std::shared_ptr<const FPP4QCurves> LoadCurves(const std::string &json_string, const std::string &curve_file) const;
+
+    FPP4QCurves BuildCurves(const std::string &json_string, const CurveFile *file) const;
+
+    FPP4QCurves BuildCurves(const CurveFile &file) const;
+
+    /// Build the table from the four quadrant data, the interpolation being set in curves
+    void FillCurves(FPP4QCurves &curves, std::vector<double> beta, std::vector<double> ct,
+                    std::vector<double> cq) const;
+
    private:
-    mathutils::LookupTable1D<double, double> m_ct_ct_coeffs;
+    CurvePointer<FPP4QCurves> m_curves;
 
   };
 
+  /// Four quadrant table of a json string, advance angles in radians, as written in a curve file (see CurveFile)
+  /// \throws std::runtime_error for Fourier series data, which are not tabulated
+  CurveData FPP4QCurveData(const std::string &json_string);
+
 }  // end namespace acme
 
 #endif //ACME_FPP4Q_H
@@ -4,6 +4,8 @@
 
 #include "PropellerBaseModel.h"
 
+#include <stdexcept>
+
 #include "MathUtils/Angles.h"
 
 namespace acme {
@@ -13,11 +15,8 @@ namespace acme {
       m_is_initialized(false),
       m_type(type),
       m_ku(1.),
-      c_sidewash_angle_rad(0.),
-      c_thrust_N(0.),
-      c_torque_Nm(0.),
-      c_efficiency(0.),
-      c_power_W(0.) {
+      m_perf_data_json_string(std::make_shared<const std::string>(std::move(m_params.m_thruster_perf_data_json_string))) {
+    m_params.m_thruster_perf_data_json_string.clear();
   }
 
   void PropellerBaseModel::Initialize() {
@@ -28,20 +27,60 @@ namespace acme {
     m_is_initialized = true;
   }
 
+  void PropellerBaseModel::Compute(const double &water_density,
+                                   const double &u_NWU,
+                                   const double &v_NWU,
+                                   const double &rpm,
+                                   const double &pitch_ratio) const {
+    c_output = Compute(PropellerInput{water_density, u_NWU, v_NWU, rpm, pitch_ratio, &c_hints});
+  }
+
+  void PropellerBaseModel::ComputeBatch(const PropellerBatchInput &input, const PropellerBatchOutput &output) const {
+    // Generic version, for the models without a specialized batch evaluation
+    for (std::size_t i = 0; i < input.m_size; i++) {
+      auto result = Compute(PropellerInput{input.m_water_density[i], input.m_u_NWU[i], input.m_v_NWU[i],
+                                           input.m_rpm[i], input.m_pitch_ratio ? input.m_pitch_ratio[i] : 0.});
+      output.m_uPA[i] = result.m_uPA;
+      output.m_sidewash_angle_rad[i] = result.m_sidewash_angle_rad;
+      output.m_advance_ratio[i] = result.m_advance_ratio;
+      output.m_thrust_N[i] = result.m_thrust_N;
+      output.m_torque_Nm[i] = result.m_torque_Nm;
+      output.m_power_W[i] = result.m_power_W;
+      output.m_efficiency[i] = result.m_efficiency;
+      if (output.m_status) output.m_status[i] = result.m_status;
+    }
+  }
+
+  void PropellerBaseModel::ReloadPerformanceData(const std::string &json_string, const std::string &curve_file) {
+    CheckInitialized();
+    ReloadPerformanceCurves(json_string, curve_file);
+  }
+
+  const std::string &PropellerBaseModel::GetPerformanceDataJsonString() const {
+    static const std::string no_data;
+    return m_perf_data_json_string ? *m_perf_data_json_string : no_data;
+  }
+
+  void PropellerBaseModel::CheckInitialized() const {
+    if (!m_is_initialized) {
+      throw std::runtime_error("Propulsion model MUST be initialized before being used.");
+    }
+  }
+
   void PropellerBaseModel::DefineLogMessages(hermes::Message *msg) {
 
     msg->AddField<double>("uPA", "m/s", "apparent longitudinal velocity, at propeller",
-                          [this](){return c_uPA;});
+                          [this](){return c_output.m_uPA;});
     msg->AddField<double>("thrust", "N", "thrust of the propeller",
-                          [this](){return c_thrust_N;});
+                          [this](){return c_output.m_thrust_N;});
     msg->AddField<double>("torque", "Nm", "torque of the propeller",
-                          [this](){return c_torque_Nm;});
+                          [this](){return c_output.m_torque_Nm;});
     msg->AddField<double>("power", "W", "power of the propeller",
-                          [this](){return c_power_W;});
+                          [this](){return c_output.m_power_W;});
     msg->AddField<double>("efficiency", "", "efficiency of the propeller",
-                          [this](){return c_efficiency;});
+                          [this](){return c_output.m_efficiency;});
     msg->AddField<double>("sidewash_angle", "deg", "sidewash angle at the propeller, in degrees",
-                          [this](){return c_sidewash_angle_rad * RAD2DEG;});
+                          [this](){return c_output.m_sidewash_angle_rad * RAD2DEG;});
 
   }
 
@@ -54,38 +93,57 @@ namespace acme {
   }
 
   double PropellerBaseModel::GetAdvanceVelocity() const {
-    return c_uPA;
+    return c_output.m_uPA;
   }
 
   double PropellerBaseModel::GetThrust() const {
-    return c_thrust_N;
+    return c_output.m_thrust_N;
   }
 
   double PropellerBaseModel::GetTorque() const {
-    return c_torque_Nm;
+    return c_output.m_torque_Nm;
   }
 
   double PropellerBaseModel::GetPropellerEfficiency() const {
-    return c_efficiency;
+    return c_output.m_efficiency;
   }
 
   double PropellerBaseModel::GetPower() const {
-    return c_power_W;
+    return c_output.m_power_W;
   }
 
   double PropellerBaseModel::GetPropellerAdvanceVelocity(const double &u_NWU,
-                                                         const double &v_NWU) const {
+                                                         const double &v_NWU,
+                                                         double &sidewash_angle_rad) const {
     // sidewash angle
-    c_sidewash_angle_rad = mathutils::Normalize__PI_PI(std::atan2(v_NWU, u_NWU));
+    sidewash_angle_rad = mathutils::Normalize__PI_PI(std::atan2(v_NWU, u_NWU));
 
     // estimated wake_fraction taken into account the sidewash angle (0 when the absolute value of the sidewash
     // angle exceeds 90°)
-    double wp = (std::abs(c_sidewash_angle_rad) > MU_PI_2) ? 0. :
-                m_params.m_hull_wake_fraction_0 * std::exp(-4. * c_sidewash_angle_rad * c_sidewash_angle_rad);
+    double wp = (std::abs(sidewash_angle_rad) > MU_PI_2) ? 0. :
+                m_params.m_hull_wake_fraction_0 * std::exp(-4. * sidewash_angle_rad * sidewash_angle_rad);
 
     // Propeller advance velocity
-    c_uPA = m_ku * u_NWU * (1 - wp);
-    return c_uPA;
+    return m_ku * u_NWU * (1 - wp);
+  }
+
+  void PropellerBaseModel::GetPropellerAdvanceVelocities(std::size_t size,
+                                                         const double *u_NWU,
+                                                         const double *v_NWU,
+                                                         double *uPA,
+                                                         double *sidewash_angle_rad) const {
+    // Same computation as GetPropellerAdvanceVelocity, written as branchless loops over the batch
+    for (std::size_t i = 0; i < size; i++) {
+      sidewash_angle_rad[i] = mathutils::Normalize__PI_PI(std::atan2(v_NWU[i], u_NWU[i]));
+    }
+
+    auto wp0 = m_params.m_hull_wake_fraction_0;
+    for (std::size_t i = 0; i < size; i++) {
+      auto sidewash = sidewash_angle_rad[i];
+      auto wp = wp0 * std::exp(-4. * sidewash * sidewash);
+      wp = (std::abs(sidewash) > MU_PI_2) ? 0. : wp;
+      uPA[i] = m_ku * u_NWU[i] * (1 - wp);
+    }
   }
 
   void PropellerBaseModel::ComputeAdvanceVelocityCorrectionFactor() {
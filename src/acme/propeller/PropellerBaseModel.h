@@ -5,7 +5,16 @@
 #ifndef ACME_PROPELLERBASEMODEL_H
 #define ACME_PROPELLERBASEMODEL_H
 
+#include <cstddef>
+#include <memory>
+#include <string>
+
 #include "MathUtils/Vector3d.h"
+#include "acme/table/CurvePointer.h"
+#include "acme/table/InterpolationType.h"
+#include "acme/table/OutOfRangePolicy.h"
+#include "acme/table/TableAxis.h"
+#include "acme/table/TableSimplification.h"
 #include "PropellerModelType.h"
 #include "hermes/hermes.h"
 
@@ -31,8 +40,75 @@ namespace acme {
     double m_thrust_coefficient_correction = 0.;
     double m_torque_coefficient_correction = 0.;
 
-    // contains open water curve json file content
+    // contains open water curve json file content. Moved out of the parameters by the model constructor : the model and
+    // its copies share it until they are initialized, GetParameters returning an empty string
     std::string m_thruster_perf_data_json_string;
+
+    // Path of a binary curve file (see CurveFile), used instead of the json string when not empty. The tables then use
+    // the file mapped in memory in place when possible (no table simplification).
+    std::string m_thruster_perf_data_curve_file;
+
+    // Interpolation of the 1D open water tables (FPP1Q, FPP4Q), overridden by an "interpolation" entry in the json
+    InterpolationType m_table_interpolation = E_LINEAR;
+
+    // If positive, redundant table nodes are removed at initialization, keeping the interpolation of the coefficients
+    // (kt/kq or ct/cq, with the table interpolation) within this absolute tolerance of the original data
+    double m_table_simplification_tolerance = 0.;
+
+    // Store the performance tables in single precision (computations remain in double precision)
+    bool m_table_single_precision = false;
+
+    // FPP1Q only : if positive, kt and kq are represented by Chebyshev expansions of this degree fitted on the open
+    // water data, instead of the table. Overridden by a "chebyshev_degree" entry in the json.
+    unsigned int m_chebyshev_degree = 0;
+
+    // Behaviour of Compute for an operating point outside of the open water data
+    OutOfRangePolicy m_out_of_range_policy = E_OUT_OF_RANGE_THROW;
+  };
+
+  /// Operating point of a propeller
+  struct PropellerInput {
+    double m_water_density;     // in kg/m3
+    double m_u_NWU;             // propeller velocity with respect to water along the vessel x-axis (m/s)
+    double m_v_NWU;             // propeller velocity with respect to water along the vessel y-axis (m/s)
+    double m_rpm;               // shaft rotational velocity in round per minutes
+    double m_pitch_ratio = 0.;  // only used for CPP
+    TableHints *m_hints = nullptr; // interval hints of the caller, may be null (see TableHints)
+  };
+
+  /// Propeller loads and kinematics at an operating point
+  struct PropellerOutput {
+    double m_uPA = 0.;                 // propeller advance velocity (m/s)
+    double m_sidewash_angle_rad = 0.;
+    double m_advance_ratio = 0.;       // J, zero when the propeller does not rotate
+    double m_thrust_N = 0.;            // effective thrust, thrust deduction included
+    double m_torque_Nm = 0.;
+    double m_power_W = 0.;
+    double m_efficiency = 0.;
+    unsigned int m_status = E_STATUS_OK; // see ComputeStatus
+  };
+
+  /// Operating points of a batch of propellers sharing the same model, as arrays of m_size values (structure of
+  /// arrays, see PropellerInput)
+  struct PropellerBatchInput {
+    std::size_t m_size = 0;
+    const double *m_water_density = nullptr;
+    const double *m_u_NWU = nullptr;
+    const double *m_v_NWU = nullptr;
+    const double *m_rpm = nullptr;
+    const double *m_pitch_ratio = nullptr;  // only used for CPP, may be null otherwise
+  };
+
+  /// Arrays receiving the results of a batch of propellers, each one with room for the batch size (see PropellerOutput)
+  struct PropellerBatchOutput {
+    double *m_uPA = nullptr;
+    double *m_sidewash_angle_rad = nullptr;
+    double *m_advance_ratio = nullptr;
+    double *m_thrust_N = nullptr;
+    double *m_torque_Nm = nullptr;
+    double *m_power_W = nullptr;
+    double *m_efficiency = nullptr;
+    unsigned int *m_status = nullptr;  // optional, see ComputeStatus
   };
 
 
@@ -41,21 +117,39 @@ namespace acme {
    public:
     PropellerBaseModel(const PropellerParams &params, PropellerModelType type);
 
+    virtual ~PropellerBaseModel() = default;
+
     virtual void Initialize();
 
     void DefineLogMessages(hermes::Message* msg);
 
-    /// Compute the models with the specified data
+    /// Compute the model at an operating point.
+    /// The result only depends on the input : the model is not modified, so that a single initialized model may be
+    /// evaluated concurrently by any number of threads. Does not allocate on the heap.
+    /// Table lookups start from the interval hints of the input, owned by the caller (one per thread or per unit).
+    /// Operating points outside of the open water data are handled according to PropellerParams::m_out_of_range_policy,
+    /// the status of the output reporting them (without exception unless the policy is E_OUT_OF_RANGE_THROW) and the
+    /// status counters of the model counting them.
+    virtual PropellerOutput Compute(const PropellerInput &input) const = 0;
+
+    /// Compute the model for a batch of propellers sharing this model definition, with the same results as Compute
+    /// called on every operating point.
+    /// The batch is processed stage by stage (kinematics, coefficients, loads), each stage being a loop over plain
+    /// arrays, without virtual call per propeller. The output arrays are also used as scratch memory : the call does
+    /// not allocate. Like Compute, it does not modify the model.
+    virtual void ComputeBatch(const PropellerBatchInput &input, const PropellerBatchOutput &output) const;
+
+    /// Compute the models with the specified data, the results being then available through the getters
     /// \param water_density in kg/m3
     /// \param u propeller velocity with respect to water (current included) expressed along x-axis of the vessel (in m/s)
     /// \param v  propeller velocity with respect to water (current included) expressed along x-axis of the vessel (in m/s)
     /// \param rpm shaft rotational velocity in round per minutes
     /// \param pitch_ratio the propeller pitch ratio. Only used for CPP
-    virtual void Compute(const double &water_density,
-                         const double &u_NWU,
-                         const double &v_NWU,
-                         const double &rpm,
-                         const double &pitch_ratio) const = 0;
+    void Compute(const double &water_density,
+                 const double &u_NWU,
+                 const double &v_NWU,
+                 const double &rpm,
+                 const double &pitch_ratio) const;
 
     PropellerModelType GetThrusterModelType() const;
 
@@ -71,11 +165,51 @@ namespace acme {
 
     double GetPower() const;
 
+    /// Results of the last call to Compute with the getters API
+    const PropellerOutput &GetOutput() const { return c_output; }
+
+    /// Nodes removed from the performance table at initialization, see PropellerParams::m_table_simplification_tolerance
+    const TableSimplificationReport &GetTableSimplificationReport() const { return m_table_simplification_report; }
+
+    /// Number of out of range lookups in the open water data and of invalid operating points met since the
+    /// initialization or the last reset
+    StatusCounts GetStatusCounts() const { return c_status_counters.Get(); }
+
+    void ResetStatusCounts() { c_status_counters.Reset(); }
+
+    /// Replace the open water data of the initialized model, while other threads may be computing it.
+    /// The new curves are built by the calling thread with the table options of the model, then published with a single
+    /// atomic pointer swap : a concurrent Compute is never blocked and uses either the former or the new curves, never a
+    /// mix of both. The former curves are kept alive until ReleaseRetiredCurves. The parameters and the table
+    /// simplification report given by the model remain those of its initialization.
+    /// \param curve_file used instead of json_string when not empty, see PropellerParams::m_thruster_perf_data_curve_file
+    /// \throws std::runtime_error for invalid data, the model keeping its curves
+    void ReloadPerformanceData(const std::string &json_string, const std::string &curve_file = "");
+
+    /// Release the curves replaced by ReloadPerformanceData. Only to be called once every Compute started before the
+    /// last reload is done, for instance between two steps of a simulation.
+    /// \return the number of curve sets released
+    std::size_t ReleaseRetiredCurves() { return m_retired_curves.Release(); }
+
+    std::size_t GetNbRetiredCurves() const { return m_retired_curves.GetSize(); }
+
 
    protected:
 
+    /// Propeller advance velocity, hull wake included, and sidewash angle at the propeller
     double GetPropellerAdvanceVelocity(const double &u_NWU,
-                                       const double &v_NWU) const;
+                                       const double &v_NWU,
+                                       double &sidewash_angle_rad) const;
+
+    /// Batch version of GetPropellerAdvanceVelocity
+    void GetPropellerAdvanceVelocities(std::size_t size,
+                                       const double *u_NWU,
+                                       const double *v_NWU,
+                                       double *uPA,
+                                       double *sidewash_angle_rad) const;
+
+    /// \throws std::runtime_error if the model is not initialized
+    void CheckInitialized() const;
 
     SCREW_DIRECTION GetScrewDirection() const {
       return m_params.m_screw_direction;
@@ -85,9 +219,15 @@ namespace acme {
       return m_params.m_screw_direction == RIGHT_HANDED ? 1 : -1;
     }
 
+    /// Json performance data given with the parameters, empty once released by the initialization
+    const std::string &GetPerformanceDataJsonString() const;
+
    private:
     virtual void ParsePropellerPerformanceCurveJsonString() = 0;
 
+    /// Build and publish the curves of new performance data, the former ones being added to m_retired_curves
+    virtual void ReloadPerformanceCurves(const std::string &json_string, const std::string &curve_file) = 0;
+
     void ComputeAdvanceVelocityCorrectionFactor();
 
 
@@ -99,12 +239,18 @@ namespace acme {
     PropellerParams m_params;
     double m_ku;
 
-    mutable double c_uPA; // Propeller advance velocity
-    mutable double c_sidewash_angle_rad;
-    mutable double c_thrust_N;
-    mutable double c_torque_Nm;
-    mutable double c_efficiency;
-    mutable double c_power_W;
+    // Json performance data of the parameters, until initialization. Shared by the copies of the model, so that the
+    // models copied from a single one (see MakeModels) hold one copy of them.
+    std::shared_ptr<const std::string> m_perf_data_json_string;
+
+    TableSimplificationReport m_table_simplification_report;
+
+    RetiredCurves m_retired_curves;
+
+    mutable PropellerOutput c_output; // last results of the getters API, for the getters and logs only
+    mutable TableHints c_hints;       // interval hints of the getters API, not used by the reentrant Compute
+
+    mutable StatusCounters c_status_counters;
 
   };
 
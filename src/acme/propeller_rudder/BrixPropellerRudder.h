@@ -15,119 +15,59 @@ namespace acme {
    public:
     BrixPropellerRudder(const PropellerParams &thruster_params, const RudderParams &rudder_params);
 
-    void
-    Compute(const double &water_density, const double &u_NWU_propeller_ms, const double &v_NWU_propeller_ms,
-            const double &u_NWU_ship_ms, const double &v_NWU_ship_ms, const double &r_rads, const double &x_pr_m,
-            const double &x_gr_m, const double &rpm, const double &pitch_ratio,
-            const double &rudder_angle_deg) const override;
+    using PropellerRudder<Propeller, Rudder>::Compute;
 
-    double GetRudderFx() const override;
+    PropellerRudderOutput Compute(const PropellerRudderInput &input) const override;
 
-    double GetRudderFy() const override;
+    /// Batch version of Compute, with the same results.
+    /// Each stage (propeller, rudder kinematics, slipstream, coefficients, loads) is a loop over the batch. The
+    /// branches of Compute on the stagnation pressure at the propeller (q_PA == 0) and on the rudder area outside of
+    /// the slipstream (A_RA > 0) are replaced by masks. The output arrays are also used as scratch memory : the call
+    /// does not allocate, and requires the m_area_RP_m2 and m_rudder_RP arrays.
+    void ComputeBatch(const PropellerRudderBatchInput &input, const PropellerRudderBatchOutput &output) const override;
 
-    double GetRudderMz() const override;
+    /// The propeller, the rudder inflow and the slipstream geometry are computed once, then only the rudder loads for
+    /// each angle
+    PropellerOutput ComputeRudderAngleSweep(const PropellerRudderInput &input, std::size_t nb_angles,
+                                            const double *rudder_angle_deg,
+                                            double *fx_N, double *fy_N, double *mz_Nm) const override;
+
+    using PropellerRudderBase::ComputeRudderAngleSweep;
 
     void DefineLogMessages(hermes::Message *propeller_message, hermes::Message *rudder_message) override;
 
-   private:
-
-    // Propeller
-    mutable double c_uPA; // Propeller advance velocity
-    mutable double c_vPA;
-
-    // Rudder
-    mutable double c_fx_R_N;
-    mutable double c_fy_R_N;
-
-    //    Outside slipstream
-    mutable double c_A_RA_m2;
-    mutable double c_uRA;
-    mutable double c_vRA;
-    mutable double c_alpha_RA_rad; //drift angle
-    mutable double c_beta_RA_rad; //drift angle
-    mutable double c_drag_RA_N;
-    mutable double c_lift_RA_N;
-    mutable double c_torque_RA_Nm;
-    mutable double c_fx_RA_N;
-    mutable double c_fy_RA_N;
-
-    //    Inside slipstream
-    mutable double c_A_RP_m2;
-    mutable double c_uRP;
-    mutable double c_vRP;
-    mutable double c_alpha_RP_rad; //drift angle
-    mutable double c_beta_RP_rad; //drift angle
-    mutable double c_drag_RP_N;
-    mutable double c_lift_RP_N;
-    mutable double c_torque_RP_Nm;
-    mutable double c_fx_RP_N;
-    mutable double c_fy_RP_N;
+   protected:
+    /// Rudder inflow quantities independent of the rudder angle, besides the ones held by PropellerRudderOutput
+    struct RudderInflow {
+      bool m_has_slipstream = false;  // false for a zero stagnation pressure at the propeller
+      double m_lambda = 0.;           // lift correction in the slipstream for the lateral variation of flow speed
+      double m_q_RP = 0.;             // stagnation pressures, cosine and sine of the drift angles in (RP) and out of
+      double m_cos_beta_RP = 0.;      // (RA) the slipstream
+      double m_sin_beta_RP = 0.;
+      double m_q_RA = 0.;
+      double m_cos_beta_RA = 0.;
+      double m_sin_beta_RA = 0.;
+    };
+
+    /// First part of Compute, independent of the rudder angle : propeller loads, rudder velocities and drift angles
+    /// outside (RA) and inside (RP) the slipstream, rudder areas
+    RudderInflow ComputeRudderInflow(const PropellerRudderInput &input, PropellerRudderOutput &output) const;
+
+    /// Second part of Compute : rudder loads and total loads for a rudder angle, output holding the results of
+    /// ComputeRudderInflow
+    void ComputeRudderLoads(const PropellerRudderInput &input, const double &rudder_angle_deg,
+                            const RudderInflow &inflow, PropellerRudderOutput &output) const;
 
   };
 
   /// Build a propeller rudder model using type keys to get a custom combination of propeller and rudder model among the
   /// available models in acme.
+  /// Defined with the model factory, see BuildPropellerRudder.
   std::shared_ptr<PropellerRudderBase>
   build_Brix_pr(PropellerModelType prop_type,
                 PropellerParams prop_params,
                 RudderModelType rudder_type,
-                RudderParams rudder_params) {
-
-    std::shared_ptr<PropellerRudderBase> pr;
-
-    switch (prop_type) {
-      case E_FPP1Q:
-        switch (rudder_type) {
-          case E_SIMPLE_RUDDER:
-            pr = std::make_shared<BrixPropellerRudder<FPP1Q, SimpleRudderModel>>(prop_params, rudder_params);
-            break;
-          case E_FLAP_RUDDER:
-            pr = std::make_shared<BrixPropellerRudder<FPP1Q, FlapRudderModel>>(prop_params, rudder_params);
-            break;
-          case E_FUJII_RUDDER:
-            pr = std::make_shared<BrixPropellerRudder<FPP1Q, FujiiRudderModel>>(prop_params, rudder_params);
-            break;
-          case E_BRIX_RUDDER:
-            pr = std::make_shared<BrixPropellerRudder<FPP1Q, BrixRudderModel>>(prop_params, rudder_params);
-            break;
-        }
-        break;
-      case E_FPP4Q:
-        switch (rudder_type) {
-          case E_SIMPLE_RUDDER:
-            pr = std::make_shared<BrixPropellerRudder<FPP4Q, SimpleRudderModel>>(prop_params, rudder_params);
-            break;
-          case E_FLAP_RUDDER:
-            pr = std::make_shared<BrixPropellerRudder<FPP4Q, FlapRudderModel>>(prop_params, rudder_params);
-            break;
-          case E_FUJII_RUDDER:
-            pr = std::make_shared<BrixPropellerRudder<FPP4Q, FujiiRudderModel>>(prop_params, rudder_params);
-            break;
-          case E_BRIX_RUDDER:
-            pr = std::make_shared<BrixPropellerRudder<FPP4Q, BrixRudderModel>>(prop_params, rudder_params);
-            break;
-        }
-        break;
-      case E_CPP:
-        switch (rudder_type) {
-          case E_SIMPLE_RUDDER:
-            pr = std::make_shared<BrixPropellerRudder<CPP, SimpleRudderModel>>(prop_params, rudder_params);
-            break;
-          case E_FLAP_RUDDER:
-            pr = std::make_shared<BrixPropellerRudder<CPP, FlapRudderModel>>(prop_params, rudder_params);
-            break;
-          case E_FUJII_RUDDER:
-            pr = std::make_shared<BrixPropellerRudder<CPP, FujiiRudderModel>>(prop_params, rudder_params);
-            break;
-          case E_BRIX_RUDDER:
-            pr = std::make_shared<BrixPropellerRudder<CPP, BrixRudderModel>>(prop_params, rudder_params);
-            break;
-        }
-        break;
-    }
-
-    return pr;
-  }
+                RudderParams rudder_params);
 
 
 } // end namespace acme
@@ -2,6 +2,7 @@
 // Created by frongere on 09/08/2021.
 //
 
+#include <cfloat>
 #include "BrixPropellerRudder.h"
 
 namespace acme {
@@ -14,46 +15,67 @@ namespace acme {
       }
 
   template<class Propeller, class Rudder>
-  double BrixPropellerRudder<Propeller, Rudder>::GetRudderFx() const {
-    return c_fx_R_N;
-  }
+  PropellerRudderOutput
+  BrixPropellerRudder<Propeller, Rudder>::Compute(const PropellerRudderInput &input) const {
 
-  template<class Propeller, class Rudder>
-  double BrixPropellerRudder<Propeller, Rudder>::GetRudderFy() const {
-    return c_fy_R_N;
+    PropellerRudderOutput output;
+    auto inflow = ComputeRudderInflow(input, output);
+    ComputeRudderLoads(input, input.m_rudder_angle_deg, inflow, output);
+
+    return output;
   }
 
   template<class Propeller, class Rudder>
-  double BrixPropellerRudder<Propeller, Rudder>::GetRudderMz() const {
-    return c_torque_RA_Nm + c_torque_RP_Nm;
+  PropellerOutput
+  BrixPropellerRudder<Propeller, Rudder>::ComputeRudderAngleSweep(const PropellerRudderInput &input,
+                                                                  std::size_t nb_angles,
+                                                                  const double *rudder_angle_deg,
+                                                                  double *fx_N, double *fy_N, double *mz_Nm) const {
+
+    PropellerRudderOutput output;
+    auto inflow = ComputeRudderInflow(input, output);
+
+    for (std::size_t i = 0; i < nb_angles; i++) {
+      ComputeRudderLoads(input, rudder_angle_deg[i], inflow, output);
+      fx_N[i] = output.m_fx_N;
+      fy_N[i] = output.m_fy_N;
+      mz_Nm[i] = output.m_mz_Nm;
+    }
+
+    return output.m_propeller;
   }
 
   template<class Propeller, class Rudder>
-  void BrixPropellerRudder<Propeller, Rudder>::Compute(const double &water_density,
-                                                   const double &u_NWU_propeller_ms,
-                                                   const double &v_NWU_propeller_ms,
-                                                   const double &u_NWU_ship_ms,
-                                                   const double &v_NWU_ship_ms,
-                                                   const double &r_rads,
-                                                   const double &x_pr_m,
-                                                   const double &x_gr_m,
-                                                   const double &rpm,
-                                                   const double &pitch_ratio,
-                                                   const double &rudder_angle_deg) const {
+  typename BrixPropellerRudder<Propeller, Rudder>::RudderInflow
+  BrixPropellerRudder<Propeller, Rudder>::ComputeRudderInflow(const PropellerRudderInput &input,
+                                                              PropellerRudderOutput &output) const {
+
+    RudderInflow inflow;
+
+    const auto &water_density = input.m_water_density;
+    const auto &u_NWU_propeller_ms = input.m_u_NWU_propeller_ms;
+    const auto &v_NWU_propeller_ms = input.m_v_NWU_propeller_ms;
+    const auto &r_rads = input.m_r_rads;
+    const auto &x_pr_m = input.m_x_pr_m;
 
     /**
      * Solving for propeller action directly using propeller classes implementation
      * ref : Manoeuvring Technical Manual, Brix, Soder, 1992, p84
      * https://drive.google.com/file/d/195jz2YHRuhX3tSrqEPNJkYZg_7ZVTcHn/view?usp=sharing
      */
-    this->m_propeller->Compute(water_density,
-                         u_NWU_propeller_ms,
-                         v_NWU_propeller_ms,
-                         rpm,
-                         pitch_ratio);
+    output.m_propeller = this->m_propeller.Compute(PropellerInput{water_density,
+                                                                  u_NWU_propeller_ms,
+                                                                  v_NWU_propeller_ms,
+                                                                  input.m_rpm,
+                                                                  input.m_pitch_ratio,
+                                                                  input.m_hints ? &input.m_hints->m_propeller
+                                                                                : nullptr});
 
-    PropellerParams propeller_params = this->m_propeller->GetParameters();
-    RudderParams rudder_params = this->m_rudder->GetParameters();
+    const PropellerParams &propeller_params = this->m_propeller.GetParameters();
+    const RudderParams &rudder_params = this->m_rudder.GetParameters();
+
+    auto &RA = output.m_rudder_RA;
+    auto &RP = output.m_rudder_RP;
 
     /*
      * Computing velocities seen by the rudder outside the slipstream but taking into account the wake fraction
@@ -64,8 +86,8 @@ namespace acme {
     double u_R0 = u_NWU_propeller_ms;
     double v_R0 = v_NWU_propeller_ms + r_rads * x_pr_m;  // Transport of the propeller velocity to the rudder position
 
-    c_uRA = u_R0;
-    c_vRA = v_R0;
+    RA.m_uRA = u_R0;
+    RA.m_vRA = v_R0;
 
     if (rudder_params.m_has_hull_influence and u_R0 > DBL_EPSILON) {
       double rudder_sidewash_angle_0 = std::atan2(v_R0, u_R0);
@@ -73,20 +95,19 @@ namespace acme {
       // Estimated wake fraction for the rudder
       double wR = wr0 * std::exp(-4. * rudder_sidewash_angle_0 * rudder_sidewash_angle_0);
 
-      c_uRA *= (1 - wR);
+      RA.m_uRA *= (1 - wR);
 
       if (rudder_params.m_has_hull_influence_transverse_velocity) {
-        double beta_R = atan2(v_NWU_ship_ms + 2 * x_gr_m * r_rads, u_NWU_ship_ms);
+        double beta_R = atan2(input.m_v_NWU_ship_ms + 2 * input.m_x_gr_m * r_rads, input.m_u_NWU_ship_ms);
         double kappa = RudderBaseModel::HullStraighteningFunction(beta_R);
-        c_vRA *= kappa;
+        RA.m_vRA *= kappa;
       }
     }
 
-    this->c_rudder_angle_rad = rudder_angle_deg * MU_PI_180;
-
     // Mean axial speed of inflow to the propeller (with wake fraction correction included)
-    c_uPA = this->m_propeller->GetAdvanceVelocity();
-    c_vPA = v_NWU_propeller_ms;
+    double uPA = output.m_propeller.m_uPA;
+    double vPA = v_NWU_propeller_ms;
+    output.m_vPA = vPA;
 
     // Propeller data
     double r0 = 0.5 * propeller_params.m_diameter_m;  // Propeller radius
@@ -97,37 +118,29 @@ namespace acme {
     double A_R = rudder_params.m_lateral_area_m2;// Rudder total area
     double c = rudder_params.m_chord_m;// Rudder chord length at its half height
     double h_R = rudder_params.m_height_m;// Rudder height
-    double a_H = rudder_params.m_aH;
-    double x_R = rudder_params.m_xR;
-    double x_H = rudder_params.m_xH;
 
     /**
      * Dealing with rudder forces INSIDE the slipstream of the propeller (RP)
      */
 
     // Stagnation pressure at propeller position
-    double q_PA = 0.5 * water_density * (c_uPA * c_uPA + c_vPA * c_vPA);
-
-    if (q_PA == 0.) {
-      c_uRP = 0.;
-      c_vRP = c_vRA;
-      c_A_RP_m2 = 0.;
-      c_beta_RP_rad = 0.;
-      c_alpha_RP_rad = this->c_rudder_angle_rad;
-      c_drag_RP_N = 0.;
-      c_lift_RP_N = 0.;
-      c_torque_RP_Nm = 0.;
-      c_fx_RP_N = 0.;
-      c_fy_RP_N = 0.;
+    double q_PA = 0.5 * water_density * (uPA * uPA + vPA * vPA);
+
+    inflow.m_has_slipstream = q_PA != 0.;
+
+    if (!inflow.m_has_slipstream) {
+      RP.m_uRA = 0.;
+      RP.m_vRA = RA.m_vRA;
+      output.m_area_RP_m2 = 0.;
     } else {
       // Thrust loading coefficient
-      double Cth = std::abs(this->m_propeller->GetThrust() / (q_PA * Ap));
+      double Cth = std::abs(output.m_propeller.m_thrust_N / (q_PA * Ap));
 
       // Mean axial speed of the slipstream far behind the propeller
-      double u_inf = c_uPA * std::sqrt(1. + Cth);
+      double u_inf = uPA * std::sqrt(1. + Cth);
 
       // Slipstream radius far behind the propeller (potential)
-      double r_inf = r0 * std::sqrt(0.5 * (1. + c_uPA / u_inf));
+      double r_inf = r0 * std::sqrt(0.5 * (1. + uPA / u_inf));
 
       // Slipstream radius at rudder position (potential)
       double rinf_r0 = r_inf / r0;
@@ -141,63 +154,116 @@ namespace acme {
       double ux = u_inf * rinf_rx * rinf_rx;
 
       // Turbulent mixing correction on radius
-      double drx = 0.15 * x_pr_m * (ux - c_uPA) / (ux + c_uPA);
+      double drx = 0.15 * x_pr_m * (ux - uPA) / (ux + uPA);
 
       // Corrected radius and axial velocities
       double r_RP = rx + drx; // corrected radius
       double r_rdr = rx / (r_RP);
-      auto u_corr = (ux - c_uPA) * r_rdr * r_rdr + c_uPA; // corrected axial velocity
+      auto u_corr = (ux - uPA) * r_rdr * r_rdr + uPA; // corrected axial velocity
 
       // Correction for the influence of lateral variation of flow speed
       double d = sqrt(MU_PI_2) * r_RP;
       double f = 2. * std::pow(2. / (2. + d / c), 8);
-      // FIXME : pow not defined for negative c_uPA / c_uRP
-      double lambda = std::pow(c_uPA / u_corr, f);
+      // FIXME : pow not defined for negative uPA / uRP
+      inflow.m_lambda = std::pow(uPA / u_corr, f);
 
       // Influence of the hull in front of the rudder
-      c_uRP = (u_corr * u_corr + t * u_NWU_propeller_ms * u_NWU_propeller_ms) / u_corr;
-      r_RP *= sqrt(u_corr/c_uRP);
-
-//      c_uRP = u_corr;
+      RP.m_uRA = (u_corr * u_corr + t * u_NWU_propeller_ms * u_NWU_propeller_ms) / u_corr;
+      r_RP *= sqrt(u_corr / RP.m_uRA);
 
       // Rudder area seen by the slipstream
-      c_A_RP_m2 = 2. * r_RP < h_R ? (2. * r_RP / h_R) * A_R : A_R;
+      output.m_area_RP_m2 = 2. * r_RP < h_R ? (2. * r_RP / h_R) * A_R : A_R;
 
       // TODO: ici, on calcule les efforts de portance et de trainee
 
-      c_vRP = c_vRA; // Radial velocity at the rudder position
-
+      RP.m_vRA = RA.m_vRA; // Radial velocity at the rudder position
 
-      /// Debut du code replique
       // Drift angle in the slipstream
-      c_beta_RP_rad = std::atan2(c_vRP, c_uRP);
+      RP.m_drift_angle_rad = std::atan2(RP.m_vRA, RP.m_uRA);
+
+      // Stagnation pressure ar rudder level
+      inflow.m_q_RP = 0.5 * water_density * (RP.m_uRA * RP.m_uRA + RP.m_vRA * RP.m_vRA);
+
+      // Projection to the ship frame
+      inflow.m_cos_beta_RP = std::cos(RP.m_drift_angle_rad);
+      inflow.m_sin_beta_RP = std::sin(RP.m_drift_angle_rad);
+    }
+
+    // Rudder area outside of the slipstream
+    output.m_area_RA_m2 = A_R - output.m_area_RP_m2;
 
+    // test if rudder has area outside the slipstream
+    if (output.m_area_RA_m2 > 0) {
+      // Drift angle outside the slipstream
+      RA.m_drift_angle_rad = std::atan2(RA.m_vRA, RA.m_uRA);
+
+      // Stagnation pressure ar rudder level
+      inflow.m_q_RA = 0.5 * water_density * (RA.m_uRA * RA.m_uRA + RA.m_vRA * RA.m_vRA);
+
+      // Projection to the rudder frame
+      inflow.m_cos_beta_RA = std::cos(RA.m_drift_angle_rad);
+      inflow.m_sin_beta_RA = std::sin(RA.m_drift_angle_rad);
+    }
+
+    return inflow;
+  }
+
+  template<class Propeller, class Rudder>
+  void BrixPropellerRudder<Propeller, Rudder>::ComputeRudderLoads(const PropellerRudderInput &input,
+                                                                  const double &rudder_angle_deg,
+                                                                  const RudderInflow &inflow,
+                                                                  PropellerRudderOutput &output) const {
+
+    const RudderParams &rudder_params = this->m_rudder.GetParameters();
+
+    auto &RA = output.m_rudder_RA;
+    auto &RP = output.m_rudder_RP;
+
+    double rudder_angle_rad = rudder_angle_deg * MU_PI_180;
+    RA.m_rudder_angle_rad = rudder_angle_rad;
+    RP.m_rudder_angle_rad = rudder_angle_rad;
+    RA.m_status = E_STATUS_OK;
+    RP.m_status = E_STATUS_OK;
+
+    // Rudder data
+    double c = rudder_params.m_chord_m;// Rudder chord length at its half height
+    double a_H = rudder_params.m_aH;
+    double x_R = rudder_params.m_xR;
+    double x_H = rudder_params.m_xH;
+
+    /**
+     * Dealing with rudder forces INSIDE the slipstream of the propeller (RP)
+     */
+
+    if (!inflow.m_has_slipstream) {
+      RP.m_drift_angle_rad = 0.;
+      RP.m_attack_angle_rad = rudder_angle_rad;
+    } else {
+      /// Debut du code replique
       // Attack angle in the slipstream
-      c_alpha_RP_rad = mathutils::Normalize__PI_PI(this->c_rudder_angle_rad - c_beta_RP_rad);
+      RP.m_attack_angle_rad = mathutils::Normalize__PI_PI(rudder_angle_rad - RP.m_drift_angle_rad);
 
       // Get Coefficients
       double cl_RP, cd_RP, cn_RP;
-      this->m_rudder->GetClCdCn(c_alpha_RP_rad, this->c_rudder_angle_rad, cl_RP, cd_RP, cn_RP);
-      cl_RP *= lambda; // Influence of lateral variation of flow speed
-
-      // Stagnation pressure ar rudder level
-      double q_RP = 0.5 * water_density * (c_uRP * c_uRP + c_vRP * c_vRP);
+      RP.m_status = this->m_rudder.GetClCdCn(RP.m_attack_angle_rad, rudder_angle_rad, cl_RP, cd_RP, cn_RP,
+                                             input.m_hints ? &input.m_hints->m_rudder_RP : nullptr);
+      cl_RP *= inflow.m_lambda; // Influence of lateral variation of flow speed
+      const auto &q_RP = inflow.m_q_RP;
 
       // Computing loads at rudder in the slipstream
-      c_drag_RP_N = q_RP * cd_RP * c_A_RP_m2;
-      c_lift_RP_N = q_RP * cl_RP * c_A_RP_m2;
-      c_torque_RP_Nm = q_RP * cn_RP * c_A_RP_m2 * c;
+      RP.m_drag_N = q_RP * cd_RP * output.m_area_RP_m2;
+      RP.m_lift_N = q_RP * cl_RP * output.m_area_RP_m2;
+      RP.m_torque_Nm = q_RP * cn_RP * output.m_area_RP_m2 * c;
 
-      // Projection to the ship frame
-      double Cbeta_RP = std::cos(c_beta_RP_rad);
-      double Sbeta_RP = std::sin(c_beta_RP_rad);
+      const auto &Cbeta_RP = inflow.m_cos_beta_RP;
+      const auto &Sbeta_RP = inflow.m_sin_beta_RP;
 
       // Hull/rudder interactions
-      c_torque_RP_Nm += a_H * (x_H - x_R) * c_lift_RP_N * Cbeta_RP;
-      c_lift_RP_N *= (1. + a_H);
+      RP.m_torque_Nm += a_H * (x_H - x_R) * RP.m_lift_N * Cbeta_RP;
+      RP.m_lift_N *= (1. + a_H);
 
-      c_fx_RP_N = Cbeta_RP * c_drag_RP_N - Sbeta_RP * c_lift_RP_N;
-      c_fy_RP_N = Sbeta_RP * c_drag_RP_N + Cbeta_RP * c_lift_RP_N;
+      RP.m_fx_N = Cbeta_RP * RP.m_drag_N - Sbeta_RP * RP.m_lift_N;
+      RP.m_fy_N = Sbeta_RP * RP.m_drag_N + Cbeta_RP * RP.m_lift_N;
     }
 
     /// Fin du code replique
@@ -207,61 +273,239 @@ namespace acme {
      * Dealing with rudder forces OUTSIDE the slipstream of the propeller (RA) (no influence of the propeller)
      */
 
-    // Rudder area outside of the slipstream
-    c_A_RA_m2 = A_R - c_A_RP_m2;
-
     // test if rudder has area outside the slipstream
-    if (c_A_RA_m2 > 0) {
+    if (output.m_area_RA_m2 > 0) {
 
       /// Debut du code replique
-      // Drift angle outside the slipstream
-      c_beta_RA_rad = std::atan2(c_vRA, c_uRA);
-
       // Attack angle outside the slipstream
-      c_alpha_RA_rad = mathutils::Normalize__PI_PI(this->c_rudder_angle_rad - c_beta_RA_rad);
+      RA.m_attack_angle_rad = mathutils::Normalize__PI_PI(rudder_angle_rad - RA.m_drift_angle_rad);
 
       // Get Coefficients
       double cl_RA, cd_RA, cn_RA;
-      this->m_rudder->GetClCdCn(c_alpha_RA_rad, this->c_rudder_angle_rad, cl_RA, cd_RA, cn_RA);
-
-      // Stagnation pressure ar rudder level
-      double q_RA = 0.5 * water_density * (c_uRA * c_uRA + c_vRA * c_vRA);
+      RA.m_status = this->m_rudder.GetClCdCn(RA.m_attack_angle_rad, rudder_angle_rad, cl_RA, cd_RA, cn_RA,
+                                             input.m_hints ? &input.m_hints->m_rudder : nullptr);
+      const auto &q_RA = inflow.m_q_RA;
 
       // Computing loads at rudder outside the slipstream
-      c_drag_RA_N = q_RA * cd_RA * c_A_RA_m2;
-      c_lift_RA_N = q_RA * cl_RA * c_A_RA_m2;
-      c_torque_RA_Nm = q_RA * cn_RA * c_A_RA_m2 * c;
+      RA.m_drag_N = q_RA * cd_RA * output.m_area_RA_m2;
+      RA.m_lift_N = q_RA * cl_RA * output.m_area_RA_m2;
+      RA.m_torque_Nm = q_RA * cn_RA * output.m_area_RA_m2 * c;
 
-      // Projection to the rudder frame
-      double Cbeta_RA = std::cos(c_beta_RA_rad);
-      double Sbeta_RA = std::sin(c_beta_RA_rad);
+      const auto &Cbeta_RA = inflow.m_cos_beta_RA;
+      const auto &Sbeta_RA = inflow.m_sin_beta_RA;
 
       // Hull/rudder interactions
-      c_torque_RA_Nm += a_H * (x_H - x_R) * c_lift_RA_N * Cbeta_RA;
-      c_lift_RA_N *= (1. + a_H);
+      RA.m_torque_Nm += a_H * (x_H - x_R) * RA.m_lift_N * Cbeta_RA;
+      RA.m_lift_N *= (1. + a_H);
 
-      c_fx_RA_N = Cbeta_RA * c_drag_RA_N - Sbeta_RA * c_lift_RA_N;
-      c_fy_RA_N = Sbeta_RA * c_drag_RA_N + Cbeta_RA * c_lift_RA_N;
+      RA.m_fx_N = Cbeta_RA * RA.m_drag_N - Sbeta_RA * RA.m_lift_N;
+      RA.m_fy_N = Sbeta_RA * RA.m_drag_N + Cbeta_RA * RA.m_lift_N;
       /// Fin du code replique
     } else {
-      c_beta_RA_rad = 0.;
-      c_alpha_RA_rad = this->c_rudder_angle_rad;
-      c_lift_RA_N = 0.;
-      c_drag_RA_N = 0.;
-      c_torque_RA_Nm = 0.;
-      c_fx_RA_N = 0.;
-      c_fy_RA_N = 0.;
+      RA.m_drift_angle_rad = 0.;
+      RA.m_attack_angle_rad = rudder_angle_rad;
     }
 
     /**
      * Summing up rudder forces from outside and inside the propeller slipstream
      */
 
-    c_fx_R_N = c_fx_RA_N + c_fx_RP_N;
-    c_fy_R_N = c_fy_RA_N + c_fy_RP_N;
+    output.m_rudder = RA;
+    output.m_rudder.m_lift_N += RP.m_lift_N;
+    output.m_rudder.m_drag_N += RP.m_drag_N;
+    output.m_rudder.m_torque_Nm += RP.m_torque_Nm;
+    output.m_rudder.m_fx_N += RP.m_fx_N;
+    output.m_rudder.m_fy_N += RP.m_fy_N;
+    output.m_rudder.m_status |= RP.m_status;
+    output.m_status = output.m_propeller.m_status | output.m_rudder.m_status;
+
+    output.m_fx_N = output.m_propeller.m_thrust_N + output.m_rudder.m_fx_N;
+    output.m_fy_N = output.m_rudder.m_fy_N;
     // Transport of the rudder torque to the propeller location
-    this->c_rudder_torque_Nm = (c_torque_RA_Nm + c_torque_RP_Nm) - x_pr_m * c_fy_R_N;
+    output.m_mz_Nm = output.m_rudder.m_torque_Nm - input.m_x_pr_m * output.m_rudder.m_fy_N;
+  }
+
+  template<class Propeller, class Rudder>
+  void BrixPropellerRudder<Propeller, Rudder>::ComputeBatch(const PropellerRudderBatchInput &input,
+                                                            const PropellerRudderBatchOutput &output) const {
+
+    if (!output.m_area_RP_m2 || !output.m_rudder_RP.m_uRA ||
+        (output.m_rudder.m_status && !output.m_rudder_RP.m_status)) {
+      throw std::invalid_argument("BrixPropellerRudder : the slipstream arrays of the batch output are required");
+    }
+
+    auto size = input.m_size;
+
+    // Propeller
+    this->m_propeller.ComputeBatch({size, input.m_water_density, input.m_u_NWU_propeller_ms,
+                                    input.m_v_NWU_propeller_ms, input.m_rpm, input.m_pitch_ratio},
+                                   output.m_propeller);
 
+    const PropellerParams &propeller_params = this->m_propeller.GetParameters();
+    const RudderParams &rudder_params = this->m_rudder.GetParameters();
+
+    const auto &RA = output.m_rudder; // part outside the slipstream, until the sum of the two parts
+    const auto &RP = output.m_rudder_RP;
+
+    // Velocities seen by the rudder outside the slipstream, wake fraction included when the rudder moves forward
+    double wr0 = rudder_params.m_hull_wake_fraction_0;
+    bool has_hull_influence = rudder_params.m_has_hull_influence;
+    bool has_transverse_influence = has_hull_influence && rudder_params.m_has_hull_influence_transverse_velocity;
+    for (std::size_t i = 0; i < size; i++) {
+      double u_R0 = input.m_u_NWU_propeller_ms[i];
+      double v_R0 = input.m_v_NWU_propeller_ms[i] + input.m_r_rads[i] * input.m_x_pr_m[i];
+      bool mask = has_hull_influence && u_R0 > DBL_EPSILON;
+
+      double rudder_sidewash_angle_0 = std::atan2(v_R0, u_R0);
+      double wR = wr0 * std::exp(-4. * rudder_sidewash_angle_0 * rudder_sidewash_angle_0);
+      RA.m_uRA[i] = mask ? u_R0 * (1 - wR) : u_R0;
+      RA.m_vRA[i] = v_R0;
+
+      double rudder_angle_rad = input.m_rudder_angle_deg[i] * MU_PI_180;
+      RA.m_rudder_angle_rad[i] = rudder_angle_rad;
+      RP.m_rudder_angle_rad[i] = rudder_angle_rad;
+    }
+    if (has_transverse_influence) {
+      for (std::size_t i = 0; i < size; i++) {
+        bool mask = input.m_u_NWU_propeller_ms[i] > DBL_EPSILON;
+        double beta_R = std::atan2(input.m_v_NWU_ship_ms[i] + 2 * input.m_x_gr_m[i] * input.m_r_rads[i],
+                                   input.m_u_NWU_ship_ms[i]);
+        double kappa = RudderBaseModel::HullStraighteningFunction(beta_R);
+        RA.m_vRA[i] = mask ? RA.m_vRA[i] * kappa : RA.m_vRA[i];
+      }
+    }
+
+    // Propeller data
+    double r0 = 0.5 * propeller_params.m_diameter_m;  // Propeller radius
+    double t = propeller_params.m_thrust_deduction_factor_0;
+    double Ap = MU_PI * r0 * r0;  // Propeller disk area
+
+    // Rudder data
+    double A_R = rudder_params.m_lateral_area_m2;
+    double c = rudder_params.m_chord_m;
+    double h_R = rudder_params.m_height_m;
+    double a_H = rudder_params.m_aH;
+    double x_R = rudder_params.m_xR;
+    double x_H = rudder_params.m_xH;
+
+    // Slipstream at the rudder position, for the units with a non zero stagnation pressure at the propeller. The
+    // lateral flow speed correction lambda and the attack angle used for the coefficients are held in the fx and fy
+    // arrays of the slipstream part until its loads are computed.
+    auto lambda = RP.m_fx_N;
+    auto attack_angle_RP = RP.m_fy_N;
+    for (std::size_t i = 0; i < size; i++) {
+      double uPA = output.m_propeller.m_uPA[i];
+      double vPA = input.m_v_NWU_propeller_ms[i];
+      double u_NWU_propeller_ms = input.m_u_NWU_propeller_ms[i];
+      double x_pr_m = input.m_x_pr_m[i];
+
+      double q_PA = 0.5 * input.m_water_density[i] * (uPA * uPA + vPA * vPA);
+      bool mask = q_PA != 0.;
+
+      double Cth = std::abs(output.m_propeller.m_thrust_N[i] / (q_PA * Ap));
+      double u_inf = uPA * std::sqrt(1. + Cth);
+      double r_inf = r0 * std::sqrt(0.5 * (1. + uPA / u_inf));
+
+      double rinf_r0 = r_inf / r0;
+      double rinf_r0_3 = std::pow(rinf_r0, 3);
+      double x_r0_1_5 = std::pow(std::abs(x_pr_m) / r0, 1.5);
+      double rx = r0 * (0.14 * rinf_r0_3 + rinf_r0 * x_r0_1_5) / (0.14 * rinf_r0_3 + x_r0_1_5);
+
+      double rinf_rx = r_inf / rx;
+      double ux = u_inf * rinf_rx * rinf_rx;
+
+      double drx = 0.15 * x_pr_m * (ux - uPA) / (ux + uPA);
+
+      double r_RP = rx + drx;
+      double r_rdr = rx / (r_RP);
+      auto u_corr = (ux - uPA) * r_rdr * r_rdr + uPA;
+
+      double d = sqrt(MU_PI_2) * r_RP;
+      double f = 2. * std::pow(2. / (2. + d / c), 8);
+      double lambda_i = std::pow(uPA / u_corr, f);
+
+      double uRP = (u_corr * u_corr + t * u_NWU_propeller_ms * u_NWU_propeller_ms) / u_corr;
+      r_RP *= sqrt(u_corr / uRP);
+      double area_RP = 2. * r_RP < h_R ? (2. * r_RP / h_R) * A_R : A_R;
+
+      double vRP = RA.m_vRA[i];
+      double drift_angle_rad = std::atan2(vRP, uRP);
+      double rudder_angle_rad = RP.m_rudder_angle_rad[i];
+      double attack_angle_rad = mathutils::Normalize__PI_PI(rudder_angle_rad - drift_angle_rad);
+
+      RP.m_uRA[i] = mask ? uRP : 0.;
+      RP.m_vRA[i] = vRP;
+      output.m_area_RP_m2[i] = mask ? area_RP : 0.;
+      RP.m_drift_angle_rad[i] = mask ? drift_angle_rad : 0.;
+      RP.m_attack_angle_rad[i] = mask ? attack_angle_rad : rudder_angle_rad;
+      lambda[i] = mask ? lambda_i : 0.;
+      attack_angle_RP[i] = mask ? attack_angle_rad : 0.; // masked units are given a valid angle for the tables
+    }
+
+    // Part of the rudder outside the slipstream, the attack angle used for the coefficients being held in the fy array
+    auto attack_angle_RA = RA.m_fy_N;
+    for (std::size_t i = 0; i < size; i++) {
+      bool mask = A_R - output.m_area_RP_m2[i] > 0;
+      double drift_angle_rad = std::atan2(RA.m_vRA[i], RA.m_uRA[i]);
+      double rudder_angle_rad = RA.m_rudder_angle_rad[i];
+      double attack_angle_rad = mathutils::Normalize__PI_PI(rudder_angle_rad - drift_angle_rad);
+      RA.m_drift_angle_rad[i] = mask ? drift_angle_rad : 0.;
+      RA.m_attack_angle_rad[i] = mask ? attack_angle_rad : rudder_angle_rad;
+      attack_angle_RA[i] = mask ? attack_angle_rad : 0.;
+    }
+
+    // Coefficients, held in the lift, drag and torque arrays until the loads are computed
+    this->m_rudder.GetClCdCnBatch(size, attack_angle_RP, RP.m_rudder_angle_rad,
+                                  RP.m_lift_N, RP.m_drag_N, RP.m_torque_Nm, RP.m_status);
+    this->m_rudder.GetClCdCnBatch(size, attack_angle_RA, RA.m_rudder_angle_rad,
+                                  RA.m_lift_N, RA.m_drag_N, RA.m_torque_Nm, RA.m_status);
+
+    // Loads of the two parts and their sum. The slipstream part of the masked units has zero area and lambda, hence
+    // zero loads.
+    for (std::size_t i = 0; i < size; i++) {
+      double water_density = input.m_water_density[i];
+
+      double area_RP = output.m_area_RP_m2[i];
+      double q_RP = 0.5 * water_density * (RP.m_uRA[i] * RP.m_uRA[i] + RP.m_vRA[i] * RP.m_vRA[i]);
+      double drag_RP = q_RP * RP.m_drag_N[i] * area_RP;
+      double lift_RP = q_RP * (RP.m_lift_N[i] * lambda[i]) * area_RP;
+      double torque_RP = q_RP * RP.m_torque_Nm[i] * area_RP * c;
+      double Cbeta_RP = std::cos(RP.m_drift_angle_rad[i]);
+      double Sbeta_RP = std::sin(RP.m_drift_angle_rad[i]);
+      torque_RP += a_H * (x_H - x_R) * lift_RP * Cbeta_RP;
+      lift_RP *= (1. + a_H);
+      RP.m_drag_N[i] = drag_RP;
+      RP.m_lift_N[i] = lift_RP;
+      RP.m_torque_Nm[i] = torque_RP;
+      RP.m_fx_N[i] = Cbeta_RP * drag_RP - Sbeta_RP * lift_RP;
+      RP.m_fy_N[i] = Sbeta_RP * drag_RP + Cbeta_RP * lift_RP;
+
+      double area_RA = A_R - area_RP;
+      bool mask_RA = area_RA > 0;
+      double q_RA = 0.5 * water_density * (RA.m_uRA[i] * RA.m_uRA[i] + RA.m_vRA[i] * RA.m_vRA[i]);
+      double drag_RA = q_RA * RA.m_drag_N[i] * area_RA;
+      double lift_RA = q_RA * RA.m_lift_N[i] * area_RA;
+      double torque_RA = q_RA * RA.m_torque_Nm[i] * area_RA * c;
+      double Cbeta_RA = std::cos(RA.m_drift_angle_rad[i]);
+      double Sbeta_RA = std::sin(RA.m_drift_angle_rad[i]);
+      torque_RA += a_H * (x_H - x_R) * lift_RA * Cbeta_RA;
+      lift_RA *= (1. + a_H);
+      double fx_RA = Cbeta_RA * drag_RA - Sbeta_RA * lift_RA;
+      double fy_RA = Sbeta_RA * drag_RA + Cbeta_RA * lift_RA;
+
+      // Whole rudder, the part outside the slipstream having loads only where it has an area
+      RA.m_drag_N[i] = (mask_RA ? drag_RA : 0.) + RP.m_drag_N[i];
+      RA.m_lift_N[i] = (mask_RA ? lift_RA : 0.) + RP.m_lift_N[i];
+      RA.m_torque_Nm[i] = (mask_RA ? torque_RA : 0.) + RP.m_torque_Nm[i];
+      RA.m_fx_N[i] = (mask_RA ? fx_RA : 0.) + RP.m_fx_N[i];
+      RA.m_fy_N[i] = (mask_RA ? fy_RA : 0.) + RP.m_fy_N[i];
+
+      if (RA.m_status) RA.m_status[i] |= RP.m_status[i];
+
+      output.m_fx_N[i] = output.m_propeller.m_thrust_N[i] + RA.m_fx_N[i];
+      output.m_fy_N[i] = RA.m_fy_N[i];
+      output.m_mz_Nm[i] = RA.m_torque_Nm[i] - input.m_x_pr_m[i] * RA.m_fy_N[i];
+    }
   }
 
   template<class Propeller, class Rudder>
@@ -273,65 +517,65 @@ namespace acme {
     // Propeller
     propeller_message->AddField<double>("uPA", "m/s",
                                         "Longitudinal velocity at the propeller position, in propeller reference frame",
-                                        [this]() { return c_uPA; });
+                                        [this]() { return this->c_output.m_propeller.m_uPA; });
 
     propeller_message->AddField<double>("vPA", "m/s",
                                         "Transverse velocity at the propeller position, in propeller reference frame",
-                                        [this]() { return c_vPA; });
+                                        [this]() { return this->c_output.m_vPA; });
 
     // Rudder
     //        outside slipstream
 
     rudder_message->AddField<double>("area_RA", "m2", "Rudder area outside the slipstream",
-                                     [this]() { return c_A_RA_m2 ; });
+                                     [this]() { return this->c_output.m_area_RA_m2; });
 
     rudder_message->AddField<double>("DriftAngle_RA", "rad", "Drift angle outside the slipstream",
-                                     [this]() { return c_beta_RA_rad; });
+                                     [this]() { return this->c_output.m_rudder_RA.m_drift_angle_rad; });
 
     rudder_message->AddField<double>("AttackAngle_RA", "rad", "Attack angle outside the slipstream",
-                                     [this]() { return c_alpha_RA_rad; });
+                                     [this]() { return this->c_output.m_rudder_RA.m_attack_angle_rad; });
 
     rudder_message->AddField<double>("u_RA", "m/s", "Longitudinal velocity",
-                                     [this]() { return c_uRA; });
+                                     [this]() { return this->c_output.m_rudder_RA.m_uRA; });
 
     rudder_message->AddField<double>("v_RA", "m/s", "transversal velocity",
-                                     [this]() { return c_vRA; });
+                                     [this]() { return this->c_output.m_rudder_RA.m_vRA; });
 
     rudder_message->AddField<double>("Drag_RA", "N", "Drag delivered by the part of the rudder outside the slipstream",
-                                     [this]() { return c_drag_RA_N; });
+                                     [this]() { return this->c_output.m_rudder_RA.m_drag_N; });
 
     rudder_message->AddField<double>("Lift_RA", "N", "Lift delivered by the part of the rudder outside the slipstream",
-                                     [this]() { return c_lift_RA_N; });
+                                     [this]() { return this->c_output.m_rudder_RA.m_lift_N; });
 
     rudder_message->AddField<double>("Torque_RA", "Nm", "Torque delivered by the part of the rudder outside the slipstream",
-                                     [this]() { return c_torque_RA_Nm; });
+                                     [this]() { return this->c_output.m_rudder_RA.m_torque_Nm; });
 
 
     //        inside slipstream
 
     rudder_message->AddField<double>("area_RP", "m2", "Rudder area in the slipstream",
-                                     [this]() { return c_A_RP_m2; });
+                                     [this]() { return this->c_output.m_area_RP_m2; });
 
     rudder_message->AddField<double>("DriftAngle_RP", "rad", "Drift angle inside the slipstream",
-                                     [this]() { return c_beta_RP_rad; });
+                                     [this]() { return this->c_output.m_rudder_RP.m_drift_angle_rad; });
 
     rudder_message->AddField<double>("AttackAngle_RP", "rad", "Attack angle inside the slipstream",
-                                     [this]() { return c_alpha_RP_rad; });
+                                     [this]() { return this->c_output.m_rudder_RP.m_attack_angle_rad; });
 
     rudder_message->AddField<double>("u_RP", "m/s", "Longitudinal velocity",
-                                     [this]() { return c_uRP; });
+                                     [this]() { return this->c_output.m_rudder_RP.m_uRA; });
 
     rudder_message->AddField<double>("v_RP", "m/s", "transversal velocity",
-                                     [this]() { return c_vRP; });
+                                     [this]() { return this->c_output.m_rudder_RP.m_vRA; });
 
     rudder_message->AddField<double>("Drag_RP", "N", "Drag delivered by the part of the rudder in the slipstream",
-                                     [this]() { return c_drag_RP_N; });
+                                     [this]() { return this->c_output.m_rudder_RP.m_drag_N; });
 
     rudder_message->AddField<double>("Lift_RP", "N", "Lift delivered by the part of the rudder in the slipstream",
-                                     [this]() { return c_lift_RP_N; });
+                                     [this]() { return this->c_output.m_rudder_RP.m_lift_N; });
 
     rudder_message->AddField<double>("Torque_RP", "Nm", "Torque delivered by the part of the rudder in the slipstream",
-                                     [this]() { return c_torque_RP_Nm; });
+                                     [this]() { return this->c_output.m_rudder_RP.m_torque_Nm; });
 
   }
 
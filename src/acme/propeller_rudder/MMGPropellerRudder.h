@@ -15,15 +15,28 @@ namespace acme {
    public:
     MMGPropellerRudder(const PropellerParams &thruster_params, const RudderParams &rudder_params);
 
-    void
-    Compute(const double &water_density, const double &u_NWU_propeller_ms, const double &v_NWU_propeller_ms,
-            const double &u_NWU_ship_ms, const double &v_NWU_ship_ms, const double &r_rads, const double &x_pr_m,
-            const double &x_gr_m, const double &rpm, const double &pitch_ratio,
-            const double &rudder_angle_deg) const override;
+    using PropellerRudder<FPP1Q, Rudder>::Compute;
+
+    PropellerRudderOutput Compute(const PropellerRudderInput &input) const override;
+
+    /// The propeller and the rudder inflow are computed once, then only the rudder loads for each angle
+    PropellerOutput ComputeRudderAngleSweep(const PropellerRudderInput &input, std::size_t nb_angles,
+                                            const double *rudder_angle_deg,
+                                            double *fx_N, double *fy_N, double *mz_Nm) const override;
+
+    using PropellerRudderBase::ComputeRudderAngleSweep;
 
     void DefineLogMessages(hermes::Message *propeller_message, hermes::Message *rudder_message) override;
 
    private:
+    /// First part of Compute, independent of the rudder angle : propeller loads and rudder inflow velocities
+    void ComputeRudderInflow(const PropellerRudderInput &input, PropellerRudderOutput &output,
+                             double &uR_ms, double &vR_ms) const;
+
+    /// Second part of Compute : rudder loads and total loads for a rudder angle
+    void ComputeRudderLoads(const PropellerRudderInput &input, const double &rudder_angle_deg,
+                            const double &uR_ms, const double &vR_ms, PropellerRudderOutput &output) const;
+
 
     double m_gamma_R; // flow straightening factor
     double m_kappa;   // correction factor
@@ -33,32 +46,13 @@ namespace acme {
 
   /// Build a propeller rudder model using type keys to get a custom combination of propeller and rudder model among the
   /// available models in acme.
+  /// The MMG model is only available with a FPP1Q propeller. Defined with the model factory, see BuildPropellerRudder.
+  /// \throws std::invalid_argument if prop_type is not E_FPP1Q
   std::shared_ptr<PropellerRudderBase>
   build_MMG_pr(PropellerModelType prop_type,
-                PropellerParams prop_params,
-                RudderModelType rudder_type,
-                RudderParams rudder_params) {
-
-    std::shared_ptr<PropellerRudderBase> pr;
-
-    switch (rudder_type) {
-      case E_SIMPLE_RUDDER:
-        pr = std::make_shared<MMGPropellerRudder<SimpleRudderModel>>(prop_params, rudder_params);
-        break;
-      case E_FLAP_RUDDER:
-        pr = std::make_shared<MMGPropellerRudder<FlapRudderModel>>(prop_params, rudder_params);
-        break;
-      case E_FUJII_RUDDER:
-        pr = std::make_shared<MMGPropellerRudder<FujiiRudderModel>>(prop_params, rudder_params);
-        break;
-      case E_BRIX_RUDDER:
-        pr = std::make_shared<MMGPropellerRudder<BrixRudderModel>>(prop_params, rudder_params);
-        break;
-    }
-
-    return pr;
-
-  }
+               PropellerParams prop_params,
+               RudderModelType rudder_type,
+               RudderParams rudder_params);
 
 
 } // end namespace acme
@@ -26,31 +26,57 @@ namespace acme {
   }
 
   template<class Rudder>
-  void MMGPropellerRudder<Rudder>::Compute(const double &water_density,
-                                           const double &u_NWU_propeller_ms,
-                                           const double &v_NWU_propeller_ms,
-                                           const double &u_NWU_ship_ms,
-                                           const double &v_NWU_ship_ms,
-                                           const double &r_rads,
-                                           const double &x_pr_m,
-                                           const double &x_gr_m,
-                                           const double &rpm,
-                                           const double &pitch_ratio,
-                                           const double &rudder_angle_deg) const {
+  PropellerRudderOutput MMGPropellerRudder<Rudder>::Compute(const PropellerRudderInput &input) const {
+
+    PropellerRudderOutput output;
+    double uR_ms, vR_ms;
+    ComputeRudderInflow(input, output, uR_ms, vR_ms);
+    ComputeRudderLoads(input, input.m_rudder_angle_deg, uR_ms, vR_ms, output);
+
+    return output;
+  }
+
+  template<class Rudder>
+  PropellerOutput MMGPropellerRudder<Rudder>::ComputeRudderAngleSweep(const PropellerRudderInput &input,
+                                                                      std::size_t nb_angles,
+                                                                      const double *rudder_angle_deg,
+                                                                      double *fx_N, double *fy_N,
+                                                                      double *mz_Nm) const {
+
+    PropellerRudderOutput output;
+    double uR_ms, vR_ms;
+    ComputeRudderInflow(input, output, uR_ms, vR_ms);
+
+    for (std::size_t i = 0; i < nb_angles; i++) {
+      ComputeRudderLoads(input, rudder_angle_deg[i], uR_ms, vR_ms, output);
+      fx_N[i] = output.m_fx_N;
+      fy_N[i] = output.m_fy_N;
+      mz_Nm[i] = output.m_mz_Nm;
+    }
+
+    return output.m_propeller;
+  }
+
+  template<class Rudder>
+  void MMGPropellerRudder<Rudder>::ComputeRudderInflow(const PropellerRudderInput &input,
+                                                       PropellerRudderOutput &output,
+                                                       double &uR_ms, double &vR_ms) const {
 
     /**
      * Solving for propeller action directly using propeller classes implementation
      * ref : Manoeuvring Technical Manual, Brix, Soder, 1992, p84
      * https://drive.google.com/file/d/195jz2YHRuhX3tSrqEPNJkYZg_7ZVTcHn/view?usp=sharing
      */
-    this->m_propeller->Compute(water_density,
-                               u_NWU_propeller_ms,
-                               v_NWU_propeller_ms,
-                               rpm,
-                               pitch_ratio);
+    output.m_propeller = this->m_propeller.Compute(PropellerInput{input.m_water_density,
+                                                                  input.m_u_NWU_propeller_ms,
+                                                                  input.m_v_NWU_propeller_ms,
+                                                                  input.m_rpm,
+                                                                  input.m_pitch_ratio,
+                                                                  input.m_hints ? &input.m_hints->m_propeller
+                                                                                : nullptr});
 
-    PropellerParams propeller_params = this->m_propeller->GetParameters();
-    RudderParams rudder_params = this->m_rudder->GetParameters();
+    const auto &u_NWU_ship_ms = input.m_u_NWU_ship_ms;
+    const auto &v_NWU_ship_ms = input.m_v_NWU_ship_ms;
 
     auto STW_ms = u_NWU_ship_ms * u_NWU_ship_ms + v_NWU_ship_ms * v_NWU_ship_ms;
     STW_ms = sqrt(STW_ms);
@@ -62,30 +88,42 @@ namespace acme {
 //    auto lr_prime = x_gr_m / m_Lpp;
 //    auto vR_ms = -STW_ms * m_gamma_R * (leeway_rad - lr_prime * r_prime);
 
-    auto vR_ms = -STW_ms * m_gamma_R * leeway_rad;
+    vR_ms = -STW_ms * m_gamma_R * leeway_rad;
 
-    auto wr = this->m_rudder->m_params.m_hull_wake_fraction_0 * std::exp(-4. * leeway_rad * leeway_rad);
+    auto wr = this->m_rudder.m_params.m_hull_wake_fraction_0 * std::exp(-4. * leeway_rad * leeway_rad);
 
-    auto uR_ms = (1 - wr) * u_NWU_ship_ms;
+    uR_ms = (1 - wr) * u_NWU_ship_ms;
 
     // Applying correction due to propeller slipstream
-    auto J = this->m_propeller->J();
-    auto kt = this->m_propeller->kt(J);
+    auto J = output.m_propeller.m_advance_ratio;
     if (J > DBL_EPSILON) {
+      auto kt = this->m_propeller.kt(J);
       double tmp = 1. + m_kappa * (std::sqrt(1. + 8. * kt / (MU_PI * J * J)) - 1.);
       // TODO: calculer dynamiquement eta avec une formule donnant un rayon de slipstream au niveau du safran
       uR_ms *= std::sqrt(m_eta * tmp * tmp + (1. - m_eta));
     }
+  }
+
+  template<class Rudder>
+  void MMGPropellerRudder<Rudder>::ComputeRudderLoads(const PropellerRudderInput &input,
+                                                      const double &rudder_angle_deg,
+                                                      const double &uR_ms, const double &vR_ms,
+                                                      PropellerRudderOutput &output) const {
 
     // Attack angle
-    auto alpha_R_rad = rudder_angle_deg * MU_PI_180 - std::atan2(vR_ms, uR_ms);
+    double rudder_angle_rad = rudder_angle_deg * MU_PI_180;
+    auto alpha_R_rad = rudder_angle_rad - std::atan2(vR_ms, uR_ms);
     alpha_R_rad = mathutils::Normalize__PI_PI(alpha_R_rad);
 
-    this->m_rudder->ComputeLoads(water_density, uR_ms, vR_ms, alpha_R_rad);
+    output.m_rudder = this->m_rudder.ComputeLoads(input.m_water_density, uR_ms, vR_ms, alpha_R_rad,
+                                                  input.m_hints ? &input.m_hints->m_rudder : nullptr);
+    output.m_rudder.m_rudder_angle_rad = rudder_angle_rad;
+    output.m_status = output.m_propeller.m_status | output.m_rudder.m_status;
 
+    output.m_fx_N = output.m_propeller.m_thrust_N + output.m_rudder.m_fx_N;
+    output.m_fy_N = output.m_rudder.m_fy_N;
     // Transport of the rudder torque to the propeller location
-    this->c_rudder_torque_Nm = this->m_rudder->GetMz() - x_pr_m * this->m_rudder->GetFy();
-
+    output.m_mz_Nm = output.m_rudder.m_torque_Nm - input.m_x_pr_m * output.m_rudder.m_fy_N;
   }
 
   template<class Rudder>
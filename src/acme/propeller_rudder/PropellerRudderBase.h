@@ -5,7 +5,11 @@
 #ifndef ACME_PROPELLERRUDDERBASE_H
 #define ACME_PROPELLERRUDDERBASE_H
 
+#include <cstddef>
 #include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 #include "acme/propeller/propeller.h"
 #include "acme/rudder/rudder.h"
@@ -18,10 +22,99 @@ namespace acme {
   };
 
 
+  /// Interval hints of a caller evaluating a propeller rudder (see TableHints)
+  struct PropellerRudderHints {
+    TableHints m_propeller;
+    TableHints m_rudder;      // whole rudder, or Brix model : part of the rudder outside of the propeller slipstream
+    TableHints m_rudder_RP;   // Brix model : part of the rudder inside the propeller slipstream
+  };
+
+  /// Operating point of a propeller rudder, see PropellerRudderBase::Compute for the definitions
+  struct PropellerRudderInput {
+    double m_water_density;
+    double m_u_NWU_propeller_ms;
+    double m_v_NWU_propeller_ms;
+    double m_u_NWU_ship_ms;
+    double m_v_NWU_ship_ms;
+    double m_r_rads;
+    double m_x_pr_m;
+    double m_x_gr_m;
+    double m_rpm;
+    double m_pitch_ratio;
+    double m_rudder_angle_deg;
+    PropellerRudderHints *m_hints = nullptr; // interval hints of the caller, may be null
+  };
+
+  /// Loads of a propeller rudder at an operating point
+  struct PropellerRudderOutput {
+    PropellerOutput m_propeller;
+    RudderOutput m_rudder;              // whole rudder, torque at the rudder position
+
+    // Brix model only : parts of the rudder outside (RA) and inside (RP) the propeller slipstream, m_rudder holding
+    // their sum (velocities and angles being the ones outside the slipstream)
+    double m_vPA = 0.;
+    double m_area_RA_m2 = 0.;
+    double m_area_RP_m2 = 0.;
+    RudderOutput m_rudder_RA;
+    RudderOutput m_rudder_RP;
+
+    double m_fx_N = 0.;                 // total longitudinal force (propeller thrust and rudder)
+    double m_fy_N = 0.;                 // total transverse force
+    double m_mz_Nm = 0.;                // total torque, at the propeller position
+
+    unsigned int m_status = E_STATUS_OK; // propeller and rudder statuses combined, see ComputeStatus
+  };
+
+  /// Operating points of a batch of propeller rudders sharing the same model, as arrays of m_size values (structure of
+  /// arrays, see PropellerRudderInput)
+  struct PropellerRudderBatchInput {
+    std::size_t m_size = 0;
+    const double *m_water_density = nullptr;
+    const double *m_u_NWU_propeller_ms = nullptr;
+    const double *m_v_NWU_propeller_ms = nullptr;
+    const double *m_u_NWU_ship_ms = nullptr;
+    const double *m_v_NWU_ship_ms = nullptr;
+    const double *m_r_rads = nullptr;
+    const double *m_x_pr_m = nullptr;
+    const double *m_x_gr_m = nullptr;
+    const double *m_rpm = nullptr;
+    const double *m_pitch_ratio = nullptr;  // only used for CPP, may be null otherwise
+    const double *m_rudder_angle_deg = nullptr;
+  };
+
+  /// Arrays receiving the results of a batch of propeller rudders, each one with room for the batch size (see
+  /// PropellerRudderOutput)
+  struct PropellerRudderBatchOutput {
+    PropellerBatchOutput m_propeller;
+    RudderBatchOutput m_rudder;         // whole rudder, torque at the rudder position. Brix model : its status
+                                        // array requires the one of m_rudder_RP
+
+    // Brix model only, and then required : part of the rudder inside the propeller slipstream (RP), the part outside
+    // being the difference between m_rudder and m_rudder_RP
+    double *m_area_RP_m2 = nullptr;
+    RudderBatchOutput m_rudder_RP;
+
+    double *m_fx_N = nullptr;
+    double *m_fy_N = nullptr;
+    double *m_mz_Nm = nullptr;
+  };
+
+
+  /// Loads of a propeller rudder for a set of rudder angles at the same operating point
+  struct RudderAngleSweep {
+    PropellerOutput m_propeller;        // common to all the rudder angles
+    std::vector<double> m_fx_N;         // total loads for each rudder angle, see PropellerRudderOutput
+    std::vector<double> m_fy_N;
+    std::vector<double> m_mz_Nm;
+  };
+
+
   class PropellerRudderBase {
 
    public:
 
+    virtual ~PropellerRudderBase() = default;
+
     virtual void Initialize() = 0;
 
     virtual void DefineLogMessages(hermes::Message *propeller_message, hermes::Message *rudder_message) = 0;
@@ -61,6 +154,36 @@ namespace acme {
             const double &pitch_ratio,
             const double &rudder_angle_deg) const = 0;
 
+    /// Same as above, the result only depending on the input : the model is not modified, so that a single initialized
+    /// model may be evaluated concurrently by any number of threads, each one with its own hints.
+    virtual PropellerRudderOutput Compute(const PropellerRudderInput &input) const = 0;
+
+    /// Compute the model for a batch of propeller rudders sharing this model definition, with the same results as
+    /// Compute called on every operating point. Does not modify the model.
+    virtual void ComputeBatch(const PropellerRudderBatchInput &input, const PropellerRudderBatchOutput &output) const = 0;
+
+    /// Compute the model for a set of rudder angles at the same operating point (input.m_rudder_angle_deg being
+    /// ignored), with the same results as Compute called for each angle. Does not modify the model.
+    /// \param fx_N, fy_N, mz_Nm total loads for each rudder angle (see PropellerRudderOutput), arrays of nb_angles
+    ///        values
+    /// \return propeller loads, common to all the rudder angles
+    virtual PropellerOutput ComputeRudderAngleSweep(const PropellerRudderInput &input, std::size_t nb_angles,
+                                                    const double *rudder_angle_deg,
+                                                    double *fx_N, double *fy_N, double *mz_Nm) const = 0;
+
+    /// Same as above, allocating the result arrays
+    RudderAngleSweep ComputeRudderAngleSweep(const PropellerRudderInput &input,
+                                             const std::vector<double> &rudder_angle_deg) const {
+      RudderAngleSweep sweep;
+      auto nb_angles = rudder_angle_deg.size();
+      sweep.m_fx_N.resize(nb_angles);
+      sweep.m_fy_N.resize(nb_angles);
+      sweep.m_mz_Nm.resize(nb_angles);
+      sweep.m_propeller = ComputeRudderAngleSweep(input, nb_angles, rudder_angle_deg.data(), sweep.m_fx_N.data(),
+                                                  sweep.m_fy_N.data(), sweep.m_mz_Nm.data());
+      return sweep;
+    }
+
     virtual double GetPropellerThrust() const = 0;
 
     virtual double GetPropellerTorque() const = 0;
@@ -81,6 +204,23 @@ namespace acme {
 
     virtual double GetPropellerRudderMz() const = 0;
 
+    /// Out of range lookups and invalid operating points met by the propeller and rudder models, see
+    /// PropellerBaseModel::GetStatusCounts
+    virtual StatusCounts GetStatusCounts() const = 0;
+
+    virtual void ResetStatusCounts() = 0;
+
+    /// Replace the performance data of the propeller model while other threads may be computing the model, see
+    /// PropellerBaseModel::ReloadPerformanceData
+    virtual void ReloadPropellerPerformanceData(const std::string &json_string, const std::string &curve_file = "") = 0;
+
+    /// Same as above for the rudder model, see RudderBaseModel::ReloadPerformanceData
+    virtual void ReloadRudderPerformanceData(const std::string &json_string, const std::string &curve_file = "") = 0;
+
+    /// Release the curves replaced in the propeller and rudder models, see PropellerBaseModel::ReleaseRetiredCurves
+    /// \return the number of curve sets released
+    virtual std::size_t ReleaseRetiredCurves() = 0;
+
   };
 
 
@@ -92,6 +232,35 @@ namespace acme {
 
     void Initialize() override;
 
+    /// Compute the model, the results being then available through the getters
+    void
+    Compute(const double &water_density,
+            const double &u_NWU_propeller_ms,
+            const double &v_NWU_propeller_ms,
+            const double &u_NWU_ship_ms,
+            const double &v_NWU_ship_ms,
+            const double &r_rads,
+            const double &x_pr_m,
+            const double &x_gr_m,
+            const double &rpm,
+            const double &pitch_ratio,
+            const double &rudder_angle_deg) const final;
+
+    using PropellerRudderBase::Compute;
+
+    /// Generic version, calling Compute for every operating point of the batch
+    void ComputeBatch(const PropellerRudderBatchInput &input, const PropellerRudderBatchOutput &output) const override;
+
+    /// Generic version, calling Compute for every rudder angle
+    PropellerOutput ComputeRudderAngleSweep(const PropellerRudderInput &input, std::size_t nb_angles,
+                                            const double *rudder_angle_deg,
+                                            double *fx_N, double *fy_N, double *mz_Nm) const override;
+
+    using PropellerRudderBase::ComputeRudderAngleSweep;
+
+    /// Results of the last call to Compute with the getters API
+    const PropellerRudderOutput &GetOutput() const { return c_output; }
+
     double GetPropellerThrust() const override;
 
     double GetPropellerTorque() const override;
@@ -112,18 +281,25 @@ namespace acme {
 
     double GetPropellerRudderMz() const override;
 
+    StatusCounts GetStatusCounts() const override;
+
+    void ResetStatusCounts() override;
+
+    void ReloadPropellerPerformanceData(const std::string &json_string, const std::string &curve_file) override;
+
+    void ReloadRudderPerformanceData(const std::string &json_string, const std::string &curve_file) override;
+
+    std::size_t ReleaseRetiredCurves() override;
+
     virtual void DefineLogMessages(hermes::Message *propeller_message, hermes::Message *rudder_message);
 
    protected:
-    std::unique_ptr<Propeller> m_propeller;
-    std::unique_ptr<Rudder> m_rudder;
-
-    mutable double c_rudder_angle_rad;
-//    mutable double c_drift_angle_rad;
-//    mutable double c_attack_angle_rad;
-//    mutable double c_rudder_drift_N;
-//    mutable double c_rudder_drag_N;
-    mutable double c_rudder_torque_Nm;
+    // Held by value : a propeller rudder model and its submodels are a single object (see ModelArena)
+    Propeller m_propeller;
+    Rudder m_rudder;
+
+    mutable PropellerRudderOutput c_output; // last results of the getters API, for the getters and logs only
+    mutable PropellerRudderHints c_hints;   // interval hints of the getters API
 
   };
 
@@ -10,16 +10,103 @@ namespace acme {
   template<class Propeller, class Rudder>
   PropellerRudder<Propeller, Rudder>::PropellerRudder(const PropellerParams &thruster_params,
                                                       const RudderParams &rudder_params) :
-      m_propeller(std::make_unique<Propeller>(thruster_params)),
-      m_rudder(std::make_unique<Rudder>(rudder_params)) {}
+      m_propeller(thruster_params),
+      m_rudder(rudder_params) {}
 
   template<class Propeller, class Rudder>
   void PropellerRudder<Propeller, Rudder>::Initialize() {
-    m_propeller->Initialize();
-    m_rudder->Initialize();
+    m_propeller.Initialize();
+    m_rudder.Initialize();
   }
 
 
+  template<class Propeller, class Rudder>
+  void PropellerRudder<Propeller, Rudder>::Compute(const double &water_density,
+                                                   const double &u_NWU_propeller_ms,
+                                                   const double &v_NWU_propeller_ms,
+                                                   const double &u_NWU_ship_ms,
+                                                   const double &v_NWU_ship_ms,
+                                                   const double &r_rads,
+                                                   const double &x_pr_m,
+                                                   const double &x_gr_m,
+                                                   const double &rpm,
+                                                   const double &pitch_ratio,
+                                                   const double &rudder_angle_deg) const {
+    c_output = Compute(PropellerRudderInput{water_density, u_NWU_propeller_ms, v_NWU_propeller_ms,
+                                            u_NWU_ship_ms, v_NWU_ship_ms, r_rads, x_pr_m, x_gr_m,
+                                            rpm, pitch_ratio, rudder_angle_deg, &c_hints});
+  }
+
+  namespace internal {
+
+    inline void StoreRudderOutput(const RudderOutput &rudder, const RudderBatchOutput &output, std::size_t i) {
+      output.m_uRA[i] = rudder.m_uRA;
+      output.m_vRA[i] = rudder.m_vRA;
+      output.m_rudder_angle_rad[i] = rudder.m_rudder_angle_rad;
+      output.m_drift_angle_rad[i] = rudder.m_drift_angle_rad;
+      output.m_attack_angle_rad[i] = rudder.m_attack_angle_rad;
+      output.m_lift_N[i] = rudder.m_lift_N;
+      output.m_drag_N[i] = rudder.m_drag_N;
+      output.m_torque_Nm[i] = rudder.m_torque_Nm;
+      output.m_fx_N[i] = rudder.m_fx_N;
+      output.m_fy_N[i] = rudder.m_fy_N;
+      if (output.m_status) output.m_status[i] = rudder.m_status;
+    }
+
+  }  // end namespace internal
+
+  template<class Propeller, class Rudder>
+  void PropellerRudder<Propeller, Rudder>::ComputeBatch(const PropellerRudderBatchInput &input,
+                                                        const PropellerRudderBatchOutput &output) const {
+    PropellerRudderHints hints;
+    for (std::size_t i = 0; i < input.m_size; i++) {
+      auto result = Compute(PropellerRudderInput{input.m_water_density[i], input.m_u_NWU_propeller_ms[i],
+                                                 input.m_v_NWU_propeller_ms[i], input.m_u_NWU_ship_ms[i],
+                                                 input.m_v_NWU_ship_ms[i], input.m_r_rads[i], input.m_x_pr_m[i],
+                                                 input.m_x_gr_m[i], input.m_rpm[i],
+                                                 input.m_pitch_ratio ? input.m_pitch_ratio[i] : 0.,
+                                                 input.m_rudder_angle_deg[i], &hints});
+
+      const auto &propeller = result.m_propeller;
+      output.m_propeller.m_uPA[i] = propeller.m_uPA;
+      output.m_propeller.m_sidewash_angle_rad[i] = propeller.m_sidewash_angle_rad;
+      output.m_propeller.m_advance_ratio[i] = propeller.m_advance_ratio;
+      output.m_propeller.m_thrust_N[i] = propeller.m_thrust_N;
+      output.m_propeller.m_torque_Nm[i] = propeller.m_torque_Nm;
+      output.m_propeller.m_power_W[i] = propeller.m_power_W;
+      output.m_propeller.m_efficiency[i] = propeller.m_efficiency;
+      if (output.m_propeller.m_status) output.m_propeller.m_status[i] = propeller.m_status;
+
+      internal::StoreRudderOutput(result.m_rudder, output.m_rudder, i);
+      if (output.m_area_RP_m2) {
+        output.m_area_RP_m2[i] = result.m_area_RP_m2;
+        internal::StoreRudderOutput(result.m_rudder_RP, output.m_rudder_RP, i);
+      }
+
+      output.m_fx_N[i] = result.m_fx_N;
+      output.m_fy_N[i] = result.m_fy_N;
+      output.m_mz_Nm[i] = result.m_mz_Nm;
+    }
+  }
+
+  template<class Propeller, class Rudder>
+  PropellerOutput
+  PropellerRudder<Propeller, Rudder>::ComputeRudderAngleSweep(const PropellerRudderInput &input, std::size_t nb_angles,
+                                                              const double *rudder_angle_deg,
+                                                              double *fx_N, double *fy_N, double *mz_Nm) const {
+    PropellerOutput propeller;
+    auto angle_input = input;
+    for (std::size_t i = 0; i < nb_angles; i++) {
+      angle_input.m_rudder_angle_deg = rudder_angle_deg[i];
+      auto result = Compute(angle_input);
+      propeller = result.m_propeller;
+      fx_N[i] = result.m_fx_N;
+      fy_N[i] = result.m_fy_N;
+      mz_Nm[i] = result.m_mz_Nm;
+    }
+    return propeller;
+  }
+
   template<class Propeller, class Rudder>
   void PropellerRudder<Propeller, Rudder>::DefineLogMessages(hermes::Message *propeller_message,
                                                              hermes::Message *rudder_message) {
@@ -57,52 +144,84 @@ namespace acme {
 
   template<class Propeller, class Rudder>
   double PropellerRudder<Propeller, Rudder>::GetPropellerThrust() const {
-    return m_propeller->GetThrust();
+    return c_output.m_propeller.m_thrust_N;
   }
 
   template<class Propeller, class Rudder>
   double PropellerRudder<Propeller, Rudder>::GetPropellerTorque() const {
-    return m_propeller->GetTorque();
+    return c_output.m_propeller.m_torque_Nm;
   }
 
   template<class Propeller, class Rudder>
   double PropellerRudder<Propeller, Rudder>::GetPropellerEfficiency() const {
-    return m_propeller->GetPropellerEfficiency();
+    return c_output.m_propeller.m_efficiency;
   }
 
   template<class Propeller, class Rudder>
   double PropellerRudder<Propeller, Rudder>::GetPropellerPower() const {
-    return m_propeller->GetPower();
+    return c_output.m_propeller.m_power_W;
   }
 
   template<class Propeller, class Rudder>
   double PropellerRudder<Propeller, Rudder>::GetRudderFx() const {
-    return m_rudder->GetFx();
+    return c_output.m_rudder.m_fx_N;
   }
 
   template<class Propeller, class Rudder>
   double PropellerRudder<Propeller, Rudder>::GetRudderFy() const {
-    return m_rudder->GetFy();
+    return c_output.m_rudder.m_fy_N;
   }
 
   template<class Propeller, class Rudder>
   double PropellerRudder<Propeller, Rudder>::GetRudderMz() const {
-    return m_rudder->GetMz();
+    return c_output.m_rudder.m_torque_Nm;
   }
 
   template<class Propeller, class Rudder>
   double PropellerRudder<Propeller, Rudder>::GetPropellerRudderFx() const {
-    return GetPropellerThrust() + GetRudderFx();
+    return c_output.m_fx_N;
   }
 
   template<class Propeller, class Rudder>
   double PropellerRudder<Propeller, Rudder>::GetPropellerRudderFy() const {
-    return GetRudderFy();
+    return c_output.m_fy_N;
   }
 
   template<class Propeller, class Rudder>
   double PropellerRudder<Propeller, Rudder>::GetPropellerRudderMz() const {
-    return c_rudder_torque_Nm;
+    return c_output.m_mz_Nm;
+  }
+
+  template<class Propeller, class Rudder>
+  StatusCounts PropellerRudder<Propeller, Rudder>::GetStatusCounts() const {
+    auto counts = m_propeller.GetStatusCounts();
+    auto rudder_counts = m_rudder.GetStatusCounts();
+    counts.m_nb_out_of_range += rudder_counts.m_nb_out_of_range;
+    counts.m_nb_invalid_input += rudder_counts.m_nb_invalid_input;
+    return counts;
+  }
+
+  template<class Propeller, class Rudder>
+  void PropellerRudder<Propeller, Rudder>::ResetStatusCounts() {
+    m_propeller.ResetStatusCounts();
+    m_rudder.ResetStatusCounts();
+  }
+
+  template<class Propeller, class Rudder>
+  void PropellerRudder<Propeller, Rudder>::ReloadPropellerPerformanceData(const std::string &json_string,
+                                                                          const std::string &curve_file) {
+    m_propeller.ReloadPerformanceData(json_string, curve_file);
+  }
+
+  template<class Propeller, class Rudder>
+  void PropellerRudder<Propeller, Rudder>::ReloadRudderPerformanceData(const std::string &json_string,
+                                                                       const std::string &curve_file) {
+    m_rudder.ReloadPerformanceData(json_string, curve_file);
+  }
+
+  template<class Propeller, class Rudder>
+  std::size_t PropellerRudder<Propeller, Rudder>::ReleaseRetiredCurves() {
+    return m_propeller.ReleaseRetiredCurves() + m_rudder.ReleaseRetiredCurves();
   }
 
 
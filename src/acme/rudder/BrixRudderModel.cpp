@@ -4,6 +4,8 @@
 
 #include "BrixRudderModel.h"
 
+#include <algorithm>
+
 namespace acme {
 
   BrixRudderModel::BrixRudderModel(const RudderParams &params,
@@ -15,12 +17,13 @@ namespace acme {
     m_is_initialized = true;
   }
 
-  void
+  unsigned int
   BrixRudderModel::GetClCdCn(const double &attack_angle_rad,
                              const double &rudder_angle_rad,
                              double &cl,
                              double &cd,
-                             double &cn) const {
+                             double &cn,
+                             TableHints * /*hints*/) const {
 
     auto aspect_ratio = m_params.m_lateral_area_m2 / (m_params.m_chord_m * m_params.m_chord_m);
     
@@ -44,5 +47,23 @@ namespace acme {
     // Torque coefficient at rudder stock
     cn = Cqn + m_params.m_distance_nose_stock_m / m_params.m_chord_m * (cl * ca + cd * sa);
 
+    return E_STATUS_OK;
+  }
+
+  void BrixRudderModel::GetClCdCnBatch(std::size_t size,
+                                       const double *attack_angle_rad,
+                                       const double *rudder_angle_rad,
+                                       double *cl,
+                                       double *cd,
+                                       double *cn,
+                                       unsigned int *status) const {
+    // Non virtual calls, inlined in the loop
+    for (std::size_t i = 0; i < size; i++) {
+      BrixRudderModel::GetClCdCn(attack_angle_rad[i], rudder_angle_rad ? rudder_angle_rad[i] : 0.,
+                                 cl[i], cd[i], cn[i]);
+    }
+    // Analytical coefficients, defined for any attack angle
+    if (status) std::fill(status, status + size, E_STATUS_OK);
   }
+
 } // end namespace acme
\ No newline at end of file
@@ -33,11 +33,20 @@ namespace acme {
 
     void Initialize() override;
 
-    virtual void GetClCdCn(const double &attack_angle_rad,
-                           const double &rudder_angle_rad,
-                           double &cl,
-                           double &cd,
-                           double &cn) const;
+    virtual unsigned int GetClCdCn(const double &attack_angle_rad,
+                                   const double &rudder_angle_rad,
+                                   double &cl,
+                                   double &cd,
+                                   double &cn,
+                                   TableHints *hints = nullptr) const;
+
+    void GetClCdCnBatch(std::size_t size,
+                        const double *attack_angle_rad,
+                        const double *rudder_angle_rad,
+                        double *cl,
+                        double *cd,
+                        double *cn,
+                        unsigned int *status) const override;
 
   };
 
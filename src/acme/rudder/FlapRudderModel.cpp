@@ -2,11 +2,9 @@
 // Created by frongere on 09/08/2021.
 //
 
-#include <nlohmann/json.hpp>
 #include <MathUtils/Constants.h>
 #include "FlapRudderModel.h"
-
-using json = nlohmann::json;
+#include "acme/table/PerformanceDataParser.h"
 
 namespace acme {
 
@@ -16,123 +14,206 @@ namespace acme {
     m_type = RudderModelType::E_FLAP_RUDDER;  // Overrides the E_SIMPLE_RUDDER
   }
 
-  void FlapRudderModel::GetClCdCn(const double &attack_angle_rad,
-                                  const double &rudder_angle_rad,
-                                  double &cl,
-                                  double &cd,
-                                  double &cn) const {
+  unsigned int FlapRudderModel::GetClCdCn(const double &attack_angle_rad,
+                                          const double &rudder_angle_rad,
+                                          double &cl,
+                                          double &cd,
+                                          double &cn,
+                                          TableHints *hints) const {
 
     // Getting the flap angle from the rudder angle using the linear law (only linear law currently supported)
     double flap_angle_rad = m_params.m_flap_slope * rudder_angle_rad;
 
-    cl = m_cl_cd_cn_coeffs.Eval("cl", attack_angle_rad, flap_angle_rad);
-    cd = m_cl_cd_cn_coeffs.Eval("cd", attack_angle_rad, flap_angle_rad);
-    cn = m_cl_cd_cn_coeffs.Eval("cn", attack_angle_rad, flap_angle_rad);
+    // Symmetric tables only hold positive attack angles : (alpha, flap) is mapped to (-alpha, -flap), cl and cn being
+    // odd and cd even with respect to this symmetry
+    const auto &curves = *m_curves;
+    double sign = (curves.m_symmetric && attack_angle_rad < 0.) ? -1. : 1.;
+
+    // Single cell location for the three coefficients
+    auto policy = m_params.m_out_of_range_policy;
+    bool is_out_of_range;
+    TableHints local_hints;
+    if (!hints) hints = &local_hints;
+    auto cell = curves.m_cl_cd_cn_coeffs.Locate(sign * attack_angle_rad, sign * flap_angle_rad,
+                                                hints->m_x, hints->m_y,
+                                                policy == E_OUT_OF_RANGE_EXTRAPOLATE, is_out_of_range);
+    cl = sign * curves.m_cl_cd_cn_coeffs.Eval(cell, curves.m_cl_column);
+    cd = curves.m_cl_cd_cn_coeffs.Eval(cell, curves.m_cd_column);
+    cn = sign * curves.m_cl_cd_cn_coeffs.Eval(cell, curves.m_cn_column);
+    if (!is_out_of_range) return E_STATUS_OK;
+
+    const auto &attack_angle_axis = curves.m_cl_cd_cn_coeffs.GetXAxis();
+    double folded_attack_angle_rad = sign * attack_angle_rad;
+    if (folded_attack_angle_rad >= attack_angle_axis.GetMin() && folded_attack_angle_rad <= attack_angle_axis.GetMax()) {
+      return HandleOutOfRange(policy, c_status_counters, "FlapRudderModel : flap angle (rad)", flap_angle_rad,
+                              {&cl, &cd, &cn});
+    }
+    return HandleOutOfRange(policy, c_status_counters, "FlapRudderModel : attack angle (rad)", attack_angle_rad,
+                            {&cl, &cd, &cn});
+  }
 
+  void FlapRudderModel::GetClCdCnBatch(std::size_t size,
+                                       const double *attack_angle_rad,
+                                       const double *rudder_angle_rad,
+                                       double *cl,
+                                       double *cd,
+                                       double *cn,
+                                       unsigned int *status) const {
+    // Non virtual calls, inlined in the loop
+    TableHints hints;
+    for (std::size_t i = 0; i < size; i++) {
+      auto status_i = FlapRudderModel::GetClCdCn(attack_angle_rad[i], rudder_angle_rad ? rudder_angle_rad[i] : 0.,
+                                                 cl[i], cd[i], cn[i], &hints);
+      if (status) status[i] = status_i;
+    }
   }
 
   void FlapRudderModel::ParseRudderPerformanceCurveJsonString() {
-    std::string json_string;
-    std::vector<double> attack_angle_rad, flap_angle_rad, cd, cl, cn;
-    ParseFlapRudderJsonString(m_params.m_perf_data_json_string, attack_angle_rad, flap_angle_rad, cd, cl, cn);
-    m_cl_cd_cn_coeffs.SetX(attack_angle_rad);
-    m_cl_cd_cn_coeffs.SetY(flap_angle_rad);
-    m_cl_cd_cn_coeffs.AddData("cd", cd);
-    m_cl_cd_cn_coeffs.AddData("cl", cl);
-    m_cl_cd_cn_coeffs.AddData("cn", cn);
-
-    m_min_alpha_R_rad = *std::min_element(attack_angle_rad.begin(), attack_angle_rad.end());
-    m_max_alpha_R_rad = *std::max_element(attack_angle_rad.begin(), attack_angle_rad.end());
-
-    m_min_flap_angle_rad = *std::min_element(flap_angle_rad.begin(), flap_angle_rad.end());
-    m_max_flap_angle_rad = *std::max_element(flap_angle_rad.begin(), flap_angle_rad.end());
-  }
+    if (m_params.m_table_interpolation != E_LINEAR) {
+      throw std::runtime_error("FlapRudderModel : only linear interpolation is available for 2D tables");
+    }
 
+    m_curves = LoadCurves(GetPerformanceDataJsonString(), m_params.m_perf_data_curve_file);
+    m_perf_data_json_string.reset();
 
-  void ParseFlapRudderJsonString(const std::string &json_string, std::vector<double> &attack_angle_rad,
-                                 std::vector<double> &flap_angle_rad, std::vector<double> &cd, std::vector<double> &cl,
-                                 std::vector<double> &cn) {
+    m_params.m_symmetric_table = m_curves->m_symmetric;
+    m_min_alpha_R_rad = m_curves->m_min_attack_angle_rad;
+    m_max_alpha_R_rad = m_curves->m_max_attack_angle_rad;
+    m_table_simplification_report = m_curves->m_table_simplification_report;
+  }
+
+  void FlapRudderModel::ReloadPerformanceCurves(const std::string &json_string, const std::string &curve_file) {
+    m_retired_curves.Add(m_curves.Publish(LoadCurves(json_string, curve_file)));
+  }
 
-    std::vector<std::vector<double>> Cd, Cl, Cn;
-    int n;
+  std::shared_ptr<const FlapRudderCurves> FlapRudderModel::LoadCurves(const std::string &json_string,
+                                                                      const std::string &curve_file) const {
+    // Rudders built from the same data share the same curves
+    auto key = CurveRegistryKey("FlapRudder", {m_params.m_table_simplification_tolerance,
+                                               double(m_params.m_table_single_precision),
+                                               double(m_params.m_symmetric_table),
+                                               m_params.m_symmetry_tolerance},
+                                json_string, curve_file);
+    return CurveRegistry::GetInstance().Get<FlapRudderCurves>(key, [&]() {
+      auto file = curve_file.empty() ? nullptr : CurveFile::Open(curve_file);
+      return BuildCurves(json_string, file.get());
+    });
+  }
 
-    json j = json::parse(json_string);
+  FlapRudderCurves FlapRudderModel::BuildCurves(const std::string &json_string, const CurveFile *file) const {
 
-    try {
-      flap_angle_rad = j["flap_angle_deg"].get<std::vector<double>>();
-      for (auto &angle:flap_angle_rad) angle *= DEG2RAD;
-      n = flap_angle_rad.size();
-    } catch (json::parse_error &err) {
-      std::cerr << "SimpleRudderModel parser : no flap_angle_deg in load_coefficients";
-      exit(EXIT_FAILURE);
+    std::vector<double> attack_angle_rad, flap_angle_rad, cd, cl, cn;
+    RudderTableOptions options;
+    options.m_symmetric = m_params.m_symmetric_table;
+
+    FlapRudderCurves curves;
+
+    if (file) {
+      file->CheckModel("FlapRudder");
+      options.m_symmetric = file->GetOption("symmetric", options.m_symmetric) != 0.;
+
+      if (!options.m_symmetric && m_params.m_table_simplification_tolerance <= 0.) {
+        // Table used in place in the mapped file
+        auto &table = curves.m_cl_cd_cn_coeffs;
+        table.SetSinglePrecision(m_params.m_table_single_precision);
+        file->SetTable(table);
+        curves.m_cd_column = table.GetColumnHandle("cd");
+        curves.m_cl_column = table.GetColumnHandle("cl");
+        curves.m_cn_column = table.GetColumnHandle("cn");
+        curves.m_min_attack_angle_rad = table.GetXAxis().GetMin();
+        curves.m_max_attack_angle_rad = table.GetXAxis().GetMax();
+        curves.m_min_flap_angle_rad = table.GetYAxis().GetMin();
+        curves.m_max_flap_angle_rad = table.GetYAxis().GetMax();
+        return curves;
+      }
+
+      attack_angle_rad = file->GetAxis(0);
+      flap_angle_rad = file->GetAxis(1);
+      cd = file->GetColumn("cd");
+      cl = file->GetColumn("cl");
+      cn = file->GetColumn("cn");
+    } else {
+      ParseFlapRudderJsonString(json_string, attack_angle_rad, flap_angle_rad, cd, cl, cn, options);
     }
 
-    try {
-      attack_angle_rad = j["flow_incidence_on_main_rudder_deg"].get<std::vector<double>>();
-      for (auto &angle:attack_angle_rad) angle *= DEG2RAD;
-      n *= attack_angle_rad.size();
-      if (!std::is_sorted(attack_angle_rad.begin(), attack_angle_rad.end()))
-        throw std::runtime_error("SimpleRudderModel parser : flow_incidence_on_main_rudder_deg not sorted");
-    } catch (json::parse_error &err) {
-      std::cerr << "SimpleRudderModel parser : no flow_incidence_on_main_rudder_deg in load_coefficients";
-      exit(EXIT_FAILURE);
-    } catch (const std::exception &d) {
-      std::cerr << d.what();
-      exit(EXIT_FAILURE);
-    }
+    curves.m_symmetric = options.m_symmetric;
 
-    try {
-      Cd = j["Cd"].get<std::vector<std::vector<double>>>();
-      Eigen::MatrixXd mat(flap_angle_rad.size(), attack_angle_rad.size());
-      for (int i = 0; i < flap_angle_rad.size(); i++)
-        mat.row(i) = Eigen::VectorXd::Map(&Cd[i][0], Cd[i].size());
-      cd = {mat.data(), mat.data() + mat.rows() * mat.cols()};
-      if (cd.size() != n)
-        throw std::runtime_error("SimpleRudderModel parser : Cd not covering all angles range");
-    } catch (json::parse_error &err) {
-      std::cerr << "SimpleRudderModel parser : no Cd in load_coefficients";
-      exit(EXIT_FAILURE);
-    } catch (const std::exception &d) {
-      std::cerr << d.what();
-      exit(EXIT_FAILURE);
+    if (curves.m_symmetric) {
+      FoldSymmetricRudderTable(attack_angle_rad, flap_angle_rad, cd, cl, cn, m_params.m_symmetry_tolerance);
     }
 
-    try {
-      Cl = j["Cl"].get<std::vector<std::vector<double>>>();
-      Eigen::MatrixXd mat(flap_angle_rad.size(), attack_angle_rad.size());
-      for (int i = 0; i < flap_angle_rad.size(); i++)
-        mat.row(i) = Eigen::VectorXd::Map(&Cl[i][0], Cl[i].size());
-      cl = {mat.data(), mat.data() + mat.rows() * mat.cols()};
-      if (cl.size() != n)
-        throw std::runtime_error("SimpleRudderModel parser : Cl not covering all angles range");
-    } catch (json::parse_error &err) {
-      std::cerr << "SimpleRudderModel parser : no Cl in load_coefficients";
-      exit(EXIT_FAILURE);
-    } catch (const std::exception &d) {
-      std::cerr << d.what();
-      exit(EXIT_FAILURE);
+    if (m_params.m_table_simplification_tolerance > 0.) {
+      curves.m_table_simplification_report = SimplifyTable2D(attack_angle_rad, flap_angle_rad, {&cd, &cl, &cn},
+                                                             m_params.m_table_simplification_tolerance);
     }
 
-    try {
-      Cn = j["Cn"].get<std::vector<std::vector<double>>>();
-      Eigen::MatrixXd mat(flap_angle_rad.size(), attack_angle_rad.size());
-      for (int i = 0; i < flap_angle_rad.size(); i++)
-        mat.row(i) = Eigen::VectorXd::Map(&Cn[i][0], Cn[i].size());
-      cn = {mat.data(), mat.data() + mat.rows() * mat.cols()};
-      if (cn.size() != n)
-        throw std::runtime_error("SimpleRudderModel parser : Cn not covering all angles range");
-    } catch (json::parse_error &err) {
-      std::cerr << "SimpleRudderModel parser : no Cn in load_coefficients";
-      exit(EXIT_FAILURE);
-    } catch (const std::exception &d) {
-      std::cerr << d.what();
-      exit(EXIT_FAILURE);
+    curves.m_cl_cd_cn_coeffs.SetX(attack_angle_rad);
+    curves.m_cl_cd_cn_coeffs.SetY(flap_angle_rad);
+    curves.m_cl_cd_cn_coeffs.SetSinglePrecision(m_params.m_table_single_precision);
+    curves.m_cd_column = curves.m_cl_cd_cn_coeffs.AddData("cd", cd);
+    curves.m_cl_column = curves.m_cl_cd_cn_coeffs.AddData("cl", cl);
+    curves.m_cn_column = curves.m_cl_cd_cn_coeffs.AddData("cn", cn);
+
+    curves.m_max_attack_angle_rad = *std::max_element(attack_angle_rad.begin(), attack_angle_rad.end());
+    curves.m_min_attack_angle_rad = curves.m_symmetric ? -curves.m_max_attack_angle_rad :
+                                    *std::min_element(attack_angle_rad.begin(), attack_angle_rad.end());
+
+    curves.m_min_flap_angle_rad = *std::min_element(flap_angle_rad.begin(), flap_angle_rad.end());
+    curves.m_max_flap_angle_rad = *std::max_element(flap_angle_rad.begin(), flap_angle_rad.end());
+    return curves;
+  }
+
+  void ParseFlapRudderJsonString(const std::string &json_string, std::vector<double> &attack_angle_rad,
+                                 std::vector<double> &flap_angle_rad, std::vector<double> &cd, std::vector<double> &cl,
+                                 std::vector<double> &cn) {
+    RudderTableOptions options;
+    ParseFlapRudderJsonString(json_string, attack_angle_rad, flap_angle_rad, cd, cl, cn, options);
+  }
+
+  namespace {
+
+    // Coefficient rows are given for each flap angle, and stored as expected by AddData (flap angle varying fastest)
+    void ParseFlapRudderPerformanceData(PerformanceDataParser &parser, const std::string &json_string,
+                                        std::vector<double> &attack_angle_rad, std::vector<double> &flap_angle_rad,
+                                        std::vector<double> &cd, std::vector<double> &cl, std::vector<double> &cn,
+                                        RudderTableOptions &options) {
+      parser.AddOption("symmetric", options.m_symmetric);
+      parser.AddAxis("flap_angle_deg", flap_angle_rad, DEG2RAD);
+      parser.AddAxis("flow_incidence_on_main_rudder_deg", attack_angle_rad, DEG2RAD);
+      parser.AddMatrix("Cd", cd, "flow_incidence_on_main_rudder_deg", "flap_angle_deg");
+      parser.AddMatrix("Cl", cl, "flow_incidence_on_main_rudder_deg", "flap_angle_deg");
+      parser.AddMatrix("Cn", cn, "flow_incidence_on_main_rudder_deg", "flap_angle_deg");
+      parser.Parse(json_string);
     }
 
+  }  // end anonymous namespace
+
+  void ParseFlapRudderJsonString(const std::string &json_string, std::vector<double> &attack_angle_rad,
+                                 std::vector<double> &flap_angle_rad, std::vector<double> &cd, std::vector<double> &cl,
+                                 std::vector<double> &cn, RudderTableOptions &options) {
+
+    PerformanceDataParser parser("FlapRudderModel parser");
+    ParseFlapRudderPerformanceData(parser, json_string, attack_angle_rad, flap_angle_rad, cd, cl, cn, options);
+
     //TODO : gerer les changements de conventions NWU/NED et GOT/COMEFROM,
     //             les conventions d'angles ([pi,pi] ou [0, 2pi]
     //             les symetries, etc.
+  }
 
-
+  CurveData FlapRudderCurveData(const std::string &json_string) {
+    std::vector<double> attack_angle_rad, flap_angle_rad, cd, cl, cn;
+    RudderTableOptions options;
+    PerformanceDataParser parser("FlapRudderModel parser");
+    ParseFlapRudderPerformanceData(parser, json_string, attack_angle_rad, flap_angle_rad, cd, cl, cn, options);
+
+    CurveData data;
+    data.m_model = "FlapRudder";
+    data.m_axes = {{"attack_angle_rad", attack_angle_rad}, {"flap_angle_rad", flap_angle_rad}};
+    data.m_columns = {{"cd", cd}, {"cl", cl}, {"cn", cn}};
+
+    // Only the options given in the json override the rudder parameters
+    if (parser.Has("symmetric")) data.m_options["symmetric"] = options.m_symmetric;
+    return data;
   }
-}  // end namespace acme
\ No newline at end of file
+
+}  // end namespace acme
@@ -5,33 +5,71 @@
 #ifndef ACME_FLAPRUDDERMODEL_H
 #define ACME_FLAPRUDDERMODEL_H
 
+#include <memory>
 #include <string>
 
-#include "MathUtils/LookupTable2D.h"
+#include "acme/table/PerformanceTable2D.h"
+#include "acme/table/CurveRegistry.h"
+#include "acme/table/CurvePointer.h"
+#include "acme/table/CurveFile.h"
 
 #include "SimpleRudderModel.h"
 
 namespace acme {
 
+  /// Performance curves of a flap rudder, shared by the rudders built from the same data (see CurveRegistry)
+  struct FlapRudderCurves {
+    PerformanceTable2D m_cl_cd_cn_coeffs;
+    ColumnHandle m_cl_column = 0;
+    ColumnHandle m_cd_column = 0;
+    ColumnHandle m_cn_column = 0;
+
+    bool m_symmetric = false; // as resolved from the parameters and the json
+
+    double m_min_attack_angle_rad = 0.;
+    double m_max_attack_angle_rad = 0.;
+    double m_min_flap_angle_rad = 0.;
+    double m_max_flap_angle_rad = 0.;
+
+    TableSimplificationReport m_table_simplification_report;
+
+    std::size_t GetMemoryUsage() const { return m_cl_cd_cn_coeffs.GetMemoryUsage(); }
+  };
+
+
   class FlapRudderModel : public SimpleRudderModel {
 
    public:
     FlapRudderModel(const RudderParams params);
 
-    void GetClCdCn(const double &attack_angle_rad,
-                   const double &rudder_angle_rad,
-                   double &cl,
-                   double &cd,
-                   double &cn) const override;
+    unsigned int GetClCdCn(const double &attack_angle_rad,
+                           const double &rudder_angle_rad,
+                           double &cl,
+                           double &cd,
+                           double &cn,
+                           TableHints *hints = nullptr) const override;
+
+    void GetClCdCnBatch(std::size_t size,
+                        const double *attack_angle_rad,
+                        const double *rudder_angle_rad,
+                        double *cl,
+                        double *cd,
+                        double *cn,
+                        unsigned int *status) const override;
 
    private:
     void ParseRudderPerformanceCurveJsonString() override;
 
-   private:
-    mathutils::LookupTable2d<double> m_cl_cd_cn_coeffs;
+    void ReloadPerformanceCurves(const std::string &json_string, const std::string &curve_file) override;
+
+    /// Curves of the performance data, shared with the rudders built from the same data and options
+    std::shared_ptr<const FlapRudderCurves> LoadCurves(const std::string &json_string,
+                                                       const std::string &curve_file) const;
 
-    double m_max_flap_angle_rad;
-    double m_min_flap_angle_rad;
+    FlapRudderCurves BuildCurves(const std::string &json_string, const CurveFile *file) const;
+
+   private:
+    CurvePointer<FlapRudderCurves> m_curves;
 
   };
 
@@ -42,6 +80,18 @@ namespace acme {
                              std::vector<double> &cl,
                              std::vector<double> &cn);
 
+  /// Same as above, the table options being overridden by the "symmetric" json entry if any
+  void ParseFlapRudderJsonString(const std::string &json_string,
+                             std::vector<double> &attack_angle_rad,
+                             std::vector<double> &flap_angle_rad,
+                             std::vector<double> &cd,
+                             std::vector<double> &cl,
+                             std::vector<double> &cn,
+                             RudderTableOptions &options);
+
+  /// Performance data of a json string, angles in radians, as written in a curve file (see CurveFile)
+  CurveData FlapRudderCurveData(const std::string &json_string);
+
 }  // end namespace acme
 
 #endif //ACME_FLAPRUDDERMODEL_H
@@ -4,6 +4,8 @@
 
 #include "FujiiRudderModel.h"
 
+#include <algorithm>
+
 namespace acme {
 
   FujiiRudderModel::FujiiRudderModel(const acme::RudderParams params) : RudderBaseModel(params), m_f_alpha(0.) {
@@ -18,9 +20,9 @@ namespace acme {
 
   }
 
-  void
+  unsigned int
   FujiiRudderModel::GetClCdCn(const double &attack_angle_rad, const double &rudder_angle_rad, double &cl, double &cd,
-                              double &cn) const {
+                              double &cn, TableHints * /*hints*/) const {
 
     double salpha = std::sin(attack_angle_rad);
     double calpha = std::cos(attack_angle_rad);
@@ -28,6 +30,23 @@ namespace acme {
     cl = m_f_alpha * salpha * calpha;
     cn = 0.;
 
+    return E_STATUS_OK;
+  }
+
+  void FujiiRudderModel::GetClCdCnBatch(std::size_t size,
+                                        const double *attack_angle_rad,
+                                        const double *rudder_angle_rad,
+                                        double *cl,
+                                        double *cd,
+                                        double *cn,
+                                        unsigned int *status) const {
+    // Non virtual calls, inlined in the loop
+    for (std::size_t i = 0; i < size; i++) {
+      FujiiRudderModel::GetClCdCn(attack_angle_rad[i], rudder_angle_rad ? rudder_angle_rad[i] : 0.,
+                                  cl[i], cd[i], cn[i]);
+    }
+    // Analytical coefficients, defined for any attack angle
+    if (status) std::fill(status, status + size, E_STATUS_OK);
   }
 
 } // end namespace acme
\ No newline at end of file
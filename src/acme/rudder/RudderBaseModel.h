@@ -5,9 +5,17 @@
 #ifndef ACME_RUDDERBASEMODEL_H
 #define ACME_RUDDERBASEMODEL_H
 
+#include <cstddef>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "MathUtils/LookupTable1D.h"
+#include "acme/table/CurvePointer.h"
+#include "acme/table/InterpolationType.h"
+#include "acme/table/OutOfRangePolicy.h"
+#include "acme/table/TableAxis.h"
+#include "acme/table/TableSimplification.h"
 #include "MathUtils/Angles.h"
 
 #include "RudderModelType.h"
@@ -39,9 +47,35 @@ namespace acme {
 
     // Optional
 
-    // For Simple and Flap rudder models
+    // For Simple and Flap rudder models. Moved out of the parameters by the model constructor : the model and its copies
+    // share it until they are initialized, GetParameters returning an empty string
     std::string m_perf_data_json_string;
 
+    // For Simple and Flap rudder models : path of a binary curve file (see CurveFile), used instead of the json string
+    // when not empty. The tables then use the file mapped in memory in place when possible (no table simplification and
+    // no symmetric table).
+    std::string m_perf_data_curve_file;
+
+    // Interpolation of the 1D performance tables (Simple rudder), overridden by an "interpolation" entry in the json
+    InterpolationType m_table_interpolation = E_LINEAR;
+
+    // For Simple and Flap rudder models : if positive, redundant table nodes are removed at initialization, keeping
+    // the interpolation of cl, cd and cn (with the table interpolation) within this absolute tolerance of the original
+    // data
+    double m_table_simplification_tolerance = 0.;
+
+    // For Simple and Flap rudder models : store the performance tables in single precision (computations remain in
+    // double precision)
+    bool m_table_single_precision = false;
+
+    // For Simple and Flap rudder models : symmetric rudder section, only the positive attack angle half of the tables
+    // is stored (cl and cn being odd, cd even). Overridden by a "symmetric" entry in the json.
+    bool m_symmetric_table = false;
+    double m_symmetry_tolerance = 1E-3; // max absolute deviation of the coefficients from the symmetry
+
+    // For Simple and Flap rudder models : behaviour for attack or flap angles outside of the performance tables
+    OutOfRangePolicy m_out_of_range_policy = E_OUT_OF_RANGE_THROW;
+
     // For Flap rudder only
     double m_flap_slope = 0.; // only used for a flap rudder type
 
@@ -56,16 +90,101 @@ namespace acme {
 
   };
 
+  /// Operating point of a rudder
+  struct RudderInput {
+    double m_water_density;       // in kg/m**3
+    double m_u_NWU;               // rudder velocity with respect to water along the vessel x-axis (m/s)
+    double m_v_NWU;               // rudder velocity with respect to water along the vessel y-axis (m/s)
+    double m_rudder_angle_deg;
+    double m_u_ship_NWU = 0.;     // ship velocities, only used for the hull straightening of the transverse velocity
+    double m_v_ship_NWU = 0.;
+    double m_r_ship_NWU = 0.;
+    double m_x_r = 0.;            // longitudinal distance between the ship COG and the rudder
+    TableHints *m_hints = nullptr; // interval hints of the caller, may be null (see TableHints)
+  };
+
+  /// Rudder loads and kinematics at an operating point
+  struct RudderOutput {
+    double m_uRA = 0.;              // apparent longitudinal velocity at the rudder, hull influence included
+    double m_vRA = 0.;              // apparent lateral velocity at the rudder, hull influence included
+    double m_rudder_angle_rad = 0.;
+    double m_drift_angle_rad = 0.;
+    double m_attack_angle_rad = 0.;
+    double m_lift_N = 0.;
+    double m_drag_N = 0.;
+    double m_torque_Nm = 0.;        // at the rudder position
+    double m_fx_N = 0.;
+    double m_fy_N = 0.;
+    unsigned int m_status = E_STATUS_OK; // see ComputeStatus
+  };
+
+  /// Operating points of a batch of rudders sharing the same model, as arrays of m_size values (structure of arrays,
+  /// see RudderInput)
+  struct RudderBatchInput {
+    std::size_t m_size = 0;
+    const double *m_water_density = nullptr;
+    const double *m_u_NWU = nullptr;
+    const double *m_v_NWU = nullptr;
+    const double *m_rudder_angle_deg = nullptr;
+    const double *m_u_ship_NWU = nullptr;  // ship velocities and rudder position, only used (and then required) for
+    const double *m_v_ship_NWU = nullptr;  // the hull straightening of the transverse velocity
+    const double *m_r_ship_NWU = nullptr;
+    const double *m_x_r = nullptr;
+  };
+
+  /// Arrays receiving the results of a batch of rudders, each one with room for the batch size (see RudderOutput)
+  struct RudderBatchOutput {
+    double *m_uRA = nullptr;
+    double *m_vRA = nullptr;
+    double *m_rudder_angle_rad = nullptr;
+    double *m_drift_angle_rad = nullptr;
+    double *m_attack_angle_rad = nullptr;
+    double *m_lift_N = nullptr;
+    double *m_drag_N = nullptr;
+    double *m_torque_Nm = nullptr;
+    double *m_fx_N = nullptr;
+    double *m_fy_N = nullptr;
+    unsigned int *m_status = nullptr;  // optional, see ComputeStatus
+  };
+
+  /// Table settings that may be overridden by entries of the rudder performance json
+  struct RudderTableOptions {
+    InterpolationType m_interpolation = E_LINEAR; // "interpolation"
+    bool m_symmetric = false;                     // "symmetric"
+  };
+
   double compute_ITTC57_frictional_resistance_coefficient(double rudder_chord_m,
                                                           double mean_velocity_ms,
                                                           double nu_water = 1.15E-6);
 
+  /// Keep only the attack_angle >= 0 half of a symmetric rudder polar, after checking that cd is even and that cl and
+  /// cn are odd within tolerance. cl and cn are set to zero at zero attack angle.
+  /// \throws std::runtime_error if the polar has no node at zero attack angle, if a negative attack angle has no
+  /// positive counterpart or if the coefficients are not symmetric within tolerance
+  void FoldSymmetricRudderTable(std::vector<double> &attack_angle_rad,
+                                std::vector<double> &cd,
+                                std::vector<double> &cl,
+                                std::vector<double> &cn,
+                                double tolerance);
+
+  /// Same as above for flap rudders, the symmetry being cd(-a, -f) = cd(a, f), cl(-a, -f) = -cl(a, f) and
+  /// cn(-a, -f) = -cn(a, f). Every flap angle is kept for the attack_angle >= 0 half.
+  /// \param cd, cl, cn values with the flap angle varying fastest : cd[i * nb_flap_angles + j]
+  void FoldSymmetricRudderTable(std::vector<double> &attack_angle_rad,
+                                const std::vector<double> &flap_angle_rad,
+                                std::vector<double> &cd,
+                                std::vector<double> &cl,
+                                std::vector<double> &cn,
+                                double tolerance);
+
 
   class RudderBaseModel {
 
    public:
     explicit RudderBaseModel(const RudderParams &params);
 
+    virtual ~RudderBaseModel() = default;
+
     virtual void Initialize() = 0;
 
     void DefineLogMessages(hermes::Message* msg);
@@ -74,7 +193,24 @@ namespace acme {
 
     void Log(bool is_logged);
 
-    virtual void
+    /// Compute the model at an operating point.
+    /// The result only depends on the input : the model is not modified, so that a single initialized model may be
+    /// evaluated concurrently by any number of threads. Does not allocate on the heap.
+    /// Table lookups start from the interval hints of the input, owned by the caller (one per thread or per unit).
+    /// Attack angles outside of the performance data are handled according to RudderParams::m_out_of_range_policy, the
+    /// status of the output reporting them and the status counters of the model counting them.
+    /// \throws std::runtime_error if the model is not initialized
+    virtual RudderOutput Compute(const RudderInput &input) const;
+
+    /// Compute the model for a batch of rudders sharing this model definition, with the same results as Compute called
+    /// on every operating point.
+    /// The hull influence is evaluated as branchless loops over the batch, and the coefficients are obtained for the
+    /// whole batch at once (GetClCdCnBatch). The output arrays are also used as scratch memory : the call does not
+    /// allocate. Like Compute, it does not modify the model.
+    virtual void ComputeBatch(const RudderBatchInput &input, const RudderBatchOutput &output) const;
+
+    /// Compute the model with the specified data, the results being then available through the getters
+    void
     Compute(const double &water_density,
             const double &u_NWU,
             const double &v_NWU,
@@ -90,67 +226,131 @@ namespace acme {
 
     const RudderParams &GetParameters() const;
 
-    virtual void GetClCdCn(const double &attack_angle_rad,
-                           const double &rudder_angle_rad,
-                           double &cl,
-                           double &cd,
-                           double &cn) const=0;
+    /// Coefficients at an attack angle, inputs outside of the performance data being handled by the out of range policy
+    /// \param hints interval hints of the caller for the tabulated models, may be null (see TableHints)
+    /// \return the status of the lookup, see ComputeStatus
+    virtual unsigned int GetClCdCn(const double &attack_angle_rad,
+                                   const double &rudder_angle_rad,
+                                   double &cl,
+                                   double &cd,
+                                   double &cn,
+                                   TableHints *hints = nullptr) const=0;
+
+    /// Batch version of GetClCdCn. The default implementation calls GetClCdCn for every rudder, models override it to
+    /// avoid a virtual call per rudder.
+    /// \param rudder_angle_rad may be null, for a zero rudder angle as used by ComputeLoads
+    /// \param status statuses of the lookups, may be null when not wanted
+    virtual void GetClCdCnBatch(std::size_t size,
+                                const double *attack_angle_rad,
+                                const double *rudder_angle_rad,
+                                double *cl,
+                                double *cd,
+                                double *cn,
+                                unsigned int *status) const;
+
+    double GetFx() const { return c_output.m_fx_N; }
+
+    double GetFy() const { return c_output.m_fy_N; }
+
+    double GetMz() const { return c_output.m_torque_Nm; }
+
+    double GetDrag() const { return c_output.m_drag_N; }
+
+    double GetLift() const { return c_output.m_lift_N; }
 
-    double GetFx() const { return c_fx_N; }
+    double GetTorque() const { return c_output.m_torque_Nm; }
 
-    double GetFy() const { return c_fy_N; }
+    /// Results of the last call to Compute with the getters API
+    const RudderOutput &GetOutput() const { return c_output; }
 
-    double GetMz() const { return c_torque_Nm; }
+    /// Nodes removed from the performance table at initialization, see RudderParams::m_table_simplification_tolerance
+    const TableSimplificationReport &GetTableSimplificationReport() const { return m_table_simplification_report; }
 
-    double GetDrag() const { return c_drag_N; }
+    /// Number of out of range lookups in the performance data met since the initialization or the last reset
+    StatusCounts GetStatusCounts() const { return c_status_counters.Get(); }
 
-    double GetLift() const { return c_lift_N; }
+    void ResetStatusCounts() { c_status_counters.Reset(); }
 
-    double GetTorque() const { return c_torque_Nm; }
+    /// Replace the performance data of the initialized model, while other threads may be computing it.
+    /// The new curves are built by the calling thread with the table options of the model, then published with a single
+    /// atomic pointer swap : a concurrent Compute is never blocked and uses either the former or the new curves, never a
+    /// mix of both. The former curves are kept alive until ReleaseRetiredCurves. The parameters and the table
+    /// simplification report given by the model remain those of its initialization.
+    /// \param curve_file used instead of json_string when not empty, see RudderParams::m_perf_data_curve_file
+    /// \throws std::runtime_error for invalid data, the model keeping its curves, and for the models without
+    ///         performance data
+    void ReloadPerformanceData(const std::string &json_string, const std::string &curve_file = "");
+
+    /// Release the curves replaced by ReloadPerformanceData. Only to be called once every Compute started before the
+    /// last reload is done, for instance between two steps of a simulation.
+    /// \return the number of curve sets released
+    std::size_t ReleaseRetiredCurves() { return m_retired_curves.Release(); }
+
+    std::size_t GetNbRetiredCurves() const { return m_retired_curves.GetSize(); }
 
     double GetDriftAngle(mathutils::ANGLE_UNIT unit) const {
-      return unit == mathutils::DEG ? c_beta_R_rad * RAD2DEG : c_beta_R_rad;
+      return unit == mathutils::DEG ? c_output.m_drift_angle_rad * RAD2DEG : c_output.m_drift_angle_rad;
     }
 
     double GetAttackAngle(mathutils::ANGLE_UNIT unit) const {
-      return unit == mathutils::DEG ? c_alpha_R_rad * RAD2DEG : c_alpha_R_rad;
+      return unit == mathutils::DEG ? c_output.m_attack_angle_rad * RAD2DEG : c_output.m_attack_angle_rad;
     }
 
    protected:
 
+    /// \throws std::runtime_error if the model is not initialized
+    void CheckInitialized() const;
+
+    /// Json performance data given with the parameters, empty once released by the initialization
+    const std::string &GetPerformanceDataJsonString() const;
+
     /// Perform the model calculations
     /// \param water_density in kg/m**3
     /// \param uR_ms axial velocity with respect to water at the rudder location, including interaction effects in m/s
     /// \param vR_ms radial velocity with respect to water at the rudder location, including interaction effects in m/s
     /// \param alpha_R_rad rudder attack angle, in rad
-    void ComputeLoads(const double &water_density,
-                      const double &uR_ms,
-                      const double &vR_ms,
-                      const double &alpha_R_rad) const;
+    /// \param hints interval hints of the caller, may be null
+    /// \return velocities, angles and loads in the flow and body frames, the rudder angle being left to the caller
+    RudderOutput ComputeLoads(const double &water_density,
+                              const double &uR_ms,
+                              const double &vR_ms,
+                              const double &alpha_R_rad,
+                              TableHints *hints) const;
+
+    /// Batch version of ComputeLoads
+    /// \param output uRA, vRA and attack angles of the batch as input, loads and drift angles as output
+    void ComputeLoadsBatch(std::size_t size, const double *water_density, const RudderBatchOutput &output) const;
+
+    /// Build and publish the curves of new performance data, the former ones being added to m_retired_curves
+    /// \throws std::runtime_error, the default models having no performance data
+    virtual void ReloadPerformanceCurves(const std::string &json_string, const std::string &curve_file);
 
     bool m_is_initialized;
 
     RudderParams m_params;
 
+    // Json performance data of the parameters, until initialization. Shared by the copies of the model, so that the
+    // models copied from a single one (see MakeModels) hold one copy of them.
+    std::shared_ptr<const std::string> m_perf_data_json_string;
+
     RudderModelType m_type;
 
     double m_max_alpha_R_rad{};
     double m_min_alpha_R_rad{};
 
+    TableSimplificationReport m_table_simplification_report;
+
+    RetiredCurves m_retired_curves;
+
     bool m_is_logged;
 
-    mutable double c_rudder_angle_rad{};
-    mutable double c_beta_R_rad{};
-    mutable double c_alpha_R_rad{};
-    mutable double c_lift_N{};
-    mutable double c_drag_N{};
-    mutable double c_torque_Nm{};
-    mutable double c_fx_N{};
-    mutable double c_fy_N{};
+    // Last inputs and results of the getters API, for the getters and logs only
     mutable double c_u_NWU{};
     mutable double c_v_NWU{};
-    mutable double c_uRA{};
-    mutable double c_vRA{};
+    mutable RudderOutput c_output;
+    mutable TableHints c_hints;
+
+    mutable StatusCounters c_status_counters;
 
     template<class Rudder> friend class MMGPropellerRudder;
 
@@ -4,7 +4,9 @@
 
 #include "RudderBaseModel.h"
 
-#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
 #include <vector>
 #include <MathUtils/Angles.h>
 #include "MathUtils/Unit.h"
@@ -12,6 +14,28 @@
 
 namespace acme {
 
+  namespace {
+
+    /// Index of the node at -axis[i], the axis being sorted
+    std::size_t MirrorIndex(const std::vector<double> &axis, std::size_t i, const std::string &axis_name) {
+      auto it = std::lower_bound(axis.begin(), axis.end(), -axis[i] - 1E-9);
+      if (it == axis.end() || std::abs(*it + axis[i]) > 1E-9) {
+        throw std::runtime_error("Symmetric rudder table : no " + axis_name + " node at " +
+                                 std::to_string(-axis[i] * RAD2DEG) + " deg");
+      }
+      return it - axis.begin();
+    }
+
+    void CheckSymmetry(const std::string &name, double value, double mirror_value, double parity, double tolerance,
+                       double attack_angle_rad) {
+      if (std::abs(value - parity * mirror_value) > tolerance) {
+        throw std::runtime_error("Symmetric rudder table : " + name + " is not " + (parity > 0. ? "even" : "odd") +
+                                 " at attack angle " + std::to_string(attack_angle_rad * RAD2DEG) + " deg");
+      }
+    }
+
+  }  // end anonymous namespace
+
   double compute_ITTC57_frictional_resistance_coefficient(double rudder_chord_m,
                                                           double mean_velocity_ms,
                                                           double nu_water) {
@@ -24,92 +48,227 @@ namespace acme {
 
   RudderBaseModel::RudderBaseModel(const RudderParams &params) :
       m_params(params),
+      m_perf_data_json_string(std::make_shared<const std::string>(std::move(m_params.m_perf_data_json_string))),
       m_type(RudderModelType::E_SIMPLE_RUDDER),
       m_is_initialized(false),
       m_is_logged(false){
-
+    m_params.m_perf_data_json_string.clear();
   }
 
   void RudderBaseModel::Compute(const double &water_density,
-                                  const double &u_NWU,
-                                  const double &v_NWU,
-                                  const double &rudder_angle_deg,
-                                  const double &u_ship_NWU,
-                                  const double &v_ship_NWU,
-                                  const double &r_ship_NWU,
-                                  const double &x_r) const {
-
-    if (!m_is_initialized) {
-      std::cerr << "Rudder model MUST be initialized before being used." << std::endl;
-      exit(EXIT_FAILURE);
-    }
-
+                                const double &u_NWU,
+                                const double &v_NWU,
+                                const double &rudder_angle_deg,
+                                const double &u_ship_NWU,
+                                const double &v_ship_NWU,
+                                const double &r_ship_NWU,
+                                const double &x_r) const {
+    c_output = Compute(RudderInput{water_density, u_NWU, v_NWU, rudder_angle_deg,
+                                   u_ship_NWU, v_ship_NWU, r_ship_NWU, x_r, &c_hints});
     c_u_NWU = u_NWU;
     c_v_NWU = v_NWU;
+  }
 
-    c_uRA = u_NWU;
-    c_vRA = v_NWU;
+  RudderOutput RudderBaseModel::Compute(const RudderInput &input) const {
+
+    CheckInitialized();
+
+    double uRA = input.m_u_NWU;
+    double vRA = input.m_v_NWU;
 
     if (m_params.m_has_hull_influence) {
 
-      double sidewash_angle_0 = std::atan2(v_NWU, u_NWU); // ou drift_angle_0 pour calculer le wake fraction
+      double sidewash_angle_0 = std::atan2(input.m_v_NWU, input.m_u_NWU); // ou drift_angle_0 pour calculer le wake fraction
 
       // Estimated wake fraction
       double wr = m_params.m_hull_wake_fraction_0 * std::exp(-4. * sidewash_angle_0 * sidewash_angle_0);
 
-      c_uRA *= (1. - wr);
+      uRA *= (1. - wr);
 
       if (m_params.m_has_hull_influence_transverse_velocity) {
-        double beta_R = atan2(v_ship_NWU + 2*x_r*r_ship_NWU, u_ship_NWU);
+        double beta_R = atan2(input.m_v_ship_NWU + 2 * input.m_x_r * input.m_r_ship_NWU, input.m_u_ship_NWU);
         double kappa = HullStraighteningFunction(beta_R);
-        c_vRA *= kappa;
+        vRA *= kappa;
       };
 
     }
 
     // Drift angle
-    c_beta_R_rad = std::atan2(c_vRA, c_uRA);
+    double beta_R_rad = std::atan2(vRA, uRA);
 
     // Attack angle
-    c_rudder_angle_rad = rudder_angle_deg * MU_PI_180;
-    c_alpha_R_rad = c_rudder_angle_rad - c_beta_R_rad;
-    c_alpha_R_rad = mathutils::Normalize__PI_PI(c_alpha_R_rad);
+    double rudder_angle_rad = input.m_rudder_angle_deg * MU_PI_180;
+    double alpha_R_rad = mathutils::Normalize__PI_PI(rudder_angle_rad - beta_R_rad);
 
     // Get coefficients
-    ComputeLoads(water_density, c_uRA, c_vRA, c_alpha_R_rad);
+    auto output = ComputeLoads(input.m_water_density, uRA, vRA, alpha_R_rad, input.m_hints);
+    output.m_rudder_angle_rad = rudder_angle_rad;
 
     // Hull/rudder interactions
     if (m_params.m_has_hull_influence) {
-      c_torque_Nm += m_params.m_aH * (m_params.m_xH - m_params.m_xR) * c_fy_N;
-      c_fx_N *= (1. - m_params.m_tR);
-      c_fy_N *= (1. + m_params.m_aH);
+      output.m_torque_Nm += m_params.m_aH * (m_params.m_xH - m_params.m_xR) * output.m_fy_N;
+      output.m_fx_N *= (1. - m_params.m_tR);
+      output.m_fy_N *= (1. + m_params.m_aH);
     }
 
+    return output;
   }
 
-  void RudderBaseModel::ComputeLoads(const double &water_density,
-                                     const double &uR_ms,
-                                     const double &vR_ms,
-                                     const double &alpha_R_rad) const {
+  void RudderBaseModel::ComputeBatch(const RudderBatchInput &input, const RudderBatchOutput &output) const {
+
+    CheckInitialized();
+
+    auto size = input.m_size;
+    auto uRA = output.m_uRA;
+    auto vRA = output.m_vRA;
+
+    if (m_params.m_has_hull_influence) {
+      auto wr0 = m_params.m_hull_wake_fraction_0;
+      for (std::size_t i = 0; i < size; i++) {
+        double sidewash_angle_0 = std::atan2(input.m_v_NWU[i], input.m_u_NWU[i]);
+        double wr = wr0 * std::exp(-4. * sidewash_angle_0 * sidewash_angle_0);
+        uRA[i] = input.m_u_NWU[i] * (1. - wr);
+      }
+
+      if (m_params.m_has_hull_influence_transverse_velocity) {
+        if (!input.m_u_ship_NWU || !input.m_v_ship_NWU || !input.m_r_ship_NWU || !input.m_x_r) {
+          throw std::invalid_argument("Rudder batch : ship velocities and rudder positions are required for the hull "
+                                      "straightening of the transverse velocity");
+        }
+        for (std::size_t i = 0; i < size; i++) {
+          double beta_R = std::atan2(input.m_v_ship_NWU[i] + 2 * input.m_x_r[i] * input.m_r_ship_NWU[i],
+                                     input.m_u_ship_NWU[i]);
+          vRA[i] = input.m_v_NWU[i] * HullStraighteningFunction(beta_R);
+        }
+      } else {
+        std::copy(input.m_v_NWU, input.m_v_NWU + size, vRA);
+      }
+
+    } else {
+      std::copy(input.m_u_NWU, input.m_u_NWU + size, uRA);
+      std::copy(input.m_v_NWU, input.m_v_NWU + size, vRA);
+    }
+
+    // Rudder and attack angles
+    for (std::size_t i = 0; i < size; i++) {
+      double beta_R_rad = std::atan2(vRA[i], uRA[i]);
+      double rudder_angle_rad = input.m_rudder_angle_deg[i] * MU_PI_180;
+      output.m_rudder_angle_rad[i] = rudder_angle_rad;
+      output.m_attack_angle_rad[i] = mathutils::Normalize__PI_PI(rudder_angle_rad - beta_R_rad);
+    }
+
+    ComputeLoadsBatch(size, input.m_water_density, output);
+
+    // Hull/rudder interactions
+    if (m_params.m_has_hull_influence) {
+      double torque_factor = m_params.m_aH * (m_params.m_xH - m_params.m_xR);
+      for (std::size_t i = 0; i < size; i++) {
+        output.m_torque_Nm[i] += torque_factor * output.m_fy_N[i];
+        output.m_fx_N[i] *= (1. - m_params.m_tR);
+        output.m_fy_N[i] *= (1. + m_params.m_aH);
+      }
+    }
+  }
+
+  void RudderBaseModel::ComputeLoadsBatch(std::size_t size,
+                                          const double *water_density,
+                                          const RudderBatchOutput &output) const {
+
+    // Coefficients, held in the lift, drag and torque arrays until the loads are computed
+    auto cl = output.m_lift_N;
+    auto cd = output.m_drag_N;
+    auto cn = output.m_torque_Nm;
+    GetClCdCnBatch(size, output.m_attack_angle_rad, nullptr, cl, cd, cn, output.m_status);
+
+    auto area = m_params.m_lateral_area_m2;
+    auto chord = m_params.m_chord_m;
+    for (std::size_t i = 0; i < size; i++) {
+      double uR = output.m_uRA[i];
+      double vR = output.m_vRA[i];
+
+      // Forces in flow frame
+      double q = 0.5 * water_density[i] * (uR * uR + vR * vR);
+      double drag = q * cd[i] * area;
+      double lift = q * cl[i] * area;
+      output.m_torque_Nm[i] = q * cn[i] * area * chord;
+      output.m_drag_N[i] = drag;
+      output.m_lift_N[i] = lift;
+
+      // Forces in body frame
+      double drift_angle_rad = std::atan2(vR, uR);
+      double Cbeta = std::cos(drift_angle_rad);
+      double Sbeta = std::sin(drift_angle_rad);
+      output.m_drift_angle_rad[i] = drift_angle_rad;
+      output.m_fx_N[i] = Cbeta * drag - Sbeta * lift;
+      output.m_fy_N[i] = Sbeta * drag + Cbeta * lift;
+    }
+  }
+
+  void RudderBaseModel::GetClCdCnBatch(std::size_t size,
+                                       const double *attack_angle_rad,
+                                       const double *rudder_angle_rad,
+                                       double *cl,
+                                       double *cd,
+                                       double *cn,
+                                       unsigned int *status) const {
+    TableHints hints;
+    for (std::size_t i = 0; i < size; i++) {
+      auto status_i = GetClCdCn(attack_angle_rad[i], rudder_angle_rad ? rudder_angle_rad[i] : 0.,
+                                cl[i], cd[i], cn[i], &hints);
+      if (status) status[i] = status_i;
+    }
+  }
+
+  RudderOutput RudderBaseModel::ComputeLoads(const double &water_density,
+                                             const double &uR_ms,
+                                             const double &vR_ms,
+                                             const double &alpha_R_rad,
+                                             TableHints *hints) const {
+
+    RudderOutput output;
+    output.m_uRA = uR_ms;
+    output.m_vRA = vR_ms;
+    output.m_attack_angle_rad = alpha_R_rad;
 
     // Get coefficients
     double cl, cd, cn;
-    GetClCdCn(alpha_R_rad, 0., cl, cd, cn);
+    output.m_status = GetClCdCn(alpha_R_rad, 0., cl, cd, cn, hints);
 
     // Forces in flow frame
     double q = 0.5 * water_density * (uR_ms * uR_ms + vR_ms * vR_ms); // stagnation pressure at rudder position
-    c_drag_N = q * cd * m_params.m_lateral_area_m2;
-    c_lift_N = q * cl * m_params.m_lateral_area_m2;
-    c_torque_Nm = q * cn * m_params.m_lateral_area_m2 * m_params.m_chord_m;
+    output.m_drag_N = q * cd * m_params.m_lateral_area_m2;
+    output.m_lift_N = q * cl * m_params.m_lateral_area_m2;
+    output.m_torque_Nm = q * cn * m_params.m_lateral_area_m2 * m_params.m_chord_m;
 
     // Forces in body frame
-    auto beta_R_rad = std::atan2(vR_ms, uR_ms);
-    double Cbeta = std::cos(beta_R_rad);
-    double Sbeta = std::sin(beta_R_rad);
+    output.m_drift_angle_rad = std::atan2(vR_ms, uR_ms);
+    double Cbeta = std::cos(output.m_drift_angle_rad);
+    double Sbeta = std::sin(output.m_drift_angle_rad);
 
-    c_fx_N = Cbeta * c_drag_N - Sbeta * c_lift_N;
-    c_fy_N = Sbeta * c_drag_N + Cbeta * c_lift_N;
+    output.m_fx_N = Cbeta * output.m_drag_N - Sbeta * output.m_lift_N;
+    output.m_fy_N = Sbeta * output.m_drag_N + Cbeta * output.m_lift_N;
 
+    return output;
+  }
+
+  void RudderBaseModel::ReloadPerformanceData(const std::string &json_string, const std::string &curve_file) {
+    CheckInitialized();
+    ReloadPerformanceCurves(json_string, curve_file);
+  }
+
+  void RudderBaseModel::ReloadPerformanceCurves(const std::string &, const std::string &) {
+    throw std::runtime_error("Rudder model without performance data, nothing to reload");
+  }
+
+  const std::string &RudderBaseModel::GetPerformanceDataJsonString() const {
+    static const std::string no_data;
+    return m_perf_data_json_string ? *m_perf_data_json_string : no_data;
+  }
+
+  void RudderBaseModel::CheckInitialized() const {
+    if (!m_is_initialized) {
+      throw std::runtime_error("Rudder model MUST be initialized before being used.");
+    }
   }
 
   RudderModelType RudderBaseModel::GetRudderModelType() const {
@@ -131,25 +290,25 @@ namespace acme {
     msg->AddField<double>("v_NWU", "m/s", "vessel lateral velocity",
                           [this](){return c_v_NWU;});
     msg->AddField<double>("uRA", "m/s", "apparent longitudinal velocity of the rudder",
-                          [this](){return c_uRA;});
+                          [this](){return c_output.m_uRA;});
     msg->AddField<double>("vRA", "m/s", "apparent lateral velocity of the rudder",
-                          [this](){return c_vRA;});
+                          [this](){return c_output.m_vRA;});
     msg->AddField<double>("rudder_angle", "deg", "rudder deflection angle, in degrees",
-                          [this](){return c_rudder_angle_rad * RAD2DEG;});
+                          [this](){return c_output.m_rudder_angle_rad * RAD2DEG;});
     msg->AddField<double>("attack_angle", "deg", "attack angle at the rudder, in degrees",
-                          [this](){return c_alpha_R_rad * RAD2DEG;});
+                          [this](){return c_output.m_attack_angle_rad * RAD2DEG;});
     msg->AddField<double>("drift_angle", "deg", "rudder drift angle, in degrees",
-                          [this](){return c_alpha_R_rad * RAD2DEG;});
+                          [this](){return c_output.m_attack_angle_rad * RAD2DEG;});
     msg->AddField<double>("drag", "N", "drag force induced by the rudder",
-                          [this](){return c_drag_N;});
+                          [this](){return c_output.m_drag_N;});
     msg->AddField<double>("lift", "N", "lift force induced by the rudder",
-                          [this](){return c_lift_N;});
+                          [this](){return c_output.m_lift_N;});
     msg->AddField<double>("fx", "N", "longitudinal force induced by the rudder",
-                          [this](){return c_fx_N;});
+                          [this](){return c_output.m_fx_N;});
     msg->AddField<double>("fy", "N", "lateral force induced by the rudder",
-                          [this](){return c_fy_N;});
+                          [this](){return c_output.m_fy_N;});
     msg->AddField<double>("torque", "Nm", "torque induced by the rudder, at the rudder position",
-                          [this](){return c_torque_Nm;});
+                          [this](){return c_output.m_torque_Nm;});
 
   }
 
@@ -174,13 +333,73 @@ namespace acme {
     double bv = (1-K2)/(beta_2 - beta_1);
     double av = K2 - bv * beta_1;
 
-    double kappa;
-    if (abs(beta) < beta_1)
-      kappa = std::min(K2, K3 * abs(beta));
-    else if (abs(beta)>beta_2)
-      kappa = 1.;
-    else
-      kappa = av + bv * abs(beta);
+    // Written with selects rather than branches, so that batch loops calling it may be vectorized
+    double abs_beta = std::abs(beta);
+    double kappa = av + bv * abs_beta;
+    kappa = (abs_beta > beta_2) ? 1. : kappa;
+    kappa = (abs_beta < beta_1) ? std::min(K2, K3 * abs_beta) : kappa;
     return kappa;
   }
+
+  void FoldSymmetricRudderTable(std::vector<double> &attack_angle_rad,
+                                std::vector<double> &cd,
+                                std::vector<double> &cl,
+                                std::vector<double> &cn,
+                                double tolerance) {
+    FoldSymmetricRudderTable(attack_angle_rad, {0.}, cd, cl, cn, tolerance);
+  }
+
+  void FoldSymmetricRudderTable(std::vector<double> &attack_angle_rad,
+                                const std::vector<double> &flap_angle_rad,
+                                std::vector<double> &cd,
+                                std::vector<double> &cl,
+                                std::vector<double> &cn,
+                                double tolerance) {
+
+    auto nf = flap_angle_rad.size();
+
+    auto zero = std::find_if(attack_angle_rad.begin(), attack_angle_rad.end(),
+                             [](double a) { return std::abs(a) <= 1E-9; });
+    if (zero == attack_angle_rad.end()) {
+      throw std::runtime_error("Symmetric rudder table : no node at zero attack angle");
+    }
+    auto i0 = std::size_t(zero - attack_angle_rad.begin());
+
+    std::vector<std::size_t> flap_mirror(nf);
+    for (std::size_t j = 0; j < nf; j++) flap_mirror[j] = MirrorIndex(flap_angle_rad, j, "flap angle");
+
+    // Negative attack angles against their positive counterparts
+    for (std::size_t i = 0; i < i0; i++) {
+      auto im = MirrorIndex(attack_angle_rad, i, "attack angle");
+      for (std::size_t j = 0; j < nf; j++) {
+        auto k = i * nf + j;
+        auto km = im * nf + flap_mirror[j];
+        CheckSymmetry("cd", cd[k], cd[km], 1., tolerance, attack_angle_rad[i]);
+        CheckSymmetry("cl", cl[k], cl[km], -1., tolerance, attack_angle_rad[i]);
+        CheckSymmetry("cn", cn[k], cn[km], -1., tolerance, attack_angle_rad[i]);
+      }
+    }
+
+    // Zero attack angle is its own mirror : the odd coefficients are made exactly odd, so that the reconstructed
+    // curves are continuous at zero
+    std::vector<double> cd0(nf), cl0(nf), cn0(nf);
+    for (std::size_t j = 0; j < nf; j++) {
+      auto k = i0 * nf + j;
+      auto km = i0 * nf + flap_mirror[j];
+      CheckSymmetry("cd", cd[k], cd[km], 1., tolerance, 0.);
+      CheckSymmetry("cl", cl[k], cl[km], -1., tolerance, 0.);
+      CheckSymmetry("cn", cn[k], cn[km], -1., tolerance, 0.);
+      cd0[j] = 0.5 * (cd[k] + cd[km]);
+      cl0[j] = 0.5 * (cl[k] - cl[km]);
+      cn0[j] = 0.5 * (cn[k] - cn[km]);
+    }
+    std::copy(cd0.begin(), cd0.end(), cd.begin() + i0 * nf);
+    std::copy(cl0.begin(), cl0.end(), cl.begin() + i0 * nf);
+    std::copy(cn0.begin(), cn0.end(), cn.begin() + i0 * nf);
+
+    // Positive half only
+    attack_angle_rad.erase(attack_angle_rad.begin(), attack_angle_rad.begin() + i0);
+    for (auto coeff : {&cd, &cl, &cn}) coeff->erase(coeff->begin(), coeff->begin() + i0 * nf);
+  }
+
 }  // end namespace acme
@@ -4,18 +4,14 @@
 
 #include "SimpleRudderModel.h"
 
-#include <iostream>
 #include <vector>
-#include <nlohmann/json.hpp>
 #include "MathUtils/Unit.h"
-
-using json = nlohmann::json;
+#include "acme/table/PerformanceDataParser.h"
 
 namespace acme {
 
   SimpleRudderModel::SimpleRudderModel(const RudderParams &params) :
-  RudderBaseModel(params),
-  m_cl_cd_cn_coeffs(mathutils::LINEAR){
+  RudderBaseModel(params) {
 
   }
 
@@ -24,37 +20,142 @@ namespace acme {
     m_is_initialized = true;
   }
 
-  void SimpleRudderModel::GetClCdCn(const double &attack_angle_rad,
-                                    const double &rudder_angle_rad,
-                                    double &cl,
-                                    double &cd,
-                                    double &cn) const {
-
-    try {
-      cl = m_cl_cd_cn_coeffs.Eval("cl", attack_angle_rad);
-      cd = m_cl_cd_cn_coeffs.Eval("cd", attack_angle_rad);
-      cn = m_cl_cd_cn_coeffs.Eval("cn", attack_angle_rad);
-    } catch (std::exception &e) {
-      std::cerr << "SimpleRudder : attack angle exceed interpolator range : " << e.what() << std::endl;
-      exit(EXIT_FAILURE);
-    }
+  unsigned int SimpleRudderModel::GetClCdCn(const double &attack_angle_rad,
+                                            const double &rudder_angle_rad,
+                                            double &cl,
+                                            double &cd,
+                                            double &cn,
+                                            TableHints *hints) const {
+
+    const auto &curves = *m_curves;
+
+    // Symmetric tables only hold positive attack angles : cl and cn are odd, cd is even
+    double sign = (curves.m_options.m_symmetric && attack_angle_rad < 0.) ? -1. : 1.;
+
+    // Single search on the attack angle axis for the three coefficients
+    auto policy = m_params.m_out_of_range_policy;
+    bool is_out_of_range;
+    AxisHint hint;
+    auto interval = curves.m_cl_cd_cn_coeffs.Locate(sign * attack_angle_rad, hints ? hints->m_x : hint,
+                                                    policy == E_OUT_OF_RANGE_EXTRAPOLATE, is_out_of_range);
+    cl = sign * curves.m_cl_cd_cn_coeffs.Eval(interval, curves.m_cl_column);
+    cd = curves.m_cl_cd_cn_coeffs.Eval(interval, curves.m_cd_column);
+    cn = sign * curves.m_cl_cd_cn_coeffs.Eval(interval, curves.m_cn_column);
+    if (!is_out_of_range) return E_STATUS_OK;
+    return HandleOutOfRange(policy, c_status_counters, "SimpleRudderModel : attack angle (rad)", attack_angle_rad,
+                            {&cl, &cd, &cn});
   }
 
+  void SimpleRudderModel::GetClCdCnBatch(std::size_t size,
+                                         const double *attack_angle_rad,
+                                         const double *rudder_angle_rad,
+                                         double *cl,
+                                         double *cd,
+                                         double *cn,
+                                         unsigned int *status) const {
+    // Non virtual calls, inlined in the loop
+    TableHints hints;
+    for (std::size_t i = 0; i < size; i++) {
+      auto status_i = SimpleRudderModel::GetClCdCn(attack_angle_rad[i], rudder_angle_rad ? rudder_angle_rad[i] : 0.,
+                                                   cl[i], cd[i], cn[i], &hints);
+      if (status) status[i] = status_i;
+    }
+  }
 
   void SimpleRudderModel::ParseRudderPerformanceCurveJsonString() {
 
+    m_curves = LoadCurves(GetPerformanceDataJsonString(), m_params.m_perf_data_curve_file);
+    m_perf_data_json_string.reset();
+
+    m_params.m_table_interpolation = m_curves->m_options.m_interpolation;
+    m_params.m_symmetric_table = m_curves->m_options.m_symmetric;
+    m_min_alpha_R_rad = m_curves->m_min_attack_angle_rad;
+    m_max_alpha_R_rad = m_curves->m_max_attack_angle_rad;
+    m_table_simplification_report = m_curves->m_table_simplification_report;
+
+  }
+
+  void SimpleRudderModel::ReloadPerformanceCurves(const std::string &json_string, const std::string &curve_file) {
+    m_retired_curves.Add(m_curves.Publish(LoadCurves(json_string, curve_file)));
+  }
+
+  std::shared_ptr<const SimpleRudderCurves> SimpleRudderModel::LoadCurves(const std::string &json_string,
+                                                                          const std::string &curve_file) const {
+    // Rudders built from the same data share the same curves
+    auto key = CurveRegistryKey("SimpleRudder", {double(m_params.m_table_interpolation),
+                                                 m_params.m_table_simplification_tolerance,
+                                                 double(m_params.m_table_single_precision),
+                                                 double(m_params.m_symmetric_table),
+                                                 m_params.m_symmetry_tolerance},
+                                json_string, curve_file);
+    return CurveRegistry::GetInstance().Get<SimpleRudderCurves>(key, [&]() {
+      auto file = curve_file.empty() ? nullptr : CurveFile::Open(curve_file);
+      return BuildCurves(json_string, file.get());
+    });
+  }
+
+  SimpleRudderCurves SimpleRudderModel::BuildCurves(const std::string &json_string,
+                                                    const CurveFile *file) const {
+
     std::vector<double> attack_angle_rad, cd, cl, cn;
 
-    ParseRudderJsonString(m_params.m_perf_data_json_string, attack_angle_rad, cd, cl, cn);
+    SimpleRudderCurves curves;
+    auto &options = curves.m_options;
+    options.m_interpolation = m_params.m_table_interpolation;
+    options.m_symmetric = m_params.m_symmetric_table;
+
+    if (file) {
+      file->CheckModel("SimpleRudder");
+      options.m_interpolation = InterpolationType(file->GetOption("interpolation", options.m_interpolation));
+      options.m_symmetric = file->GetOption("symmetric", options.m_symmetric) != 0.;
+
+      if (!options.m_symmetric && m_params.m_table_simplification_tolerance <= 0.) {
+        // Table used in place in the mapped file
+        auto &table = curves.m_cl_cd_cn_coeffs;
+        table.SetInterpolation(options.m_interpolation);
+        table.SetSinglePrecision(m_params.m_table_single_precision);
+        file->SetTable(table);
+        curves.m_cd_column = table.GetColumnHandle("cd");
+        curves.m_cl_column = table.GetColumnHandle("cl");
+        curves.m_cn_column = table.GetColumnHandle("cn");
+        curves.m_min_attack_angle_rad = table.GetAxis().GetMin();
+        curves.m_max_attack_angle_rad = table.GetAxis().GetMax();
+        return curves;
+      }
 
-    m_cl_cd_cn_coeffs.SetX(attack_angle_rad);
-    m_cl_cd_cn_coeffs.AddY("cd", cd);
-    m_cl_cd_cn_coeffs.AddY("cl", cl);
-    m_cl_cd_cn_coeffs.AddY("cn", cn);
-//    m_cl_cd_cn_coeffs.PermissiveOFF();
-    m_min_alpha_R_rad = *std::min_element(attack_angle_rad.begin(), attack_angle_rad.end());
-    m_max_alpha_R_rad = *std::max_element(attack_angle_rad.begin(), attack_angle_rad.end());
+      attack_angle_rad = file->GetAxis(0);
+      cd = file->GetColumn("cd");
+      cl = file->GetColumn("cl");
+      cn = file->GetColumn("cn");
+    } else {
+      ParseRudderJsonString(json_string, attack_angle_rad, cd, cl, cn, options);
+    }
 
+    // Mirrored as an even cd, odd cl and cn, for the cubic slopes at zero attack angle to be those of the whole table
+    std::vector<double> mirror_parities;
+    if (options.m_symmetric) {
+      FoldSymmetricRudderTable(attack_angle_rad, cd, cl, cn, m_params.m_symmetry_tolerance);
+      mirror_parities = {1., -1., -1.};
+    }
+
+    if (m_params.m_table_simplification_tolerance > 0.) {
+      curves.m_table_simplification_report = SimplifyTable1D(attack_angle_rad, {&cd, &cl, &cn},
+                                                             m_params.m_table_simplification_tolerance,
+                                                             options.m_interpolation, mirror_parities);
+    }
+
+    curves.m_cl_cd_cn_coeffs.SetX(attack_angle_rad);
+    curves.m_cl_cd_cn_coeffs.SetInterpolation(options.m_interpolation);
+    curves.m_cl_cd_cn_coeffs.SetSinglePrecision(m_params.m_table_single_precision);
+    curves.m_cd_column = curves.m_cl_cd_cn_coeffs.AddY("cd", cd);
+    curves.m_cl_column = curves.m_cl_cd_cn_coeffs.AddY("cl", cl);
+    curves.m_cn_column = curves.m_cl_cd_cn_coeffs.AddY("cn", cn);
+    if (options.m_symmetric) curves.m_cl_cd_cn_coeffs.SetMirrorParities(mirror_parities);
+//    m_cl_cd_cn_coeffs.PermissiveOFF();
+    curves.m_max_attack_angle_rad = *std::max_element(attack_angle_rad.begin(), attack_angle_rad.end());
+    curves.m_min_attack_angle_rad = options.m_symmetric ? -curves.m_max_attack_angle_rad :
+                                    *std::min_element(attack_angle_rad.begin(), attack_angle_rad.end());
+    return curves;
   }
 
   void ParseRudderJsonString(const std::string &json_string,
@@ -62,66 +163,57 @@ namespace acme {
                              std::vector<double> &cd,
                              std::vector<double> &cl,
                              std::vector<double> &cn) {
+    RudderTableOptions options;
+    ParseRudderJsonString(json_string, attack_angle_rad, cd, cl, cn, options);
+  }
 
-    json node = json::parse(json_string);
-    unsigned int n;
+  namespace {
 
-    try {
-      attack_angle_rad = node["angle_of_attack_deg"].get<std::vector<double>>();
-      n = attack_angle_rad.size();
-      if (!std::is_sorted(attack_angle_rad.begin(), attack_angle_rad.end()))
-        throw std::runtime_error("SimpleRudderModel parser : angle_of_attack_deg not sorted");
-      for (auto &angle:attack_angle_rad) {
-        angle *= DEG2RAD;
-      }
-    } catch (json::parse_error &err) {
-      std::cerr << "SimpleRudderModel parser : no angle_of_attack_deg in load_coefficients";
-      exit(EXIT_FAILURE);
-    } catch (const std::exception &d) {
-      std::cerr << d.what();
-      exit(EXIT_FAILURE);
-    }
+    void ParseRudderPerformanceData(PerformanceDataParser &parser, const std::string &json_string,
+                                    std::vector<double> &attack_angle_rad, std::vector<double> &cd,
+                                    std::vector<double> &cl, std::vector<double> &cn, RudderTableOptions &options) {
+      std::string interpolation;
+      parser.AddOption("interpolation", interpolation);
+      parser.AddOption("symmetric", options.m_symmetric);
+      parser.AddAxis("angle_of_attack_deg", attack_angle_rad, DEG2RAD);
+      parser.AddArray("cd", cd, "angle_of_attack_deg");
+      parser.AddArray("cl", cl, "angle_of_attack_deg");
+      parser.AddArray("cn", cn, "angle_of_attack_deg", false);
+      parser.Parse(json_string);
 
-    try {
-      cd = node["cd"].get<std::vector<double>>();
-      if (cd.size() != n)
-        throw std::runtime_error(
-            "SimpleRudderModel parser : cd not covering all angle_of_attack_deg range");
-    } catch (json::parse_error &err) {
-      std::cerr << "SimpleRudderModel parser : no cd in load_coefficients";
-      exit(EXIT_FAILURE);
-    } catch (const std::exception &d) {
-      std::cerr << d.what();
-      exit(EXIT_FAILURE);
-    }
+      if (parser.Has("interpolation")) options.m_interpolation = ParseInterpolationType(interpolation);
 
-    try {
-      cl = node["cl"].get<std::vector<double>>();
-      if (cl.size() != n)
-        throw std::runtime_error(
-            "SimpleRudderModel parser : cl not covering all angle_of_attack_deg range");
-    } catch (json::parse_error &err) {
-      std::cerr << "SimpleRudderModel parser : no cl in load_coefficients";
-      exit(EXIT_FAILURE);
-    } catch (const std::exception &d) {
-      std::cerr << d.what();
-      exit(EXIT_FAILURE);
+      // cn is optional, zero if not given
+      if (!parser.Has("cn")) cn.assign(attack_angle_rad.size(), 0.);
     }
 
-    try {
-      cn = node["cn"].get<std::vector<double>>();
-      if (cl.size() != n)
-        throw std::runtime_error(
-            "SimpleRudderModel parser : cn not covering all angle_of_attack_deg range");
-    } catch (json::parse_error &err) {
-      std::cerr << "SimpleRudderModel parser : no cn in load_coefficients. Set zeros";
-      cn = std::vector<double>(cd.size(), 0.0); // Fill cn with 0, not loaded from json ...
-    } catch (const std::exception &d) {
-      std::cerr << d.what();
-      exit(EXIT_FAILURE);
-    }
+  }  // end anonymous namespace
 
+  void ParseRudderJsonString(const std::string &json_string,
+                             std::vector<double> &attack_angle_rad,
+                             std::vector<double> &cd,
+                             std::vector<double> &cl,
+                             std::vector<double> &cn,
+                             RudderTableOptions &options) {
+    PerformanceDataParser parser("SimpleRudderModel parser");
+    ParseRudderPerformanceData(parser, json_string, attack_angle_rad, cd, cl, cn, options);
+  }
 
+  CurveData SimpleRudderCurveData(const std::string &json_string) {
+    std::vector<double> attack_angle_rad, cd, cl, cn;
+    RudderTableOptions options;
+    PerformanceDataParser parser("SimpleRudderModel parser");
+    ParseRudderPerformanceData(parser, json_string, attack_angle_rad, cd, cl, cn, options);
+
+    CurveData data;
+    data.m_model = "SimpleRudder";
+    data.m_axes = {{"attack_angle_rad", attack_angle_rad}};
+    data.m_columns = {{"cd", cd}, {"cl", cl}, {"cn", cn}};
+
+    // Only the options given in the json override the rudder parameters
+    if (parser.Has("interpolation")) data.m_options["interpolation"] = options.m_interpolation;
+    if (parser.Has("symmetric")) data.m_options["symmetric"] = options.m_symmetric;
+    return data;
   }
 
-}  // end namespace acme
\ No newline at end of file
+}  // end namespace acme
@@ -5,11 +5,15 @@
 #ifndef ACME_SIMPLERUDDERMODEL_H
 #define ACME_SIMPLERUDDERMODEL_H
 
+#include <memory>
 #include <string>
 
 #include "RudderBaseModel.h"
 
-#include "MathUtils/LookupTable1D.h"
+#include "acme/table/PerformanceTable1D.h"
+#include "acme/table/CurveRegistry.h"
+#include "acme/table/CurvePointer.h"
+#include "acme/table/CurveFile.h"
 #include "MathUtils/Angles.h"
 
 #include "RudderModelType.h"
@@ -17,6 +21,24 @@
 namespace acme {
 
 
+  /// Performance curves of a simple rudder, shared by the rudders built from the same data (see CurveRegistry)
+  struct SimpleRudderCurves {
+    PerformanceTable1D m_cl_cd_cn_coeffs;
+    ColumnHandle m_cl_column = 0;
+    ColumnHandle m_cd_column = 0;
+    ColumnHandle m_cn_column = 0;
+
+    RudderTableOptions m_options; // as resolved from the parameters and the json
+
+    double m_min_attack_angle_rad = 0.;
+    double m_max_attack_angle_rad = 0.;
+
+    TableSimplificationReport m_table_simplification_report;
+
+    std::size_t GetMemoryUsage() const { return m_cl_cd_cn_coeffs.GetMemoryUsage(); }
+  };
+
+
   class SimpleRudderModel: public RudderBaseModel {
 
    public:
@@ -24,18 +46,35 @@ namespace acme {
 
     void Initialize() override;
 
-    virtual void GetClCdCn(const double &attack_angle_rad,
-                           const double &rudder_angle_rad,
-                           double &cl,
-                           double &cd,
-                           double &cn) const;
+    virtual unsigned int GetClCdCn(const double &attack_angle_rad,
+                                   const double &rudder_angle_rad,
+                                   double &cl,
+                                   double &cd,
+                                   double &cn,
+                                   TableHints *hints = nullptr) const;
+
+    void GetClCdCnBatch(std::size_t size,
+                        const double *attack_angle_rad,
+                        const double *rudder_angle_rad,
+                        double *cl,
+                        double *cd,
+                        double *cn,
+                        unsigned int *status) const override;
 
    private:
 
     virtual void ParseRudderPerformanceCurveJsonString();
 
+    void ReloadPerformanceCurves(const std::string &json_string, const std::string &curve_file) override;
+
+    /// Curves of the performance data, shared with the rudders built from the same data and options
+    std::shared_ptr<const SimpleRudderCurves> LoadCurves(const std::string &json_string,
+                                                         const std::string &curve_file) const;
+
+    SimpleRudderCurves BuildCurves(const std::string &json_string, const CurveFile *file) const;
+
    private:
-    mathutils::LookupTable1D<double, double> m_cl_cd_cn_coeffs;
+    CurvePointer<SimpleRudderCurves> m_curves;
 
   };
 
@@ -45,6 +84,16 @@ namespace acme {
                              std::vector<double> &cl,
                              std::vector<double> &cn);
 
+  /// Same as above, the table options being overridden by the "interpolation" and "symmetric" json entries if any
+  void ParseRudderJsonString(const std::string &json_string,
+                             std::vector<double> &attack_angle_rad,
+                             std::vector<double> &cd,
+                             std::vector<double> &cl,
+                             std::vector<double> &cn,
+                             RudderTableOptions &options);
+
+  /// Performance data of a json string, attack angles in radians, as written in a curve file (see CurveFile)
+  CurveData SimpleRudderCurveData(const std::string &json_string);
 
 }  // end namespace acme
 
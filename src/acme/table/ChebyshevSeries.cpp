@@ -0,0 +1,94 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#include "ChebyshevSeries.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <Eigen/Dense>
+
+namespace acme {
+
+  ColumnHandle ChebyshevSeries::Fit(const std::string &name,
+                                    const std::vector<double> &x,
+                                    const std::vector<double> &y,
+                                    unsigned int degree) {
+
+    if (std::find(m_names.begin(), m_names.end(), name) != m_names.end()) {
+      throw std::runtime_error("ChebyshevSeries : curve " + name + " already defined");
+    }
+    if (x.size() != y.size()) {
+      throw std::runtime_error("ChebyshevSeries : curve " + name + " has " + std::to_string(y.size()) +
+                               " values for " + std::to_string(x.size()) + " abscissae");
+    }
+    if (x.size() < degree + 1) {
+      throw std::runtime_error("ChebyshevSeries : " + std::to_string(x.size()) + " points are not enough to fit " +
+                               name + " with degree " + std::to_string(degree));
+    }
+
+    auto minmax = std::minmax_element(x.begin(), x.end());
+    if (m_names.empty()) {
+      m_min = *minmax.first;
+      m_max = *minmax.second;
+      if (m_max <= m_min) {
+        throw std::runtime_error("ChebyshevSeries : curve " + name + " is defined on an empty interval");
+      }
+    } else if (*minmax.first < m_min || *minmax.second > m_max) {
+      throw std::runtime_error("ChebyshevSeries : curve " + name + " is defined out of the series interval");
+    }
+
+    // Least squares fit : A c = y, with A_ik = T_k(t_i)
+    auto n = x.size();
+    Eigen::MatrixXd A(n, degree + 1);
+    Eigen::VectorXd b(n);
+    for (std::size_t i = 0; i < n; i++) {
+      double t = (2. * x[i] - m_min - m_max) / (m_max - m_min);
+      A(i, 0) = 1.;
+      if (degree > 0) A(i, 1) = t;
+      for (unsigned int k = 2; k <= degree; k++) A(i, k) = 2. * t * A(i, k - 1) - A(i, k - 2);
+      b(i) = y[i];
+    }
+    Eigen::VectorXd coeffs = A.colPivHouseholderQr().solve(b);
+
+    // Every curve is padded with zeros to the highest degree
+    auto nc = m_names.size();
+    auto new_degree = std::max(m_degree, degree);
+    std::vector<double> new_coeffs((nc + 1) * (new_degree + 1), 0.);
+    for (std::size_t c = 0; c < nc; c++) {
+      std::copy(m_coeffs.begin() + c * (m_degree + 1), m_coeffs.begin() + (c + 1) * (m_degree + 1),
+                new_coeffs.begin() + c * (new_degree + 1));
+    }
+    for (unsigned int k = 0; k <= degree; k++) new_coeffs[nc * (new_degree + 1) + k] = coeffs(k);
+
+    m_coeffs = std::move(new_coeffs);
+    m_degree = new_degree;
+    m_names.push_back(name);
+
+    auto column = static_cast<ColumnHandle>(nc);
+    double max_residual = 0.;
+    for (std::size_t i = 0; i < n; i++) {
+      max_residual = std::max(max_residual, std::abs(Eval(x[i], column) - y[i]));
+    }
+    m_max_residuals.push_back(max_residual);
+
+    return column;
+  }
+
+  ColumnHandle ChebyshevSeries::GetColumnHandle(const std::string &name) const {
+    auto it = std::find(m_names.begin(), m_names.end(), name);
+    if (it == m_names.end()) {
+      throw std::out_of_range("ChebyshevSeries : no curve named " + name);
+    }
+    return static_cast<ColumnHandle>(it - m_names.begin());
+  }
+
+}  // end namespace acme
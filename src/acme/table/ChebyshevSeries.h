@@ -0,0 +1,103 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#ifndef ACME_CHEBYSHEVSERIES_H
+#define ACME_CHEBYSHEVSERIES_H
+
+#include <string>
+#include <vector>
+
+#include "PerformanceTable1D.h"
+
+namespace acme {
+
+  /// Set of smooth curves given by their Chebyshev expansion on the same interval [x_min, x_max] :
+  ///
+  ///   f(x) = sum_k c_k T_k(t),  t = (2 x - x_min - x_max) / (x_max - x_min),  k = 0..N
+  ///
+  /// The coefficients are least squares fits of tabulated data. Evaluation uses the Clenshaw recurrence : it has no
+  /// branch nor search, its cost only depends on the degree, and the whole curve is held in N + 1 coefficients.
+  /// Evaluation outside of [x_min, x_max] is an extrapolation, range checks are left to the caller.
+  class ChebyshevSeries {
+
+   public:
+    ChebyshevSeries() = default;
+
+    /// Fit a curve of the given degree on the data points (x, y) and get back its handle.
+    /// The interval of the series is set by the first fitted curve, to the range of its x values.
+    /// \throws std::runtime_error if there are fewer data points than coefficients or if x is out of the interval
+    ColumnHandle Fit(const std::string &name, const std::vector<double> &x, const std::vector<double> &y,
+                     unsigned int degree);
+
+    /// Get the handle of a curve from its name
+    /// \throws std::out_of_range if there is no curve with that name
+    ColumnHandle GetColumnHandle(const std::string &name) const;
+
+    std::size_t GetNbColumns() const { return m_names.size(); }
+
+    unsigned int GetDegree() const { return m_degree; }
+
+    double GetMin() const { return m_min; }
+
+    double GetMax() const { return m_max; }
+
+    /// Heap memory held by the series, in bytes (the object itself excluded)
+    std::size_t GetMemoryUsage() const {
+      return VectorMemoryUsage(m_names) + VectorMemoryUsage(m_coeffs) +
+             VectorMemoryUsage(m_max_residuals);
+    }
+
+    /// Max absolute deviation of the fitted curve from the data points it was fitted on
+    double GetMaxResidual(ColumnHandle column) const { return m_max_residuals[column]; }
+
+    /// Evaluate all the curves at x
+    /// \param values output, must have room for GetNbColumns() values
+    inline void Eval(const double &x, double *values) const;
+
+    /// Evaluate a single curve at x
+    inline double Eval(const double &x, ColumnHandle column) const;
+
+   private:
+    std::vector<std::string> m_names;
+    unsigned int m_degree = 0;
+    double m_min = 0.;
+    double m_max = 0.;
+    std::vector<double> m_coeffs; // contiguous per curve : m_coeffs[column * (degree + 1) + k]
+    std::vector<double> m_max_residuals;
+
+  };
+
+
+  double ChebyshevSeries::Eval(const double &x, ColumnHandle column) const {
+    double t = (2. * x - m_min - m_max) / (m_max - m_min);
+    double t2 = 2. * t;
+
+    // Clenshaw recurrence : b_k = c_k + 2 t b_k+1 - b_k+2, f = c_0 + t b_1 - b_2
+    auto c = m_coeffs.data() + column * (m_degree + 1);
+    double b1 = 0.;
+    double b2 = 0.;
+    for (auto k = m_degree; k > 0; k--) {
+      double b0 = c[k] + t2 * b1 - b2;
+      b2 = b1;
+      b1 = b0;
+    }
+    return c[0] + t * b1 - b2;
+  }
+
+  void ChebyshevSeries::Eval(const double &x, double *values) const {
+    for (std::size_t column = 0; column < m_names.size(); column++) {
+      values[column] = Eval(x, static_cast<ColumnHandle>(column));
+    }
+  }
+
+}  // end namespace acme
+
+#endif //ACME_CHEBYSHEVSERIES_H
@@ -0,0 +1,390 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#include "CurveFile.h"
+#include "CurveRegistry.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#include <iterator>
+#include <sys/types.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace acme {
+
+  namespace {
+
+    const char c_magic[8] = {'A', 'C', 'M', 'E', 'C', 'R', 'V', '\0'};
+    const std::uint32_t c_version = 1;
+
+    // magic, version, numbers of options, axes and columns, payload size, checksum
+    const std::size_t c_header_size = 40;
+
+    /// FNV-1a 64 bits hash
+    std::uint64_t Checksum(const char *bytes, std::size_t size) {
+      std::uint64_t hash = 14695981039346656037ULL;
+      for (std::size_t i = 0; i < size; i++) {
+        hash ^= static_cast<unsigned char>(bytes[i]);
+        hash *= 1099511628211ULL;
+      }
+      return hash;
+    }
+
+    template<class T>
+    void WriteValue(std::string &buffer, const T &value) {
+      buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    void WriteString(std::string &buffer, const std::string &string) {
+      WriteValue(buffer, static_cast<std::uint32_t>(string.size()));
+      buffer.append(string);
+    }
+
+    void WriteValues(std::string &buffer, const double *values, std::size_t size) {
+      buffer.append(reinterpret_cast<const char *>(values), size * sizeof(double));
+    }
+
+    /// Bounds checked reading of the mapped file
+    class Reader {
+
+     public:
+      Reader(const std::string &path, const char *bytes, std::size_t size, std::size_t offset) :
+          m_path(path), m_bytes(bytes), m_size(size), m_offset(offset) {}
+
+      template<class T>
+      T ReadValue() {
+        T value;
+        std::memcpy(&value, Read(sizeof(T)), sizeof(T));
+        return value;
+      }
+
+      std::string ReadString() {
+        auto size = ReadValue<std::uint32_t>();
+        return {Read(size), size};
+      }
+
+      const double *ReadValues(std::size_t size) {
+        if (size > (m_size - m_offset) / sizeof(double)) Truncated();
+        return reinterpret_cast<const double *>(Read(size * sizeof(double)));
+      }
+
+      void Align() {
+        Read((8 - m_offset % 8) % 8);
+      }
+
+     private:
+      const char *Read(std::size_t size) {
+        if (size > m_size - m_offset) Truncated();
+        auto bytes = m_bytes + m_offset;
+        m_offset += size;
+        return bytes;
+      }
+
+      [[noreturn]] void Truncated() const {
+        throw std::runtime_error("Curve file : truncated file " + m_path);
+      }
+
+     private:
+      const std::string &m_path;
+      const char *m_bytes;
+      std::size_t m_size;
+      std::size_t m_offset;
+
+    };
+
+    /// Write content to a temporary file of the directory of path, then rename it over path. The processes having the
+    /// former file mapped in memory keep its content, and a partially written file is never seen under path.
+    void ReplaceFile(const std::string &path, const std::string &content) {
+#if defined(_WIN32)
+      auto temp_path = path + ".tmp";
+      {
+        std::ofstream file(temp_path, std::ios::binary);
+        file.write(content.data(), static_cast<std::streamsize>(content.size()));
+        if (!file) {
+          file.close();
+          std::remove(temp_path.c_str());
+          throw std::runtime_error("Curve file : can not write " + path);
+        }
+      }
+      std::remove(path.c_str());  // no replacement by rename on Windows, where the files are not mapped
+#else
+      auto temp_path = path + ".XXXXXX";
+      int fd = mkstemp(&temp_path[0]);
+      if (fd < 0) throw std::runtime_error("Curve file : can not write " + path);
+
+      auto bytes = content.data();
+      auto remaining = content.size();
+      while (remaining > 0) {
+        auto written = write(fd, bytes, remaining);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) break;
+        bytes += written;
+        remaining -= static_cast<std::size_t>(written);
+      }
+      // mkstemp creates the file readable by its owner only
+      bool ok = remaining == 0 && fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH) == 0;
+      ok = (close(fd) == 0) && ok;
+      if (!ok) {
+        unlink(temp_path.c_str());
+        throw std::runtime_error("Curve file : can not write " + path);
+      }
+#endif
+      if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+        std::remove(temp_path.c_str());
+        throw std::runtime_error("Curve file : can not write " + path);
+      }
+    }
+
+  }  // end anonymous namespace
+
+  std::size_t CurveData::GetNbNodes() const {
+    std::size_t nb_nodes = 1;
+    for (const auto &axis : m_axes) nb_nodes *= axis.m_values.size();
+    return nb_nodes;
+  }
+
+  void CurveData::Write(const std::string &path) const {
+
+    auto nb_nodes = GetNbNodes();
+    for (const auto &column : m_columns) {
+      if (column.m_values.size() != nb_nodes) {
+        throw std::runtime_error("Curve file : column " + column.m_name + " has " +
+                                 std::to_string(column.m_values.size()) + " values, " + std::to_string(nb_nodes) +
+                                 " expected");
+      }
+    }
+
+    std::string payload;
+    WriteString(payload, m_model);
+    for (const auto &option : m_options) {
+      WriteString(payload, option.first);
+      WriteValue(payload, option.second);
+    }
+    for (const auto &axis : m_axes) {
+      WriteString(payload, axis.m_name);
+      WriteValue(payload, static_cast<std::uint64_t>(axis.m_values.size()));
+    }
+    for (const auto &column : m_columns) WriteString(payload, column.m_name);
+
+    // Values aligned on 8 bytes, the header size being a multiple of 8
+    payload.append((8 - payload.size() % 8) % 8, '\0');
+
+    for (const auto &axis : m_axes) WriteValues(payload, axis.m_values.data(), axis.m_values.size());
+
+    // Node values interleaved per node, as stored by the performance tables
+    std::vector<double> data(nb_nodes * m_columns.size());
+    for (std::size_t node = 0; node < nb_nodes; node++) {
+      for (std::size_t column = 0; column < m_columns.size(); column++) {
+        data[node * m_columns.size() + column] = m_columns[column].m_values[node];
+      }
+    }
+    WriteValues(payload, data.data(), data.size());
+
+    std::string header;
+    header.append(c_magic, sizeof(c_magic));
+    WriteValue(header, c_version);
+    WriteValue(header, static_cast<std::uint32_t>(m_options.size()));
+    WriteValue(header, static_cast<std::uint32_t>(m_axes.size()));
+    WriteValue(header, static_cast<std::uint32_t>(m_columns.size()));
+    WriteValue(header, static_cast<std::uint64_t>(payload.size()));
+    WriteValue(header, Checksum(payload.data(), payload.size()));
+
+    ReplaceFile(path, header + payload);
+  }
+
+  CurveFile::CurveFile(std::string path) : m_path(std::move(path)) {}
+
+  CurveFile::~CurveFile() {
+#if !defined(_WIN32)
+    if (m_bytes && m_buffer.empty()) munmap(const_cast<char *>(m_bytes), m_size);
+#endif
+  }
+
+  std::shared_ptr<const CurveFile> CurveFile::Open(const std::string &path) {
+    std::shared_ptr<CurveFile> file(new CurveFile(path));
+    file->Map();
+    file->Parse();
+    return file;
+  }
+
+  bool CurveFile::IsCurveFile(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    char magic[sizeof(c_magic)];
+    file.read(magic, sizeof(magic));
+    return file && std::memcmp(magic, c_magic, sizeof(c_magic)) == 0;
+  }
+
+  void CurveFile::Map() {
+#if defined(_WIN32)
+    std::ifstream file(m_path, std::ios::binary);
+    if (!file) throw std::runtime_error("Curve file : can not read " + m_path);
+    std::string content{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    m_buffer.resize(content.size() / sizeof(double) + 1);
+    std::memcpy(m_buffer.data(), content.data(), content.size());
+    m_bytes = reinterpret_cast<const char *>(m_buffer.data());
+    m_size = content.size();
+#else
+    int fd = open(m_path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Curve file : can not read " + m_path);
+
+    struct stat status;
+    if (fstat(fd, &status) != 0 || status.st_size < static_cast<off_t>(c_header_size)) {
+      close(fd);
+      throw std::runtime_error("Curve file : " + m_path + " is not a curve file");
+    }
+
+    auto size = static_cast<std::size_t>(status.st_size);
+    void *bytes = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (bytes == MAP_FAILED) throw std::runtime_error("Curve file : can not map " + m_path);
+
+    m_bytes = static_cast<const char *>(bytes);
+    m_size = size;
+#endif
+  }
+
+  void CurveFile::Parse() {
+
+    if (m_size < c_header_size || std::memcmp(m_bytes, c_magic, sizeof(c_magic)) != 0) {
+      throw std::runtime_error("Curve file : " + m_path + " is not a curve file");
+    }
+
+    Reader header(m_path, m_bytes, c_header_size, sizeof(c_magic));
+    if (header.ReadValue<std::uint32_t>() != c_version) {
+      throw std::runtime_error("Curve file : unsupported format version in " + m_path);
+    }
+    auto nb_options = header.ReadValue<std::uint32_t>();
+    auto nb_axes = header.ReadValue<std::uint32_t>();
+    auto nb_columns = header.ReadValue<std::uint32_t>();
+    auto payload_size = header.ReadValue<std::uint64_t>();
+    m_checksum = header.ReadValue<std::uint64_t>();
+
+    if (payload_size != m_size - c_header_size) {
+      throw std::runtime_error("Curve file : truncated file " + m_path);
+    }
+    if (Checksum(m_bytes + c_header_size, payload_size) != m_checksum) {
+      throw std::runtime_error("Curve file : checksum mismatch, corrupted file " + m_path);
+    }
+
+    // Offsets relative to the start of the file, for the alignment of the values
+    Reader reader(m_path, m_bytes, m_size, c_header_size);
+
+    m_model = reader.ReadString();
+    for (std::uint32_t i = 0; i < nb_options; i++) {
+      auto name = reader.ReadString();
+      m_options[name] = reader.ReadValue<double>();
+    }
+
+    m_nb_nodes = 1;
+    m_axes.resize(nb_axes);
+    for (auto &axis : m_axes) {
+      axis.m_name = reader.ReadString();
+      axis.m_size = reader.ReadValue<std::uint64_t>();
+      m_nb_nodes *= axis.m_size;
+    }
+    m_column_names.resize(nb_columns);
+    for (auto &name : m_column_names) name = reader.ReadString();
+
+    reader.Align();
+    for (auto &axis : m_axes) axis.m_values = reader.ReadValues(axis.m_size);
+    m_data = reader.ReadValues(m_nb_nodes * nb_columns);
+  }
+
+  void CurveFile::CheckModel(const std::string &model) const {
+    if (m_model != model) {
+      throw std::runtime_error("Curve file : " + m_path + " holds " + m_model + " performance data, not " + model);
+    }
+  }
+
+  double CurveFile::GetOption(const std::string &name, double default_value) const {
+    auto option = m_options.find(name);
+    return option == m_options.end() ? default_value : option->second;
+  }
+
+  std::vector<double> CurveFile::GetAxis(std::size_t axis) const {
+    return {GetAxisValues(axis), GetAxisValues(axis) + GetAxisSize(axis)};
+  }
+
+  std::vector<double> CurveFile::GetColumn(const std::string &name) const {
+    auto it = std::find(m_column_names.begin(), m_column_names.end(), name);
+    if (it == m_column_names.end()) {
+      throw std::out_of_range("Curve file : no column " + name + " in " + m_path);
+    }
+    auto column = static_cast<std::size_t>(it - m_column_names.begin());
+    auto nb_columns = m_column_names.size();
+
+    std::vector<double> values(m_nb_nodes);
+    for (std::size_t node = 0; node < m_nb_nodes; node++) values[node] = m_data[node * nb_columns + column];
+    return values;
+  }
+
+  CurveData CurveFile::GetCurveData() const {
+    CurveData data{m_model, m_options, {}, {}};
+    for (std::size_t axis = 0; axis < m_axes.size(); axis++) data.m_axes.push_back({GetAxisName(axis), GetAxis(axis)});
+    for (const auto &name : m_column_names) data.m_columns.push_back({name, GetColumn(name)});
+    return data;
+  }
+
+  void CurveFile::SetTable(PerformanceTable1D &table) const {
+    if (m_axes.size() != 1) throw std::runtime_error("Curve file : " + m_path + " does not hold 1D data");
+    table.SetData(m_axes[0].m_values, m_axes[0].m_size, m_column_names, m_data, shared_from_this());
+  }
+
+  void CurveFile::SetTable(PerformanceTable2D &table) const {
+    if (m_axes.size() != 2) throw std::runtime_error("Curve file : " + m_path + " does not hold 2D data");
+    table.SetData(m_axes[0].m_values, m_axes[0].m_size, m_axes[1].m_values, m_axes[1].m_size, m_column_names, m_data,
+                  shared_from_this());
+  }
+
+  std::string CurveRegistryKey(const std::string &model, const std::vector<double> &options,
+                               const std::string &json_string, const std::string &curve_file) {
+    if (curve_file.empty()) return CurveRegistryKey(model, options, json_string);
+
+#if defined(_WIN32)
+    struct _stat64 status;
+    if (_stat64(curve_file.c_str(), &status) != 0) {
+      throw std::runtime_error("Curve file : can not read " + curve_file);
+    }
+    auto modification_ns = static_cast<long long>(status.st_mtime) * 1000000000LL;
+#else
+    struct stat status;
+    if (stat(curve_file.c_str(), &status) != 0) {
+      throw std::runtime_error("Curve file : can not read " + curve_file);
+    }
+#if defined(__APPLE__)
+    const auto &modification_time = status.st_mtimespec;
+#else
+    const auto &modification_time = status.st_mtim;
+#endif
+    auto modification_ns = static_cast<long long>(modification_time.tv_sec) * 1000000000LL + modification_time.tv_nsec;
+#endif
+
+    auto identity = "curve file " + curve_file +
+                    " device " + std::to_string(static_cast<unsigned long long>(status.st_dev)) +
+                    " inode " + std::to_string(static_cast<unsigned long long>(status.st_ino)) +
+                    " size " + std::to_string(static_cast<long long>(status.st_size)) +
+                    " modified " + std::to_string(modification_ns);
+    return CurveRegistryKey(model, options, identity);
+  }
+
+}  // end namespace acme
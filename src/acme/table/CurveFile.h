@@ -0,0 +1,167 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#ifndef ACME_CURVEFILE_H
+#define ACME_CURVEFILE_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "PerformanceTable1D.h"
+#include "PerformanceTable2D.h"
+
+namespace acme {
+
+  /// Named values of a curve file : an axis, or a column given at the grid nodes
+  struct CurveValues {
+    std::string m_name;
+    std::vector<double> m_values;
+  };
+
+
+  /// Performance data of a model, as written in a curve file (see CurveFile).
+  ///
+  /// Axes are in the units used by the model tables (angles in radians). Columns are given at the grid nodes with the
+  /// last axis varying fastest, which is the layout of PerformanceTable2D::AddData.
+  struct CurveData {
+    std::string m_model;                     // model type, as used by CurveRegistryKey ("FPP1Q", "CPP", ...)
+    std::map<std::string, double> m_options; // options overriding the model parameters ("interpolation", ...)
+    std::vector<CurveValues> m_axes;
+    std::vector<CurveValues> m_columns;
+
+    /// Number of grid nodes : product of the axis sizes
+    std::size_t GetNbNodes() const;
+
+    /// Write the curve file. An existing file is replaced by renaming a new file over it, so that the processes having
+    /// it mapped in memory (see CurveFile) keep reading its former content.
+    /// \throws std::runtime_error if a column size does not match the grid or the file can not be written
+    void Write(const std::string &path) const;
+  };
+
+
+  /// Binary performance curve file, mapped read-only in memory.
+  ///
+  /// The file holds the performance data of a model in the layout of the performance tables : axes in radians and node
+  /// values interleaved per node (the layout of PerformanceTable1D and PerformanceTable2D), 8 bytes aligned. The
+  /// tables then use the mapped values in place (see PerformanceTable1D::SetData), so that initializing a model costs
+  /// a few system calls instead of a json parsing, and the pages are shared by every process using the file.
+  ///
+  /// Layout : 40 bytes header (magic, format version, numbers of options, axes and columns, payload size and FNV-1a
+  /// checksum of the payload), model type, options, axis names and sizes, column names, padding, axis values and node
+  /// values. The checksum is verified when the file is opened.
+  class CurveFile : public std::enable_shared_from_this<CurveFile> {
+
+   public:
+    /// Map the file in memory and check its header and checksum
+    /// \throws std::runtime_error if the file can not be read, is not a curve file or is corrupted
+    static std::shared_ptr<const CurveFile> Open(const std::string &path);
+
+    /// Does the file start as a curve file (the content not being checked)
+    static bool IsCurveFile(const std::string &path);
+
+    CurveFile(const CurveFile &) = delete;
+
+    CurveFile &operator=(const CurveFile &) = delete;
+
+    ~CurveFile();
+
+    const std::string &GetPath() const { return m_path; }
+
+    const std::string &GetModel() const { return m_model; }
+
+    /// \throws std::runtime_error if the file holds the performance data of another model type
+    void CheckModel(const std::string &model) const;
+
+    std::uint64_t GetChecksum() const { return m_checksum; }
+
+    bool HasOption(const std::string &name) const { return m_options.count(name) > 0; }
+
+    double GetOption(const std::string &name, double default_value) const;
+
+    std::size_t GetNbAxes() const { return m_axes.size(); }
+
+    const std::string &GetAxisName(std::size_t axis) const { return m_axes.at(axis).m_name; }
+
+    std::size_t GetAxisSize(std::size_t axis) const { return m_axes.at(axis).m_size; }
+
+    /// Values of an axis, in the mapped file
+    const double *GetAxisValues(std::size_t axis) const { return m_axes.at(axis).m_values; }
+
+    const std::vector<std::string> &GetColumnNames() const { return m_column_names; }
+
+    std::size_t GetNbNodes() const { return m_nb_nodes; }
+
+    /// Node values interleaved per node, in the mapped file : GetData()[node * nb_columns + column]
+    const double *GetData() const { return m_data; }
+
+    /// Copy of the values of an axis
+    std::vector<double> GetAxis(std::size_t axis) const;
+
+    /// Copy of the values of a column at the grid nodes
+    /// \throws std::out_of_range if there is no column with that name
+    std::vector<double> GetColumn(const std::string &name) const;
+
+    /// Copy of the whole content
+    CurveData GetCurveData() const;
+
+    /// Set the axis and the columns of a table from the file, the table keeping the file mapped as long as it uses the
+    /// values in place (see PerformanceTable1D::SetData)
+    /// \throws std::runtime_error if the file does not hold 1D data
+    void SetTable(PerformanceTable1D &table) const;
+
+    /// \throws std::runtime_error if the file does not hold 2D data
+    void SetTable(PerformanceTable2D &table) const;
+
+   private:
+    explicit CurveFile(std::string path);
+
+    void Map();
+
+    void Parse();
+
+   private:
+    struct Axis {
+      std::string m_name;
+      std::size_t m_size;
+      const double *m_values;
+    };
+
+    std::string m_path;
+
+    const char *m_bytes = nullptr;
+    std::size_t m_size = 0;
+    std::vector<double> m_buffer; // file content, where memory mapping is not available
+
+    std::string m_model;
+    std::uint64_t m_checksum = 0;
+    std::map<std::string, double> m_options;
+    std::vector<Axis> m_axes;
+    std::vector<std::string> m_column_names;
+    std::size_t m_nb_nodes = 0;
+    const double *m_data = nullptr;
+
+  };
+
+  /// CurveRegistryKey of the curves of a model built from json_string, or from curve_file when it is not empty.
+  /// A curve file is identified by its path and its identity on the file system (device, inode, size and modification
+  /// time), given by stat : the models loading a file whose curves are registered neither map nor checksum it, while a
+  /// file rewritten since its last load (CurveData::Write replaces it by a rename) gets another key. The curves are
+  /// then built by opening the file, only when no curves with this key are alive.
+  /// \throws std::runtime_error if the curve file does not exist
+  std::string CurveRegistryKey(const std::string &model, const std::vector<double> &options,
+                               const std::string &json_string, const std::string &curve_file);
+
+}  // end namespace acme
+
+#endif //ACME_CURVEFILE_H
@@ -0,0 +1,37 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#include "CurvePointer.h"
+
+namespace acme {
+
+  void RetiredCurves::Add(std::shared_ptr<const void> curves) {
+    if (!curves) return;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_curves.push_back(std::move(curves));
+  }
+
+  std::size_t RetiredCurves::Release() {
+    std::vector<std::shared_ptr<const void>> curves;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      std::swap(curves, m_curves);
+    }
+    // Curves destroyed outside of the lock
+    return curves.size();
+  }
+
+  std::size_t RetiredCurves::GetSize() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_curves.size();
+  }
+
+}  // end namespace acme
@@ -0,0 +1,113 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#ifndef ACME_CURVEPOINTER_H
+#define ACME_CURVEPOINTER_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace acme {
+
+  /// Curves of a model, which may be replaced while other threads evaluate the model (read-copy-update).
+  ///
+  /// Readers dereference a plain atomic pointer : they never take a lock nor touch a reference count. New curves are
+  /// built beforehand, off the hot path, then published with a single atomic store, so that a reader sees either the
+  /// former or the new curves, never a partially updated set. The pointer does not know when the readers of the former
+  /// curves are done : Publish returns them, to be kept alive until then (see RetiredCurves).
+  template<class Curves>
+  class CurvePointer {
+
+   public:
+    CurvePointer() = default;
+
+    CurvePointer(const CurvePointer &other) {
+      Publish(other.Get());
+    }
+
+    CurvePointer &operator=(const CurvePointer &other) {
+      Publish(other.Get());
+      return *this;
+    }
+
+    /// Set the curves of a model being initialized, not yet evaluated by any thread
+    CurvePointer &operator=(std::shared_ptr<const Curves> curves) {
+      Publish(std::move(curves));
+      return *this;
+    }
+
+    const Curves &operator*() const { return *Load(); }
+
+    const Curves *operator->() const { return Load(); }
+
+    explicit operator bool() const { return Load() != nullptr; }
+
+    /// Current curves, lock free. A reader evaluating several quantities loads the pointer once, to use the same
+    /// curves for all of them.
+    const Curves *Load() const { return m_current.load(std::memory_order_acquire); }
+
+    /// Owning pointer to the current curves
+    std::shared_ptr<const Curves> Get() const {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      return m_curves;
+    }
+
+    /// Replace the curves, concurrent publications being serialized
+    /// \return the former curves, which may still be used by readers having loaded the pointer before the store
+    std::shared_ptr<const Curves> Publish(std::shared_ptr<const Curves> curves) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      std::swap(m_curves, curves);
+      m_current.store(m_curves.get(), std::memory_order_release);
+      return curves;
+    }
+
+   private:
+    std::atomic<const Curves *> m_current{nullptr};
+
+    mutable std::mutex m_mutex;             // serializes the writers
+    std::shared_ptr<const Curves> m_curves; // keeps the current curves alive
+
+  };
+
+
+  /// Curves replaced by CurvePointer::Publish, kept alive until the caller knows that no reader may still use them
+  /// (grace period of the read-copy-update), for instance between two steps of a simulation.
+  ///
+  /// Copies start empty : the retired curves stay with the model which replaced them.
+  class RetiredCurves {
+
+   public:
+    RetiredCurves() = default;
+
+    RetiredCurves(const RetiredCurves &) {}
+
+    RetiredCurves &operator=(const RetiredCurves &) { return *this; }
+
+    void Add(std::shared_ptr<const void> curves);
+
+    /// Release the retired curves, which must no longer be used by any reader
+    /// \return the number of curve sets released
+    std::size_t Release();
+
+    std::size_t GetSize() const;
+
+   private:
+    mutable std::mutex m_mutex;
+    std::vector<std::shared_ptr<const void>> m_curves;
+
+  };
+
+}  // end namespace acme
+
+#endif //ACME_CURVEPOINTER_H
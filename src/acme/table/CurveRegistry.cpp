@@ -0,0 +1,204 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#include "CurveRegistry.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+namespace acme {
+
+  namespace {
+
+    std::uint64_t RotateLeft(std::uint64_t x, int r) {
+      return (x << r) | (x >> (64 - r));
+    }
+
+    std::uint64_t Mix(std::uint64_t k) {
+      k ^= k >> 33;
+      k *= 0xff51afd7ed558ccdULL;
+      k ^= k >> 33;
+      k *= 0xc4ceb9fe1a85ec53ULL;
+      k ^= k >> 33;
+      return k;
+    }
+
+    /// MurmurHash3 x64 128 bits hash (Austin Appleby, public domain) of the data, in two 64 bits words
+    void Hash128(const std::string &data, std::uint64_t &h1, std::uint64_t &h2) {
+      const std::uint64_t c1 = 0x87c37b91114253d5ULL;
+      const std::uint64_t c2 = 0x4cf5ad432745937fULL;
+      auto bytes = reinterpret_cast<const unsigned char *>(data.data());
+      auto size = data.size();
+      auto nb_blocks = size / 16;
+
+      h1 = 0;
+      h2 = 0;
+      for (std::size_t i = 0; i < nb_blocks; i++) {
+        std::uint64_t k1, k2;
+        std::memcpy(&k1, bytes + 16 * i, 8);
+        std::memcpy(&k2, bytes + 16 * i + 8, 8);
+
+        k1 *= c1;
+        k1 = RotateLeft(k1, 31);
+        k1 *= c2;
+        h1 ^= k1;
+        h1 = RotateLeft(h1, 27);
+        h1 += h2;
+        h1 = h1 * 5 + 0x52dce729;
+
+        k2 *= c2;
+        k2 = RotateLeft(k2, 33);
+        k2 *= c1;
+        h2 ^= k2;
+        h2 = RotateLeft(h2, 31);
+        h2 += h1;
+        h2 = h2 * 5 + 0x38495ab5;
+      }
+
+      // Last 0 to 15 bytes, little endian
+      auto tail = bytes + 16 * nb_blocks;
+      auto tail_size = size % 16;
+      std::uint64_t k1 = 0, k2 = 0;
+      for (std::size_t i = 0; i < tail_size; i++) {
+        if (i < 8) {
+          k1 ^= std::uint64_t(tail[i]) << (8 * i);
+        } else {
+          k2 ^= std::uint64_t(tail[i]) << (8 * (i - 8));
+        }
+      }
+      if (tail_size > 8) {
+        k2 *= c2;
+        k2 = RotateLeft(k2, 33);
+        k2 *= c1;
+        h2 ^= k2;
+      }
+      if (tail_size > 0) {
+        k1 *= c1;
+        k1 = RotateLeft(k1, 31);
+        k1 *= c2;
+        h1 ^= k1;
+      }
+
+      h1 ^= size;
+      h2 ^= size;
+      h1 += h2;
+      h2 += h1;
+      h1 = Mix(h1);
+      h2 = Mix(h2);
+      h1 += h2;
+      h2 += h1;
+    }
+
+  }  // end anonymous namespace
+
+  CurveRegistry &CurveRegistry::GetInstance() {
+    static CurveRegistry registry;
+    return registry;
+  }
+
+  std::shared_ptr<const void> CurveRegistry::Acquire(const std::string &key) {
+    std::shared_future<std::shared_ptr<const void>> build;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+
+      auto entry = m_entries.find(key);
+      if (entry != m_entries.end()) {
+        if (auto curves = entry->second.m_curves.lock()) return curves;
+      }
+
+      auto &pending = m_builds[key];
+      if (!pending) {
+        // The calling thread builds the curves
+        pending = std::make_shared<Build>();
+        return nullptr;
+      }
+      build = pending->m_curves;
+    }
+
+    // Built by another thread, waited for outside of the lock
+    return build.get();
+  }
+
+  std::shared_ptr<const void> CurveRegistry::Insert(const std::string &key,
+                                                    std::shared_ptr<const void> curves,
+                                                    std::size_t bytes) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto &entry = m_entries[key];
+    entry.m_curves = curves;
+    entry.m_bytes = bytes;
+    m_nb_builds++;
+
+    auto build = m_builds.find(key);
+    build->second->m_promise.set_value(curves);
+    m_builds.erase(build);
+
+    if (m_entries.size() >= m_purge_size) Purge();
+
+    return curves;
+  }
+
+  void CurveRegistry::Abandon(const std::string &key, std::exception_ptr exception) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto build = m_builds.find(key);
+    build->second->m_promise.set_exception(exception);
+    m_builds.erase(build);
+  }
+
+  void CurveRegistry::Purge() {
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+      if (it->second.m_curves.expired()) {
+        it = m_entries.erase(it);
+      } else {
+        it++;
+      }
+    }
+    // Amortized : the next purge occurs once the number of entries has doubled
+    m_purge_size = std::max(std::size_t(64), 2 * m_entries.size());
+  }
+
+  CurveRegistryStats CurveRegistry::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    CurveRegistryStats stats;
+    stats.m_nb_builds = m_nb_builds;
+    for (const auto &entry : m_entries) {
+      auto nb_references = std::size_t(entry.second.m_curves.use_count());
+      if (nb_references == 0) continue;
+      stats.m_nb_unique_curves++;
+      stats.m_nb_references += nb_references;
+      stats.m_unique_bytes += entry.second.m_bytes;
+      stats.m_saved_bytes += (nb_references - 1) * entry.second.m_bytes;
+    }
+    return stats;
+  }
+
+  std::string CurveRegistryKey(const std::string &model, const std::vector<double> &options, const std::string &data) {
+    std::string key = model;
+    char buffer[40];
+    for (const auto &option : options) {
+      std::snprintf(buffer, sizeof(buffer), "|%a", option);
+      key += buffer;
+    }
+    // The data, possibly several MB of json, are identified by their size and hash : the registry keeps no copy
+    std::uint64_t h1, h2;
+    Hash128(data, h1, h2);
+    std::snprintf(buffer, sizeof(buffer), "|%zu|", data.size());
+    key += buffer;
+    std::snprintf(buffer, sizeof(buffer), "%016llx%016llx", static_cast<unsigned long long>(h1),
+                  static_cast<unsigned long long>(h2));
+    key += buffer;
+    return key;
+  }
+
+}  // end namespace acme
@@ -0,0 +1,121 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#ifndef ACME_CURVEREGISTRY_H
+#define ACME_CURVEREGISTRY_H
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace acme {
+
+  /// Memory statistics of the curves held by the registry
+  struct CurveRegistryStats {
+    std::size_t m_nb_unique_curves = 0; // curve sets alive, each one built once
+    std::size_t m_nb_references = 0;   // models (or copies of models) sharing them
+    std::size_t m_unique_bytes = 0;     // memory held by the curve sets alive
+    std::size_t m_saved_bytes = 0;      // memory that one copy of the curves per model would have taken in addition
+    std::size_t m_nb_builds = 0;        // curve sets built since the start of the process
+  };
+
+
+  /// Process-wide registry of the immutable performance curves built by the models at initialization.
+  ///
+  /// Curves are identified by a key made of the model type, the options used to build them and the performance data
+  /// (see CurveRegistryKey). Models built from identical data get the same reference counted curves instead of
+  /// parsing and storing their own copy, so that a fleet of sister ships holds a single table.
+  ///
+  /// The registry only keeps weak references : curves are released with the last model using them. Accesses are
+  /// thread safe, and curves are built outside of the lock so that distinct curves may be built concurrently, while
+  /// identical ones are built once.
+  class CurveRegistry {
+
+   public:
+    static CurveRegistry &GetInstance();
+
+    /// Get the curves registered with this key, or build and register them if there are none alive.
+    /// \tparam Curves immutable curve set, providing GetMemoryUsage() (heap memory held, in bytes)
+    /// \param build called without the registry lock, only when no curves with this key are alive. A thread asking
+    ///        for curves being built by another thread waits for them (or for the exception thrown by build) instead
+    ///        of building them again.
+    template<class Curves>
+    std::shared_ptr<const Curves> Get(const std::string &key, const std::function<Curves()> &build);
+
+    CurveRegistryStats GetStats() const;
+
+   private:
+    CurveRegistry() = default;
+
+    /// Get the curves alive or being built with this key. When there are none, the calling thread is registered as
+    /// the one building them and nullptr is returned : it must then call Insert or Abandon.
+    std::shared_ptr<const void> Acquire(const std::string &key);
+
+    /// Register the curves built by the calling thread and release the threads waiting for them
+    std::shared_ptr<const void> Insert(const std::string &key, std::shared_ptr<const void> curves, std::size_t bytes);
+
+    /// Release the threads waiting for curves whose build failed, with the exception thrown
+    void Abandon(const std::string &key, std::exception_ptr exception);
+
+    /// Remove the entries whose curves have been released
+    void Purge();
+
+   private:
+    struct Entry {
+      std::weak_ptr<const void> m_curves;
+      std::size_t m_bytes;
+    };
+
+    /// Curves being built by a thread
+    struct Build {
+      std::promise<std::shared_ptr<const void>> m_promise;
+      std::shared_future<std::shared_ptr<const void>> m_curves = m_promise.get_future().share();
+    };
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, Entry> m_entries;
+    std::unordered_map<std::string, std::shared_ptr<Build>> m_builds;
+    std::size_t m_purge_size = 64; // number of entries triggering the next purge
+    std::size_t m_nb_builds = 0;
+
+  };
+
+  /// Key identifying curves in the registry : model type, build options and performance data.
+  /// Options are written exactly (hexadecimal floating point), so that curves built with different options, however
+  /// close, are never mixed up. The data are identified by their size and 128 bits hash, the key staying short
+  /// whatever their size.
+  std::string CurveRegistryKey(const std::string &model, const std::vector<double> &options, const std::string &data);
+
+
+  template<class Curves>
+  std::shared_ptr<const Curves> CurveRegistry::Get(const std::string &key, const std::function<Curves()> &build) {
+    if (auto curves = Acquire(key)) return std::static_pointer_cast<const Curves>(curves);
+
+    std::shared_ptr<const Curves> curves;
+    try {
+      curves = std::make_shared<const Curves>(build());
+    } catch (...) {
+      Abandon(key, std::current_exception());
+      throw;
+    }
+    auto bytes = sizeof(Curves) + curves->GetMemoryUsage();
+    return std::static_pointer_cast<const Curves>(Insert(key, curves, bytes));
+  }
+
+}  // end namespace acme
+
+#endif //ACME_CURVEREGISTRY_H
@@ -0,0 +1,55 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#include "FourierSeries.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace acme {
+
+  ColumnHandle FourierSeries::AddSeries(const std::string &name,
+                                        const std::vector<double> &a,
+                                        const std::vector<double> &b) {
+
+    if (std::find(m_names.begin(), m_names.end(), name) != m_names.end()) {
+      throw std::runtime_error("FourierSeries : series " + name + " already defined");
+    }
+
+    // Rebuild the interleaved layout with the new series appended, padding every series to the same number of terms
+    auto nc = m_names.size();
+    auto nb_terms = std::max({m_nb_terms, a.size(), b.size()});
+    std::vector<double> new_a(nb_terms * (nc + 1), 0.);
+    std::vector<double> new_b(nb_terms * (nc + 1), 0.);
+    for (std::size_t k = 0; k < m_nb_terms; k++) {
+      std::copy(m_a.begin() + k * nc, m_a.begin() + (k + 1) * nc, new_a.begin() + k * (nc + 1));
+      std::copy(m_b.begin() + k * nc, m_b.begin() + (k + 1) * nc, new_b.begin() + k * (nc + 1));
+    }
+    for (std::size_t k = 0; k < a.size(); k++) new_a[k * (nc + 1) + nc] = a[k];
+    for (std::size_t k = 0; k < b.size(); k++) new_b[k * (nc + 1) + nc] = b[k];
+
+    m_a = std::move(new_a);
+    m_b = std::move(new_b);
+    m_nb_terms = nb_terms;
+    m_names.push_back(name);
+
+    return static_cast<ColumnHandle>(nc);
+  }
+
+  ColumnHandle FourierSeries::GetColumnHandle(const std::string &name) const {
+    auto it = std::find(m_names.begin(), m_names.end(), name);
+    if (it == m_names.end()) {
+      throw std::out_of_range("FourierSeries : no series named " + name);
+    }
+    return static_cast<ColumnHandle>(it - m_names.begin());
+  }
+
+}  // end namespace acme
@@ -0,0 +1,109 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#ifndef ACME_FOURIERSERIES_H
+#define ACME_FOURIERSERIES_H
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "PerformanceTable1D.h"
+
+namespace acme {
+
+  /// Set of periodic curves given by their Fourier series, sharing the same angle :
+  ///
+  ///   f(angle) = sum_k ( a_k cos(k angle) + b_k sin(k angle) ),  k = 0..N
+  ///
+  /// This is the classical representation of four quadrant propeller data (Wageningen B-series 4Q, N = 20).
+  /// Evaluation needs a single sin/cos computation, the higher harmonics being obtained by recurrence, and has no
+  /// branch nor search : its cost only depends on the number of terms.
+  class FourierSeries {
+
+   public:
+    FourierSeries() = default;
+
+    /// Add a curve and get back its handle. a and b may have different sizes, missing terms are taken as zero.
+    ColumnHandle AddSeries(const std::string &name, const std::vector<double> &a, const std::vector<double> &b);
+
+    /// Get the handle of a curve from its name
+    /// \throws std::out_of_range if there is no curve with that name
+    ColumnHandle GetColumnHandle(const std::string &name) const;
+
+    std::size_t GetNbColumns() const { return m_names.size(); }
+
+    std::size_t GetNbTerms() const { return m_nb_terms; }
+
+    /// Heap memory held by the series, in bytes (the object itself excluded)
+    std::size_t GetMemoryUsage() const {
+      return VectorMemoryUsage(m_names) + VectorMemoryUsage(m_a) + VectorMemoryUsage(m_b);
+    }
+
+    /// Evaluate all the curves at the given angle (in rad)
+    /// \param values output, must have room for GetNbColumns() values
+    inline void Eval(const double &angle, double *values) const;
+
+    /// Evaluate a single curve at the given angle (in rad)
+    inline double Eval(const double &angle, ColumnHandle column) const;
+
+   private:
+    std::vector<std::string> m_names;
+    std::size_t m_nb_terms = 0;
+    std::vector<double> m_a; // interleaved per harmonic : m_a[k * nb_columns + column]
+    std::vector<double> m_b;
+
+  };
+
+
+  void FourierSeries::Eval(const double &angle, double *values) const {
+    auto nc = m_names.size();
+    for (std::size_t c = 0; c < nc; c++) values[c] = 0.;
+
+    double c1 = std::cos(angle);
+    double s1 = std::sin(angle);
+
+    // cos(k angle), sin(k angle) by successive rotations of angle
+    double ck = 1.;
+    double sk = 0.;
+    for (std::size_t k = 0; k < m_nb_terms; k++) {
+      auto a = m_a.data() + k * nc;
+      auto b = m_b.data() + k * nc;
+      for (std::size_t c = 0; c < nc; c++) {
+        values[c] += a[c] * ck + b[c] * sk;
+      }
+      double ck1 = ck * c1 - sk * s1;
+      sk = sk * c1 + ck * s1;
+      ck = ck1;
+    }
+  }
+
+  double FourierSeries::Eval(const double &angle, ColumnHandle column) const {
+    auto nc = m_names.size();
+
+    double c1 = std::cos(angle);
+    double s1 = std::sin(angle);
+
+    double value = 0.;
+    double ck = 1.;
+    double sk = 0.;
+    for (std::size_t k = 0; k < m_nb_terms; k++) {
+      value += m_a[k * nc + column] * ck + m_b[k * nc + column] * sk;
+      double ck1 = ck * c1 - sk * s1;
+      sk = sk * c1 + ck * s1;
+      ck = ck1;
+    }
+    return value;
+  }
+
+}  // end namespace acme
+
+#endif //ACME_FOURIERSERIES_H
@@ -0,0 +1,25 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#include "InterpolationType.h"
+
+#include <stdexcept>
+
+namespace acme {
+
+  InterpolationType ParseInterpolationType(const std::string &name) {
+    if (name == "linear") return E_LINEAR;
+    if (name == "monotone_cubic") return E_MONOTONE_CUBIC;
+    if (name == "akima") return E_AKIMA;
+    throw std::runtime_error("Unknown interpolation type " + name + ", expected linear, monotone_cubic or akima");
+  }
+
+}  // end namespace acme
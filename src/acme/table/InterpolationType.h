@@ -0,0 +1,31 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#ifndef ACME_INTERPOLATIONTYPE_H
+#define ACME_INTERPOLATIONTYPE_H
+
+#include <string>
+
+namespace acme {
+
+  enum InterpolationType {
+    E_LINEAR,         // piecewise linear, slope discontinuities at the nodes
+    E_MONOTONE_CUBIC, // piecewise cubic Hermite with Fritsch-Carlson slopes (PCHIP), C1 and no overshoot
+    E_AKIMA           // piecewise cubic Hermite with Akima slopes, C1 and little sensitivity to outliers
+  };
+
+  /// Get the interpolation type from its json name ("linear", "monotone_cubic" or "akima")
+  /// \throws std::runtime_error for unknown names
+  InterpolationType ParseInterpolationType(const std::string &name);
+
+}  // end namespace acme
+
+#endif //ACME_INTERPOLATIONTYPE_H
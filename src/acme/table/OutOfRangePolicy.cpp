@@ -0,0 +1,43 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#include "OutOfRangePolicy.h"
+
+#include <stdexcept>
+
+namespace acme {
+
+  OutOfRangePolicy ParseOutOfRangePolicy(const std::string &name) {
+    if (name == "throw") return E_OUT_OF_RANGE_THROW;
+    if (name == "clamp") return E_OUT_OF_RANGE_CLAMP;
+    if (name == "extrapolate") return E_OUT_OF_RANGE_EXTRAPOLATE;
+    if (name == "zero") return E_OUT_OF_RANGE_ZERO;
+    throw std::runtime_error("Unknown out of range policy " + name + ", expected throw, clamp, extrapolate or zero");
+  }
+
+  unsigned int HandleOutOfRange(OutOfRangePolicy policy, StatusCounters &counters, const char *what, double value,
+                                std::initializer_list<double *> coefficients) {
+    counters.Count(E_STATUS_OUT_OF_RANGE);
+    switch (policy) {
+      case E_OUT_OF_RANGE_THROW:
+        throw std::runtime_error(std::string(what) + " = " + std::to_string(value) +
+                                 " out of the performance data range");
+      case E_OUT_OF_RANGE_ZERO:
+        for (auto coefficient : coefficients) *coefficient = 0.;
+        break;
+      case E_OUT_OF_RANGE_CLAMP:
+      case E_OUT_OF_RANGE_EXTRAPOLATE:
+        break;
+    }
+    return E_STATUS_OUT_OF_RANGE;
+  }
+
+}  // end namespace acme
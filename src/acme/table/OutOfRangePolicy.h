@@ -0,0 +1,97 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#ifndef ACME_OUTOFRANGEPOLICY_H
+#define ACME_OUTOFRANGEPOLICY_H
+
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+
+namespace acme {
+
+  /// Behaviour of a model when an input falls outside of its performance data
+  enum OutOfRangePolicy {
+    E_OUT_OF_RANGE_THROW,       // std::runtime_error thrown by Compute
+    E_OUT_OF_RANGE_CLAMP,       // coefficients at the nearest bound of the data
+    E_OUT_OF_RANGE_EXTRAPOLATE, // linear extrapolation from the nearest bound of the data
+    E_OUT_OF_RANGE_ZERO         // zero coefficients, hence zero loads
+  };
+
+  /// Get the out of range policy from its name ("throw", "clamp", "extrapolate" or "zero")
+  /// \throws std::runtime_error for unknown names
+  OutOfRangePolicy ParseOutOfRangePolicy(const std::string &name);
+
+
+  /// Status of a model evaluation : E_STATUS_OK or a combination of the flags below
+  enum ComputeStatus : unsigned int {
+    E_STATUS_OK = 0,
+    E_STATUS_OUT_OF_RANGE = 1,  // an input outside of the performance data, handled by the out of range policy
+    E_STATUS_INVALID_INPUT = 2  // an operating point outside of the model domain, zero loads
+  };
+
+  /// Number of performance data lookups of a model per status
+  struct StatusCounts {
+    std::size_t m_nb_out_of_range = 0;
+    std::size_t m_nb_invalid_input = 0;
+  };
+
+
+  /// Counters of the abnormal statuses met by a model.
+  ///
+  /// Only the lookups with a status other than E_STATUS_OK touch the counters, with relaxed atomic increments, so that
+  /// counting costs nothing in normal operation and a model may still be evaluated concurrently.
+  class StatusCounters {
+
+   public:
+    StatusCounters() : m_nb_out_of_range(0), m_nb_invalid_input(0) {}
+
+    StatusCounters(const StatusCounters &other) : StatusCounters() { *this = other; }
+
+    StatusCounters &operator=(const StatusCounters &other) {
+      auto counts = other.Get();
+      m_nb_out_of_range.store(counts.m_nb_out_of_range, std::memory_order_relaxed);
+      m_nb_invalid_input.store(counts.m_nb_invalid_input, std::memory_order_relaxed);
+      return *this;
+    }
+
+    void Count(unsigned int status) {
+      if (status == E_STATUS_OK) return;
+      if (status & E_STATUS_OUT_OF_RANGE) m_nb_out_of_range.fetch_add(1, std::memory_order_relaxed);
+      if (status & E_STATUS_INVALID_INPUT) m_nb_invalid_input.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    StatusCounts Get() const {
+      return {m_nb_out_of_range.load(std::memory_order_relaxed), m_nb_invalid_input.load(std::memory_order_relaxed)};
+    }
+
+    void Reset() { *this = StatusCounters(); }
+
+   private:
+    std::atomic<std::size_t> m_nb_out_of_range;
+    std::atomic<std::size_t> m_nb_invalid_input;
+
+  };
+
+
+  /// Apply the policy to the coefficients obtained for an input outside of the performance data : they have been
+  /// evaluated on the clamped or extrapolated location of the input (see TableAxis::Locate) and are set to zero for
+  /// E_OUT_OF_RANGE_ZERO. The lookup is counted.
+  /// \param what description of the input, for the exception message
+  /// \return E_STATUS_OUT_OF_RANGE
+  /// \throws std::runtime_error for E_OUT_OF_RANGE_THROW
+  unsigned int HandleOutOfRange(OutOfRangePolicy policy, StatusCounters &counters, const char *what, double value,
+                                std::initializer_list<double *> coefficients);
+
+}  // end namespace acme
+
+#endif //ACME_OUTOFRANGEPOLICY_H
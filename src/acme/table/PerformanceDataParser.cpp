@@ -0,0 +1,385 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#include "PerformanceDataParser.h"
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+namespace acme {
+
+  /// SAX events of nlohmann::json::sax_parse, dispatched to the declared entries
+  class PerformanceDataParser::Handler {
+
+   public:
+    explicit Handler(PerformanceDataParser &parser) : m_parser(parser) {}
+
+    bool null() {
+      return Unexpected();
+    }
+
+    bool boolean(bool value) {
+      if (m_skip > 0) return true;
+      auto entry = Find(E_BOOL);
+      if (entry) *entry->m_bool = value;
+      return true;
+    }
+
+    bool number_integer(json::number_integer_t value) {
+      if (m_skip > 0) return true;
+      if (!m_entry && value >= 0) return Unsigned(static_cast<json::number_unsigned_t>(value));
+      return Number(static_cast<double>(value));
+    }
+
+    bool number_unsigned(json::number_unsigned_t value) {
+      if (m_skip > 0) return true;
+      if (!m_entry) return Unsigned(value);
+      return Number(static_cast<double>(value));
+    }
+
+    bool number_float(json::number_float_t value, const std::string &) {
+      if (m_skip > 0) return true;
+      return Number(static_cast<double>(value));
+    }
+
+    bool string(std::string &value) {
+      if (m_skip > 0) return true;
+      auto entry = Find(E_STRING);
+      if (entry) *entry->m_string = std::move(value);
+      return true;
+    }
+
+    template<class Binary>
+    bool binary(Binary &) {
+      return Unexpected();
+    }
+
+    bool start_object(std::size_t) {
+      if (m_skip > 0) {
+        m_skip++;
+        return true;
+      }
+      if (m_entry) m_parser.Error("unexpected object in " + m_entry_key);
+      // Objects are always entered, their declared entries being found by the path of their keys
+      m_keys.emplace_back();
+      return true;
+    }
+
+    bool key(std::string &key) {
+      if (m_skip == 0) m_keys.back() = std::move(key);
+      return true;
+    }
+
+    bool end_object() {
+      if (m_skip > 0) {
+        m_skip--;
+        return true;
+      }
+      m_keys.pop_back();
+      return true;
+    }
+
+    bool start_array(std::size_t) {
+      if (m_skip > 0) {
+        m_skip++;
+        return true;
+      }
+
+      if (!m_entry) {
+        auto path = Path();
+        auto it = m_parser.m_entries.find(path);
+        if (it == m_parser.m_entries.end()) {
+          // Not declared : the whole array is skipped
+          m_skip = 1;
+          return true;
+        }
+        auto &entry = it->second;
+        if (entry.m_type != E_AXIS && entry.m_type != E_ARRAY && entry.m_type != E_MATRIX) {
+          m_parser.Error("unexpected array for " + path);
+        }
+        if (entry.m_read) m_parser.Error(path + " given twice");
+        m_entry = &entry;
+        m_entry_key = std::move(path);
+      }
+
+      if (++m_depth > (m_entry->m_type == E_MATRIX ? 2 : 1)) {
+        m_parser.Error("unexpected nested array in " + m_entry_key);
+      }
+      m_parser.StartArray(m_entry_key, *m_entry, m_depth);
+      return true;
+    }
+
+    bool end_array() {
+      if (m_skip > 0) {
+        m_skip--;
+        return true;
+      }
+      m_parser.EndArray(m_entry_key, *m_entry, m_depth);
+      if (--m_depth == 0) m_entry = nullptr;
+      return true;
+    }
+
+    bool parse_error(std::size_t, const std::string &, const json::exception &error) {
+      m_parser.Error(error.what());
+    }
+
+   private:
+    std::string Path() const {
+      if (m_keys.empty()) m_parser.Error("the performance data must be a json object");
+      std::string path = m_keys.front();
+      for (std::size_t i = 1; i < m_keys.size(); i++) path += "/" + m_keys[i];
+      return path;
+    }
+
+    /// Declared scalar entry of the current key, nullptr if the key is not declared
+    Entry *Find(EntryType type) {
+      if (m_entry) m_parser.Error("non numeric value in " + m_entry_key);
+      auto path = Path();
+      auto it = m_parser.m_entries.find(path);
+      if (it == m_parser.m_entries.end()) return nullptr;
+      if (it->second.m_type != type) m_parser.Error("unexpected value for " + path);
+      it->second.m_read = true;
+      return &it->second;
+    }
+
+    bool Number(double value) {
+      if (!m_entry) {
+        // Floating point or negative value outside of an array
+        if (Find(E_UNSIGNED)) m_parser.Error("unexpected value for " + Path());
+        return true;
+      }
+      if (m_depth != (m_entry->m_type == E_MATRIX ? 2 : 1)) m_parser.Error("unexpected value in " + m_entry_key);
+      m_parser.Value(m_entry_key, *m_entry, value);
+      return true;
+    }
+
+    bool Unsigned(json::number_unsigned_t value) {
+      auto entry = Find(E_UNSIGNED);
+      if (entry) *entry->m_unsigned = static_cast<unsigned int>(value);
+      return true;
+    }
+
+    bool Unexpected() {
+      if (m_skip > 0) return true;
+      if (m_entry) m_parser.Error("non numeric value in " + m_entry_key);
+      if (m_parser.m_entries.count(Path()) > 0) m_parser.Error("unexpected value for " + Path());
+      return true;
+    }
+
+   private:
+    PerformanceDataParser &m_parser;
+
+    std::vector<std::string> m_keys;  // current key of each open object
+    std::size_t m_skip = 0;           // depth in a skipped array
+
+    Entry *m_entry = nullptr;         // array or matrix being read
+    std::string m_entry_key;
+    std::size_t m_depth = 0;
+
+  };
+
+
+  PerformanceDataParser::PerformanceDataParser(std::string context) : m_context(std::move(context)) {}
+
+  PerformanceDataParser::Entry &PerformanceDataParser::Add(const std::string &key, EntryType type, bool required) {
+    auto &entry = m_entries[key];
+    entry = Entry();
+    entry.m_type = type;
+    entry.m_required = required;
+    return entry;
+  }
+
+  void PerformanceDataParser::AddAxis(const std::string &key, std::vector<double> &values, double scale,
+                                      bool required) {
+    auto &entry = Add(key, E_AXIS, required);
+    entry.m_values = &values;
+    entry.m_scale = scale;
+  }
+
+  void PerformanceDataParser::AddArray(const std::string &key, std::vector<double> &values, const std::string &axis,
+                                       bool required) {
+    auto &entry = Add(key, E_ARRAY, required);
+    entry.m_values = &values;
+    entry.m_first_axis = axis;
+  }
+
+  void PerformanceDataParser::AddMatrix(const std::string &key, std::vector<double> &values,
+                                        const std::string &first_axis, const std::string &second_axis,
+                                        bool required) {
+    auto &entry = Add(key, E_MATRIX, required);
+    entry.m_values = &values;
+    entry.m_first_axis = first_axis;
+    entry.m_second_axis = second_axis;
+  }
+
+  void PerformanceDataParser::AddOption(const std::string &key, std::string &value) {
+    Add(key, E_STRING, false).m_string = &value;
+  }
+
+  void PerformanceDataParser::AddOption(const std::string &key, bool &value) {
+    Add(key, E_BOOL, false).m_bool = &value;
+  }
+
+  void PerformanceDataParser::AddOption(const std::string &key, unsigned int &value) {
+    Add(key, E_UNSIGNED, false).m_unsigned = &value;
+  }
+
+  void PerformanceDataParser::Parse(const std::string &json_string) {
+
+    for (auto &entry : m_entries) entry.second.m_read = false;
+
+    Handler handler(*this);
+    json::sax_parse(json_string, &handler);
+
+    for (const auto &entry : m_entries) {
+      if (entry.second.m_required && !entry.second.m_read) Error("no " + entry.first);
+    }
+    for (auto &entry : m_entries) {
+      if (entry.second.m_read) Finalize(entry.first, entry.second);
+    }
+  }
+
+  bool PerformanceDataParser::Has(const std::string &key) const {
+    auto it = m_entries.find(key);
+    return it != m_entries.end() && it->second.m_read;
+  }
+
+  std::size_t PerformanceDataParser::AxisSize(const std::string &axis) const {
+    auto it = m_entries.find(axis);
+    if (it == m_entries.end() || it->second.m_type != E_AXIS) {
+      throw std::logic_error(m_context + " : " + axis + " is not declared as an axis");
+    }
+    return it->second.m_read ? it->second.m_values->size() : 0;
+  }
+
+  void PerformanceDataParser::StartArray(const std::string &key, Entry &entry, std::size_t depth) {
+
+    if (depth == 2) {
+      // Matrix row
+      if (entry.m_in_place && entry.m_nb_rows == entry.m_second_size) {
+        Error(key + " has more rows than " + entry.m_second_axis + " values");
+      }
+      entry.m_nb_values = 0;
+      return;
+    }
+
+    auto &values = *entry.m_values;
+    values.clear();
+    entry.m_nb_values = 0;
+    entry.m_nb_rows = 0;
+
+    switch (entry.m_type) {
+      case E_AXIS:
+        break;
+      case E_ARRAY:
+        entry.m_first_size = entry.m_first_axis.empty() ? 0 : AxisSize(entry.m_first_axis);
+        values.reserve(entry.m_first_size);
+        break;
+      case E_MATRIX:
+        entry.m_first_size = AxisSize(entry.m_first_axis);
+        entry.m_second_size = AxisSize(entry.m_second_axis);
+        entry.m_in_place = entry.m_first_size > 0 && entry.m_second_size > 0;
+        if (entry.m_in_place) values.resize(entry.m_first_size * entry.m_second_size);
+        break;
+      default:
+        break;
+    }
+  }
+
+  void PerformanceDataParser::Value(const std::string &key, Entry &entry, double value) {
+
+    auto &values = *entry.m_values;
+
+    switch (entry.m_type) {
+      case E_AXIS:
+        value *= entry.m_scale;
+        if (!values.empty() && !(value > values.back())) {
+          Error(key + " not strictly increasing (" + std::to_string(value) + " after " +
+                std::to_string(values.back()) + ")");
+        }
+        values.push_back(value);
+        break;
+
+      case E_ARRAY:
+        if (entry.m_first_size > 0 && entry.m_nb_values == entry.m_first_size) {
+          Error(key + " not covering all " + entry.m_first_axis + " range");
+        }
+        values.push_back(value);
+        break;
+
+      case E_MATRIX:
+        if (entry.m_first_size > 0 && entry.m_nb_values == entry.m_first_size) {
+          Error(key + " rows not covering all " + entry.m_first_axis + " range");
+        }
+        if (entry.m_in_place) {
+          values[entry.m_nb_values * entry.m_second_size + entry.m_nb_rows] = value;
+        } else {
+          values.push_back(value);
+        }
+        break;
+
+      default:
+        break;
+    }
+    entry.m_nb_values++;
+  }
+
+  void PerformanceDataParser::EndArray(const std::string &key, Entry &entry, std::size_t depth) {
+
+    if (depth == 2) {
+      // The first row gives the row size when the first axis is not read yet
+      if (entry.m_first_size == 0) entry.m_first_size = entry.m_nb_values;
+      if (entry.m_nb_values != entry.m_first_size) {
+        Error(key + " rows not covering all " + entry.m_first_axis + " range");
+      }
+      entry.m_nb_rows++;
+      return;
+    }
+
+    if (entry.m_type == E_MATRIX && entry.m_in_place && entry.m_nb_rows != entry.m_second_size) {
+      Error(key + " not covering all " + entry.m_second_axis + " range");
+    }
+    entry.m_read = true;
+  }
+
+  void PerformanceDataParser::Finalize(const std::string &key, Entry &entry) {
+
+    if (entry.m_type == E_ARRAY && !entry.m_first_axis.empty()) {
+      if (entry.m_values->size() != AxisSize(entry.m_first_axis)) {
+        Error(key + " not covering all " + entry.m_first_axis + " range");
+      }
+    }
+
+    if (entry.m_type == E_MATRIX && !entry.m_in_place) {
+      // Rows read before their axes : transposed to the table layout
+      auto n1 = AxisSize(entry.m_first_axis);
+      auto n2 = AxisSize(entry.m_second_axis);
+      if (entry.m_nb_rows != n2) Error(key + " not covering all " + entry.m_second_axis + " range");
+      if (entry.m_values->size() != n1 * n2) Error(key + " rows not covering all " + entry.m_first_axis + " range");
+
+      std::vector<double> values(n1 * n2);
+      for (std::size_t i = 0; i < n2; i++) {
+        for (std::size_t j = 0; j < n1; j++) values[j * n2 + i] = (*entry.m_values)[i * n1 + j];
+      }
+      *entry.m_values = std::move(values);
+    }
+  }
+
+  void PerformanceDataParser::Error(const std::string &message) const {
+    throw std::runtime_error(m_context + " : " + message);
+  }
+
+}  // end namespace acme
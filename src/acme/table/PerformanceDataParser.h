@@ -0,0 +1,112 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#ifndef ACME_PERFORMANCEDATAPARSER_H
+#define ACME_PERFORMANCEDATAPARSER_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace acme {
+
+  /// Streaming (SAX) parser of the json performance data of a model.
+  ///
+  /// The entries to read are declared first with their destination, then Parse reads the json string once and writes
+  /// each value directly into it : no json document nor intermediate array is built. Sizes and the ordering of the axes
+  /// are checked as the values are read. Keys of nested objects are joined with '/' ("fourier/ct/a"), entries which are
+  /// not declared are skipped.
+  ///
+  /// 2D entries are given in the json as one row per node of their second axis, and are written in the layout of
+  /// PerformanceTable2D::AddData (second axis varying fastest). When both axes precede the matrix in the json, each
+  /// value goes to its final slot as it is read, otherwise the rows are transposed once the whole string is read.
+  class PerformanceDataParser {
+
+   public:
+    /// \param context prefix of the error messages ("CPP parser", ...)
+    explicit PerformanceDataParser(std::string context);
+
+    /// Axis values, multiplied by scale (unit conversion), which must be strictly increasing
+    void AddAxis(const std::string &key, std::vector<double> &values, double scale = 1., bool required = true);
+
+    /// Values at the nodes of an axis declared with AddAxis, or of any size if axis is empty
+    void AddArray(const std::string &key, std::vector<double> &values, const std::string &axis = "",
+                  bool required = true);
+
+    /// Values at the nodes of the (first_axis, second_axis) grid, given as one row per node of the second axis
+    void AddMatrix(const std::string &key, std::vector<double> &values, const std::string &first_axis,
+                   const std::string &second_axis, bool required = true);
+
+    /// Optional scalar entries, left unchanged when absent from the json
+    void AddOption(const std::string &key, std::string &value);
+
+    void AddOption(const std::string &key, bool &value);
+
+    void AddOption(const std::string &key, unsigned int &value);
+
+    /// \throws std::runtime_error for invalid json, values of unexpected type, missing required entries, unsorted axes
+    /// and sizes not matching the axes
+    void Parse(const std::string &json_string);
+
+    /// Was the entry in the parsed json string
+    bool Has(const std::string &key) const;
+
+   private:
+    enum EntryType { E_AXIS, E_ARRAY, E_MATRIX, E_STRING, E_BOOL, E_UNSIGNED };
+
+    struct Entry {
+      EntryType m_type;
+      bool m_required = true;
+      bool m_read = false;
+
+      std::vector<double> *m_values = nullptr;
+      std::string *m_string = nullptr;
+      bool *m_bool = nullptr;
+      unsigned int *m_unsigned = nullptr;
+
+      double m_scale = 1.;
+      std::string m_first_axis;
+      std::string m_second_axis;
+
+      // Reading state of arrays and matrices
+      std::size_t m_nb_values = 0;    // values read in the current row (whole array for 1D entries)
+      std::size_t m_nb_rows = 0;
+      std::size_t m_first_size = 0;   // size of the first axis (matrix rows), zero while unknown
+      std::size_t m_second_size = 0;  // size of the second axis (number of matrix rows), zero while unknown
+      bool m_in_place = false;        // matrix values written at their final slot as they are read
+    };
+
+    class Handler;
+
+    Entry &Add(const std::string &key, EntryType type, bool required);
+
+    /// Size of a read axis, zero if the axis is not read yet
+    std::size_t AxisSize(const std::string &axis) const;
+
+    void StartArray(const std::string &key, Entry &entry, std::size_t depth);
+
+    void EndArray(const std::string &key, Entry &entry, std::size_t depth);
+
+    void Value(const std::string &key, Entry &entry, double value);
+
+    void Finalize(const std::string &key, Entry &entry);
+
+    [[noreturn]] void Error(const std::string &message) const;
+
+   private:
+    std::string m_context;
+    std::map<std::string, Entry> m_entries;
+
+  };
+
+}  // end namespace acme
+
+#endif //ACME_PERFORMANCEDATAPARSER_H
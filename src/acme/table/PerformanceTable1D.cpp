@@ -0,0 +1,267 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#include "PerformanceTable1D.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace acme {
+
+  namespace {
+
+    /// Node slopes of the Fritsch-Carlson monotone piecewise cubic interpolation (PCHIP) : zero slope at local extrema,
+    /// weighted harmonic mean of the adjacent secants elsewhere, which prevents any overshoot
+    void MonotoneCubicSlopes(const std::vector<double> &h, const std::vector<double> &d, std::vector<double> &m) {
+      auto n = m.size();
+      m.front() = d.front();
+      m.back() = d.back();
+      for (std::size_t i = 1; i < n - 1; i++) {
+        if (d[i - 1] * d[i] <= 0.) {
+          m[i] = 0.;
+        } else {
+          double w1 = 2. * h[i] + h[i - 1];
+          double w2 = h[i] + 2. * h[i - 1];
+          m[i] = (w1 + w2) / (w1 / d[i - 1] + w2 / d[i]);
+        }
+      }
+    }
+
+    /// Node slopes of the Akima interpolation, secants being extrapolated by two intervals on each side
+    void AkimaSlopes(const std::vector<double> &d, std::vector<double> &m) {
+      auto n = m.size();
+      if (n < 2) return;  // no secant (rejected by TableAxis::SetValues)
+
+      // Extended secants : e[k + 2] = d[k], for k in [-2, n]
+      std::vector<double> e(n + 3);
+      std::copy(d.begin(), d.begin() + (n - 1), e.begin() + 2);
+      if (n == 2) {
+        e[1] = e[0] = e[3] = e[4] = d[0];
+      } else {
+        e[1] = 2. * e[2] - e[3];
+        e[0] = 2. * e[1] - e[2];
+        e[n + 1] = 2. * e[n] - e[n - 1];
+        e[n + 2] = 2. * e[n + 1] - e[n];
+      }
+
+      for (std::size_t i = 0; i < n; i++) {
+        // secants d[i-2], d[i-1], d[i], d[i+1]
+        double w1 = std::abs(e[i + 3] - e[i + 2]);
+        double w2 = std::abs(e[i + 1] - e[i]);
+        m[i] = (w1 + w2 > 0.) ? (w1 * e[i + 1] + w2 * e[i + 2]) / (w1 + w2) : 0.5 * (e[i + 1] + e[i + 2]);
+      }
+    }
+
+  }  // end anonymous namespace
+
+  void PerformanceTable1D::SetX(const std::vector<double> &x) {
+    m_axis.SetValues(x);
+    m_names.clear();
+    m_mirror_parities.clear();
+    StoreData({});
+  }
+
+  ColumnHandle PerformanceTable1D::AddY(const std::string &name, const std::vector<double> &y) {
+
+    auto n = m_axis.GetSize();
+    if (n == 0) {
+      throw std::runtime_error("PerformanceTable1D : SetX must be called before AddY");
+    }
+    if (y.size() != n) {
+      throw std::runtime_error("PerformanceTable1D : column " + name + " has " + std::to_string(y.size()) +
+                               " values, " + std::to_string(n) + " expected");
+    }
+    if (std::find(m_names.begin(), m_names.end(), name) != m_names.end()) {
+      throw std::runtime_error("PerformanceTable1D : column " + name + " already defined");
+    }
+    if (!m_mirror_parities.empty()) {
+      throw std::runtime_error("PerformanceTable1D : SetMirrorParities must be called after AddY");
+    }
+
+    // Rebuild the interleaved layout with the new column appended
+    auto nc = m_names.size();
+    auto old_data = GetData();
+    std::vector<double> data(n * (nc + 1));
+    for (std::size_t i = 0; i < n; i++) {
+      std::copy(old_data.begin() + i * nc, old_data.begin() + (i + 1) * nc, data.begin() + i * (nc + 1));
+      data[i * (nc + 1) + nc] = y[i];
+    }
+    m_names.push_back(name);
+    StoreData(data);
+
+    return static_cast<ColumnHandle>(nc);
+  }
+
+  void PerformanceTable1D::SetData(const double *x, std::size_t nx, const std::vector<std::string> &names,
+                                   const double *data, const std::shared_ptr<const void> &owner) {
+
+    for (auto name = names.begin(); name != names.end(); ++name) {
+      if (std::find(names.begin(), name, *name) != name) {
+        throw std::runtime_error("PerformanceTable1D : column " + *name + " already defined");
+      }
+    }
+
+    m_axis.SetValues(x, nx, owner);
+    m_names = names;
+    m_mirror_parities.clear();
+
+    auto size = nx * names.size();
+    if (m_single_precision) {
+      StoreData({data, data + size});
+      return;
+    }
+
+    m_data.View(data, size, owner);
+    if (m_interpolation == E_LINEAR) {
+      m_cubic_coeffs.Clear();
+    } else {
+      auto coeffs = ComputeCubicCoefficients(data);
+      m_cubic_coeffs.Assign(coeffs.begin(), coeffs.end());
+    }
+    m_data_single.Clear();
+    m_cubic_coeffs_single.Clear();
+  }
+
+  void PerformanceTable1D::SetInterpolation(InterpolationType interpolation) {
+    auto data = GetData();
+    m_interpolation = interpolation;
+    StoreData(data);
+  }
+
+  void PerformanceTable1D::SetMirrorParities(const std::vector<double> &parities) {
+    if (parities.size() != m_names.size()) {
+      throw std::runtime_error("PerformanceTable1D : " + std::to_string(parities.size()) + " mirror parities for " +
+                               std::to_string(m_names.size()) + " columns");
+    }
+    if (m_axis.GetSize() == 0 || std::abs(m_axis.GetMin()) > 1E-9) {
+      throw std::runtime_error("PerformanceTable1D : the axis of a mirrored table must start at zero");
+    }
+    auto data = GetData();
+    m_mirror_parities = parities;
+    StoreData(data);
+  }
+
+  void PerformanceTable1D::SetSinglePrecision(bool single_precision) {
+    auto data = GetData();
+    m_single_precision = single_precision;
+    StoreData(data);
+  }
+
+  std::vector<double> PerformanceTable1D::GetData() const {
+    if (m_single_precision) return {m_data_single.begin(), m_data_single.end()};
+    return {m_data.begin(), m_data.end()};
+  }
+
+  void PerformanceTable1D::StoreData(const std::vector<double> &data) {
+
+    std::vector<double> coeffs;
+    if (m_interpolation != E_LINEAR) coeffs = ComputeCubicCoefficients(data.data());
+
+    if (m_single_precision) {
+      m_data_single.Assign(data.begin(), data.end());
+      m_cubic_coeffs_single.Assign(coeffs.begin(), coeffs.end());
+      m_data.Clear();
+      m_cubic_coeffs.Clear();
+    } else {
+      m_data.Assign(data.begin(), data.end());
+      m_cubic_coeffs.Assign(coeffs.begin(), coeffs.end());
+      m_data_single.Clear();
+      m_cubic_coeffs_single.Clear();
+    }
+  }
+
+  std::vector<double> PerformanceTable1D::ComputeCubicCoefficients(const double *data) const {
+
+    auto n = m_axis.GetSize();
+    auto nc = m_names.size();
+    std::vector<double> coeffs(n > 0 ? (n - 1) * nc * 4 : 0, 0.);
+    if (n == 0 || nc == 0) return coeffs;
+
+    auto &x = m_axis.GetValues();
+    std::vector<double> h(n - 1), y(n), d(n - 1), m(n);
+    for (std::size_t i = 0; i < n - 1; i++) h[i] = x[i + 1] - x[i];
+
+    // Positive half of a symmetric table : the slopes are computed on the whole table, of 2 n - 1 nodes, the negative
+    // half being mirrored from the positive one
+    bool is_mirrored = !m_mirror_parities.empty() && n > 1;
+    std::vector<double> h_whole, d_whole, m_whole;
+    if (is_mirrored) {
+      h_whole.resize(2 * (n - 1));
+      d_whole.resize(2 * (n - 1));
+      m_whole.resize(2 * n - 1);
+      for (std::size_t i = 0; i < n - 1; i++) {
+        h_whole[n - 2 - i] = h[i];
+        h_whole[n - 1 + i] = h[i];
+      }
+    }
+
+    for (std::size_t column = 0; column < nc; column++) {
+
+      for (std::size_t i = 0; i < n; i++) y[i] = data[i * nc + column];
+      for (std::size_t i = 0; i < n - 1; i++) d[i] = (y[i + 1] - y[i]) / h[i];
+
+      if (is_mirrored) {
+        // Secant of the mirrored interval [-x[i + 1], -x[i]] : -d[i] for an even column, d[i] for an odd one
+        auto parity = m_mirror_parities[column];
+        for (std::size_t i = 0; i < n - 1; i++) {
+          d_whole[n - 2 - i] = -parity * d[i];
+          d_whole[n - 1 + i] = d[i];
+        }
+      }
+      auto &slopes = is_mirrored ? m_whole : m;
+
+      switch (m_interpolation) {
+        case E_MONOTONE_CUBIC:
+          MonotoneCubicSlopes(is_mirrored ? h_whole : h, is_mirrored ? d_whole : d, slopes);
+          break;
+        case E_AKIMA:
+          AkimaSlopes(is_mirrored ? d_whole : d, slopes);
+          break;
+        case E_LINEAR:
+          return coeffs;
+      }
+      if (is_mirrored) std::copy(m_whole.begin() + (n - 1), m_whole.end(), m.begin());
+
+      // Hermite cubic on each interval, expressed in the normalized coordinate t in [0, 1]
+      for (std::size_t i = 0; i < n - 1; i++) {
+        auto c = coeffs.data() + (i * nc + column) * 4;
+        double dy = y[i + 1] - y[i];
+        double m0 = m[i] * h[i];
+        double m1 = m[i + 1] * h[i];
+        c[0] = y[i];
+        c[1] = m0;
+        c[2] = 3. * dy - 2. * m0 - m1;
+        c[3] = -2. * dy + m0 + m1;
+      }
+    }
+
+    return coeffs;
+  }
+
+  ColumnHandle PerformanceTable1D::GetColumnHandle(const std::string &name) const {
+    auto it = std::find(m_names.begin(), m_names.end(), name);
+    if (it == m_names.end()) {
+      throw std::out_of_range("PerformanceTable1D : no column named " + name);
+    }
+    return static_cast<ColumnHandle>(it - m_names.begin());
+  }
+
+  std::size_t PerformanceTable1D::GetMemoryUsage() const {
+    return m_axis.GetMemoryUsage() + VectorMemoryUsage(m_names) + VectorMemoryUsage(m_mirror_parities) +
+           VectorMemoryUsage(m_data) + VectorMemoryUsage(m_data_single) +
+           VectorMemoryUsage(m_cubic_coeffs) + VectorMemoryUsage(m_cubic_coeffs_single);
+  }
+
+  double PerformanceTable1D::Eval(const std::string &name, const double &x) const {
+    return Eval(Locate(x), GetColumnHandle(name));
+  }
+
+}  // end namespace acme
@@ -0,0 +1,210 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#ifndef ACME_PERFORMANCETABLE1D_H
+#define ACME_PERFORMANCETABLE1D_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <initializer_list>
+
+#include "InterpolationType.h"
+#include "TableAxis.h"
+
+namespace acme {
+
+  /// Integer key of a column in a performance table, resolved once at initialization
+  using ColumnHandle = unsigned int;
+
+
+  /// Multi-column 1D lookup table.
+  ///
+  /// All the columns share the same axis so that the interval of a given x is located once and reused to evaluate every
+  /// requested column. Values are stored interleaved per node (all the columns of node i are contiguous) so that the
+  /// evaluation of every column of an interval touches a single cache line in most cases.
+  ///
+  /// Interpolation is linear by default. Piecewise cubic interpolations (see InterpolationType) have their polynomial
+  /// coefficients computed when the table is built, and give continuous first derivatives.
+  ///
+  /// Values are stored in double precision by default. The single precision storage halves the memory footprint of
+  /// the table, evaluation being still carried out in double precision.
+  ///
+  /// The axis and node values may also be used in place in memory held by another object, such as a curve file mapped
+  /// in memory (see SetData and CurveFile).
+  class PerformanceTable1D {
+
+   public:
+    PerformanceTable1D() = default;
+
+    /// Set the axis values. Must be called before adding columns.
+    void SetX(const std::vector<double> &x);
+
+    /// Add a column to the table and get back its handle
+    ColumnHandle AddY(const std::string &name, const std::vector<double> &y);
+
+    /// Set the axis and every column at once from values held by owner. With the double precision storage, they are
+    /// used in place instead of being copied (only the cubic coefficients are then computed and held by the table) ;
+    /// owner is kept alive as long as the table uses them. Later changes of the interpolation or of the precision make
+    /// a copy of the values.
+    /// \param x axis values, nx values
+    /// \param data node values interleaved per node : data[i * names.size() + column], nx * names.size() values
+    void SetData(const double *x, std::size_t nx, const std::vector<std::string> &names, const double *data,
+                 const std::shared_ptr<const void> &owner);
+
+    /// Set the interpolation used for every column of the table
+    void SetInterpolation(InterpolationType interpolation);
+
+    InterpolationType GetInterpolation() const { return m_interpolation; }
+
+    /// Declare the table as the positive half of a table symmetric about x = 0, its first node. The cubic slopes are
+    /// computed as on the whole table, each column being extended to negative x as an even (parity 1) or odd (parity -1)
+    /// function : the slope at zero is then zero for even columns and the mirrored secant for odd ones, so that the
+    /// curves mirrored at evaluation have no kink at zero. Must be called once every column is added.
+    /// \param parities one per column, in the order of the columns
+    /// \throws std::runtime_error if there is not one parity per column or if the axis does not start at zero
+    void SetMirrorParities(const std::vector<double> &parities);
+
+    /// Store the values (and cubic coefficients) in single precision, or back in double precision
+    void SetSinglePrecision(bool single_precision);
+
+    bool IsSinglePrecision() const { return m_single_precision; }
+
+    /// Get the handle of a column from its name
+    /// \throws std::out_of_range if there is no column with that name
+    ColumnHandle GetColumnHandle(const std::string &name) const;
+
+    std::size_t GetNbColumns() const { return m_names.size(); }
+
+    const TableAxis &GetAxis() const { return m_axis; }
+
+    /// Heap memory held by the table, in bytes (the object itself excluded)
+    std::size_t GetMemoryUsage() const;
+
+    /// Locate the interval of the axis containing x
+    AxisInterval Locate(const double &x) const { return m_axis.Locate(x); }
+
+    /// Locate the interval of the axis containing x, starting the search from the hint (see TableAxis)
+    AxisInterval Locate(const double &x, AxisHint &hint) const { return m_axis.Locate(x, hint); }
+
+    /// Locate x without throwing when it is outside of the axis range, see TableAxis
+    AxisInterval Locate(const double &x, AxisHint &hint, bool extrapolate, bool &is_out_of_range) const {
+      return m_axis.Locate(x, hint, extrapolate, is_out_of_range);
+    }
+
+    /// Evaluate a column on an already located interval
+    inline double Eval(const AxisInterval &interval, ColumnHandle column) const;
+
+    /// Evaluate a column and its derivative with respect to x on an already located interval
+    inline double EvalWithDerivative(const AxisInterval &interval, ColumnHandle column, double &derivative) const;
+
+    /// Evaluate a list of columns at x with a single search on the axis.
+    /// \param values output, must have room for columns.size() values
+    /// \return the located interval, so that it can be used to evaluate other columns
+    inline AxisInterval Eval(const double &x, std::initializer_list<ColumnHandle> columns, double *values) const;
+
+    /// Evaluate a single column at x
+    double Eval(const std::string &name, const double &x) const;
+
+   private:
+    /// Node values in double precision, whatever the storage
+    std::vector<double> GetData() const;
+
+    /// Store the node values with the current precision, and the cubic coefficients if needed
+    void StoreData(const std::vector<double> &data);
+
+    std::vector<double> ComputeCubicCoefficients(const double *data) const;
+
+    template<class Real>
+    inline double EvalImpl(const Real *data, const Real *coeffs, const AxisInterval &interval, ColumnHandle column,
+                           double *derivative) const;
+
+   private:
+    TableAxis m_axis;
+    std::vector<std::string> m_names;
+
+    InterpolationType m_interpolation = E_LINEAR;
+    bool m_single_precision = false;
+    std::vector<double> m_mirror_parities;  // positive half of a symmetric table, see SetMirrorParities
+
+    // Node values, interleaved per node : m_data[i * nb_columns + column]. Only one of them is filled, depending on the
+    // precision
+    TableArray<double> m_data;
+    TableArray<float> m_data_single;
+
+    // For cubic interpolations, polynomial coefficients in the normalized interval coordinate, interleaved per interval :
+    // y = c0 + c1 t + c2 t^2 + c3 t^3, with ck = m_cubic_coeffs[(i * nb_columns + column) * 4 + k]
+    TableArray<double> m_cubic_coeffs;
+    TableArray<float> m_cubic_coeffs_single;
+
+  };
+
+
+  template<class Real>
+  double PerformanceTable1D::EvalImpl(const Real *data,
+                                      const Real *coeffs,
+                                      const AxisInterval &interval,
+                                      ColumnHandle column,
+                                      double *derivative) const {
+    auto nc = m_names.size();
+    double t = interval.m_weight;
+
+    if (m_interpolation == E_LINEAR) {
+      double y0 = data[interval.m_index * nc + column];
+      double y1 = data[(interval.m_index + 1) * nc + column];
+      if (derivative) {
+        auto &x = m_axis.GetValues();
+        *derivative = (y1 - y0) / (x[interval.m_index + 1] - x[interval.m_index]);
+      }
+      return y0 + t * (y1 - y0);
+    }
+
+    // Weights outside of [0, 1] (extrapolation, see TableAxis) : linear extrapolation of the cubic from the bound
+    auto c = coeffs + (interval.m_index * nc + column) * 4;
+    double c0 = c[0], c1 = c[1], c2 = c[2], c3 = c[3];
+    double tb = std::min(std::max(t, 0.), 1.);
+    double slope = c1 + tb * (2. * c2 + 3. * tb * c3);
+    if (derivative) {
+      auto &x = m_axis.GetValues();
+      *derivative = slope / (x[interval.m_index + 1] - x[interval.m_index]);
+    }
+    return c0 + tb * (c1 + tb * (c2 + tb * c3)) + (t - tb) * slope;
+  }
+
+  double PerformanceTable1D::Eval(const AxisInterval &interval, ColumnHandle column) const {
+    if (m_single_precision) {
+      return EvalImpl(m_data_single.data(), m_cubic_coeffs_single.data(), interval, column, nullptr);
+    }
+    return EvalImpl(m_data.data(), m_cubic_coeffs.data(), interval, column, nullptr);
+  }
+
+  double PerformanceTable1D::EvalWithDerivative(const AxisInterval &interval,
+                                                ColumnHandle column,
+                                                double &derivative) const {
+    if (m_single_precision) {
+      return EvalImpl(m_data_single.data(), m_cubic_coeffs_single.data(), interval, column, &derivative);
+    }
+    return EvalImpl(m_data.data(), m_cubic_coeffs.data(), interval, column, &derivative);
+  }
+
+  AxisInterval PerformanceTable1D::Eval(const double &x,
+                                        std::initializer_list<ColumnHandle> columns,
+                                        double *values) const {
+    auto interval = Locate(x);
+    for (auto column : columns) {
+      *values++ = Eval(interval, column);
+    }
+    return interval;
+  }
+
+}  // end namespace acme
+
+#endif //ACME_PERFORMANCETABLE1D_H
@@ -0,0 +1,121 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#include "PerformanceTable2D.h"
+
+namespace acme {
+
+  void PerformanceTable2D::SetX(const std::vector<double> &x) {
+    m_x_axis.SetValues(x);
+    m_names.clear();
+    StoreData({});
+  }
+
+  void PerformanceTable2D::SetY(const std::vector<double> &y) {
+    m_y_axis.SetValues(y);
+    m_names.clear();
+    StoreData({});
+  }
+
+  void PerformanceTable2D::CheckAxes() const {
+    if (m_x_axis.GetSize() == 0 || m_y_axis.GetSize() == 0) {
+      throw std::runtime_error("PerformanceTable2D : SetX and SetY must be called before AddData");
+    }
+  }
+
+  ColumnHandle PerformanceTable2D::AddData(const std::string &name, const std::vector<double> &data) {
+
+    CheckAxes();
+
+    auto n = m_x_axis.GetSize() * m_y_axis.GetSize();
+    if (data.size() != n) {
+      throw std::runtime_error("PerformanceTable2D : column " + name + " has " + std::to_string(data.size()) +
+                               " values, " + std::to_string(n) + " expected");
+    }
+    if (std::find(m_names.begin(), m_names.end(), name) != m_names.end()) {
+      throw std::runtime_error("PerformanceTable2D : column " + name + " already defined");
+    }
+
+    // Rebuild the interleaved layout with the new column appended
+    auto nc = m_names.size();
+    auto old_data = GetData();
+    std::vector<double> interleaved(n * (nc + 1));
+    for (std::size_t k = 0; k < n; k++) {
+      std::copy(old_data.begin() + k * nc, old_data.begin() + (k + 1) * nc, interleaved.begin() + k * (nc + 1));
+      interleaved[k * (nc + 1) + nc] = data[k];
+    }
+    m_names.push_back(name);
+    StoreData(interleaved);
+
+    return static_cast<ColumnHandle>(nc);
+  }
+
+  void PerformanceTable2D::SetData(const double *x, std::size_t nx, const double *y, std::size_t ny,
+                                   const std::vector<std::string> &names, const double *data,
+                                   const std::shared_ptr<const void> &owner) {
+
+    for (auto name = names.begin(); name != names.end(); ++name) {
+      if (std::find(names.begin(), name, *name) != name) {
+        throw std::runtime_error("PerformanceTable2D : column " + *name + " already defined");
+      }
+    }
+
+    m_x_axis.SetValues(x, nx, owner);
+    m_y_axis.SetValues(y, ny, owner);
+    m_names = names;
+
+    auto size = nx * ny * names.size();
+    if (m_single_precision) {
+      StoreData({data, data + size});
+    } else {
+      m_data.View(data, size, owner);
+      m_data_single.Clear();
+    }
+  }
+
+  void PerformanceTable2D::SetSinglePrecision(bool single_precision) {
+    auto data = GetData();
+    m_single_precision = single_precision;
+    StoreData(data);
+  }
+
+  std::vector<double> PerformanceTable2D::GetData() const {
+    if (m_single_precision) return {m_data_single.begin(), m_data_single.end()};
+    return {m_data.begin(), m_data.end()};
+  }
+
+  void PerformanceTable2D::StoreData(const std::vector<double> &data) {
+    if (m_single_precision) {
+      m_data_single.Assign(data.begin(), data.end());
+      m_data.Clear();
+    } else {
+      m_data.Assign(data.begin(), data.end());
+      m_data_single.Clear();
+    }
+  }
+
+  ColumnHandle PerformanceTable2D::GetColumnHandle(const std::string &name) const {
+    auto it = std::find(m_names.begin(), m_names.end(), name);
+    if (it == m_names.end()) {
+      throw std::out_of_range("PerformanceTable2D : no column named " + name);
+    }
+    return static_cast<ColumnHandle>(it - m_names.begin());
+  }
+
+  std::size_t PerformanceTable2D::GetMemoryUsage() const {
+    return m_x_axis.GetMemoryUsage() + m_y_axis.GetMemoryUsage() + VectorMemoryUsage(m_names) + VectorMemoryUsage(m_data) + VectorMemoryUsage(m_data_single);
+  }
+
+  double PerformanceTable2D::Eval(const std::string &name, const double &x, const double &y) const {
+    return Eval(Locate(x, y), GetColumnHandle(name));
+  }
+
+}  // end namespace acme
@@ -0,0 +1,175 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#ifndef ACME_PERFORMANCETABLE2D_H
+#define ACME_PERFORMANCETABLE2D_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <initializer_list>
+
+#include "TableAxis.h"
+#include "PerformanceTable1D.h"
+
+namespace acme {
+
+  /// Location of a point in a 2D table : intervals on both axes
+  struct TableCell {
+    AxisInterval m_x;
+    AxisInterval m_y;
+  };
+
+
+  /// Multi-column 2D lookup table with bilinear interpolation.
+  ///
+  /// The cell containing (x, y) is located once and all the columns are evaluated with the same bilinear weights.
+  /// Values are stored interleaved per grid node (all the columns of node (i, j) are contiguous) so that evaluating
+  /// every column of a cell touches the same cache lines.
+  ///
+  /// As for PerformanceTable1D, values may be stored in single precision, evaluation being still in double precision,
+  /// or used in place in memory held by another object (see SetData).
+  class PerformanceTable2D {
+
+   public:
+    PerformanceTable2D() = default;
+
+    /// Set the x axis values. SetX and SetY must be called before adding columns.
+    void SetX(const std::vector<double> &x);
+
+    /// Set the y axis values. SetX and SetY must be called before adding columns.
+    void SetY(const std::vector<double> &y);
+
+    /// Add a column to the table and get back its handle
+    /// \param data values at the grid nodes, with y varying fastest : data[i * ny + j] is the value at (x_i, y_j)
+    ColumnHandle AddData(const std::string &name, const std::vector<double> &data);
+
+    /// Set both axes and every column at once from values held by owner. With the double precision storage, they are
+    /// used in place instead of being copied, owner being kept alive as long as the table uses them (see
+    /// PerformanceTable1D::SetData).
+    /// \param data node values interleaved per node, y varying fastest : data[(i * ny + j) * names.size() + column]
+    void SetData(const double *x, std::size_t nx, const double *y, std::size_t ny,
+                 const std::vector<std::string> &names, const double *data, const std::shared_ptr<const void> &owner);
+
+    /// Store the values in single precision, or back in double precision
+    void SetSinglePrecision(bool single_precision);
+
+    bool IsSinglePrecision() const { return m_single_precision; }
+
+    /// Get the handle of a column from its name
+    /// \throws std::out_of_range if there is no column with that name
+    ColumnHandle GetColumnHandle(const std::string &name) const;
+
+    std::size_t GetNbColumns() const { return m_names.size(); }
+
+    const TableAxis &GetXAxis() const { return m_x_axis; }
+
+    const TableAxis &GetYAxis() const { return m_y_axis; }
+
+    /// Heap memory held by the table, in bytes (the object itself excluded)
+    std::size_t GetMemoryUsage() const;
+
+    /// Locate the cell containing (x, y)
+    TableCell Locate(const double &x, const double &y) const {
+      return {m_x_axis.Locate(x), m_y_axis.Locate(y)};
+    }
+
+    /// Locate the cell containing (x, y), starting the searches from the hints (see TableAxis)
+    TableCell Locate(const double &x, const double &y, AxisHint &x_hint, AxisHint &y_hint) const {
+      return {m_x_axis.Locate(x, x_hint), m_y_axis.Locate(y, y_hint)};
+    }
+
+    /// Locate (x, y) without throwing when it is outside of the table, see TableAxis. Weights outside of [0, 1] give a
+    /// bilinear extrapolation.
+    /// \param is_out_of_range set when x or y is outside of its axis range
+    TableCell Locate(const double &x, const double &y, AxisHint &x_hint, AxisHint &y_hint, bool extrapolate,
+                     bool &is_out_of_range) const {
+      bool is_x_out_of_range, is_y_out_of_range;
+      TableCell cell{m_x_axis.Locate(x, x_hint, extrapolate, is_x_out_of_range),
+                     m_y_axis.Locate(y, y_hint, extrapolate, is_y_out_of_range)};
+      is_out_of_range = is_x_out_of_range || is_y_out_of_range;
+      return cell;
+    }
+
+    /// Evaluate a column on an already located cell
+    inline double Eval(const TableCell &cell, ColumnHandle column) const;
+
+    /// Evaluate a list of columns at (x, y) with a single cell location.
+    /// \param values output, must have room for columns.size() values
+    /// \return the located cell
+    inline TableCell Eval(const double &x, const double &y,
+                          std::initializer_list<ColumnHandle> columns, double *values) const;
+
+    /// Evaluate a single column at (x, y)
+    double Eval(const std::string &name, const double &x, const double &y) const;
+
+   private:
+    void CheckAxes() const;
+
+    /// Node values in double precision, whatever the storage
+    std::vector<double> GetData() const;
+
+    /// Store the node values with the current precision
+    void StoreData(const std::vector<double> &data);
+
+    template<class Real>
+    inline double EvalImpl(const Real *data, const TableCell &cell, ColumnHandle column) const;
+
+   private:
+    TableAxis m_x_axis;
+    TableAxis m_y_axis;
+    std::vector<std::string> m_names;
+
+    bool m_single_precision = false;
+
+    // Node values, interleaved per node : m_data[(i * ny + j) * nb_columns + column]. Only one of them is filled,
+    // depending on the precision
+    TableArray<double> m_data;
+    TableArray<float> m_data_single;
+
+  };
+
+
+  template<class Real>
+  double PerformanceTable2D::EvalImpl(const Real *data, const TableCell &cell, ColumnHandle column) const {
+    auto nc = m_names.size();
+    auto row = m_y_axis.GetSize() * nc;
+
+    auto p00 = data + cell.m_x.m_index * row + cell.m_y.m_index * nc + column;
+    auto p10 = p00 + row;
+
+    double wx = cell.m_x.m_weight;
+    double wy = cell.m_y.m_weight;
+
+    double v00 = p00[0], v01 = p00[nc], v10 = p10[0], v11 = p10[nc];
+    double y0 = v00 + wy * (v01 - v00);
+    double y1 = v10 + wy * (v11 - v10);
+    return y0 + wx * (y1 - y0);
+  }
+
+  double PerformanceTable2D::Eval(const TableCell &cell, ColumnHandle column) const {
+    if (m_single_precision) return EvalImpl(m_data_single.data(), cell, column);
+    return EvalImpl(m_data.data(), cell, column);
+  }
+
+  TableCell PerformanceTable2D::Eval(const double &x, const double &y,
+                                     std::initializer_list<ColumnHandle> columns,
+                                     double *values) const {
+    auto cell = Locate(x, y);
+    for (auto column : columns) {
+      *values++ = Eval(cell, column);
+    }
+    return cell;
+  }
+
+}  // end namespace acme
+
+#endif //ACME_PERFORMANCETABLE2D_H
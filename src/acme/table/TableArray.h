@@ -0,0 +1,105 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#ifndef ACME_TABLEARRAY_H
+#define ACME_TABLEARRAY_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace acme {
+
+  /// Contiguous values of a performance table, either held by the array or used in place in memory held by another
+  /// object (typically a curve file mapped in memory, see CurveFile), which the array then keeps alive.
+  ///
+  /// Read accesses follow the std::vector ones, so that the tables use both kinds of storage the same way.
+  template<class T>
+  class TableArray {
+
+   public:
+    TableArray() = default;
+
+    TableArray(const TableArray &other) { *this = other; }
+
+    TableArray(TableArray &&other) noexcept = default;
+
+    TableArray &operator=(const TableArray &other) {
+      if (this == &other) return *this;
+      m_values = other.m_values;
+      m_owner = other.m_owner;
+      m_data = m_owner ? other.m_data : m_values.data();
+      m_size = other.m_size;
+      return *this;
+    }
+
+    TableArray &operator=(TableArray &&other) noexcept = default;
+
+    /// Copy the values into the array
+    template<class Iterator>
+    void Assign(Iterator first, Iterator last) {
+      m_values.assign(first, last);
+      m_values.shrink_to_fit();
+      m_owner.reset();
+      m_data = m_values.data();
+      m_size = m_values.size();
+    }
+
+    /// Use size values held by owner in place, without any copy
+    void View(const T *data, std::size_t size, std::shared_ptr<const void> owner) {
+      m_values.clear();
+      m_values.shrink_to_fit();
+      m_owner = std::move(owner);
+      m_data = data;
+      m_size = size;
+    }
+
+    void Clear() {
+      m_values.clear();
+      m_values.shrink_to_fit();
+      m_owner.reset();
+      m_data = nullptr;
+      m_size = 0;
+    }
+
+    /// Are the values used in place in memory held by another object
+    bool IsView() const { return m_owner != nullptr; }
+
+    /// Heap memory held by the array, in bytes (values used in place excluded)
+    std::size_t GetMemoryUsage() const { return m_values.capacity() * sizeof(T); }
+
+    const T *data() const { return m_data; }
+
+    std::size_t size() const { return m_size; }
+
+    bool empty() const { return m_size == 0; }
+
+    const T &operator[](std::size_t i) const { return m_data[i]; }
+
+    const T &front() const { return m_data[0]; }
+
+    const T &back() const { return m_data[m_size - 1]; }
+
+    const T *begin() const { return m_data; }
+
+    const T *end() const { return m_data + m_size; }
+
+   private:
+    std::vector<T> m_values;
+    std::shared_ptr<const void> m_owner;
+    const T *m_data = nullptr;
+    std::size_t m_size = 0;
+
+  };
+
+}  // end namespace acme
+
+#endif //ACME_TABLEARRAY_H
@@ -0,0 +1,57 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#include "TableAxis.h"
+
+#include <cmath>
+
+namespace acme {
+
+  void TableAxis::SetValues(const std::vector<double> &values) {
+    CheckValues(values.data(), values.size());
+    m_values.Assign(values.begin(), values.end());
+    DetectUniformSpacing();
+  }
+
+  void TableAxis::SetValues(const double *values, std::size_t size, std::shared_ptr<const void> owner) {
+    CheckValues(values, size);
+    m_values.View(values, size, std::move(owner));
+    DetectUniformSpacing();
+  }
+
+  void TableAxis::CheckValues(const double *values, std::size_t size) {
+
+    if (size < 2) {
+      throw std::runtime_error("TableAxis : at least two nodes are required");
+    }
+
+    if (std::adjacent_find(values, values + size, std::greater_equal<double>()) != values + size) {
+      throw std::runtime_error("TableAxis : values must be strictly increasing");
+    }
+  }
+
+  void TableAxis::DetectUniformSpacing() {
+
+    // Uniform spacing detection. The tolerance only needs to guarantee that the direct index computation is at most
+    // one interval away from the right one, the exact interval being then recovered from the actual node values.
+    auto n = m_values.size();
+    double spacing = (m_values.back() - m_values.front()) / double(n - 1);
+    m_is_uniform = true;
+    for (std::size_t i = 1; i < n; i++) {
+      if (std::abs(m_values[i] - (m_values.front() + double(i) * spacing)) > s_uniform_tolerance * spacing) {
+        m_is_uniform = false;
+        break;
+      }
+    }
+    m_inv_spacing = 1. / spacing;
+  }
+
+}  // end namespace acme
@@ -0,0 +1,256 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#ifndef ACME_TABLEAXIS_H
+#define ACME_TABLEAXIS_H
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+
+#include "TableArray.h"
+
+namespace acme {
+
+  /// Memory footprint of the elements of a vector (heap allocation only)
+  template<class T>
+  std::size_t VectorMemoryUsage(const std::vector<T> &values) {
+    return values.capacity() * sizeof(T);
+  }
+
+  /// Memory footprint of a list of names (heap allocations only)
+  inline std::size_t VectorMemoryUsage(const std::vector<std::string> &names) {
+    auto bytes = names.capacity() * sizeof(std::string);
+    for (const auto &name : names) bytes += name.capacity();
+    return bytes;
+  }
+
+  /// Heap memory held by a table array (values used in place excluded)
+  template<class T>
+  std::size_t VectorMemoryUsage(const TableArray<T> &values) {
+    return values.GetMemoryUsage();
+  }
+
+
+  /// Location of a value on a table axis.
+  /// m_index is the index of the lower node of the interval and m_weight the normalized position of the value inside
+  /// the interval (0 on the lower node, 1 on the upper node).
+  struct AxisInterval {
+    std::size_t m_index;
+    double m_weight;
+  };
+
+
+  /// Index of the last interval located on an axis, used as the starting point of the next search.
+  ///
+  /// A hint belongs to a single caller (a thread, a unit of a fleet, a batch evaluation) and must not be shared between
+  /// concurrent callers. Whatever its value, it only affects the cost of the search, never its result.
+  class AxisHint {
+
+   public:
+    AxisHint() : m_index(0) {}
+
+    std::size_t Get() const { return m_index; }
+
+    void Set(std::size_t index) { m_index = index; }
+
+   private:
+    std::size_t m_index;
+
+  };
+
+  /// Interval hints of a caller evaluating a model repeatedly, for the (up to two) axes of the model tables : x is the
+  /// first axis (advance ratio or angle, attack angle), y the second one (pitch ratio, flap angle).
+  ///
+  /// The hints are given with the inputs of the models (see PropellerInput, RudderInput), so that threads and units
+  /// evaluating the same model each hunt from their own last interval.
+  struct TableHints {
+    AxisHint m_x;
+    AxisHint m_y;
+  };
+
+
+  /// Sorted sample points of a performance table.
+  ///
+  /// Uniformly spaced axes are detected when the values are set. The interval of a value is then obtained by a direct
+  /// index computation instead of a binary search, so that the lookup cost does not depend on the axis resolution.
+  class TableAxis {
+
+   public:
+    TableAxis() = default;
+
+    /// Set the axis node values. They must be strictly increasing and at least two nodes are required.
+    void SetValues(const std::vector<double> &values);
+
+    /// Same as above, the size values being used in place in memory held by owner (see TableArray)
+    void SetValues(const double *values, std::size_t size, std::shared_ptr<const void> owner);
+
+    const TableArray<double> &GetValues() const { return m_values; }
+
+    std::size_t GetSize() const { return m_values.size(); }
+
+    double GetMin() const { return m_values.front(); }
+
+    double GetMax() const { return m_values.back(); }
+
+    /// Heap memory held by the axis, in bytes (the object itself excluded)
+    std::size_t GetMemoryUsage() const { return VectorMemoryUsage(m_values); }
+
+    /// Is the axis uniformly spaced (within a tolerance relative to the mean spacing)
+    bool IsUniform() const { return m_is_uniform; }
+
+    /// Locate the interval containing x
+    /// \throws std::out_of_range if x is outside of the axis range
+    inline AxisInterval Locate(const double &x) const;
+
+    /// Locate the interval containing x, hunting outward from the interval given by the hint which is then updated.
+    /// For slowly varying inputs, the interval is found in a few comparisons whatever the axis resolution.
+    /// \throws std::out_of_range if x is outside of the axis range
+    inline AxisInterval Locate(const double &x, AxisHint &hint) const;
+
+    /// Same as above without throwing when x is outside of the axis range : x is then located on the first or last
+    /// interval, with a weight clamped to [0, 1] or, if extrapolate, its actual weight (outside of [0, 1]) for a linear
+    /// extrapolation. NaN values are located on the lower bound.
+    /// \param is_out_of_range set when x is outside of the axis range
+    inline AxisInterval Locate(const double &x, AxisHint &hint, bool extrapolate, bool &is_out_of_range) const;
+
+   private:
+    static void CheckValues(const double *values, std::size_t size);
+
+    void DetectUniformSpacing();
+
+    inline bool IsInRange(const double &x) const { return x >= m_values.front() && x <= m_values.back(); }
+
+    inline void CheckRange(const double &x) const;
+
+    inline AxisInterval LocateInRange(const double &x) const;
+
+    inline AxisInterval LocateInRange(const double &x, AxisHint &hint) const;
+
+   private:
+    TableArray<double> m_values;
+
+    static constexpr double s_uniform_tolerance = 1E-3;
+
+    bool m_is_uniform = false;
+    double m_inv_spacing = 0.; // inverse of the mean spacing, for uniform axes
+
+  };
+
+
+  void TableAxis::CheckRange(const double &x) const {
+    if (!IsInRange(x)) {
+      throw std::out_of_range("TableAxis : value " + std::to_string(x) + " outside of the range [" +
+                              std::to_string(m_values.front()) + ", " + std::to_string(m_values.back()) + "]");
+    }
+  }
+
+  AxisInterval TableAxis::Locate(const double &x) const {
+    CheckRange(x);
+    return LocateInRange(x);
+  }
+
+  AxisInterval TableAxis::Locate(const double &x, AxisHint &hint) const {
+    CheckRange(x);
+    return LocateInRange(x, hint);
+  }
+
+  AxisInterval TableAxis::Locate(const double &x, AxisHint &hint, bool extrapolate, bool &is_out_of_range) const {
+    is_out_of_range = !IsInRange(x);
+    if (!is_out_of_range) return LocateInRange(x, hint);
+
+    bool is_above = x > m_values.back();
+    std::size_t i = is_above ? m_values.size() - 2 : 0;
+    double weight = is_above ? 1. : 0.;
+    if (extrapolate && !std::isnan(x)) weight = (x - m_values[i]) / (m_values[i + 1] - m_values[i]);
+    hint.Set(i);
+    return {i, weight};
+  }
+
+  AxisInterval TableAxis::LocateInRange(const double &x) const {
+
+    std::size_t i;
+    if (m_is_uniform) {
+      // Direct index computation, clamped so that the upper bound maps onto the last interval
+      i = std::min(static_cast<std::size_t>((x - m_values.front()) * m_inv_spacing), m_values.size() - 2);
+      // The nodes may deviate slightly from the exact uniform grid : one step correction on the actual node values
+      if (x < m_values[i]) {
+        i--;
+      } else if (x >= m_values[i + 1] && i < m_values.size() - 2) {
+        i++;
+      }
+    } else {
+      // Index of the first node strictly greater than x, clamped so that the upper bound maps onto the last interval
+      auto upper = std::upper_bound(m_values.begin() + 1, m_values.end() - 1, x);
+      i = (upper - m_values.begin()) - 1;
+    }
+
+    return {i, (x - m_values[i]) / (m_values[i + 1] - m_values[i])};
+  }
+
+  AxisInterval TableAxis::LocateInRange(const double &x, AxisHint &hint) const {
+
+    if (m_is_uniform) {
+      auto interval = LocateInRange(x);
+      hint.Set(interval.m_index);
+      return interval;
+    }
+
+    auto last = m_values.size() - 1;
+    std::size_t i = std::min(hint.Get(), last - 1);
+
+    if (x < m_values[i] || x > m_values[i + 1]) {
+
+      // Bracket x between lo and hi by doubling steps from the hint, such that m_values[lo] <= x and either
+      // x < m_values[hi] or hi is the last node
+      std::size_t lo, hi, step = 1;
+      if (x > m_values[i + 1]) {
+        lo = i + 1;
+        while (true) {
+          hi = lo + step;
+          if (hi >= last) {
+            hi = last;
+            break;
+          }
+          if (x < m_values[hi]) break;
+          lo = hi;
+          step *= 2;
+        }
+      } else {
+        hi = i;
+        while (true) {
+          if (hi <= step) {
+            lo = 0;
+            break;
+          }
+          lo = hi - step;
+          if (m_values[lo] <= x) break;
+          hi = lo;
+          step *= 2;
+        }
+      }
+
+      // Bisection inside the bracket
+      auto upper = std::upper_bound(m_values.begin() + lo + 1, m_values.begin() + hi, x);
+      i = (upper - m_values.begin()) - 1;
+    }
+
+    hint.Set(i);
+    return {i, (x - m_values[i]) / (m_values[i + 1] - m_values[i])};
+  }
+
+}  // end namespace acme
+
+#endif //ACME_TABLEAXIS_H
@@ -0,0 +1,282 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#include "TableSimplification.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "PerformanceTable1D.h"
+
+namespace acme {
+
+  namespace {
+
+    /// Max deviation, on the nodes strictly between first and last, from the chord joining first and last
+    double ChordError(const std::vector<double> &x,
+                      const std::vector<std::vector<double>> &curves,
+                      std::size_t first,
+                      std::size_t last) {
+      double error = 0.;
+      auto h = x[last] - x[first];
+      for (const auto &curve : curves) {
+        auto slope = (curve[last] - curve[first]) / h;
+        for (auto k = first + 1; k < last; k++) {
+          error = std::max(error, std::abs(curve[first] + slope * (x[k] - x[first]) - curve[k]));
+        }
+      }
+      return error;
+    }
+
+    /// Linear interpolation location of xi on the axis x : index of the interval and weight
+    void Locate(const std::vector<double> &x, double xi, std::size_t &index, double &weight) {
+      auto it = std::upper_bound(x.begin(), x.end(), xi);
+      index = std::min(std::size_t(std::max(it - x.begin(), std::ptrdiff_t(1)) - 1), x.size() - 2);
+      weight = (xi - x[index]) / (x[index + 1] - x[index]);
+    }
+
+    template<class T>
+    std::vector<T> Extract(const std::vector<T> &values, const std::vector<std::size_t> &indices) {
+      std::vector<T> extracted;
+      extracted.reserve(indices.size());
+      for (auto i : indices) extracted.push_back(values[i]);
+      return extracted;
+    }
+
+    /// Number of points per original interval at which the deviation of cubic interpolants is measured
+    const int c_nb_samples_per_interval = 10;
+
+    /// Max deviation of the interpolation on the kept nodes from the interpolation on every node, sampled on every
+    /// original interval
+    /// \param errors output, max deviation on each kept interval
+    double InterpolationError(const std::vector<double> &x,
+                              const std::vector<std::vector<double>> &curves,
+                              const std::vector<std::size_t> &kept,
+                              InterpolationType interpolation,
+                              const std::vector<double> &mirror_parities,
+                              std::vector<double> &errors) {
+
+      PerformanceTable1D original, simplified;
+      original.SetX(x);
+      original.SetInterpolation(interpolation);
+      simplified.SetX(Extract(x, kept));
+      simplified.SetInterpolation(interpolation);
+      std::vector<ColumnHandle> original_columns, simplified_columns;
+      for (std::size_t c = 0; c < curves.size(); c++) {
+        original_columns.push_back(original.AddY(std::to_string(c), curves[c]));
+        simplified_columns.push_back(simplified.AddY(std::to_string(c), Extract(curves[c], kept)));
+      }
+      if (!mirror_parities.empty()) {
+        original.SetMirrorParities(mirror_parities);
+        simplified.SetMirrorParities(mirror_parities);
+      }
+
+      errors.assign(kept.size() - 1, 0.);
+      std::size_t j = 0;  // kept interval containing the original interval k
+      for (std::size_t k = 0; k + 1 < x.size(); k++) {
+        while (kept[j + 1] <= k) j++;
+        auto nb_samples = (k + 2 == x.size()) ? c_nb_samples_per_interval + 1 : c_nb_samples_per_interval;
+        for (int s = 0; s < nb_samples; s++) {
+          auto xs = x[k] + (x[k + 1] - x[k]) * s / c_nb_samples_per_interval;
+          auto original_interval = original.Locate(xs);
+          auto simplified_interval = simplified.Locate(xs);
+          for (std::size_t c = 0; c < curves.size(); c++) {
+            auto error = std::abs(simplified.Eval(simplified_interval, simplified_columns[c]) -
+                                  original.Eval(original_interval, original_columns[c]));
+            errors[j] = std::max(errors[j], error);
+          }
+        }
+      }
+
+      return errors.empty() ? 0. : *std::max_element(errors.begin(), errors.end());
+    }
+
+    /// Add removed nodes back to kept until the given interpolation on the kept nodes is within tolerance
+    /// \return the achieved error
+    double RefineTableNodes(const std::vector<double> &x,
+                            const std::vector<std::vector<double>> &curves,
+                            double tolerance,
+                            InterpolationType interpolation,
+                            const std::vector<double> &mirror_parities,
+                            std::vector<std::size_t> &kept) {
+
+      std::vector<double> errors;
+      auto error = InterpolationError(x, curves, kept, interpolation, mirror_parities, errors);
+
+      while (error > tolerance) {
+        std::vector<bool> is_kept(x.size(), false);
+        for (auto i : kept) is_kept[i] = true;
+
+        // The cubic on a kept interval also depends on the slopes at its ends, hence on the two neighbouring intervals
+        // on each side (Akima) : the closest of them still having removed nodes gets its middle node back
+        auto nb_intervals = static_cast<long>(kept.size()) - 1;
+        for (long j = 0; j < nb_intervals; j++) {
+          if (errors[j] <= tolerance) continue;
+          for (long offset : {0, -1, 1, -2, 2}) {
+            auto jj = j + offset;
+            if (jj < 0 || jj >= nb_intervals || kept[jj + 1] - kept[jj] < 2) continue;
+            is_kept[(kept[jj] + kept[jj + 1]) / 2] = true;
+            break;
+          }
+        }
+
+        std::vector<std::size_t> refined;
+        for (std::size_t i = 0; i < x.size(); i++) {
+          if (is_kept[i]) refined.push_back(i);
+        }
+        if (refined.size() == kept.size()) break;  // nothing left to add around the deviating intervals
+
+        kept = std::move(refined);
+        error = InterpolationError(x, curves, kept, interpolation, mirror_parities, errors);
+      }
+
+      return error;
+    }
+
+  }  // end anonymous namespace
+
+  std::vector<std::size_t> SelectTableNodes(const std::vector<double> &x,
+                                            const std::vector<std::vector<double>> &curves,
+                                            double tolerance) {
+
+    auto n = x.size();
+    std::vector<std::size_t> kept;
+    if (n == 0) return kept;
+
+    // Greedy : from the last kept node, extend the segment as far as every skipped node stays within tolerance
+    std::size_t first = 0;
+    kept.push_back(first);
+    while (first < n - 1) {
+      auto last = first + 1;
+      while (last + 1 < n && ChordError(x, curves, first, last + 1) <= tolerance) last++;
+      kept.push_back(last);
+      first = last;
+    }
+
+    return kept;
+  }
+
+  TableSimplificationReport SimplifyTable1D(std::vector<double> &x,
+                                            const std::vector<std::vector<double> *> &columns,
+                                            double tolerance,
+                                            InterpolationType interpolation,
+                                            const std::vector<double> &mirror_parities) {
+
+    TableSimplificationReport report;
+    report.m_nb_nodes_before = x.size();
+
+    std::vector<std::vector<double>> curves;
+    for (auto column : columns) curves.push_back(*column);
+
+    auto kept = SelectTableNodes(x, curves, tolerance);
+    if (interpolation != E_LINEAR && kept.size() > 1) {
+      report.m_max_error = RefineTableNodes(x, curves, tolerance, interpolation, mirror_parities, kept);
+    }
+
+    auto simplified_x = Extract(x, kept);
+    for (std::size_t c = 0; c < columns.size(); c++) *columns[c] = Extract(curves[c], kept);
+
+    // Achieved linear interpolation error, on the original nodes
+    if (interpolation == E_LINEAR && simplified_x.size() > 1) {
+      for (std::size_t k = 0; k < x.size(); k++) {
+        std::size_t index;
+        double weight;
+        Locate(simplified_x, x[k], index, weight);
+        for (std::size_t c = 0; c < columns.size(); c++) {
+          auto &y = *columns[c];
+          auto value = y[index] + weight * (y[index + 1] - y[index]);
+          report.m_max_error = std::max(report.m_max_error, std::abs(value - curves[c][k]));
+        }
+      }
+    }
+
+    x = std::move(simplified_x);
+    report.m_nb_nodes_after = x.size();
+    return report;
+  }
+
+  TableSimplificationReport SimplifyTable2D(std::vector<double> &x,
+                                            std::vector<double> &y,
+                                            const std::vector<std::vector<double> *> &columns,
+                                            double tolerance) {
+
+    TableSimplificationReport report;
+    report.m_nb_nodes_before = x.size() * y.size();
+
+    auto nx = x.size();
+    auto ny = y.size();
+
+    std::vector<std::vector<double>> original;
+    for (auto column : columns) original.push_back(*column);
+
+    // Rows along x : one curve per (column, j)
+    std::vector<std::vector<double>> curves;
+    for (const auto &data : original) {
+      for (std::size_t j = 0; j < ny; j++) {
+        std::vector<double> curve(nx);
+        for (std::size_t i = 0; i < nx; i++) curve[i] = data[i * ny + j];
+        curves.push_back(std::move(curve));
+      }
+    }
+    auto kept_x = SelectTableNodes(x, curves, 0.5 * tolerance);
+
+    // Columns along y, on the kept rows only : one curve per (column, kept i)
+    curves.clear();
+    for (const auto &data : original) {
+      for (auto i : kept_x) {
+        curves.emplace_back(data.begin() + i * ny, data.begin() + (i + 1) * ny);
+      }
+    }
+    auto kept_y = SelectTableNodes(y, curves, 0.5 * tolerance);
+
+    auto simplified_x = Extract(x, kept_x);
+    auto simplified_y = Extract(y, kept_y);
+    auto sny = kept_y.size();
+    for (std::size_t c = 0; c < columns.size(); c++) {
+      auto &data = *columns[c];
+      data.resize(kept_x.size() * sny);
+      for (std::size_t i = 0; i < kept_x.size(); i++) {
+        for (std::size_t j = 0; j < sny; j++) {
+          data[i * sny + j] = original[c][kept_x[i] * ny + kept_y[j]];
+        }
+      }
+    }
+
+    // Achieved error, on the original nodes
+    if (simplified_x.size() > 1 && simplified_y.size() > 1) {
+      for (std::size_t i = 0; i < nx; i++) {
+        std::size_t ix;
+        double wx;
+        Locate(simplified_x, x[i], ix, wx);
+        for (std::size_t j = 0; j < ny; j++) {
+          std::size_t iy;
+          double wy;
+          Locate(simplified_y, y[j], iy, wy);
+          for (std::size_t c = 0; c < columns.size(); c++) {
+            auto p00 = columns[c]->data() + ix * sny + iy;
+            auto p10 = p00 + sny;
+            auto v0 = p00[0] + wy * (p00[1] - p00[0]);
+            auto v1 = p10[0] + wy * (p10[1] - p10[0]);
+            auto value = v0 + wx * (v1 - v0);
+            report.m_max_error = std::max(report.m_max_error, std::abs(value - original[c][i * ny + j]));
+          }
+        }
+      }
+    }
+
+    x = std::move(simplified_x);
+    y = std::move(simplified_y);
+    report.m_nb_nodes_after = x.size() * y.size();
+    return report;
+  }
+
+}  // end namespace acme
@@ -0,0 +1,70 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#ifndef ACME_TABLESIMPLIFICATION_H
+#define ACME_TABLESIMPLIFICATION_H
+
+#include <cstddef>
+#include <vector>
+
+#include "InterpolationType.h"
+
+namespace acme {
+
+  /// Outcome of a table simplification
+  struct TableSimplificationReport {
+    std::size_t m_nb_nodes_before = 0; // total number of grid nodes before simplification
+    std::size_t m_nb_nodes_after = 0;  // total number of grid nodes after simplification
+    double m_max_error = 0.;           // max absolute deviation from the original table, over every column
+
+    /// Ratio between the original and the simplified table sizes (1 when nothing was removed)
+    double GetCompressionRatio() const {
+      return m_nb_nodes_after > 0 ? double(m_nb_nodes_before) / double(m_nb_nodes_after) : 1.;
+    }
+  };
+
+  /// Select the axis nodes to keep so that the piecewise linear interpolation of every curve on the kept nodes does
+  /// not deviate by more than tolerance from its interpolation on all the nodes. The bounds are always kept.
+  ///
+  /// Both interpolants being piecewise linear with breakpoints among the original nodes, their deviation is maximal at
+  /// an original node : checking the removed nodes bounds the error over the whole range.
+  /// \param curves values at the axis nodes, each curve having x.size() values
+  /// \return indices of the kept nodes, in increasing order
+  std::vector<std::size_t> SelectTableNodes(const std::vector<double> &x,
+                                            const std::vector<std::vector<double>> &curves,
+                                            double tolerance);
+
+  /// Remove the redundant nodes of a 1D table, keeping its interpolation within tolerance of the interpolation of the
+  /// original table. x and the columns are modified in place.
+  ///
+  /// With the linear interpolation the error is guaranteed over the whole range (see SelectTableNodes). The cubic
+  /// interpolants depend on the neighbouring nodes through their slopes and may deviate most between the nodes : the
+  /// linear selection is refined, adding removed nodes back where needed, until the deviation sampled on every original
+  /// interval is within tolerance. The reported error is the one of the given interpolation.
+  /// \param mirror_parities for the positive half of a symmetric table, the parities of the columns with which the
+  ///        cubic interpolants are computed (see PerformanceTable1D::SetMirrorParities)
+  TableSimplificationReport SimplifyTable1D(std::vector<double> &x,
+                                            const std::vector<std::vector<double> *> &columns,
+                                            double tolerance,
+                                            InterpolationType interpolation = E_LINEAR,
+                                            const std::vector<double> &mirror_parities = {});
+
+  /// Remove the redundant rows and columns of a 2D grid with a guaranteed max bilinear interpolation error.
+  /// Each axis is simplified with half the tolerance, so that the errors along x and y sum up to at most tolerance.
+  /// \param columns grid values with y varying fastest (data[i * ny + j]), modified in place like x and y
+  TableSimplificationReport SimplifyTable2D(std::vector<double> &x,
+                                            std::vector<double> &y,
+                                            const std::vector<std::vector<double> *> &columns,
+                                            double tolerance);
+
+}  // end namespace acme
+
+#endif //ACME_TABLESIMPLIFICATION_H
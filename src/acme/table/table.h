@@ -0,0 +1,29 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#ifndef ACME_TABLE_H
+#define ACME_TABLE_H
+
+#include "InterpolationType.h"
+#include "TableArray.h"
+#include "TableAxis.h"
+#include "PerformanceTable1D.h"
+#include "PerformanceTable2D.h"
+#include "TableSimplification.h"
+#include "FourierSeries.h"
+#include "ChebyshevSeries.h"
+#include "CurveRegistry.h"
+#include "CurvePointer.h"
+#include "OutOfRangePolicy.h"
+#include "CurveFile.h"
+#include "PerformanceDataParser.h"
+
+#endif //ACME_TABLE_H
@@ -0,0 +1,89 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+// Speed / accuracy trade-off of the Chebyshev representation of FPP1Q open water curves versus the table, for
+// increasing degrees. The open water data may be given as a json file in argument, a B-series like curve is used
+// otherwise.
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include "acme/acme.h"
+
+using namespace acme;
+
+std::string default_open_water_data() {
+  std::stringstream j, kt, kq;
+  for (int i = 0; i <= 85; i++) {
+    double J = i / 99.;
+    if (i > 0) {
+      j << ", ";
+      kt << ", ";
+      kq << ", ";
+    }
+    j << J;
+    kt << 0.3542 - 0.2747 * J - 0.1365 * J * J + 0.0362 * J * J * J;
+    kq << 0.04336 - 0.02771 * J - 0.02141 * J * J + 0.00913 * J * J * J;
+  }
+  return R"({"j": [)" + j.str() + R"(], "kt": [)" + kt.str() + R"(], "kq": [)" + kq.str() + "]}";
+}
+
+int main(int argc, char **argv) {
+
+  std::string open_water_data = default_open_water_data();
+  if (argc > 1) {
+    std::ifstream file(argv[1]);
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    open_water_data = buffer.str();
+  }
+
+  PropellerParams params;
+  params.m_diameter_m = 4.;
+  params.m_screw_direction = RIGHT_HANDED;
+  params.m_hull_wake_fraction_0 = 0.;
+  params.m_thrust_deduction_factor_0 = 0.;
+  params.m_thruster_perf_data_json_string = open_water_data;
+
+  FPP1Q table_propeller(params);
+  table_propeller.Initialize();
+
+  // Slowly varying advance ratio, within the data range
+  const std::size_t nb_evaluations = 5000000;
+  std::vector<double> J(nb_evaluations);
+  for (std::size_t i = 0; i < nb_evaluations; i++) {
+    J[i] = 0.42 + 0.4 * std::sin(1E-5 * double(i));
+  }
+
+  auto time_per_evaluation_ns = [&J](const FPP1Q &propeller) {
+    double sink = 0.;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &Ji : J) sink += propeller.kt(Ji) + propeller.kq(Ji);
+    auto stop = std::chrono::steady_clock::now();
+    if (sink == -1.) std::cout << sink;  // Prevents the loop from being optimized out
+    return std::chrono::duration<double, std::nano>(stop - start).count() / double(J.size());
+  };
+
+  std::cout << "kt + kq evaluation" << std::endl;
+  std::cout << "  table            : " << time_per_evaluation_ns(table_propeller) << " ns" << std::endl;
+
+  for (unsigned int degree : {2, 3, 4, 6, 8, 10, 12}) {
+    params.m_chebyshev_degree = degree;
+    FPP1Q chebyshev_propeller(params);
+    chebyshev_propeller.Initialize();
+    std::cout << "  chebyshev, N = " << degree << (degree < 10 ? "  : " : " : ")
+              << time_per_evaluation_ns(chebyshev_propeller) << " ns, max residual "
+              << chebyshev_propeller.GetChebyshevMaxResidual() << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,93 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+// Scaling of the fleet engine with the number of threads : a fleet of Brix propeller rudder units, built from a few
+// ship designs, is stepped with 1 thread up to the number of hardware threads. The number of units may be given in
+// argument (12000 by default).
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include "acme/acme.h"
+
+using namespace acme;
+
+int main(int argc, char **argv) {
+
+  std::size_t nb_units = argc > 1 ? std::stoul(argv[1]) : 12000;
+  const int nb_steps = 100;
+
+  // Ship designs, shared by the units
+  std::vector<std::shared_ptr<PropellerRudderBase>> designs;
+  for (double diameter : {3., 4., 5., 6.}) {
+    PropellerParams propeller_params;
+    propeller_params.m_diameter_m = diameter;
+    propeller_params.m_screw_direction = RIGHT_HANDED;
+    propeller_params.m_hull_wake_fraction_0 = 0.2;
+    propeller_params.m_thrust_deduction_factor_0 = 0.15;
+    propeller_params.m_thruster_perf_data_json_string =
+        R"({"j": [0, 0.2, 0.4, 0.6, 0.8, 1.0, 1.2, 1.4], "kt": [0.35, 0.29, 0.22, 0.15, 0.07, -0.02, -0.11, -0.21],)"
+        R"( "kq": [0.043, 0.038, 0.031, 0.024, 0.015, 0.005, -0.006, -0.018]})";
+
+    RudderParams rudder_params;
+    rudder_params.m_lateral_area_m2 = 3. * diameter;
+    rudder_params.m_chord_m = 0.75 * diameter;
+    rudder_params.m_height_m = diameter;
+    rudder_params.m_distance_nose_stock_m = 0.25 * diameter;
+    rudder_params.m_hull_wake_fraction_0 = 0.15;
+
+    designs.push_back(std::make_shared<BrixPropellerRudder<FPP1Q, BrixRudderModel>>(propeller_params, rudder_params));
+  }
+
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> speed(2., 6.), drift(-0.3, 0.3), yaw_rate(-0.02, 0.02), rpm(80., 110.);
+  std::normal_distribution<double> rudder_angle(0., 10.);
+  std::vector<PropellerRudderInput> inputs;
+  for (std::size_t i = 0; i < nb_units; i++) {
+    double u = speed(generator);
+    double v = drift(generator);
+    double r = yaw_rate(generator);
+    inputs.push_back({1025., u, v + 45. * r, u, v, r, 5., 50., rpm(generator), 0.,
+                      std::max(-35., std::min(35., rudder_angle(generator)))});
+  }
+
+  std::cout << nb_units << " propeller rudder units, " << nb_steps << " steps" << std::endl;
+
+  auto nb_hardware_threads = std::max(1u, std::thread::hardware_concurrency());
+  double reference_time_ms = 0.;
+  for (unsigned int nb_threads = 1; nb_threads <= nb_hardware_threads; nb_threads *= 2) {
+    FleetEngine fleet(nb_threads);
+    for (std::size_t i = 0; i < nb_units; i++) fleet.AddPropellerRudder(designs[i % designs.size()], inputs[i]);
+    fleet.Initialize();
+
+    double step_time_ms = 0.;
+    double load_imbalance = 0.;
+    std::size_t nb_steals = 0;
+    for (int step = 0; step < nb_steps; step++) {
+      // Rudders sweeping slowly, as an autopilot would
+      for (std::size_t i = 0; i < nb_units; i++) fleet.GetPropellerRudderInput(i).m_rudder_angle_deg *= 0.999;
+      fleet.Step();
+      const auto &stats = fleet.GetLastStepStats();
+      step_time_ms += stats.m_step_time_ms;
+      load_imbalance += stats.m_load_imbalance;
+      nb_steals += stats.m_nb_steals;
+    }
+    step_time_ms /= nb_steps;
+    if (nb_threads == 1) reference_time_ms = step_time_ms;
+
+    std::cout << "  " << nb_threads << " threads : " << step_time_ms << " ms per step, speedup "
+              << reference_time_ms / step_time_ms << ", load imbalance " << 100. * load_imbalance / nb_steps
+              << " %, " << double(nb_steals) / nb_steps << " steals per step" << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,138 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+// Single core throughput of the batch evaluation of N propellers sharing one model (ComputeBatch) versus a loop of
+// scalar Compute calls, for N = 1, 64 and 4096.
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include "acme/acme.h"
+
+using namespace acme;
+
+std::string json_array(const std::vector<double> &values) {
+  std::stringstream ss;
+  ss.precision(17);
+  ss << "[";
+  for (std::size_t i = 0; i < values.size(); i++) ss << (i ? ", " : "") << values[i];
+  ss << "]";
+  return ss.str();
+}
+
+std::string open_water_data() {
+  std::vector<double> j, kt, kq;
+  for (int i = 0; i <= 85; i++) {
+    double J = i / 99.;
+    j.push_back(J);
+    kt.push_back(0.3542 - 0.2747 * J - 0.1365 * J * J + 0.0362 * J * J * J);
+    kq.push_back(0.04336 - 0.02771 * J - 0.02141 * J * J + 0.00913 * J * J * J);
+  }
+  return R"({"j": )" + json_array(j) + R"(, "kt": )" + json_array(kt) + R"(, "kq": )" + json_array(kq) + "}";
+}
+
+std::string four_quadrant_data() {
+  return R"({"fourier": {"ct": {"a": [-0.0584, 0.1327, -0.0081, -0.0213, 0.0036, 0.0059],
+                                "b": [0.0, -0.7316, 0.0221, 0.0480, -0.0107, -0.0039]},
+                         "cq": {"a": [-0.0051, 0.0197, -0.0010, -0.0022, 0.0005, 0.0007],
+                                "b": [0.0, -0.0767, 0.0009, 0.0056, -0.0011, -0.0003]}}})";
+}
+
+struct Fleet {
+  explicit Fleet(std::size_t size) : rho(size, 1025.), u(size), v(size), rpm(size), pitch_ratio(size, 1.),
+                                     uPA(size), sidewash(size), J(size), thrust(size), torque(size), power(size),
+                                     efficiency(size) {
+    for (std::size_t i = 0; i < size; i++) {
+      u[i] = 1. + 4. * double(i % 97) / 97.;
+      v[i] = 0.05 * u[i];
+      rpm[i] = 90. + 30. * double(i % 13) / 13.;
+    }
+  }
+
+  PropellerBatchInput Input() const {
+    return {u.size(), rho.data(), u.data(), v.data(), rpm.data(), pitch_ratio.data()};
+  }
+
+  PropellerBatchOutput Output() {
+    return {uPA.data(), sidewash.data(), J.data(), thrust.data(), torque.data(), power.data(), efficiency.data()};
+  }
+
+  std::vector<double> rho, u, v, rpm, pitch_ratio;
+  std::vector<double> uPA, sidewash, J, thrust, torque, power, efficiency;
+};
+
+// Time per propeller, in ns, the same number of propellers being evaluated whatever the batch size
+template<class Function>
+double time_per_propeller_ns(std::size_t batch_size, Function function) {
+  const std::size_t nb_propellers = 4000000;
+  auto nb_repeats = nb_propellers / batch_size;
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t k = 0; k < nb_repeats; k++) function();
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(stop - start).count() / double(nb_repeats * batch_size);
+}
+
+void bench(const std::string &name, const PropellerBaseModel &propeller) {
+  std::cout << name << std::endl;
+  for (std::size_t size : {1, 64, 4096}) {
+    Fleet fleet(size);
+    double sink = 0.;
+
+    auto scalar_ns = time_per_propeller_ns(size, [&]() {
+      for (std::size_t i = 0; i < size; i++) {
+        auto output = propeller.Compute(PropellerInput{fleet.rho[i], fleet.u[i], fleet.v[i], fleet.rpm[i],
+                                                       fleet.pitch_ratio[i]});
+        sink += output.m_thrust_N;
+      }
+    });
+
+    auto input = fleet.Input();
+    auto output = fleet.Output();
+    auto batch_ns = time_per_propeller_ns(size, [&]() {
+      propeller.ComputeBatch(input, output);
+      sink += fleet.thrust[0];
+    });
+
+    if (sink == -1.) std::cout << sink;  // Prevents the loops from being optimized out
+    std::cout << "  N = " << size << (size < 10 ? "    " : size < 100 ? "   " : " ")
+              << ": scalar " << scalar_ns << " ns (" << 1E3 / scalar_ns << " M/s), batch "
+              << batch_ns << " ns (" << 1E3 / batch_ns << " M/s), speedup " << scalar_ns / batch_ns << std::endl;
+  }
+}
+
+int main() {
+
+  PropellerParams params;
+  params.m_diameter_m = 4.;
+  params.m_screw_direction = RIGHT_HANDED;
+  params.m_hull_wake_fraction_0 = 0.2;
+  params.m_thrust_deduction_factor_0 = 0.15;
+
+  params.m_thruster_perf_data_json_string = open_water_data();
+  FPP1Q table_propeller(params);
+  table_propeller.Initialize();
+
+  params.m_chebyshev_degree = 6;
+  FPP1Q chebyshev_propeller(params);
+  chebyshev_propeller.Initialize();
+
+  params.m_chebyshev_degree = 0;
+  params.m_thruster_perf_data_json_string = four_quadrant_data();
+  FPP4Q fourier_propeller(params);
+  fourier_propeller.Initialize();
+
+  std::cout << "Time per propeller, single core" << std::endl;
+  bench("FPP1Q, table", table_propeller);
+  bench("FPP1Q, chebyshev", chebyshev_propeller);
+  bench("FPP4Q, fourier", fourier_propeller);
+
+  return 0;
+}
@@ -0,0 +1,130 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+// Single core throughput of the batch evaluation of N Brix propeller rudder units (ComputeBatch) versus a loop of
+// scalar Compute calls. The operating points are drawn from a traffic like distribution : cruising and manoeuvring
+// ships, a few of them stopped with their propeller at rest.
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include "acme/acme.h"
+
+using namespace acme;
+
+struct Units {
+  explicit Units(std::size_t size) : in(11, std::vector<double>(size)), out(31, std::vector<double>(size)) {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> speed(2., 7.), drift(-0.3, 0.3), yaw_rate(-0.02, 0.02), rpm(70., 110.),
+        uniform(0., 1.);
+    std::normal_distribution<double> rudder_angle(0., 10.);
+    for (std::size_t i = 0; i < size; i++) {
+      bool is_stopped = uniform(generator) < 0.02;
+      double u = is_stopped ? 0. : speed(generator);
+      double v = is_stopped ? 0. : drift(generator);
+      double r = is_stopped ? 0. : yaw_rate(generator);
+      double values[11] = {1025., u, v + 45. * r, u, v, r, 5., 50., is_stopped ? 0. : rpm(generator), 0.,
+                           std::max(-35., std::min(35., rudder_angle(generator)))};
+      for (std::size_t k = 0; k < 11; k++) in[k][i] = values[k];
+    }
+  }
+
+  PropellerRudderInput Input(std::size_t i) const {
+    return {in[0][i], in[1][i], in[2][i], in[3][i], in[4][i], in[5][i], in[6][i], in[7][i], in[8][i], in[9][i],
+            in[10][i]};
+  }
+
+  PropellerRudderBatchInput BatchInput() const {
+    return {in[0].size(), in[0].data(), in[1].data(), in[2].data(), in[3].data(), in[4].data(), in[5].data(),
+            in[6].data(), in[7].data(), in[8].data(), in[9].data(), in[10].data()};
+  }
+
+  PropellerRudderBatchOutput BatchOutput() {
+    PropellerRudderBatchOutput output;
+    output.m_propeller = {out[0].data(), out[1].data(), out[2].data(), out[3].data(), out[4].data(), out[5].data(),
+                          out[6].data()};
+    output.m_rudder = {out[7].data(), out[8].data(), out[9].data(), out[10].data(), out[11].data(), out[12].data(),
+                       out[13].data(), out[14].data(), out[15].data(), out[16].data()};
+    output.m_area_RP_m2 = out[17].data();
+    output.m_rudder_RP = {out[18].data(), out[19].data(), out[20].data(), out[21].data(), out[22].data(),
+                          out[23].data(), out[24].data(), out[25].data(), out[26].data(), out[27].data()};
+    output.m_fx_N = out[28].data();
+    output.m_fy_N = out[29].data();
+    output.m_mz_Nm = out[30].data();
+    return output;
+  }
+
+  std::vector<std::vector<double>> in;
+  std::vector<std::vector<double>> out;
+};
+
+// Time per unit, in ns, the same number of units being evaluated whatever the batch size
+template<class Function>
+double time_per_unit_ns(std::size_t batch_size, Function function) {
+  const std::size_t nb_units = 2000000;
+  auto nb_repeats = nb_units / batch_size;
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t k = 0; k < nb_repeats; k++) function();
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(stop - start).count() / double(nb_repeats * batch_size);
+}
+
+int main() {
+
+  PropellerParams propeller_params;
+  propeller_params.m_diameter_m = 4.;
+  propeller_params.m_screw_direction = RIGHT_HANDED;
+  propeller_params.m_hull_wake_fraction_0 = 0.2;
+  propeller_params.m_thrust_deduction_factor_0 = 0.15;
+  propeller_params.m_thruster_perf_data_json_string =
+      R"({"fourier": {"ct": {"a": [-0.0584, 0.1327, -0.0081, -0.0213, 0.0036, 0.0059],
+                             "b": [0.0, -0.7316, 0.0221, 0.0480, -0.0107, -0.0039]},
+                      "cq": {"a": [-0.0051, 0.0197, -0.0010, -0.0022, 0.0005, 0.0007],
+                             "b": [0.0, -0.0767, 0.0009, 0.0056, -0.0011, -0.0003]}}})";
+
+  RudderParams rudder_params;
+  rudder_params.m_lateral_area_m2 = 12.;
+  rudder_params.m_chord_m = 3.;
+  rudder_params.m_height_m = 4.;
+  rudder_params.m_distance_nose_stock_m = 1.;
+  rudder_params.m_hull_wake_fraction_0 = 0.15;
+  rudder_params.m_has_hull_influence_transverse_velocity = true;
+  rudder_params.m_aH = 0.2;
+  rudder_params.m_xR = -50.;
+  rudder_params.m_xH = -45.;
+
+  BrixPropellerRudder<FPP4Q, BrixRudderModel> propeller_rudder(propeller_params, rudder_params);
+  propeller_rudder.Initialize();
+
+  std::cout << "BrixPropellerRudder<FPP4Q, BrixRudderModel>, time per unit, single core" << std::endl;
+  for (std::size_t size : {1, 64, 4096}) {
+    Units units(size);
+    double sink = 0.;
+
+    auto scalar_ns = time_per_unit_ns(size, [&]() {
+      for (std::size_t i = 0; i < size; i++) sink += propeller_rudder.Compute(units.Input(i)).m_fy_N;
+    });
+
+    auto input = units.BatchInput();
+    auto output = units.BatchOutput();
+    auto batch_ns = time_per_unit_ns(size, [&]() {
+      propeller_rudder.ComputeBatch(input, output);
+      sink += output.m_fy_N[0];
+    });
+
+    if (sink == -1.) std::cout << sink;  // Prevents the loops from being optimized out
+    std::cout << "  N = " << size << (size < 10 ? "    " : size < 100 ? "   " : " ")
+              << ": scalar " << scalar_ns << " ns (" << 1E3 / scalar_ns << " M/s), batch "
+              << batch_ns << " ns (" << 1E3 / batch_ns << " M/s), speedup " << scalar_ns / batch_ns << std::endl;
+  }
+
+  return 0;
+}
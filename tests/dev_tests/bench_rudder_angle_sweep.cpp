@@ -0,0 +1,94 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+// Cost of the evaluation of a set of candidate rudder angles at the same operating point, as done by an autopilot :
+// rudder angle sweep (ComputeRudderAngleSweep) versus one Compute call per angle, for Brix and MMG propeller rudders.
+
+#include <chrono>
+#include <iostream>
+#include "acme/acme.h"
+
+using namespace acme;
+
+// Time per decision (evaluation of all the candidate angles), in us
+template<class Function>
+double time_per_decision_us(Function function) {
+  const int nb_decisions = 20000;
+  auto start = std::chrono::steady_clock::now();
+  for (int k = 0; k < nb_decisions; k++) function(k);
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(stop - start).count() / nb_decisions;
+}
+
+void bench(const std::string &name, const PropellerRudderBase &propeller_rudder) {
+
+  for (std::size_t nb_angles : {20, 60}) {
+    std::vector<double> rudder_angles(nb_angles);
+    for (std::size_t i = 0; i < nb_angles; i++) rudder_angles[i] = -35. + 70. * double(i) / double(nb_angles - 1);
+    std::vector<double> fx(nb_angles), fy(nb_angles), mz(nb_angles);
+
+    // Slightly different operating point at each decision
+    auto input = [](int k) {
+      double u = 4. + 1E-4 * k;
+      return PropellerRudderInput{1025., u, 0.3, u, 0.2, 0.002, 5., 50., 90., 0., 0.};
+    };
+
+    double sink = 0.;
+    auto compute_time = time_per_decision_us([&](int k) {
+      auto angle_input = input(k);
+      for (std::size_t i = 0; i < nb_angles; i++) {
+        angle_input.m_rudder_angle_deg = rudder_angles[i];
+        sink += propeller_rudder.Compute(angle_input).m_fy_N;
+      }
+    });
+    auto sweep_time = time_per_decision_us([&](int k) {
+      propeller_rudder.ComputeRudderAngleSweep(input(k), nb_angles, rudder_angles.data(), fx.data(), fy.data(),
+                                               mz.data());
+      sink += fy[0];
+    });
+    if (sink == -1.) std::cout << sink;  // Prevents the loops from being optimized out
+
+    std::cout << "  " << name << ", " << nb_angles << " angles : Compute " << compute_time << " us, sweep "
+              << sweep_time << " us, speedup " << compute_time / sweep_time << std::endl;
+  }
+}
+
+int main() {
+
+  PropellerParams propeller_params;
+  propeller_params.m_diameter_m = 4.;
+  propeller_params.m_screw_direction = RIGHT_HANDED;
+  propeller_params.m_hull_wake_fraction_0 = 0.2;
+  propeller_params.m_thrust_deduction_factor_0 = 0.15;
+  propeller_params.m_thruster_perf_data_json_string =
+      R"({"j": [0, 0.2, 0.4, 0.6, 0.8, 1.0], "kt": [0.35, 0.29, 0.22, 0.15, 0.07, -0.02],)"
+      R"( "kq": [0.043, 0.038, 0.031, 0.024, 0.015, 0.005]})";
+
+  RudderParams rudder_params;
+  rudder_params.m_lateral_area_m2 = 12.;
+  rudder_params.m_chord_m = 3.;
+  rudder_params.m_height_m = 4.;
+  rudder_params.m_distance_nose_stock_m = 1.;
+  rudder_params.m_hull_wake_fraction_0 = 0.15;
+  rudder_params.m_has_hull_influence_transverse_velocity = true;
+  rudder_params.m_flow_straightening = 0.5;
+
+  BrixPropellerRudder<FPP1Q, BrixRudderModel> brix(propeller_params, rudder_params);
+  brix.Initialize();
+  MMGPropellerRudder<BrixRudderModel> mmg(propeller_params, rudder_params);
+  mmg.Initialize();
+
+  std::cout << "Time per decision" << std::endl;
+  bench("Brix", brix);
+  bench("MMG", mmg);
+
+  return 0;
+}
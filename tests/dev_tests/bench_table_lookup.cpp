@@ -0,0 +1,71 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+// Cost of a table lookup for a slowly varying input trajectory, as seen in time-domain simulations, versus random
+// inputs, with and without an interval hint.
+
+#include <chrono>
+#include <random>
+#include <iostream>
+#include "acme/acme.h"
+
+using namespace acme;
+
+template<class Lookup>
+double time_per_lookup_ns(const std::vector<double> &inputs, Lookup &&lookup) {
+  double sink = 0.;
+  auto start = std::chrono::steady_clock::now();
+  for (const auto &x : inputs) {
+    auto interval = lookup(x);
+    sink += interval.m_weight + double(interval.m_index);
+  }
+  auto stop = std::chrono::steady_clock::now();
+  if (sink == -1.) std::cout << sink;  // Prevents the loop from being optimized out
+  return std::chrono::duration<double, std::nano>(stop - start).count() / double(inputs.size());
+}
+
+int main() {
+
+  const std::size_t nb_nodes = 2000;
+  const std::size_t nb_lookups = 10000000;
+
+  // Non uniform axis (cosine spacing, as typically produced by CFD post-processing)
+  std::vector<double> nodes(nb_nodes);
+  for (std::size_t i = 0; i < nb_nodes; i++) {
+    nodes[i] = 0.5 * (1. - std::cos(MU_PI * double(i) / double(nb_nodes - 1)));
+  }
+  TableAxis axis;
+  axis.SetValues(nodes);
+
+  // Slowly varying trajectory : advance ratio oscillating during a manoeuvre, sampled at a small time step
+  std::vector<double> trajectory(nb_lookups);
+  for (std::size_t i = 0; i < nb_lookups; i++) {
+    trajectory[i] = 0.5 + 0.4 * std::sin(1E-5 * double(i)) + 0.05 * std::sin(3E-4 * double(i));
+  }
+
+  // Random inputs over the whole axis range
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> distribution(0., 1.);
+  std::vector<double> random(nb_lookups);
+  for (auto &x : random) x = distribution(generator);
+
+  AxisHint hint;
+  auto search = [&axis](const double &x) { return axis.Locate(x); };
+  auto hunt = [&axis, &hint](const double &x) { return axis.Locate(x, hint); };
+
+  std::cout << "Axis with " << nb_nodes << " non uniform nodes, " << nb_lookups << " lookups" << std::endl;
+  std::cout << "  slowly varying, binary search : " << time_per_lookup_ns(trajectory, search) << " ns" << std::endl;
+  std::cout << "  slowly varying, hunt          : " << time_per_lookup_ns(trajectory, hunt) << " ns" << std::endl;
+  std::cout << "  random, binary search         : " << time_per_lookup_ns(random, search) << " ns" << std::endl;
+  std::cout << "  random, hunt                  : " << time_per_lookup_ns(random, hunt) << " ns" << std::endl;
+
+  return 0;
+}
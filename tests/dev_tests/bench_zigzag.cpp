@@ -0,0 +1,241 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+// 10/10 and 20/20 zigzag manoeuvres of a single screw ship, integrated with an implicit Euler scheme, using linear then
+// cubic propeller and rudder tables. Reports the wall-clock time per simulated second, the mean number of Newton
+// iterations per time step and the first overshoot angle, for coarse tables (4 deg on the attack angle).
+//
+// The hull is a linear manoeuvring model with constant coefficients, the point being the cost of the propeller and
+// rudder evaluations inside the nonlinear solver, not the hydrodynamics of the hull.
+
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include "acme/acme.h"
+
+using namespace acme;
+
+using State = std::array<double, 4>; // u, v, r, psi
+
+template<typename T>
+std::string str(const std::vector<T> &values) {
+  std::stringstream ss;
+  ss << "[";
+  for (std::size_t i = 0; i < values.size(); i++) {
+    if (i > 0) ss << ", ";
+    ss << values[i];
+  }
+  ss << "]";
+  return ss.str();
+}
+
+// Open water curves of a 4 blades propeller (polynomial fit of a B-series, P/D = 0.8), coarsely tabulated
+std::string propeller_json(const std::string &interpolation) {
+  std::vector<double> j, kt, kq;
+  for (int i = 0; i <= 18; i++) {
+    double J = 0.05 * i;
+    j.push_back(J);
+    kt.push_back(0.33 - 0.25 * J - 0.12 * J * J);
+    kq.push_back(0.039 - 0.021 * J - 0.015 * J * J);
+  }
+  return R"({"j": )" + str(j) + R"(, "kt": )" + str(kt) + R"(, "kq": )" + str(kq) +
+         R"(, "interpolation": ")" + interpolation + R"("})";
+}
+
+// Rudder lift, drag and moment coefficients with a stall at 20 deg, tabulated every 4 deg
+std::string rudder_json(const std::string &interpolation) {
+  std::vector<double> alpha, cl, cd, cn;
+  for (int i = -12; i <= 12; i++) {
+    double a = 4. * i;
+    double a_rad = a * DEG2RAD;
+    alpha.push_back(a);
+    double linear = 2.8 * a_rad;
+    cl.push_back(std::abs(a) <= 20. ? linear : (a > 0 ? 1. : -1.) * (0.98 - 0.6 * (std::abs(a_rad) - 20. * DEG2RAD)));
+    cd.push_back(0.01 + 1.1 * a_rad * a_rad);
+    cn.push_back(-0.05 * std::sin(2. * a_rad));
+  }
+  return R"({"angle_of_attack_deg": )" + str(alpha) + R"(, "cd": )" + str(cd) + R"(, "cl": )" + str(cl) +
+         R"(, "cn": )" + str(cn) + R"(, "interpolation": ")" + interpolation + R"("})";
+}
+
+struct Ship {
+  double m_mass = 1.2E7;
+  double m_inertia = 1.2E7 * 25. * 25.;
+  double m_resistance = 6.E3;  // X = -R u|u|
+  double m_Yv = -9.E6;
+  double m_Yr = 2.5E8;
+  double m_Nv = -5.E7;
+  double m_Nr = -4.E8;
+  double m_x_propeller = -48.;
+  double m_x_rudder = -50.;
+  double m_rpm = 120.;
+  double m_water_density = 1025.;
+
+  std::unique_ptr<FPP1Q> m_propeller;
+  std::unique_ptr<SimpleRudderModel> m_rudder;
+
+  // Time derivative of the state for a given rudder angle
+  State Derivative(const State &x, double rudder_angle_deg) const {
+    auto u = x[0], v = x[1], r = x[2];
+
+    m_propeller->Compute(m_water_density, u, v + m_x_propeller * r, m_rpm, 0.);
+    m_rudder->Compute(m_water_density, u, v + m_x_rudder * r, rudder_angle_deg, u, v, r, m_x_rudder);
+
+    double X = -m_resistance * u * std::abs(u) + m_propeller->GetThrust() + m_rudder->GetFx();
+    double Y = m_Yv * v + m_Yr * r + m_rudder->GetFy();
+    double N = m_Nv * v + m_Nr * r + m_x_rudder * m_rudder->GetFy() + m_rudder->GetMz();
+
+    return {X / m_mass + v * r, Y / m_mass - u * r, N / m_inertia, r};
+  }
+};
+
+struct Result {
+  double m_wall_clock_per_second_us;
+  double m_mean_newton_iterations;
+  double m_first_overshoot_deg;
+};
+
+// Solves x1 = x0 + dt f(x1) with a Newton method and a finite differences Jacobian
+int ImplicitEulerStep(const Ship &ship, State &x, double rudder_angle_deg, double dt) {
+
+  const double tolerance = 1E-10;
+  const int max_iterations = 50;
+
+  State x0 = x;
+  int iteration = 0;
+  for (; iteration < max_iterations; iteration++) {
+
+    auto f = ship.Derivative(x, rudder_angle_deg);
+    State residual;
+    for (int i = 0; i < 4; i++) residual[i] = x[i] - x0[i] - dt * f[i];
+
+    double norm = 0.;
+    for (int i = 0; i < 4; i++) norm = std::max(norm, std::abs(residual[i]) / (1. + std::abs(x[i])));
+    if (norm < tolerance) break;
+
+    // Jacobian of the residual
+    double jacobian[4][4];
+    for (int k = 0; k < 4; k++) {
+      State xk = x;
+      double eps = 1E-7 * (1. + std::abs(x[k]));
+      xk[k] += eps;
+      auto fk = ship.Derivative(xk, rudder_angle_deg);
+      for (int i = 0; i < 4; i++) jacobian[i][k] = (i == k ? 1. : 0.) - dt * (fk[i] - f[i]) / eps;
+    }
+
+    // Gaussian elimination with partial pivoting
+    double a[4][5];
+    for (int i = 0; i < 4; i++) {
+      for (int k = 0; k < 4; k++) a[i][k] = jacobian[i][k];
+      a[i][4] = -residual[i];
+    }
+    for (int c = 0; c < 4; c++) {
+      int pivot = c;
+      for (int i = c + 1; i < 4; i++) if (std::abs(a[i][c]) > std::abs(a[pivot][c])) pivot = i;
+      for (int k = 0; k < 5; k++) std::swap(a[c][k], a[pivot][k]);
+      for (int i = c + 1; i < 4; i++) {
+        double factor = a[i][c] / a[c][c];
+        for (int k = c; k < 5; k++) a[i][k] -= factor * a[c][k];
+      }
+    }
+    State dx;
+    for (int i = 3; i >= 0; i--) {
+      double sum = a[i][4];
+      for (int k = i + 1; k < 4; k++) sum -= a[i][k] * dx[k];
+      dx[i] = sum / a[i][i];
+    }
+    for (int i = 0; i < 4; i++) x[i] += dx[i];
+  }
+
+  return iteration;
+}
+
+Result RunZigzag(const std::string &interpolation, double execute_angle, int nb_repetitions) {
+
+  PropellerParams propeller_params;
+  propeller_params.m_diameter_m = 4.;
+  propeller_params.m_screw_direction = RIGHT_HANDED;
+  propeller_params.m_hull_wake_fraction_0 = 0.25;
+  propeller_params.m_thrust_deduction_factor_0 = 0.2;
+  propeller_params.m_thruster_perf_data_json_string = propeller_json(interpolation);
+
+  RudderParams rudder_params;
+  rudder_params.m_lateral_area_m2 = 20.;
+  rudder_params.m_chord_m = 4.;
+  rudder_params.m_height_m = 5.;
+  rudder_params.m_hull_wake_fraction_0 = 0.25;
+  rudder_params.m_perf_data_json_string = rudder_json(interpolation);
+
+  Ship ship;
+  ship.m_propeller = std::make_unique<FPP1Q>(propeller_params);
+  ship.m_propeller->Initialize();
+  ship.m_rudder = std::make_unique<SimpleRudderModel>(rudder_params);
+  ship.m_rudder->Initialize();
+
+  const double dt = 0.5;
+  const double duration = 600.;
+  const double rudder_rate = 2.3;  // deg/s
+
+  long nb_iterations = 0;
+  long nb_steps = 0;
+  double overshoot = 0.;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int repetition = 0; repetition < nb_repetitions; repetition++) {
+
+    State x = {6., 0., 0., 0.};
+    double rudder = 0.;
+    double rudder_order = execute_angle;
+    int nb_switches = 0;
+    overshoot = 0.;
+
+    for (double t = 0.; t < duration; t += dt) {
+
+      // Rudder is switched when the heading deviation reaches the execute angle, on the side the rudder turns to
+      double psi_deg = x[3] * RAD2DEG;
+      double turning_side = rudder_order > 0. ? -1. : 1.;
+      if (turning_side * psi_deg >= execute_angle) {
+        rudder_order = -rudder_order;
+        nb_switches++;
+      }
+      if (nb_switches == 1) overshoot = std::max(overshoot, std::abs(psi_deg) - execute_angle);
+
+      rudder += std::max(-rudder_rate * dt, std::min(rudder_rate * dt, rudder_order - rudder));
+
+      nb_iterations += ImplicitEulerStep(ship, x, rudder, dt);
+      nb_steps++;
+    }
+  }
+  auto stop = std::chrono::steady_clock::now();
+
+  double wall_clock_us = std::chrono::duration<double, std::micro>(stop - start).count();
+  return {wall_clock_us / (duration * nb_repetitions), double(nb_iterations) / double(nb_steps), overshoot};
+}
+
+int main() {
+
+  const int nb_repetitions = 50;
+
+  for (auto execute_angle : {10., 20.}) {
+    std::cout << execute_angle << "/" << execute_angle << " zigzag, implicit Euler, dt = 0.5 s" << std::endl;
+    for (const auto &interpolation : {"linear", "monotone_cubic", "akima"}) {
+      auto result = RunZigzag(interpolation, execute_angle, nb_repetitions);
+      std::cout << "  " << interpolation << " tables : "
+                << result.m_wall_clock_per_second_us << " us per simulated second, "
+                << result.m_mean_newton_iterations << " Newton iterations per step, first overshoot "
+                << result.m_first_overshoot_deg << " deg" << std::endl;
+    }
+  }
+
+  return 0;
+}
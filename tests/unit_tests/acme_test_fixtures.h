@@ -0,0 +1,85 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+// Model parameters and performance data shared by the unit tests
+
+#ifndef ACME_TEST_FIXTURES_H
+#define ACME_TEST_FIXTURES_H
+
+#include <string>
+
+#include "acme/acme.h"
+
+namespace acme {
+
+  inline PropellerParams propeller_params(const std::string &perf_data = "") {
+    PropellerParams params;
+    params.m_diameter_m = 4.;
+    params.m_screw_direction = RIGHT_HANDED;
+    params.m_hull_wake_fraction_0 = 0.2;
+    params.m_thrust_deduction_factor_0 = 0.15;
+    params.m_thruster_perf_data_json_string = perf_data;
+    return params;
+  }
+
+  inline RudderParams rudder_params(const std::string &perf_data = "") {
+    RudderParams params;
+    params.m_lateral_area_m2 = 12.;
+    params.m_chord_m = 3.;
+    params.m_height_m = 4.;
+    params.m_distance_nose_stock_m = 1.;
+    params.m_hull_wake_fraction_0 = 0.15;
+    params.m_flap_slope = 1.;
+    params.m_flow_straightening = 0.5;
+    params.m_perf_data_json_string = perf_data;
+    return params;
+  }
+
+  /// \param entries json entries added to the open water data, starting with a comma
+  inline std::string fpp1q_perf_data(const std::string &entries = "") {
+    return R"({"j": [0, 0.2, 0.4, 0.6, 0.8, 1.0, 1.2, 1.4], "kt": [0.35, 0.29, 0.22, 0.15, 0.07, -0.02, -0.11, -0.21],)"
+           R"( "kq": [0.043, 0.038, 0.031, 0.024, 0.015, 0.005, -0.006, -0.018])" + entries + "}";
+  }
+
+  inline std::string fpp4q_perf_data() {
+    return R"({"beta_deg": [-180, -140, -100, -60, -20, 20, 60, 100, 140, 180],)"
+           R"( "ct": [-0.163, 0.449, 0.894, 0.803, 0.276, 0.018, -1.143, -1.384, -0.779, -0.163],)"
+           R"( "cq": [-0.019, 0.055, 0.109, 0.126, 0.056, 0.015, -0.104, -0.123, -0.081, -0.019]})";
+  }
+
+  inline std::string fpp4q_fourier_perf_data() {
+    return R"({"fourier": {"ct": {"a": [-0.0584, 0.1327, -0.0081], "b": [0.0, -0.7316, 0.0221]},)"
+           R"( "cq": {"a": [-0.0051, 0.0197, -0.0010], "b": [0.0, -0.0767, 0.0009]}}})";
+  }
+
+  inline std::string cpp_perf_data() {
+    return R"({"beta_deg": [-180, -90, 0, 90, 180], "p_d": [-1, 0, 1],)"
+           R"( "ct": [[0.1, 0.8, 0.3, -0.5, 0.1], [0.0, 1.1, 0.0, -1.1, 0.0], [-0.16, 0.89, 0.28, -1.38, -0.16]],)"
+           R"( "cq": [[-0.01, -0.07, 0.01, 0.07, -0.01], [0.0, 0.01, 0.0, 0.01, 0.0], [-0.02, 0.11, 0.06, -0.12, -0.02]]})";
+  }
+
+  inline std::string simple_rudder_perf_data() {
+    return R"({"angle_of_attack_deg": [-40, -20, -10, 0, 10, 20, 40],)"
+           R"( "cd": [0.5, 0.045, 0.01, 0.005, 0.01, 0.045, 0.5],)"
+           R"( "cl": [-1.2, -1.74, -1.1, 0.0, 1.1, 1.74, 1.2],)"
+           R"( "cn": [0.1, -0.03, 0.0, 0.0, 0.0, 0.03, -0.1]})";
+  }
+
+  inline std::string flap_rudder_perf_data() {
+    return R"({"flow_incidence_on_main_rudder_deg": [-40, -20, 0, 20, 40], "flap_angle_deg": [-10, 0, 10],)"
+           R"( "Cd": [[0.5, 0.05, 0.01, 0.06, 0.6], [0.5, 0.04, 0.005, 0.04, 0.5], [0.6, 0.06, 0.01, 0.05, 0.5]],)"
+           R"( "Cl": [[-1.4, -1.9, -0.3, 1.5, 1.1], [-1.2, -1.7, 0.0, 1.7, 1.2], [-1.1, -1.5, 0.3, 1.9, 1.4]],)"
+           R"( "Cn": [[0.1, 0.03, 0.01, -0.02, -0.1], [0.1, 0.03, 0.0, -0.03, -0.1], [0.1, 0.02, -0.01, -0.03, -0.1]]})";
+  }
+
+}  // end namespace acme
+
+#endif //ACME_TEST_FIXTURES_H
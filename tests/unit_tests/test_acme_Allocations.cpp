@@ -0,0 +1,244 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+// Checks that the Compute paths of the initialized models do not allocate on the heap : the global operator new is
+// replaced by a counting one, enabled only around the calls under test.
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "acme/acme.h"
+#include "gtest/gtest.h"
+
+#include "acme_test_fixtures.h"
+
+using namespace acme;
+
+
+std::atomic<bool> c_count_allocations{false};
+std::atomic<std::size_t> c_nb_allocations{0};
+std::atomic<std::size_t> c_allocated_bytes{0};
+
+// The replacements pair malloc and free on purpose, GCC would report every inlined new/delete pair of the file
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+void *operator new(std::size_t size) {
+  if (c_count_allocations) {
+    c_nb_allocations++;
+    c_allocated_bytes += size;
+  }
+  if (void *ptr = std::malloc(size ? size : 1)) return ptr;
+  throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+#pragma GCC diagnostic pop
+
+/// Number of heap allocations made by a few calls to function
+template<class Function>
+std::size_t CountAllocations(Function &&function) {
+  c_nb_allocations = 0;
+  c_count_allocations = true;
+  for (int i = 0; i < 3; i++) function();
+  c_count_allocations = false;
+  return c_nb_allocations;
+}
+
+/// Heap memory allocated by a call to function, in bytes
+template<class Function>
+std::size_t CountAllocatedBytes(Function &&function) {
+  c_allocated_bytes = 0;
+  c_count_allocations = true;
+  function();
+  c_count_allocations = false;
+  return c_allocated_bytes;
+}
+
+
+void CheckPropeller(PropellerBaseModel &propeller, double pitch_ratio) {
+  propeller.Initialize();
+  // Performance data no longer needed, not to be copied along with the parameters
+  EXPECT_TRUE(propeller.GetParameters().m_thruster_perf_data_json_string.empty());
+
+  PropellerInput input{1025., 3., 0.2, 100., pitch_ratio};
+  EXPECT_EQ(CountAllocations([&]() { propeller.Compute(input); }), 0);
+  EXPECT_EQ(CountAllocations([&]() { propeller.Compute(1025., 3., 0.2, 100., pitch_ratio); }), 0);
+
+  std::vector<double> rho(8, 1025.), u(8, 3.), v(8, 0.2), rpm(8, 100.), p_d(8, pitch_ratio);
+  std::vector<double> uPA(8), sidewash(8), J(8), thrust(8), torque(8), power(8), efficiency(8);
+  PropellerBatchInput batch_input{8, rho.data(), u.data(), v.data(), rpm.data(), p_d.data()};
+  PropellerBatchOutput batch_output{uPA.data(), sidewash.data(), J.data(), thrust.data(), torque.data(), power.data(),
+                                    efficiency.data()};
+  EXPECT_EQ(CountAllocations([&]() { propeller.ComputeBatch(batch_input, batch_output); }), 0);
+}
+
+void CheckRudder(RudderBaseModel &rudder) {
+  rudder.Initialize();
+  EXPECT_TRUE(rudder.GetParameters().m_perf_data_json_string.empty());
+
+  RudderInput input{1025., 4., 0.3, 12.};
+  EXPECT_EQ(CountAllocations([&]() { rudder.Compute(input); }), 0);
+  EXPECT_EQ(CountAllocations([&]() { rudder.Compute(1025., 4., 0.3, 12., 4., 0.3, 0.01, -50.); }), 0);
+
+  std::vector<double> rho(8, 1025.), u(8, 4.), v(8, 0.3), angle(8, 12.);
+  std::vector<std::vector<double>> results(10, std::vector<double>(8));
+  RudderBatchInput batch_input{8, rho.data(), u.data(), v.data(), angle.data()};
+  RudderBatchOutput batch_output{results[0].data(), results[1].data(), results[2].data(), results[3].data(),
+                                 results[4].data(), results[5].data(), results[6].data(), results[7].data(),
+                                 results[8].data(), results[9].data()};
+  EXPECT_EQ(CountAllocations([&]() { rudder.ComputeBatch(batch_input, batch_output); }), 0);
+}
+
+void CheckPropellerRudder(PropellerRudderBase &propeller_rudder) {
+  propeller_rudder.Initialize();
+
+  PropellerRudderInput input{1025., 4., 0.1, 4., 0.1, 0.001, 5., 50., 100., 0., 10.};
+  EXPECT_EQ(CountAllocations([&]() { propeller_rudder.Compute(input); }), 0);
+  EXPECT_EQ(CountAllocations([&]() {
+    propeller_rudder.Compute(1025., 4., 0.1, 4., 0.1, 0.001, 5., 50., 100., 0., 10.);
+  }), 0);
+
+  std::vector<double> angles = {-30., -10., 0., 10., 30.};
+  std::vector<double> fx(angles.size()), fy(angles.size()), mz(angles.size());
+  EXPECT_EQ(CountAllocations([&]() {
+    propeller_rudder.ComputeRudderAngleSweep(input, angles.size(), angles.data(), fx.data(), fy.data(), mz.data());
+  }), 0);
+}
+
+
+TEST(Allocations, counter) {
+  // The counter itself works
+  EXPECT_EQ(CountAllocations([]() { ::operator delete(::operator new(16)); }), 3);
+  EXPECT_EQ(CountAllocations([]() {}), 0);
+}
+
+TEST(Allocations, propellers) {
+  FPP1Q fpp1q(propeller_params(fpp1q_perf_data()));
+  CheckPropeller(fpp1q, 0.);
+
+  FPP4Q fpp4q(propeller_params(fpp4q_perf_data()));
+  CheckPropeller(fpp4q, 0.);
+
+  FPP4Q fpp4q_fourier(propeller_params(fpp4q_fourier_perf_data()));
+  CheckPropeller(fpp4q_fourier, 0.);
+
+  CPP cpp(propeller_params(cpp_perf_data()));
+  CheckPropeller(cpp, 0.7);
+}
+
+TEST(Allocations, rudders) {
+  SimpleRudderModel simple(rudder_params(simple_rudder_perf_data()));
+  CheckRudder(simple);
+
+  FlapRudderModel flap(rudder_params(flap_rudder_perf_data()));
+  CheckRudder(flap);
+
+  FujiiRudderModel fujii(rudder_params());
+  CheckRudder(fujii);
+
+  BrixRudderModel brix(rudder_params());
+  CheckRudder(brix);
+}
+
+TEST(Allocations, propeller_rudders) {
+  BrixPropellerRudder<FPP1Q, SimpleRudderModel> brix_simple(propeller_params(fpp1q_perf_data()),
+                                                            rudder_params(simple_rudder_perf_data()));
+  CheckPropellerRudder(brix_simple);
+
+  BrixPropellerRudder<FPP1Q, BrixRudderModel> brix(propeller_params(fpp1q_perf_data()), rudder_params());
+  CheckPropellerRudder(brix);
+
+  MMGPropellerRudder<FlapRudderModel> mmg_flap(propeller_params(fpp1q_perf_data()),
+                                               rudder_params(flap_rudder_perf_data()));
+  CheckPropellerRudder(mmg_flap);
+
+  MMGPropellerRudder<FujiiRudderModel> mmg_fujii(propeller_params(fpp1q_perf_data()), rudder_params());
+  CheckPropellerRudder(mmg_fujii);
+}
+
+TEST(Allocations, fleet_step) {
+  FleetEngine fleet(1, 4);
+  auto propeller = std::make_shared<FPP1Q>(propeller_params(fpp1q_perf_data()));
+  auto rudder = std::make_shared<BrixRudderModel>(rudder_params());
+  for (int i = 0; i < 10; i++) {
+    fleet.AddPropeller(propeller, {1025., 3., 0.2, 100., 0.});
+    fleet.AddRudder(rudder, {1025., 4., 0.3, 12.});
+  }
+  fleet.Initialize();
+  fleet.Step();
+
+  EXPECT_EQ(CountAllocations([&]() { fleet.Step(); }), 0);
+}
+
+TEST(Allocations, model_arena) {
+  // Propeller rudder models built in bulk, submodels included, take a fixed number of allocations whatever their number
+  auto build = [](std::size_t count) {
+    return [count]() {
+      BuildPropellerRudders(E_BRIX, E_FPP1Q, propeller_params(), E_BRIX_RUDDER, rudder_params(), count);
+    };
+  };
+  auto nb_allocations = CountAllocations(build(10));
+  EXPECT_EQ(CountAllocations(build(1000)), nb_allocations);
+  // arena, its storage, the vector of models, and the performance data of the propeller and of the rudder
+  EXPECT_LE(nb_allocations, 3 * 5);
+}
+
+TEST(Allocations, model_arena_performance_data) {
+  // The performance data are held once per arena : the memory of the models grows with their number only
+  std::string padding(1 << 20, ' ');
+  auto propeller = propeller_params(fpp1q_perf_data() + padding);
+  auto rudder = rudder_params(simple_rudder_perf_data() + padding);
+  auto build = [&](std::size_t count) {
+    return [&, count]() { BuildPropellerRudders(E_BRIX, E_FPP1Q, propeller, E_SIMPLE_RUDDER, rudder, count); };
+  };
+  using Model = BrixPropellerRudder<FPP1Q, SimpleRudderModel>;
+  auto unit_bytes = sizeof(Model) + sizeof(std::shared_ptr<PropellerRudderBase>);
+  EXPECT_LE(CountAllocatedBytes(build(100)), CountAllocatedBytes(build(1)) + 99 * unit_bytes);
+
+  // Models sharing their performance data initialize like the others
+  auto models = BuildPropellerRudders(E_BRIX, E_FPP1Q, propeller, E_SIMPLE_RUDDER, rudder, 3);
+  auto model = BuildPropellerRudder(E_BRIX, E_FPP1Q, propeller, E_SIMPLE_RUDDER, rudder);
+  model->Initialize();
+  PropellerRudderInput input{1025., 4., 0.2, 4., 0.2, 0.01, -20., -22., 120., 0., 15.};
+  for (const auto &unit : models) {
+    unit->Initialize();
+    EXPECT_EQ(unit->Compute(input).m_fy_N, model->Compute(input).m_fy_N);
+  }
+}
+
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
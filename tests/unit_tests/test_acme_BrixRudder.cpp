@@ -6,6 +6,8 @@
 #include "gtest/gtest.h"
 #include "acme/acme.h"
 
+#include "acme_test_fixtures.h"
+
 using namespace acme;
 
 void test_coefficients(double alpha, BrixRudderModel& rudder, double d, double Cf){
@@ -63,6 +65,138 @@ TEST(BrixRudder, coefficients) {
 
 }
 
+void test_batch_compute(const PropellerRudderBase &propeller_rudder, const std::vector<PropellerRudderInput> &inputs) {
+
+  // Structure of arrays
+  std::vector<std::vector<double>> in(11);
+  for (const auto &input : inputs) {
+    std::size_t k = 0;
+    for (double value : {input.m_water_density, input.m_u_NWU_propeller_ms, input.m_v_NWU_propeller_ms,
+                         input.m_u_NWU_ship_ms, input.m_v_NWU_ship_ms, input.m_r_rads, input.m_x_pr_m, input.m_x_gr_m,
+                         input.m_rpm, input.m_pitch_ratio, input.m_rudder_angle_deg}) {
+      in[k++].push_back(value);
+    }
+  }
+  auto size = inputs.size();
+  std::vector<std::vector<double>> out(31, std::vector<double>(size));
+
+  PropellerRudderBatchOutput output;
+  output.m_propeller = {out[0].data(), out[1].data(), out[2].data(), out[3].data(), out[4].data(), out[5].data(),
+                        out[6].data()};
+  output.m_rudder = {out[7].data(), out[8].data(), out[9].data(), out[10].data(), out[11].data(), out[12].data(),
+                     out[13].data(), out[14].data(), out[15].data(), out[16].data()};
+  output.m_area_RP_m2 = out[17].data();
+  output.m_rudder_RP = {out[18].data(), out[19].data(), out[20].data(), out[21].data(), out[22].data(),
+                        out[23].data(), out[24].data(), out[25].data(), out[26].data(), out[27].data()};
+  output.m_fx_N = out[28].data();
+  output.m_fy_N = out[29].data();
+  output.m_mz_Nm = out[30].data();
+
+  propeller_rudder.ComputeBatch({size, in[0].data(), in[1].data(), in[2].data(), in[3].data(), in[4].data(),
+                                 in[5].data(), in[6].data(), in[7].data(), in[8].data(), in[9].data(), in[10].data()},
+                                output);
+
+  for (std::size_t i = 0; i < size; i++) {
+    auto expected = propeller_rudder.Compute(inputs[i]);
+    EXPECT_DOUBLE_EQ(output.m_propeller.m_thrust_N[i], expected.m_propeller.m_thrust_N);
+    EXPECT_DOUBLE_EQ(output.m_rudder.m_uRA[i], expected.m_rudder.m_uRA);
+    EXPECT_DOUBLE_EQ(output.m_rudder.m_vRA[i], expected.m_rudder.m_vRA);
+    EXPECT_DOUBLE_EQ(output.m_rudder.m_attack_angle_rad[i], expected.m_rudder.m_attack_angle_rad);
+    EXPECT_DOUBLE_EQ(output.m_rudder.m_drift_angle_rad[i], expected.m_rudder.m_drift_angle_rad);
+    EXPECT_DOUBLE_EQ(output.m_rudder.m_lift_N[i], expected.m_rudder.m_lift_N);
+    EXPECT_DOUBLE_EQ(output.m_rudder.m_drag_N[i], expected.m_rudder.m_drag_N);
+    EXPECT_DOUBLE_EQ(output.m_rudder.m_torque_Nm[i], expected.m_rudder.m_torque_Nm);
+    EXPECT_DOUBLE_EQ(output.m_rudder.m_fx_N[i], expected.m_rudder.m_fx_N);
+    EXPECT_DOUBLE_EQ(output.m_rudder.m_fy_N[i], expected.m_rudder.m_fy_N);
+    EXPECT_DOUBLE_EQ(output.m_area_RP_m2[i], expected.m_area_RP_m2);
+    EXPECT_DOUBLE_EQ(output.m_rudder_RP.m_uRA[i], expected.m_rudder_RP.m_uRA);
+    EXPECT_DOUBLE_EQ(output.m_rudder_RP.m_attack_angle_rad[i], expected.m_rudder_RP.m_attack_angle_rad);
+    EXPECT_DOUBLE_EQ(output.m_rudder_RP.m_lift_N[i], expected.m_rudder_RP.m_lift_N);
+    EXPECT_DOUBLE_EQ(output.m_fx_N[i], expected.m_fx_N);
+    EXPECT_DOUBLE_EQ(output.m_fy_N[i], expected.m_fy_N);
+    EXPECT_DOUBLE_EQ(output.m_mz_Nm[i], expected.m_mz_Nm);
+  }
+}
+
+TEST(BrixPropellerRudder, batch_compute) {
+
+  auto rudder = rudder_params();
+  rudder.m_has_hull_influence_transverse_velocity = true;
+  rudder.m_aH = 0.2;
+  rudder.m_xR = -50.;
+  rudder.m_xH = -45.;
+
+  // First quadrant, the propeller always running
+  BrixPropellerRudder<FPP1Q, BrixRudderModel> fpp1q_propeller_rudder(propeller_params(fpp1q_perf_data()), rudder);
+  fpp1q_propeller_rudder.Initialize();
+
+  std::vector<PropellerRudderInput> inputs;
+  for (double u : {0.5, 3., 6.}) {
+    for (double v : {-0.5, 0., 0.5}) {
+      for (double delta : {-35., -10., 0., 10., 35.}) {
+        inputs.push_back({1025., u, v, u, v, 0.01 * v, 5., 50., 100., 0., delta});
+      }
+    }
+  }
+  test_batch_compute(fpp1q_propeller_rudder, inputs);
+
+  // Four quadrants, with stopped propellers in still water (zero stagnation pressure at the propeller)
+  BrixPropellerRudder<FPP4Q, BrixRudderModel> fpp4q_propeller_rudder(propeller_params(fpp4q_fourier_perf_data()),
+                                                                      rudder);
+  fpp4q_propeller_rudder.Initialize();
+
+  inputs.clear();
+  for (double u : {-2., 0., 3.}) {
+    for (double rpm : {-60., 0., 100.}) {
+      for (double delta : {-35., 0., 20.}) {
+        inputs.push_back({1025., u, 0., u, 0., 0., 5., 50., rpm, 0., delta});
+      }
+    }
+  }
+  test_batch_compute(fpp4q_propeller_rudder, inputs);
+
+}
+
+
+void test_rudder_angle_sweep(const PropellerRudderBase &propeller_rudder, const PropellerRudderInput &input) {
+
+  std::vector<double> rudder_angles;
+  for (double delta = -35.; delta <= 35.; delta += 2.5) rudder_angles.push_back(delta);
+
+  auto sweep = propeller_rudder.ComputeRudderAngleSweep(input, rudder_angles);
+  ASSERT_EQ(sweep.m_fx_N.size(), rudder_angles.size());
+
+  for (std::size_t i = 0; i < rudder_angles.size(); i++) {
+    auto angle_input = input;
+    angle_input.m_rudder_angle_deg = rudder_angles[i];
+    auto expected = propeller_rudder.Compute(angle_input);
+    EXPECT_DOUBLE_EQ(sweep.m_propeller.m_thrust_N, expected.m_propeller.m_thrust_N);
+    EXPECT_DOUBLE_EQ(sweep.m_fx_N[i], expected.m_fx_N);
+    EXPECT_DOUBLE_EQ(sweep.m_fy_N[i], expected.m_fy_N);
+    EXPECT_DOUBLE_EQ(sweep.m_mz_Nm[i], expected.m_mz_Nm);
+  }
+}
+
+TEST(BrixPropellerRudder, rudder_angle_sweep) {
+
+  auto propeller = propeller_params(fpp1q_perf_data());
+  auto rudder = rudder_params();
+  rudder.m_has_hull_influence_transverse_velocity = true;
+
+  BrixPropellerRudder<FPP1Q, BrixRudderModel> brix(propeller, rudder);
+  brix.Initialize();
+  MMGPropellerRudder<BrixRudderModel> mmg(propeller, rudder);
+  mmg.Initialize();
+
+  // Cruising, manoeuvring, and stopped propeller in still water (no slipstream)
+  for (const auto &input : {PropellerRudderInput{1025., 5., 0., 5., 0., 0., 5., 50., 100., 0., 0.},
+                            PropellerRudderInput{1025., 3., 0.6, 3., 0.4, 0.005, 5., 50., 80., 0., 0.}}) {
+    test_rudder_angle_sweep(brix, input);
+    test_rudder_angle_sweep(mmg, input);
+  }
+  test_rudder_angle_sweep(brix, {1025., 0., 0., 0., 0., 0., 5., 50., 0., 0., 0.});
+
+}
 
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
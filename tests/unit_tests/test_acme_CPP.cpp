@@ -31,7 +31,7 @@ std::string str(T begin, T end) {
 
 TEST(TestCPP, parser) {
 
-  mathutils::LookupTable2d<double> ct_cq_coeffs;
+  PerformanceTable2D ct_cq_coeffs;
 
   std::vector<double> beta_in = {-180.0, -140.0, -100.0, -60.0, -20.0, 20.0, 60.0, 100.0, 140.0, 180.0};
   std::vector<double> pitch_ratio_in = {-1.0, -0.5, 0.0, 0.5, 1.0};
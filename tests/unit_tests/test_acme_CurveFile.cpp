@@ -0,0 +1,320 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+
+#include "acme/acme.h"
+#include "gtest/gtest.h"
+
+#include "acme_test_fixtures.h"
+
+using namespace acme;
+
+
+std::string temp_path(const std::string &name) {
+  return std::string(testing::TempDir()) + name;
+}
+
+CurveData table_data() {
+  CurveData data;
+  data.m_model = "Test";
+  data.m_options = {{"interpolation", 1.}, {"symmetric", 0.}};
+  data.m_axes = {{"x", {0., 1., 3.}}, {"y", {-1., 1.}}};
+  data.m_columns = {{"a", {1., 2., 3., 4., 5., 6.}}, {"b", {-1., -2., -3., -4., -5., -6.}}};
+  return data;
+}
+
+/// Compare the propeller built from the json string with the one built from its curve file
+template<class Propeller>
+void CheckPropeller(const std::string &json_string, const CurveData &data, double pitch_ratio,
+                    double table_simplification_tolerance = 0.) {
+  auto path = temp_path("acme_propeller.crv");
+  data.Write(path);
+
+  auto params = propeller_params();
+  params.m_out_of_range_policy = E_OUT_OF_RANGE_EXTRAPOLATE;
+  params.m_table_simplification_tolerance = table_simplification_tolerance;
+  params.m_thruster_perf_data_json_string = json_string;
+  Propeller from_json(params);
+  from_json.Initialize();
+
+  params.m_thruster_perf_data_json_string.clear();
+  params.m_thruster_perf_data_curve_file = path;
+  Propeller from_file(params);
+  from_file.Initialize();
+  std::remove(path.c_str());
+
+  EXPECT_EQ(from_file.GetParameters().m_table_interpolation, from_json.GetParameters().m_table_interpolation);
+  for (double u : {-4., -1., 0., 0.5, 1.7, 3., 6.}) {
+    for (double rpm : {-100., 20., 50., 120.}) {
+      if (std::is_same<Propeller, FPP1Q>::value && (u < 0. || rpm < 0.)) continue;
+      PropellerInput input{1025., u, 0.1, rpm, pitch_ratio};
+      auto expected = from_json.Compute(input);
+      auto actual = from_file.Compute(input);
+      EXPECT_DOUBLE_EQ(actual.m_thrust_N, expected.m_thrust_N);
+      EXPECT_DOUBLE_EQ(actual.m_torque_Nm, expected.m_torque_Nm);
+    }
+  }
+}
+
+/// Compare the rudder built from the json string with the one built from its curve file
+template<class Rudder>
+void CheckRudder(const std::string &json_string, const CurveData &data, bool symmetric_table = false) {
+  auto path = temp_path("acme_rudder.crv");
+  data.Write(path);
+
+  auto params = rudder_params();
+  params.m_out_of_range_policy = E_OUT_OF_RANGE_EXTRAPOLATE;
+  params.m_symmetric_table = symmetric_table;
+  params.m_perf_data_json_string = json_string;
+  Rudder from_json(params);
+  from_json.Initialize();
+
+  params.m_perf_data_json_string.clear();
+  params.m_perf_data_curve_file = path;
+  Rudder from_file(params);
+  from_file.Initialize();
+  std::remove(path.c_str());
+
+  for (double angle : {-35., -12., -3., 0., 4., 17., 33.}) {
+    RudderInput input{1025., 4., 0.3, angle};
+    auto expected = from_json.Compute(input);
+    auto actual = from_file.Compute(input);
+    EXPECT_DOUBLE_EQ(actual.m_fx_N, expected.m_fx_N);
+    EXPECT_DOUBLE_EQ(actual.m_fy_N, expected.m_fy_N);
+    EXPECT_DOUBLE_EQ(actual.m_torque_Nm, expected.m_torque_Nm);
+  }
+}
+
+
+TEST(CurveFile, round_trip) {
+  auto path = temp_path("acme_table.crv");
+  auto data = table_data();
+  data.Write(path);
+  EXPECT_TRUE(CurveFile::IsCurveFile(path));
+
+  auto file = CurveFile::Open(path);
+  EXPECT_EQ(file->GetModel(), "Test");
+  EXPECT_NO_THROW(file->CheckModel("Test"));
+  EXPECT_THROW(file->CheckModel("CPP"), std::runtime_error);
+  EXPECT_EQ(file->GetOption("interpolation", 0.), 1.);
+  EXPECT_EQ(file->GetOption("chebyshev_degree", 7.), 7.);
+  ASSERT_EQ(file->GetNbAxes(), 2);
+  EXPECT_EQ(file->GetAxisName(1), "y");
+  EXPECT_EQ(file->GetNbNodes(), 6);
+
+  // Values aligned, interleaved per node
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(file->GetData()) % alignof(double), 0);
+  EXPECT_EQ(file->GetData()[0], 1.);
+  EXPECT_EQ(file->GetData()[1], -1.);
+  EXPECT_EQ(file->GetData()[2], 2.);
+
+  auto read_data = file->GetCurveData();
+  EXPECT_EQ(read_data.m_options, data.m_options);
+  for (std::size_t i = 0; i < 2; i++) {
+    EXPECT_EQ(read_data.m_axes[i].m_values, data.m_axes[i].m_values);
+    EXPECT_EQ(read_data.m_columns[i].m_name, data.m_columns[i].m_name);
+    EXPECT_EQ(read_data.m_columns[i].m_values, data.m_columns[i].m_values);
+  }
+
+  // The table uses the mapped values in place, and keeps the file mapped
+  PerformanceTable2D table;
+  file->SetTable(table);
+  PerformanceTable1D table_1d;
+  EXPECT_THROW(file->SetTable(table_1d), std::runtime_error);
+  file.reset();
+  std::remove(path.c_str());
+
+  EXPECT_TRUE(table.GetXAxis().GetValues().IsView());
+  PerformanceTable2D table_copy(table);
+  EXPECT_TRUE(table_copy.GetYAxis().GetValues().IsView());
+
+  PerformanceTable2D expected;
+  expected.SetX(data.m_axes[0].m_values);
+  expected.SetY(data.m_axes[1].m_values);
+  expected.AddData("a", data.m_columns[0].m_values);
+  expected.AddData("b", data.m_columns[1].m_values);
+  for (double x : {0., 0.3, 1., 2.2, 3.}) {
+    for (double y : {-1., 0.1, 1.}) {
+      EXPECT_EQ(table.Eval("a", x, y), expected.Eval("a", x, y));
+      EXPECT_EQ(table_copy.Eval("b", x, y), expected.Eval("b", x, y));
+    }
+  }
+
+  // Single precision storage : copy of the values
+  PerformanceTable1D single_table;
+  single_table.SetSinglePrecision(true);
+  data.m_axes.pop_back();
+  data.m_columns = {{"a", {1., 2., 3.}}};
+  data.Write(path);
+  CurveFile::Open(path)->SetTable(single_table);
+  std::remove(path.c_str());
+  EXPECT_EQ(single_table.Eval("a", 2.), 2.5);
+}
+
+TEST(CurveFile, rewrite_mapped_file) {
+  auto path = temp_path("acme_rewritten.crv");
+  auto data = table_data();
+  data.Write(path);
+  auto file = CurveFile::Open(path);
+
+  // The file is replaced, not rewritten in place : the mapped content does not change
+  auto new_data = table_data();
+  for (auto &value : new_data.m_columns[0].m_values) value *= 10.;
+  new_data.m_columns.pop_back();
+  new_data.Write(path);
+
+  EXPECT_EQ(file->GetColumnNames().size(), 2);
+  EXPECT_EQ(file->GetColumn("a"), data.m_columns[0].m_values);
+  EXPECT_EQ(file->GetColumn("b"), data.m_columns[1].m_values);
+
+  auto new_file = CurveFile::Open(path);
+  EXPECT_EQ(new_file->GetColumnNames().size(), 1);
+  EXPECT_EQ(new_file->GetColumn("a"), new_data.m_columns[0].m_values);
+  EXPECT_NE(new_file->GetChecksum(), file->GetChecksum());
+  std::remove(path.c_str());
+
+  // Directory that does not exist
+  EXPECT_THROW(data.Write(temp_path("acme_no_such_directory/table.crv")), std::runtime_error);
+}
+
+TEST(CurveFile, invalid_files) {
+  auto path = temp_path("acme_invalid.crv");
+  auto data = table_data();
+
+  // Column not matching the grid
+  data.m_columns[0].m_values.pop_back();
+  EXPECT_THROW(data.Write(path), std::runtime_error);
+
+  data = table_data();
+  data.Write(path);
+  std::string content;
+  {
+    std::ifstream file(path, std::ios::binary);
+    content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+
+  auto write = [&path](const std::string &bytes) {
+    std::ofstream file(path, std::ios::binary);
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  };
+
+  // Corrupted value
+  auto corrupted = content;
+  corrupted[corrupted.size() - 3] ^= 0x10;
+  write(corrupted);
+  EXPECT_THROW(CurveFile::Open(path), std::runtime_error);
+
+  // Truncated file
+  write(content.substr(0, content.size() - 8));
+  EXPECT_THROW(CurveFile::Open(path), std::runtime_error);
+
+  // Not a curve file
+  write(fpp4q_perf_data());
+  EXPECT_FALSE(CurveFile::IsCurveFile(path));
+  EXPECT_THROW(CurveFile::Open(path), std::runtime_error);
+
+  std::remove(path.c_str());
+  EXPECT_FALSE(CurveFile::IsCurveFile(path));
+  EXPECT_THROW(CurveFile::Open(path), std::runtime_error);
+
+  // Curve file of another model
+  FPP4QCurveData(fpp4q_perf_data()).Write(path);
+  auto params = propeller_params();
+  params.m_thruster_perf_data_curve_file = path;
+  FPP1Q propeller(params);
+  EXPECT_THROW(propeller.Initialize(), std::runtime_error);
+  std::remove(path.c_str());
+
+  // Fourier series are not tabulated
+  EXPECT_THROW(FPP4QCurveData(R"({"fourier": {"ct": {"a": [0.1], "b": [0.0]}, "cq": {"a": [0.0], "b": [0.0]}}})"),
+               std::runtime_error);
+}
+
+TEST(CurveFile, propellers) {
+  auto fpp1q_cubic_perf_data = fpp1q_perf_data(R"(, "interpolation": "monotone_cubic")");
+  auto fpp1q = FPP1QCurveData(fpp1q_cubic_perf_data);
+  EXPECT_EQ(fpp1q.m_options.at("interpolation"), E_MONOTONE_CUBIC);
+  CheckPropeller<FPP1Q>(fpp1q_cubic_perf_data, fpp1q, 0.);
+  CheckPropeller<FPP1Q>(fpp1q_cubic_perf_data, fpp1q, 0., 1E-3);
+
+  auto chebyshev_perf_data = fpp1q_perf_data(R"(, "interpolation": "monotone_cubic", "chebyshev_degree": 4)");
+  CheckPropeller<FPP1Q>(chebyshev_perf_data, FPP1QCurveData(chebyshev_perf_data), 0.);
+
+  auto fpp4q = FPP4QCurveData(fpp4q_perf_data());
+  EXPECT_DOUBLE_EQ(fpp4q.m_axes[0].m_values.front(), -MU_PI);
+  CheckPropeller<FPP4Q>(fpp4q_perf_data(), fpp4q, 0.);
+
+  CheckPropeller<CPP>(cpp_perf_data(), CPPCurveData(cpp_perf_data()), 0.7);
+  CheckPropeller<CPP>(cpp_perf_data(), CPPCurveData(cpp_perf_data()), -0.4, 1E-3);
+}
+
+TEST(CurveFile, rudders) {
+  CheckRudder<SimpleRudderModel>(simple_rudder_perf_data(), SimpleRudderCurveData(simple_rudder_perf_data()));
+  CheckRudder<SimpleRudderModel>(simple_rudder_perf_data(), SimpleRudderCurveData(simple_rudder_perf_data()), true);
+  CheckRudder<FlapRudderModel>(flap_rudder_perf_data(), FlapRudderCurveData(flap_rudder_perf_data()));
+}
+
+TEST(CurveFile, shared_curves) {
+  auto path = temp_path("acme_shared.crv");
+  SimpleRudderCurveData(simple_rudder_perf_data()).Write(path);
+
+  auto params = rudder_params();
+  params.m_perf_data_curve_file = path;
+
+  auto stats = CurveRegistry::GetInstance().GetStats();
+  std::vector<std::unique_ptr<SimpleRudderModel>> rudders;
+  for (int i = 0; i < 10; i++) {
+    rudders.push_back(std::make_unique<SimpleRudderModel>(params));
+    rudders.back()->Initialize();
+  }
+  std::remove(path.c_str());
+
+  // A single curve set for the file, the table using the mapped values in place
+  auto shared_stats = CurveRegistry::GetInstance().GetStats();
+  EXPECT_EQ(shared_stats.m_nb_unique_curves, stats.m_nb_unique_curves + 1);
+  EXPECT_LT(shared_stats.m_unique_bytes - stats.m_unique_bytes, sizeof(SimpleRudderCurves) + 256);
+
+  auto output = rudders.back()->Compute(RudderInput{1025., 4., 0.3, 12.});
+  EXPECT_NE(output.m_fy_N, 0.);
+}
+
+
+TEST(CurveFile, reload_rewritten_file) {
+  auto path = temp_path("acme_reloaded.crv");
+  FPP1QCurveData(fpp1q_perf_data()).Write(path);
+
+  auto params = propeller_params();
+  params.m_thruster_perf_data_curve_file = path;
+  FPP1Q propeller(params);
+  propeller.Initialize();
+
+  // Same path, new content : the reload must not get the curves cached for the former content
+  auto new_perf_data = R"({"j": [0, 0.5, 1.0, 1.5], "kt": [0.5, 0.4, 0.2, -0.1], "kq": [0.06, 0.05, 0.03, -0.01]})";
+  FPP1QCurveData(new_perf_data).Write(path);
+  propeller.ReloadPerformanceData("", path);
+  std::remove(path.c_str());
+
+  FPP1Q expected(propeller_params(new_perf_data));
+  expected.Initialize();
+  for (double u : {0., 1., 2.5}) {
+    PropellerInput input{1025., u, 0., 100., 0.};
+    EXPECT_DOUBLE_EQ(propeller.Compute(input).m_thrust_N, expected.Compute(input).m_thrust_N);
+    EXPECT_DOUBLE_EQ(propeller.Compute(input).m_torque_Nm, expected.Compute(input).m_torque_Nm);
+  }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -9,6 +9,11 @@
 //
 // ==========================================================================
 
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
 #include "acme/acme.h"
 #include "gtest/gtest.h"
 
@@ -48,6 +53,12 @@ using namespace acme;
 //  propeller.Initialize();
 //}
 
+const std::string open_water_data_table = R"({"j": [0, 0.01010101, 0.02020202, 0.03030303, 0.04040404, 0.05050505, 0.06060606, 0.07070707, 0.08080808, 0.09090909, 0.1010101, 0.11111111, 0.12121212, 0.13131313, 0.14141414, 0.15151515, 0.16161616, 0.17171717, 0.18181818, 0.19191919, 0.2020202, 0.21212121, 0.22222222, 0.23232323, 0.24242424, 0.25252525, 0.26262626, 0.27272727, 0.28282828, 0.29292929, 0.3030303, 0.31313131, 0.32323232, 0.33333333, 0.34343434, 0.35353535, 0.36363636, 0.37373737, 0.38383838, 0.39393939, 0.4040404, 0.41414141, 0.42424242, 0.43434343, 0.44444444, 0.45454545, 0.46464646, 0.47474747, 0.48484848, 0.49494949, 0.50505051, 0.51515152, 0.52525253, 0.53535354, 0.54545455, 0.55555556, 0.56565657, 0.57575758, 0.58585859, 0.5959596, 0.60606061, 0.61616162, 0.62626263, 0.63636364, 0.64646465, 0.65656566, 0.66666667, 0.67676768, 0.68686869, 0.6969697, 0.70707071, 0.71717172, 0.72727273, 0.73737374, 0.74747475, 0.75757576, 0.76767677, 0.77777778, 0.78787879, 0.7979798, 0.80808081, 0.81818182, 0.82828283, 0.83838384, 0.84848485],
+    "kt": [0.35422196, 0.35142214, 0.34857537, 0.34568216, 0.34274302, 0.33975846, 0.33672898, 0.3336551, 0.33053732, 0.32737615, 0.32417211, 0.3209257, 0.31763743, 0.31430781, 0.31093735, 0.30752656, 0.30407595, 0.30058602, 0.29705729, 0.29349026, 0.28988544, 0.28624335, 0.28256449, 0.27884937, 0.2750985,  0.27131239, 0.26749155, 0.26363649, 0.25974771, 0.25582573, 0.25187106, 0.24788419, 0.24386565, 0.23981594, 0.23573558, 0.23162506, 0.2274849,  0.22331562, 0.2191177,  0.21489168, 0.21063805, 0.20635733, 0.20205002, 0.19771663, 0.19335768, 0.18897366, 0.1845651,  0.1801325, 0.17567636, 0.17119721, 0.16669554, 0.16217186, 0.15762669, 0.15306054, 0.14847391, 0.14386731, 0.13924125, 0.13459624, 0.12993279, 0.12525141, 0.12055261, 0.1158369,  0.11110478, 0.10635677, 0.10159337, 0.09681509, 0.09202245, 0.08721595, 0.08239609, 0.0775634,  0.07271838, 0.06786154, 0.06299338, 0.05811442, 0.05322516, 0.04832612, 0.0434178,  0.03850072, 0.03357537, 0.02864228, 0.02370195, 0.01875488, 0.0138016,  0.0088426, 0.0038784],
+    "kq": [0.04336206,  0.04307767,  0.04278789,  0.04249279,  0.04219242,  0.04188681, 0.04157602,  0.04126011,  0.04093911,  0.04061307,  0.04028205,  0.03994609, 0.03960525,  0.03925957,  0.03890909,  0.03855388,  0.03819397,  0.03782941, 0.03746027,  0.03708657,  0.03670838,  0.03632574, 0.0359387,   0.0355473, 0.03515161,  0.03475165, 0.0343475,   0.03393919,  0.03352677,  0.03311029, 0.0326898, 0.03226534,  0.03183698, 0.03140475,  0.03096871,  0.0305289, 0.03008537,  0.02963817, 0.02918735,  0.02873296,  0.02827505,  0.02781366, 0.02734885,  0.02688066,  0.02640914,  0.02593434,  0.02545632,  0.02497511, 0.02449077,  0.02400334,  0.02351288,  0.02301943,  0.02252305,  0.02202377, 0.02152166,  0.02101675,  0.0205091,   0.01999876, 0.01948577,  0.01897018, 0.01845205, 0.01793141,  0.01740833, 0.01688284,  0.016355,    0.01582486, 0.01529246,  0.01475786,  0.0142211,   0.01368222,  0.01314129,  0.01259835, 0.01205344,  0.01150662,  0.01095793,  0.01040742, 0.00985515,  0.00930116, 0.0087455,  0.00818822,  0.00762936,  0.00706898,  0.00650712,  0.00594384, 0.00537918]
+  })";
+
+
 TEST(TestFPP1Q, forces) {
 
   PropellerParams params;
@@ -56,10 +67,6 @@ TEST(TestFPP1Q, forces) {
   params.m_thrust_deduction_factor_0 = 0.2;
   params.m_screw_direction = acme::RIGHT_HANDED;
 
-  const std::string open_water_data_table = R"({"j": [0, 0.01010101, 0.02020202, 0.03030303, 0.04040404, 0.05050505, 0.06060606, 0.07070707, 0.08080808, 0.09090909, 0.1010101, 0.11111111, 0.12121212, 0.13131313, 0.14141414, 0.15151515, 0.16161616, 0.17171717, 0.18181818, 0.19191919, 0.2020202, 0.21212121, 0.22222222, 0.23232323, 0.24242424, 0.25252525, 0.26262626, 0.27272727, 0.28282828, 0.29292929, 0.3030303, 0.31313131, 0.32323232, 0.33333333, 0.34343434, 0.35353535, 0.36363636, 0.37373737, 0.38383838, 0.39393939, 0.4040404, 0.41414141, 0.42424242, 0.43434343, 0.44444444, 0.45454545, 0.46464646, 0.47474747, 0.48484848, 0.49494949, 0.50505051, 0.51515152, 0.52525253, 0.53535354, 0.54545455, 0.55555556, 0.56565657, 0.57575758, 0.58585859, 0.5959596, 0.60606061, 0.61616162, 0.62626263, 0.63636364, 0.64646465, 0.65656566, 0.66666667, 0.67676768, 0.68686869, 0.6969697, 0.70707071, 0.71717172, 0.72727273, 0.73737374, 0.74747475, 0.75757576, 0.76767677, 0.77777778, 0.78787879, 0.7979798, 0.80808081, 0.81818182, 0.82828283, 0.83838384, 0.84848485],
-      "kt": [0.35422196, 0.35142214, 0.34857537, 0.34568216, 0.34274302, 0.33975846, 0.33672898, 0.3336551, 0.33053732, 0.32737615, 0.32417211, 0.3209257, 0.31763743, 0.31430781, 0.31093735, 0.30752656, 0.30407595, 0.30058602, 0.29705729, 0.29349026, 0.28988544, 0.28624335, 0.28256449, 0.27884937, 0.2750985,  0.27131239, 0.26749155, 0.26363649, 0.25974771, 0.25582573, 0.25187106, 0.24788419, 0.24386565, 0.23981594, 0.23573558, 0.23162506, 0.2274849,  0.22331562, 0.2191177,  0.21489168, 0.21063805, 0.20635733, 0.20205002, 0.19771663, 0.19335768, 0.18897366, 0.1845651,  0.1801325, 0.17567636, 0.17119721, 0.16669554, 0.16217186, 0.15762669, 0.15306054, 0.14847391, 0.14386731, 0.13924125, 0.13459624, 0.12993279, 0.12525141, 0.12055261, 0.1158369,  0.11110478, 0.10635677, 0.10159337, 0.09681509, 0.09202245, 0.08721595, 0.08239609, 0.0775634,  0.07271838, 0.06786154, 0.06299338, 0.05811442, 0.05322516, 0.04832612, 0.0434178,  0.03850072, 0.03357537, 0.02864228, 0.02370195, 0.01875488, 0.0138016,  0.0088426, 0.0038784],
-      "kq": [0.04336206,  0.04307767,  0.04278789,  0.04249279,  0.04219242,  0.04188681, 0.04157602,  0.04126011,  0.04093911,  0.04061307,  0.04028205,  0.03994609, 0.03960525,  0.03925957,  0.03890909,  0.03855388,  0.03819397,  0.03782941, 0.03746027,  0.03708657,  0.03670838,  0.03632574, 0.0359387,   0.0355473, 0.03515161,  0.03475165, 0.0343475,   0.03393919,  0.03352677,  0.03311029, 0.0326898, 0.03226534,  0.03183698, 0.03140475,  0.03096871,  0.0305289, 0.03008537,  0.02963817, 0.02918735,  0.02873296,  0.02827505,  0.02781366, 0.02734885,  0.02688066,  0.02640914,  0.02593434,  0.02545632,  0.02497511, 0.02449077,  0.02400334,  0.02351288,  0.02301943,  0.02252305,  0.02202377, 0.02152166,  0.02101675,  0.0205091,   0.01999876, 0.01948577,  0.01897018, 0.01845205, 0.01793141,  0.01740833, 0.01688284,  0.016355,    0.01582486, 0.01529246,  0.01475786,  0.0142211,   0.01368222,  0.01314129,  0.01259835, 0.01205344,  0.01150662,  0.01095793,  0.01040742, 0.00985515,  0.00930116, 0.0087455,  0.00818822,  0.00762936,  0.00706898,  0.00650712,  0.00594384, 0.00537918]
-    })";
   params.m_thruster_perf_data_json_string = open_water_data_table;
 
   auto propeller = FPP1Q(params);
@@ -115,6 +122,433 @@ TEST(TestFPP1Q, forces) {
   EXPECT_NEAR(propeller.GetPropellerEfficiency(), 0.250089, 1E-6);
 }
 
+TEST(TestFPP1Q, single_precision_tables) {
+
+  PropellerParams params;
+  params.m_diameter_m = 2.;
+  params.m_hull_wake_fraction_0 = 0.25;
+  params.m_thrust_deduction_factor_0 = 0.2;
+  params.m_screw_direction = acme::RIGHT_HANDED;
+  params.m_thruster_perf_data_json_string = open_water_data_table;
+
+  auto propeller = FPP1Q(params);
+  propeller.Initialize();
+
+  params.m_table_single_precision = true;
+  auto single_precision_propeller = FPP1Q(params);
+  single_precision_propeller.Initialize();
+
+  // Max deviation on the thrust and the torque over the whole J range
+  double max_thrust = 0., max_thrust_deviation = 0., max_torque = 0., max_torque_deviation = 0.;
+  for (double u = 0.; u <= 2.2; u += 0.01) {
+    propeller.Compute(1025, u, 0., 60., 0.);
+    single_precision_propeller.Compute(1025, u, 0., 60., 0.);
+    max_thrust = std::max(max_thrust, std::abs(propeller.GetThrust()));
+    max_thrust_deviation = std::max(max_thrust_deviation,
+                                    std::abs(single_precision_propeller.GetThrust() - propeller.GetThrust()));
+    max_torque = std::max(max_torque, std::abs(propeller.GetTorque()));
+    max_torque_deviation = std::max(max_torque_deviation,
+                                    std::abs(single_precision_propeller.GetTorque() - propeller.GetTorque()));
+  }
+
+  std::cout << "Single precision tables, max relative deviation : thrust " << max_thrust_deviation / max_thrust
+            << ", torque " << max_torque_deviation / max_torque << std::endl;
+
+  // float has 24 bits of mantissa : relative rounding error below 6E-8 on each node
+  EXPECT_LT(max_thrust_deviation, 1E-7 * max_thrust);
+  EXPECT_LT(max_torque_deviation, 1E-7 * max_torque);
+
+}
+
+TEST(TestFPP1Q, chebyshev_series) {
+
+  PropellerParams params;
+  params.m_diameter_m = 2.;
+  params.m_hull_wake_fraction_0 = 0.25;
+  params.m_thrust_deduction_factor_0 = 0.2;
+  params.m_screw_direction = acme::RIGHT_HANDED;
+  params.m_thruster_perf_data_json_string = open_water_data_table;
+
+  auto propeller = FPP1Q(params);
+  propeller.Initialize();
+  EXPECT_EQ(propeller.GetChebyshevMaxResidual(), 0.);
+
+  params.m_chebyshev_degree = 6;
+  auto chebyshev_propeller = FPP1Q(params);
+  chebyshev_propeller.Initialize();
+
+  // The open water curves are smooth : a few coefficients reproduce the data points to their rounding
+  auto residual = chebyshev_propeller.GetChebyshevMaxResidual();
+  std::cout << "Chebyshev expansion of degree 6, max residual : " << residual << std::endl;
+  EXPECT_GT(residual, 0.);
+  EXPECT_LT(residual, 1E-6);
+
+  for (double u = 0.; u <= 2.2; u += 0.01) {
+    propeller.Compute(1025, u, 0., 60., 0.);
+    chebyshev_propeller.Compute(1025, u, 0., 60., 0.);
+    double J = chebyshev_propeller.J();
+    EXPECT_NEAR(chebyshev_propeller.kt(J), propeller.kt(J), 1E-5);
+    EXPECT_NEAR(chebyshev_propeller.kq(J), propeller.kq(J), 1E-6);
+    EXPECT_NEAR(chebyshev_propeller.GetThrust(), propeller.GetThrust(), 1E-5 * 1025 * 16 * 0.8);
+  }
+
+  // Out of the data range, as with the table
+  EXPECT_THROW(chebyshev_propeller.Compute(1025, 3., 0., 60., 0.), std::runtime_error);
+
+}
+
+TEST(TestFPP1Q, concurrent_compute) {
+
+  PropellerParams params;
+  params.m_diameter_m = 2.;
+  params.m_hull_wake_fraction_0 = 0.25;
+  params.m_thrust_deduction_factor_0 = 0.2;
+  params.m_screw_direction = acme::RIGHT_HANDED;
+  params.m_thruster_perf_data_json_string = open_water_data_table;
+
+  auto propeller = FPP1Q(params);
+  propeller.Initialize();
+
+  // Reference results from the getters API
+  std::vector<PropellerInput> inputs;
+  std::vector<PropellerOutput> outputs;
+  for (double u = 0.; u <= 2.2; u += 0.05) {
+    for (double rpm = 60.; rpm <= 120.; rpm += 10.) {
+      inputs.push_back({1025., u, 0.1 * u, rpm, 0.});
+      propeller.Compute(1025., u, 0.1 * u, rpm, 0.);
+      outputs.push_back(propeller.GetOutput());
+    }
+  }
+
+  // The same model evaluated by several threads, each one sweeping the operating points in a different order, half
+  // of them with their own interval hints
+  const int nb_threads = 4;
+  std::vector<int> nb_mismatches(nb_threads, 0);
+  std::vector<std::thread> threads;
+  for (int k = 0; k < nb_threads; k++) {
+    threads.emplace_back([&, k]() {
+      TableHints hints;
+      for (int repeat = 0; repeat < 20; repeat++) {
+        for (std::size_t i = 0; i < inputs.size(); i++) {
+          auto index = (k % 2 == 0) ? i : inputs.size() - 1 - i;
+          auto input = inputs[index];
+          if (k < 2) input.m_hints = &hints;
+          auto output = propeller.Compute(input);
+          if (output.m_thrust_N != outputs[index].m_thrust_N || output.m_torque_Nm != outputs[index].m_torque_Nm ||
+              output.m_efficiency != outputs[index].m_efficiency || output.m_uPA != outputs[index].m_uPA) {
+            nb_mismatches[k]++;
+          }
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) thread.join();
+
+  for (int k = 0; k < nb_threads; k++) EXPECT_EQ(nb_mismatches[k], 0);
+
+  // The getters still hold the results of the last call with the getters API
+  EXPECT_EQ(propeller.GetThrust(), outputs.back().m_thrust_N);
+
+}
+
+TEST(TestFPP1Q, shared_curves) {
+
+  PropellerParams params;
+  params.m_diameter_m = 2.;
+  params.m_hull_wake_fraction_0 = 0.25;
+  params.m_thrust_deduction_factor_0 = 0.2;
+  params.m_screw_direction = acme::RIGHT_HANDED;
+  params.m_thruster_perf_data_json_string = open_water_data_table;
+
+  auto &registry = CurveRegistry::GetInstance();
+  auto stats_before = registry.GetStats();
+
+  // A fleet of sister ships : a single curve set is built and shared
+  const std::size_t nb_propellers = 10;
+  std::vector<FPP1Q> fleet(nb_propellers, FPP1Q(params));
+  for (auto &propeller : fleet) propeller.Initialize();
+
+  auto stats = registry.GetStats();
+  EXPECT_EQ(stats.m_nb_unique_curves, stats_before.m_nb_unique_curves + 1);
+  EXPECT_EQ(stats.m_nb_references, stats_before.m_nb_references + nb_propellers);
+  EXPECT_GT(stats.m_unique_bytes, stats_before.m_unique_bytes);
+  EXPECT_EQ(stats.m_saved_bytes - stats_before.m_saved_bytes,
+            (nb_propellers - 1) * (stats.m_unique_bytes - stats_before.m_unique_bytes));
+
+  // Other options give other curves
+  params.m_table_single_precision = true;
+  FPP1Q single_precision_propeller(params);
+  single_precision_propeller.Initialize();
+  EXPECT_EQ(registry.GetStats().m_nb_unique_curves, stats.m_nb_unique_curves + 1);
+
+  // Sharing the curves does not change the results
+  FPP1Q reference_propeller(fleet.front());
+  for (auto &propeller : fleet) {
+    propeller.Compute(1025., 1.5, 0.1, 100., 0.);
+    reference_propeller.Compute(1025., 1.5, 0.1, 100., 0.);
+    EXPECT_EQ(propeller.GetThrust(), reference_propeller.GetThrust());
+    EXPECT_EQ(propeller.GetTorque(), reference_propeller.GetTorque());
+  }
+
+  // Only the copy and the single precision propeller are left
+  fleet.clear();
+  EXPECT_EQ(registry.GetStats().m_nb_references, stats_before.m_nb_references + 2);
+
+  // Models held through their base release their curves too
+  std::unique_ptr<PropellerBaseModel> base_propeller = std::make_unique<FPP1Q>(params);
+  base_propeller->Initialize();
+  EXPECT_EQ(registry.GetStats().m_nb_references, stats_before.m_nb_references + 3);
+  base_propeller.reset();
+  EXPECT_EQ(registry.GetStats().m_nb_references, stats_before.m_nb_references + 2);
+
+}
+
+TEST(CurveRegistry, key) {
+
+  // The performance data are not copied in the key
+  std::string data(1 << 20, ' ');
+  data.replace(0, open_water_data_table.size(), open_water_data_table);
+  auto key = CurveRegistryKey("FPP1Q", {0., 1e-3}, data);
+  EXPECT_LT(key.size(), 100u);
+
+  EXPECT_EQ(CurveRegistryKey("FPP1Q", {0., 1e-3}, data), key);
+  EXPECT_NE(CurveRegistryKey("FPP4Q", {0., 1e-3}, data), key);
+  EXPECT_NE(CurveRegistryKey("FPP1Q", {0., 2e-3}, data), key);
+  data.back() = '\n';
+  EXPECT_NE(CurveRegistryKey("FPP1Q", {0., 1e-3}, data), key);
+  data.pop_back();
+  EXPECT_NE(CurveRegistryKey("FPP1Q", {0., 1e-3}, data), key);
+
+}
+
+TEST(TestFPP1Q, reload_performance_data) {
+
+  PropellerParams params;
+  params.m_diameter_m = 2.;
+  params.m_hull_wake_fraction_0 = 0.25;
+  params.m_thrust_deduction_factor_0 = 0.2;
+  params.m_screw_direction = acme::RIGHT_HANDED;
+
+  // Initial and recalibrated data, on different J axes
+  const std::string initial_data = R"({"j": [0, 0.4, 0.8, 1.2], "kt": [0.35, 0.22, 0.07, -0.11],)"
+                                   R"( "kq": [0.043, 0.031, 0.015, -0.006]})";
+  const std::string recalibrated_data = R"({"j": [0, 0.2, 0.4, 0.6, 0.8, 1.0, 1.2],)"
+                                        R"( "kt": [0.36, 0.3, 0.23, 0.16, 0.08, -0.01, -0.1],)"
+                                        R"( "kq": [0.045, 0.04, 0.033, 0.025, 0.017, 0.007, -0.004]})";
+
+  params.m_thruster_perf_data_json_string = initial_data;
+  FPP1Q propeller(params), initial_propeller(params);
+  params.m_thruster_perf_data_json_string = recalibrated_data;
+  FPP1Q recalibrated_propeller(params);
+
+  // Not initialized
+  EXPECT_THROW(propeller.ReloadPerformanceData(recalibrated_data), std::runtime_error);
+
+  propeller.Initialize();
+  initial_propeller.Initialize();
+  recalibrated_propeller.Initialize();
+
+  std::vector<PropellerInput> inputs;
+  for (double u = 0.5; u <= 4.; u += 0.5) inputs.push_back({1025., u, 0.1 * u, 100., 0.});
+
+  // Readers computing the model while its curves are swapped : every result is the one of either curve set, thrust and
+  // torque coming from the same one
+  std::atomic<bool> done{false};
+  std::atomic<int> nb_passes{0};
+  const int nb_threads = 3;
+  std::vector<int> nb_mismatches(nb_threads, 0);
+  std::vector<std::thread> threads;
+  for (int k = 0; k < nb_threads; k++) {
+    threads.emplace_back([&, k]() {
+      while (!done) {
+        for (const auto &input : inputs) {
+          auto output = propeller.Compute(input);
+          auto initial = initial_propeller.Compute(input);
+          auto recalibrated = recalibrated_propeller.Compute(input);
+          bool is_initial = output.m_thrust_N == initial.m_thrust_N && output.m_torque_Nm == initial.m_torque_Nm;
+          bool is_recalibrated = output.m_thrust_N == recalibrated.m_thrust_N &&
+                                 output.m_torque_Nm == recalibrated.m_torque_Nm;
+          if (!is_initial && !is_recalibrated) nb_mismatches[k]++;
+        }
+        nb_passes++;
+      }
+    });
+  }
+
+  while (nb_passes < nb_threads) std::this_thread::yield();
+  const int nb_reloads = 200;
+  for (int i = 0; i < nb_reloads; i++) {
+    propeller.ReloadPerformanceData(i % 2 == 0 ? recalibrated_data : initial_data);
+    std::this_thread::yield();
+  }
+  done = true;
+  for (auto &thread : threads) thread.join();
+  for (int k = 0; k < nb_threads; k++) EXPECT_EQ(nb_mismatches[k], 0);
+
+  // The former curves are kept until released, once no reader is left
+  EXPECT_EQ(propeller.GetNbRetiredCurves(), nb_reloads);
+  EXPECT_EQ(propeller.ReleaseRetiredCurves(), nb_reloads);
+  EXPECT_EQ(propeller.GetNbRetiredCurves(), 0);
+
+  // Last reload : initial data
+  for (const auto &input : inputs) {
+    EXPECT_EQ(propeller.Compute(input).m_thrust_N, initial_propeller.Compute(input).m_thrust_N);
+  }
+
+  // Invalid data : the model keeps its curves
+  EXPECT_THROW(propeller.ReloadPerformanceData(R"({"j": [0, 0.4], "kt": [0.35]})"), std::runtime_error);
+  EXPECT_EQ(propeller.GetNbRetiredCurves(), 0);
+  EXPECT_EQ(propeller.Compute(inputs[0]).m_thrust_N, initial_propeller.Compute(inputs[0]).m_thrust_N);
+
+}
+
+TEST(TestFPP1Q, batch_compute) {
+
+  PropellerParams params;
+  params.m_diameter_m = 2.;
+  params.m_hull_wake_fraction_0 = 0.25;
+  params.m_thrust_deduction_factor_0 = 0.2;
+  params.m_screw_direction = acme::RIGHT_HANDED;
+  params.m_thruster_perf_data_json_string = open_water_data_table;
+
+  FPP1Q table_propeller(params);
+  table_propeller.Initialize();
+
+  params.m_chebyshev_degree = 6;
+  FPP1Q chebyshev_propeller(params);
+  chebyshev_propeller.Initialize();
+
+  // Operating points of a fleet, stopped propellers and sidewash included
+  std::vector<double> rho, u, v, rpm;
+  for (double ui = 0.; ui <= 2.; ui += 0.1) {
+    for (double rpm_i : {0., 60., 90., 120.}) {
+      rho.push_back(1025.);
+      u.push_back(ui);
+      v.push_back(0.3 * ui - 0.2);
+      rpm.push_back(rpm_i);
+    }
+  }
+  auto size = u.size();
+
+  for (const FPP1Q *propeller : {&table_propeller, &chebyshev_propeller}) {
+    std::vector<double> uPA(size), sidewash(size), J(size), thrust(size), torque(size), power(size), efficiency(size);
+    propeller->ComputeBatch({size, rho.data(), u.data(), v.data(), rpm.data(), nullptr},
+                            {uPA.data(), sidewash.data(), J.data(), thrust.data(), torque.data(), power.data(),
+                             efficiency.data()});
+
+    for (std::size_t i = 0; i < size; i++) {
+      auto output = propeller->Compute(PropellerInput{rho[i], u[i], v[i], rpm[i]});
+      EXPECT_DOUBLE_EQ(uPA[i], output.m_uPA);
+      EXPECT_DOUBLE_EQ(sidewash[i], output.m_sidewash_angle_rad);
+      EXPECT_DOUBLE_EQ(J[i], output.m_advance_ratio);
+      EXPECT_DOUBLE_EQ(thrust[i], output.m_thrust_N);
+      EXPECT_DOUBLE_EQ(torque[i], output.m_torque_Nm);
+      EXPECT_DOUBLE_EQ(power[i], output.m_power_W);
+      EXPECT_DOUBLE_EQ(efficiency[i], output.m_efficiency);
+    }
+  }
+
+  // Same errors as Compute
+  std::vector<double> out(size);
+  rpm[5] = -60.;
+  EXPECT_THROW(table_propeller.ComputeBatch({size, rho.data(), u.data(), v.data(), rpm.data(), nullptr},
+                                            {out.data(), out.data(), out.data(), out.data(), out.data(), out.data(),
+                                             out.data()}),
+               std::runtime_error);
+
+}
+
+TEST(TestFPP1Q, out_of_range_policies) {
+
+  PropellerParams params;
+  params.m_diameter_m = 2.;
+  params.m_screw_direction = acme::RIGHT_HANDED;
+  params.m_hull_wake_fraction_0 = 0.;
+  params.m_thrust_deduction_factor_0 = 0.;
+  params.m_thruster_perf_data_json_string = open_water_data_table;
+
+  // J = 1.5, beyond the open water data (J <= 0.848)
+  PropellerInput input{1025., 3., 0., 60.};
+  double J = 1.5;
+
+  auto reference = FPP1Q(params);
+  reference.Initialize();
+  double J_max = 0.84848485, J_prev = 0.83838384;
+  double kt_max = reference.kt(J_max);
+  double kt_slope = (kt_max - reference.kt(J_prev)) / (J_max - J_prev);
+
+  // Default policy : same exception as before
+  EXPECT_THROW(reference.Compute(input), std::runtime_error);
+  EXPECT_EQ(reference.GetStatusCounts().m_nb_out_of_range, 1);
+
+  params.m_out_of_range_policy = E_OUT_OF_RANGE_CLAMP;
+  auto clamp = FPP1Q(params);
+  clamp.Initialize();
+  auto output = clamp.Compute(input);
+  EXPECT_EQ(output.m_status, E_STATUS_OUT_OF_RANGE);
+  EXPECT_DOUBLE_EQ(output.m_advance_ratio, J);
+  EXPECT_DOUBLE_EQ(output.m_thrust_N, 1025. * 16. * kt_max);
+  EXPECT_EQ(clamp.Compute(PropellerInput{1025., 1., 0., 60.}).m_status, E_STATUS_OK);
+
+  params.m_out_of_range_policy = E_OUT_OF_RANGE_EXTRAPOLATE;
+  auto extrapolate = FPP1Q(params);
+  extrapolate.Initialize();
+  output = extrapolate.Compute(input);
+  EXPECT_EQ(output.m_status, E_STATUS_OUT_OF_RANGE);
+  EXPECT_NEAR(extrapolate.kt(J), kt_max + kt_slope * (J - J_max), 1E-8);
+  EXPECT_NEAR(output.m_thrust_N, 1025. * 16. * extrapolate.kt(J), 1E-6);
+
+  params.m_out_of_range_policy = E_OUT_OF_RANGE_ZERO;
+  auto zero = FPP1Q(params);
+  zero.Initialize();
+  output = zero.Compute(input);
+  EXPECT_EQ(output.m_status, E_STATUS_OUT_OF_RANGE);
+  EXPECT_EQ(output.m_thrust_N, 0.);
+  EXPECT_EQ(output.m_torque_Nm, 0.);
+  EXPECT_EQ(output.m_efficiency, 0.);
+
+  // Chebyshev expansions : values at the bound, slope at the bound
+  params.m_out_of_range_policy = E_OUT_OF_RANGE_EXTRAPOLATE;
+  params.m_chebyshev_degree = 6;
+  auto chebyshev = FPP1Q(params);
+  chebyshev.Initialize();
+  EXPECT_NEAR(chebyshev.kt(J), kt_max + kt_slope * (J - J_max), 1E-3);
+  EXPECT_NEAR(chebyshev.kt(J_max + 1E-9), chebyshev.kt(J_max), 1E-8);
+  params.m_chebyshev_degree = 0;
+
+  // Outside of the first quadrant : zero loads, without exception unless the policy is E_OUT_OF_RANGE_THROW
+  EXPECT_THROW(reference.Compute(1025., -1., 0., 60., 0.), std::runtime_error);
+  output = clamp.Compute(PropellerInput{1025., -1., 0., 60.});
+  EXPECT_EQ(output.m_status, E_STATUS_INVALID_INPUT);
+  EXPECT_EQ(output.m_thrust_N, 0.);
+  EXPECT_EQ(clamp.Compute(PropellerInput{1025., 1., 0., -60.}).m_status, E_STATUS_INVALID_INPUT);
+
+  // Batch statuses, as obtained by Compute
+  std::vector<double> rho(5, 1025.), u = {1., 3., -1., 1., 2.}, v(5, 0.), rpm = {60., 60., 60., -60., 0.};
+  std::vector<double> uPA(5), sidewash(5), advance_ratio(5), thrust(5), torque(5), power(5), efficiency(5);
+  std::vector<unsigned int> status(5);
+  clamp.ResetStatusCounts();
+  clamp.ComputeBatch({5, rho.data(), u.data(), v.data(), rpm.data(), nullptr},
+                     {uPA.data(), sidewash.data(), advance_ratio.data(), thrust.data(), torque.data(), power.data(),
+                      efficiency.data(), status.data()});
+  for (std::size_t i = 0; i < 5; i++) {
+    output = clamp.Compute(PropellerInput{rho[i], u[i], v[i], rpm[i]});
+    EXPECT_EQ(status[i], output.m_status);
+    EXPECT_DOUBLE_EQ(thrust[i], output.m_thrust_N);
+    EXPECT_DOUBLE_EQ(efficiency[i], output.m_efficiency);
+  }
+  EXPECT_EQ(status[1], E_STATUS_OUT_OF_RANGE);
+  EXPECT_EQ(status[4], E_STATUS_OK);
+
+  // One out of range lookup and two invalid operating points, for the batch and for Compute
+  auto counts = clamp.GetStatusCounts();
+  EXPECT_EQ(counts.m_nb_out_of_range, 2);
+  EXPECT_EQ(counts.m_nb_invalid_input, 4);
+  clamp.ResetStatusCounts();
+  EXPECT_EQ(clamp.GetStatusCounts().m_nb_out_of_range, 0);
+  EXPECT_EQ(clamp.GetStatusCounts().m_nb_invalid_input, 0);
+
+}
 
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
@@ -203,6 +203,106 @@ TEST(TestFPP4Q, with_interactions) {
   EXPECT_NEAR(propeller.GetPropellerEfficiency(), 0.122334, 1E-6);
 }
 
+TEST(TestFPP4Q, fourier_series) {
+
+  // A few harmonics, with the shape of four quadrant open water curves
+  std::vector<double> ct_a = {-0.0584, 0.1327, -0.0081, -0.0213, 0.0036, 0.0059};
+  std::vector<double> ct_b = {0., -0.7316, 0.0221, 0.0480, -0.0107, -0.0039};
+  std::vector<double> cq_a = {-0.0051, 0.0197, -0.0010, -0.0022, 0.0005, 0.0007};
+  std::vector<double> cq_b = {0., -0.0767, 0.0009, 0.0056, -0.0011, -0.0003};
+
+  auto series = [](const std::vector<double> &a, const std::vector<double> &b, double beta) {
+    double value = 0.;
+    for (int k = 0; k < a.size(); k++) value += a[k] * std::cos(k * beta) + b[k] * std::sin(k * beta);
+    return value;
+  };
+
+  auto json_array = [](const std::vector<double> &values) {
+    std::stringstream ss;
+    ss.precision(17);
+    ss << "[";
+    for (int i = 0; i < values.size(); i++) ss << (i ? ", " : "") << values[i];
+    ss << "]";
+    return ss.str();
+  };
+
+  std::stringstream fourier_json;
+  fourier_json << R"({"fourier": {"ct": {"a": )" << json_array(ct_a) << R"(, "b": )" << json_array(ct_b)
+               << R"(}, "cq": {"a": )" << json_array(cq_a) << R"(, "b": )" << json_array(cq_b) << "}}}";
+
+  // Same curves tabulated every degree
+  std::vector<double> beta_deg, ct, cq;
+  for (int i = -180; i <= 180; i++) {
+    beta_deg.push_back(i);
+    ct.push_back(series(ct_a, ct_b, i * DEG2RAD));
+    cq.push_back(series(cq_a, cq_b, i * DEG2RAD));
+  }
+  std::stringstream table_json;
+  table_json << R"({"beta_deg": )" << json_array(beta_deg) << R"(, "ct": )" << json_array(ct)
+             << R"(, "cq": )" << json_array(cq) << "}";
+
+  PropellerParams params;
+  params.m_diameter_m = 2.;
+  params.m_hull_wake_fraction_0 = 0.2;
+  params.m_thrust_deduction_factor_0 = 0.25;
+  params.m_screw_direction = acme::RIGHT_HANDED;
+
+  params.m_thruster_perf_data_json_string = fourier_json.str();
+  FPP4Q fourier_propeller(params);
+  fourier_propeller.Initialize();
+
+  params.m_thruster_perf_data_json_string = table_json.str();
+  FPP4Q table_propeller(params);
+  table_propeller.Initialize();
+
+  // beta = 0 : ct is the sum of the cosine coefficients
+  fourier_propeller.Compute(1025, 0., 0., 60., 0.);
+  double vp = 0.7 * MU_PI * 2.;
+  double thrust = 0.5 * 1025 * vp * vp * MU_PI * (1. - 0.25) * series(ct_a, ct_b, 0.);
+  EXPECT_NEAR(fourier_propeller.GetThrust(), thrust, 1E-8 * std::abs(thrust));
+
+  // Four quadrants : the 1 degree table and the series must agree within the linear interpolation error, ie 1E-3 on
+  // the coefficients
+  for (double u : {-3., -1., 0., 1., 3.}) {
+    for (double rpm : {-120., -60., 0., 60., 120.}) {
+      fourier_propeller.Compute(1025, u, 0.1, rpm, 0.);
+      table_propeller.Compute(1025, u, 0.1, rpm, 0.);
+      double vp_n = 0.7 * MU_PI * rpm / 60. * 2.;
+      double load = 0.5 * 1025 * (u * u + 0.01 + vp_n * vp_n) * MU_PI; // upper bound of 0.5 rho vB2 Ad
+      EXPECT_NEAR(fourier_propeller.GetThrust(), table_propeller.GetThrust(), 1E-3 * load);
+      EXPECT_NEAR(fourier_propeller.GetTorque(), table_propeller.GetTorque(), 1E-3 * load * 2.);
+    }
+  }
+
+  // The batch evaluation gives the results of Compute, in every quadrant
+  std::vector<double> rho, u, v, rpm;
+  for (double ui : {-3., -1., 0., 1., 3.}) {
+    for (double rpm_i : {-120., -60., 0., 60., 120.}) {
+      rho.push_back(1025.);
+      u.push_back(ui);
+      v.push_back(0.1);
+      rpm.push_back(rpm_i);
+    }
+  }
+  auto size = u.size();
+  for (const FPP4Q *propeller : {&fourier_propeller, &table_propeller}) {
+    std::vector<double> uPA(size), sidewash(size), J(size), thrust(size), torque(size), power(size), efficiency(size);
+    propeller->ComputeBatch({size, rho.data(), u.data(), v.data(), rpm.data(), nullptr},
+                            {uPA.data(), sidewash.data(), J.data(), thrust.data(), torque.data(), power.data(),
+                             efficiency.data()});
+    for (std::size_t i = 0; i < size; i++) {
+      auto output = propeller->Compute(PropellerInput{rho[i], u[i], v[i], rpm[i]});
+      EXPECT_DOUBLE_EQ(uPA[i], output.m_uPA);
+      EXPECT_DOUBLE_EQ(J[i], output.m_advance_ratio);
+      EXPECT_DOUBLE_EQ(thrust[i], output.m_thrust_N);
+      EXPECT_DOUBLE_EQ(torque[i], output.m_torque_Nm);
+      EXPECT_DOUBLE_EQ(power[i], output.m_power_W);
+      EXPECT_DOUBLE_EQ(efficiency[i], output.m_efficiency);
+    }
+  }
+
+}
+
 
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
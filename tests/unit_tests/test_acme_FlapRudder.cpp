@@ -31,7 +31,7 @@ std::string str(T begin, T end) {
 
 TEST(TestFlapRudder, parser) {
 
-  mathutils::LookupTable2d<double> cd_cl_cn_coeffs;
+  PerformanceTable2D cd_cl_cn_coeffs;
 
   std::vector<double> alpha_in = {-50.0, -40.0, -30.0, -20.0, -10.0, 10.0, 20.0, 30.0, 40.0, 50.0};
   std::vector<double> flap_angle_in = {-10.0, -5., 0.0, 5., 10.0};
@@ -104,6 +104,71 @@ TEST(TestFlapRudder, parser) {
 
 }
 
+TEST(TestFlapRudder, symmetric_table) {
+
+  // Polar of a symmetric section : cl and cn odd, cd even with respect to (alpha, flap) -> (-alpha, -flap)
+  std::vector<double> alpha_in = {-30., -20., -10., -5., 0., 5., 10., 20., 30.};
+  std::vector<double> flap_angle_in = {-10., -5., 0., 5., 10.};
+  auto polar = [&alpha_in, &flap_angle_in](double cl_scale, double cd_offset, double asymmetry) {
+    std::vector<std::vector<double>> cl(flap_angle_in.size()), cd(flap_angle_in.size()), cn(flap_angle_in.size());
+    for (int j = 0; j < flap_angle_in.size(); j++) {
+      for (auto alpha : alpha_in) {
+        double effective = (alpha + 0.4 * flap_angle_in[j]) * DEG2RAD;
+        cl[j].push_back(cl_scale * std::sin(2. * effective) + asymmetry);
+        cd[j].push_back(cd_offset + effective * effective);
+        cn[j].push_back(-0.05 * std::sin(effective));
+      }
+    }
+    std::stringstream ss;
+    ss << R"({"symmetric": true, "flow_incidence_on_main_rudder_deg": )" << str(alpha_in.begin(), alpha_in.end())
+       << R"(, "flap_angle_deg": )" << str(flap_angle_in.begin(), flap_angle_in.end());
+    for (auto coeff : {std::make_pair("Cd", &cd), std::make_pair("Cl", &cl), std::make_pair("Cn", &cn)}) {
+      ss << R"(, ")" << coeff.first << R"(": [)";
+      for (int j = 0; j < coeff.second->size(); j++) {
+        if (j > 0) ss << ", ";
+        ss << str((*coeff.second)[j].begin(), (*coeff.second)[j].end());
+      }
+      ss << "]";
+    }
+    ss << "}";
+    return ss.str();
+  };
+
+  RudderParams params;
+  params.m_chord_m = 2.;
+  params.m_lateral_area_m2 = 4.;
+  params.m_flap_slope = 0.5;
+  params.m_perf_data_json_string = polar(1.2, 0.01, 0.);
+
+  auto symmetric_rudder = FlapRudderModel(params);
+  symmetric_rudder.Initialize();
+  EXPECT_TRUE(symmetric_rudder.GetParameters().m_symmetric_table);
+
+  // Same polar without the symmetric flag
+  auto json_string = params.m_perf_data_json_string;
+  params.m_perf_data_json_string = json_string.replace(json_string.find("true"), 4, "false");
+  auto rudder = FlapRudderModel(params);
+  rudder.Initialize();
+  EXPECT_FALSE(rudder.GetParameters().m_symmetric_table);
+
+  for (double alpha = -30.; alpha <= 30.; alpha += 0.7) {
+    for (double rudder_angle = -20.; rudder_angle <= 20.; rudder_angle += 1.3) {
+      double cl, cd, cn, cl_s, cd_s, cn_s;
+      rudder.GetClCdCn(alpha * DEG2RAD, rudder_angle * DEG2RAD, cl, cd, cn);
+      symmetric_rudder.GetClCdCn(alpha * DEG2RAD, rudder_angle * DEG2RAD, cl_s, cd_s, cn_s);
+      EXPECT_NEAR(cl_s, cl, 1E-12);
+      EXPECT_NEAR(cd_s, cd, 1E-12);
+      EXPECT_NEAR(cn_s, cn, 1E-12);
+    }
+  }
+
+  // Non symmetric data are rejected
+  params.m_perf_data_json_string = polar(1.2, 0.01, 0.01);
+  auto asymmetric_rudder = FlapRudderModel(params);
+  EXPECT_THROW(asymmetric_rudder.Initialize(), std::runtime_error);
+
+}
+
 
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
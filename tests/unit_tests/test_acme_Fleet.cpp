@@ -0,0 +1,213 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+
+#include "acme/acme.h"
+#include "gtest/gtest.h"
+
+#include "acme_test_fixtures.h"
+
+using namespace acme;
+
+
+PropellerParams fleet_propeller_params(double diameter_m) {
+  auto params = propeller_params(fpp1q_perf_data());
+  params.m_diameter_m = diameter_m;
+  return params;
+}
+
+/// Rudder failing for negative velocities, to check the propagation of the exceptions thrown by the models
+class FailingRudder : public BrixRudderModel {
+ public:
+  explicit FailingRudder(const RudderParams &params) : BrixRudderModel(params) {}
+
+  using BrixRudderModel::Compute;
+
+  RudderOutput Compute(const RudderInput &input) const override {
+    if (input.m_u_NWU < 0.) throw std::runtime_error("negative velocity");
+    return BrixRudderModel::Compute(input);
+  }
+};
+
+
+TEST(WorkStealingPool, run) {
+
+  WorkStealingPool pool(4);
+  EXPECT_EQ(pool.GetNbThreads(), 4);
+
+  // Uneven tasks : the last ones are much longer, every task must be executed exactly once
+  const std::size_t nb_tasks = 1000;
+  std::vector<std::atomic<int>> counts(nb_tasks);
+  for (auto &count : counts) count = 0;
+  std::atomic<double> sink{0.};
+
+  for (int repeat = 0; repeat < 3; repeat++) {
+    pool.Run(nb_tasks, [&](std::size_t task, unsigned int worker) {
+      ASSERT_LT(worker, 4u);
+      double sum = 0.;
+      for (std::size_t k = 0; k < (task > 900 ? 20000 : 10); k++) sum += std::sqrt(double(k));
+      sink = sum;
+      counts[task]++;
+    });
+  }
+  for (const auto &count : counts) EXPECT_EQ(count, 3);
+
+  std::size_t nb_executed = 0;
+  for (const auto &worker : pool.GetWorkerStats()) nb_executed += worker.m_nb_tasks;
+  EXPECT_EQ(nb_executed, nb_tasks);
+
+  // No task
+  pool.Run(0, [](std::size_t, unsigned int) { FAIL(); });
+
+  // The first exception is rethrown once all workers are done, and the pool remains usable
+  EXPECT_THROW(pool.Run(nb_tasks, [](std::size_t task, unsigned int) {
+    if (task == 500) throw std::runtime_error("task failure");
+  }), std::runtime_error);
+  std::atomic<std::size_t> nb_done{0};
+  pool.Run(nb_tasks, [&](std::size_t, unsigned int) { nb_done++; });
+  EXPECT_EQ(nb_done, nb_tasks);
+
+}
+
+TEST(FleetEngine, step) {
+
+  FleetEngine fleet(3, 7);
+  EXPECT_EQ(fleet.GetNbThreads(), 3);
+
+  // Two propeller designs shared by the units, one model per rudder
+  auto propeller_small = std::make_shared<FPP1Q>(fleet_propeller_params(3.));
+  auto propeller_large = std::make_shared<FPP1Q>(fleet_propeller_params(5.));
+  for (std::size_t i = 0; i < 100; i++) {
+    double u = 0.05 * double(i);
+    auto unit = fleet.AddPropeller(i % 2 ? propeller_small : propeller_large, {1025., u, 0.01 * u, 80. + i % 30, 0.});
+    EXPECT_EQ(unit, i);
+  }
+  for (std::size_t i = 0; i < 50; i++) {
+    fleet.AddRudder(std::make_shared<BrixRudderModel>(rudder_params()),
+                    {1025., 0.2 * double(i), 0.5, -30. + double(i)});
+  }
+  auto propeller_rudder = std::make_shared<BrixPropellerRudder<FPP1Q, BrixRudderModel>>(fleet_propeller_params(4.),
+                                                                                         rudder_params());
+  for (std::size_t i = 0; i < 60; i++) {
+    double u = 0.5 + 0.1 * double(i);
+    fleet.AddPropellerRudder(propeller_rudder, {1025., u, 0.1, u, 0.1, 0.001, 5., 50., 100., 0., -30. + double(i)});
+  }
+  fleet.Initialize();
+
+  for (int step = 0; step < 2; step++) {
+    // Operating points updated between the steps
+    for (std::size_t i = 0; i < fleet.GetNbPropellers(); i++) fleet.GetPropellerInput(i).m_rpm += 5.;
+    fleet.Step();
+
+    for (std::size_t i = 0; i < fleet.GetNbPropellers(); i++) {
+      auto expected = (i % 2 ? propeller_small : propeller_large)->Compute(fleet.GetPropellerInput(i));
+      EXPECT_DOUBLE_EQ(fleet.GetPropellerOutput(i).m_thrust_N, expected.m_thrust_N);
+      EXPECT_DOUBLE_EQ(fleet.GetPropellerOutput(i).m_torque_Nm, expected.m_torque_Nm);
+    }
+    BrixRudderModel rudder(rudder_params());
+    rudder.Initialize();
+    for (std::size_t i = 0; i < fleet.GetNbRudders(); i++) {
+      auto expected = rudder.Compute(fleet.GetRudderInput(i));
+      EXPECT_DOUBLE_EQ(fleet.GetRudderOutput(i).m_fx_N, expected.m_fx_N);
+      EXPECT_DOUBLE_EQ(fleet.GetRudderOutput(i).m_fy_N, expected.m_fy_N);
+      EXPECT_DOUBLE_EQ(fleet.GetRudderOutput(i).m_torque_Nm, expected.m_torque_Nm);
+    }
+    for (std::size_t i = 0; i < fleet.GetNbPropellerRudders(); i++) {
+      auto expected = propeller_rudder->Compute(fleet.GetPropellerRudderInput(i));
+      EXPECT_DOUBLE_EQ(fleet.GetPropellerRudderOutput(i).m_fx_N, expected.m_fx_N);
+      EXPECT_DOUBLE_EQ(fleet.GetPropellerRudderOutput(i).m_fy_N, expected.m_fy_N);
+      EXPECT_DOUBLE_EQ(fleet.GetPropellerRudderOutput(i).m_mz_Nm, expected.m_mz_Nm);
+    }
+  }
+
+  auto stats = fleet.GetLastStepStats();
+  EXPECT_EQ(stats.m_nb_chunks, 15 + 8 + 9);
+  EXPECT_EQ(stats.m_nb_threads, 3);
+  EXPECT_GT(stats.m_step_time_ms, 0.);
+  EXPECT_GE(stats.m_max_busy_time_ms, stats.m_mean_busy_time_ms);
+  EXPECT_GE(stats.m_load_imbalance, 0.);
+
+}
+
+TEST(FleetEngine, bulk_initialization) {
+
+  // Performance data only used by this test, three distinct ones
+  auto perf_data = [](int variant) {
+    return R"({"j": [0, 0.4, 0.8, 1.2], "kt": [0.35, 0.22, 0.07, -0.11], "kq": [0.043, 0.031, 0.015, -0.006],)"
+           R"( "variant": )" + std::to_string(variant) + "}";
+  };
+
+  std::vector<std::shared_ptr<PropellerBaseModel>> propellers;
+  for (int i = 0; i < 60; i++) {
+    auto params = fleet_propeller_params(4.);
+    params.m_thruster_perf_data_json_string = perf_data(i % 3);
+    propellers.push_back(std::make_shared<FPP1Q>(params));
+  }
+  propellers.push_back(propellers[5]);  // given twice, initialized once
+
+  std::vector<std::shared_ptr<RudderBaseModel>> rudders;
+  for (int i = 0; i < 10; i++) rudders.push_back(std::make_shared<BrixRudderModel>(rudder_params()));
+
+  WorkStealingPool pool(4);
+  auto stats = InitializeModels(pool, propellers, rudders);
+
+  EXPECT_EQ(stats.m_nb_threads, 4);
+  EXPECT_EQ(stats.m_nb_models, 70);
+  EXPECT_EQ(stats.m_nb_curve_builds, 3);
+  ASSERT_EQ(stats.m_propeller_times_ms.size(), 61);
+  ASSERT_EQ(stats.m_rudder_times_ms.size(), 10);
+  EXPECT_TRUE(stats.m_propeller_rudder_times_ms.empty());
+  EXPECT_EQ(stats.m_propeller_times_ms.back(), 0.);
+  EXPECT_GT(stats.m_total_time_ms, 0.);
+  EXPECT_GE(stats.m_sum_model_time_ms, stats.m_max_model_time_ms);
+
+  // Initialized, sharing the curves of identical data
+  for (const auto &propeller : propellers) {
+    EXPECT_NO_THROW(propeller->Compute(PropellerInput{1025., 3., 0., 100.}));
+    EXPECT_TRUE(propeller->GetParameters().m_thruster_perf_data_json_string.empty());
+  }
+
+  // Invalid data : the exception reaches the caller, and every model waiting for the same data gets it
+  std::vector<std::shared_ptr<PropellerBaseModel>> invalid;
+  for (int i = 0; i < 8; i++) {
+    auto params = fleet_propeller_params(4.);
+    params.m_thruster_perf_data_json_string = R"({"j": [0, 0.4], "kt": [0.35, 0.22]})";
+    invalid.push_back(std::make_shared<FPP1Q>(params));
+  }
+  EXPECT_THROW(InitializeModels(pool, invalid), std::runtime_error);
+
+}
+
+TEST(FleetEngine, model_failure) {
+
+  FleetEngine fleet(2, 4);
+  auto rudder = std::make_shared<FailingRudder>(rudder_params());
+  for (std::size_t i = 0; i < 40; i++) fleet.AddRudder(rudder, {1025., 2., 0., 10.});
+  fleet.Initialize();
+  fleet.Step();
+
+  fleet.GetRudderInput(17).m_u_NWU = -1.;
+  EXPECT_THROW(fleet.Step(), std::runtime_error);
+  EXPECT_EQ(fleet.GetLastStepStats().m_nb_chunks, 10);
+
+  fleet.GetRudderInput(17).m_u_NWU = 2.;
+  EXPECT_NO_THROW(fleet.Step());
+
+}
+
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,173 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#include <stdexcept>
+
+#include "acme/acme.h"
+#include "gtest/gtest.h"
+
+using namespace acme;
+
+
+const std::string tug_propeller = R"({"type": "FPP1Q", "diameter_m": 3.2, "screw_direction": "left",
+    "hull_wake_fraction_0": 0.2, "thrust_deduction_factor_0": 0.15, "out_of_range": "clamp",
+    "perf_data": {"j": [0, 0.4, 0.8, 1.2], "kt": [0.35, 0.22, 0.07, -0.11], "kq": [0.043, 0.031, 0.015, -0.006]}})";
+
+const std::string tug_rudder = R"({"type": "brix", "lateral_area_m2": 8.0, "chord_m": 2.0, "height_m": 4.0,
+    "hull_wake_fraction_0": 0.15, "distance_nose_stock_m": 0.5})";
+
+const std::string thruster_propeller = R"({"type": "FPP4Q", "diameter_m": 2.0,
+    "perf_data": {"beta_deg": [-180, -90, 0, 90, 180], "ct": [-0.16, 0.89, 0.28, -1.38, -0.16],
+                  "cq": [-0.019, 0.109, 0.056, -0.123, -0.019]}})";
+
+
+TEST(ModelFactory, every_combination) {
+
+  PropellerParams propeller_params{};
+  propeller_params.m_diameter_m = 4.;
+  RudderParams rudder_params{};
+  rudder_params.m_lateral_area_m2 = 12.;
+  rudder_params.m_chord_m = 3.;
+  rudder_params.m_height_m = 4.;
+
+  for (auto propeller_type : {E_FPP1Q, E_FPP4Q, E_CPP}) {
+    EXPECT_TRUE(BuildPropeller(propeller_type, propeller_params));
+
+    for (auto rudder_type : {E_SIMPLE_RUDDER, E_FLAP_RUDDER, E_FUJII_RUDDER, E_BRIX_RUDDER}) {
+      auto brix = BuildPropellerRudder(E_BRIX, propeller_type, propeller_params, rudder_type, rudder_params);
+      EXPECT_TRUE(brix);
+
+      if (propeller_type == E_FPP1Q) {
+        EXPECT_TRUE(BuildPropellerRudder(E_MMG, propeller_type, propeller_params, rudder_type, rudder_params));
+      } else {
+        EXPECT_THROW(BuildPropellerRudder(E_MMG, propeller_type, propeller_params, rudder_type, rudder_params),
+                     std::invalid_argument);
+      }
+    }
+  }
+
+  for (auto rudder_type : {E_SIMPLE_RUDDER, E_FLAP_RUDDER, E_FUJII_RUDDER, E_BRIX_RUDDER}) {
+    EXPECT_TRUE(BuildRudder(rudder_type, rudder_params));
+  }
+
+  // Concrete types
+  EXPECT_TRUE(std::dynamic_pointer_cast<CPP>(BuildPropeller(E_CPP, propeller_params)));
+  EXPECT_TRUE(std::dynamic_pointer_cast<FlapRudderModel>(BuildRudder(E_FLAP_RUDDER, rudder_params)));
+  EXPECT_TRUE((std::dynamic_pointer_cast<BrixPropellerRudder<FPP4Q, FujiiRudderModel>>(
+      BuildPropellerRudder(E_BRIX, E_FPP4Q, propeller_params, E_FUJII_RUDDER, rudder_params))));
+  EXPECT_TRUE(std::dynamic_pointer_cast<MMGPropellerRudder<SimpleRudderModel>>(
+      BuildPropellerRudder(E_MMG, E_FPP1Q, propeller_params, E_SIMPLE_RUDDER, rudder_params)));
+
+  // Legacy builders
+  EXPECT_TRUE(std::dynamic_pointer_cast<MMGPropellerRudder<BrixRudderModel>>(
+      build_MMG_pr(E_FPP1Q, propeller_params, E_BRIX_RUDDER, rudder_params)));
+  EXPECT_THROW(build_MMG_pr(E_FPP4Q, propeller_params, E_BRIX_RUDDER, rudder_params), std::invalid_argument);
+  EXPECT_TRUE((std::dynamic_pointer_cast<BrixPropellerRudder<CPP, FlapRudderModel>>(
+      build_Brix_pr(E_CPP, propeller_params, E_FLAP_RUDDER, rudder_params))));
+
+}
+
+TEST(ModelFactory, parse_model_config) {
+
+  auto config = ParseModelConfig(
+      R"({"propeller": )" + tug_propeller + R"(, "rudder": )" + tug_rudder + R"(, "interaction": "mmg"})");
+  EXPECT_TRUE(config.m_has_propeller);
+  EXPECT_TRUE(config.m_has_rudder);
+  EXPECT_EQ(config.m_propeller_type, E_FPP1Q);
+  EXPECT_EQ(config.m_rudder_type, E_BRIX_RUDDER);
+  EXPECT_EQ(config.m_interaction, E_MMG);
+  EXPECT_DOUBLE_EQ(config.m_propeller_params.m_diameter_m, 3.2);
+  EXPECT_EQ(config.m_propeller_params.m_screw_direction, LEFT_HANDED);
+  EXPECT_EQ(config.m_propeller_params.m_out_of_range_policy, E_OUT_OF_RANGE_CLAMP);
+  EXPECT_FALSE(config.m_propeller_params.m_thruster_perf_data_json_string.empty());
+  EXPECT_DOUBLE_EQ(config.m_rudder_params.m_distance_nose_stock_m, 0.5);
+
+  auto rudder = ParseModelConfig(R"({"rudder": )" + tug_rudder + "}");
+  EXPECT_FALSE(rudder.m_has_propeller);
+  EXPECT_TRUE(rudder.m_has_rudder);
+  EXPECT_EQ(rudder.m_interaction, E_BRIX);
+
+  EXPECT_THROW(ParseModelConfig(R"({"propeller": {"type": "FPP2Q", "diameter_m": 1.0, "perf_data": {}}})"),
+               std::runtime_error);
+  EXPECT_THROW(ParseModelConfig(R"({"rudder": )" + tug_rudder + R"(, "interaction": "none"})"), std::runtime_error);
+  EXPECT_THROW(ParseModelConfig(R"({"propeller": {"type": "FPP1Q"}})"), std::runtime_error);
+  EXPECT_THROW(ParseModelConfig("{}"), std::runtime_error);
+  EXPECT_THROW(ParseModelConfig("{"), std::runtime_error);
+
+}
+
+TEST(ModelFactory, scenario) {
+
+  auto scenario = BuildScenario(R"({
+      "models": {
+        "tug": {"propeller": )" + tug_propeller + R"(, "rudder": )" + tug_rudder + R"(},
+        "thruster": {"propeller": )" + thruster_propeller + R"(},
+        "spare_rudder": {"rudder": )" + tug_rudder + R"(}
+      },
+      "units": [{"model": "tug", "count": 1000}, {"model": "thruster", "count": 300}, {"model": "tug"},
+                {"model": "spare_rudder", "count": 10}]
+    })");
+
+  ASSERT_EQ(scenario.m_propeller_rudders.size(), 1001);
+  ASSERT_EQ(scenario.m_propellers.size(), 300);
+  ASSERT_EQ(scenario.m_rudders.size(), 10);
+
+  // The units of an entry are contiguous, in the order of the scenario
+  using Tug = BrixPropellerRudder<FPP1Q, BrixRudderModel>;
+  for (std::size_t i = 0; i + 1 < 1000; i++) {
+    auto first = reinterpret_cast<const char *>(scenario.m_propeller_rudders[i].get());
+    auto next = reinterpret_cast<const char *>(scenario.m_propeller_rudders[i + 1].get());
+    ASSERT_EQ(next - first, sizeof(Tug));
+  }
+  EXPECT_TRUE(std::dynamic_pointer_cast<Tug>(scenario.m_propeller_rudders.back()));
+  for (std::size_t i = 0; i + 1 < 300; i++) {
+    auto first = reinterpret_cast<const char *>(scenario.m_propellers[i].get());
+    auto next = reinterpret_cast<const char *>(scenario.m_propellers[i + 1].get());
+    ASSERT_EQ(next - first, sizeof(FPP4Q));
+  }
+
+  // A single curve build per distinct performance data
+  WorkStealingPool pool(4);
+  auto stats = InitializeModels(pool, scenario.m_propellers, scenario.m_rudders, scenario.m_propeller_rudders);
+  EXPECT_EQ(stats.m_nb_models, 1311);
+  EXPECT_EQ(stats.m_nb_curve_builds, 2);
+
+  // Same results as a model built alone from the same configuration
+  auto config = ParseModelConfig(R"({"propeller": )" + tug_propeller + R"(, "rudder": )" + tug_rudder + "}");
+  auto tug = BuildPropellerRudder(config.m_interaction, config.m_propeller_type, config.m_propeller_params,
+                                  config.m_rudder_type, config.m_rudder_params);
+  tug->Initialize();
+
+  PropellerRudderInput input{1025., 4., 0.2, 4., 0.2, 0.01, -20., -22., 120., 0., 15.};
+  auto expected = tug->Compute(input);
+  for (std::size_t i : {std::size_t(0), std::size_t(517), std::size_t(1000)}) {
+    auto output = scenario.m_propeller_rudders[i]->Compute(input);
+    EXPECT_DOUBLE_EQ(output.m_fx_N, expected.m_fx_N);
+    EXPECT_DOUBLE_EQ(output.m_fy_N, expected.m_fy_N);
+    EXPECT_DOUBLE_EQ(output.m_mz_Nm, expected.m_mz_Nm);
+  }
+
+  // The arena is released with the last unit
+  std::weak_ptr<PropellerRudderBase> unit = scenario.m_propeller_rudders[3];
+  scenario.m_propeller_rudders.erase(scenario.m_propeller_rudders.begin(), scenario.m_propeller_rudders.begin() + 999);
+  EXPECT_FALSE(unit.expired());
+  scenario.m_propeller_rudders.erase(scenario.m_propeller_rudders.begin());
+  EXPECT_TRUE(unit.expired());
+
+  EXPECT_THROW(BuildScenario(R"({"models": {}, "units": [{"model": "tug"}]})"), std::runtime_error);
+  EXPECT_THROW(BuildScenario(R"({"units": []})"), std::runtime_error);
+
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,145 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+
+#include "acme/acme.h"
+#include "gtest/gtest.h"
+
+#include "acme_test_fixtures.h"
+
+using namespace acme;
+
+
+TEST(OperatingMap, grid) {
+
+  auto axis = GridAxis::Linspace("x", -1., 1., 5);
+  EXPECT_EQ(axis.m_values.size(), 5);
+  EXPECT_DOUBLE_EQ(axis.m_values[1], -0.5);
+  EXPECT_DOUBLE_EQ(axis.m_values[4], 1.);
+
+  // Last axis varying fastest
+  OperatingMap map({axis, {"y", {10., 20., 30.}}}, {"sum"});
+  EXPECT_EQ(map.GetNbPoints(), 15);
+  double coordinates[2];
+  map.GetCoordinates(7, coordinates);
+  EXPECT_DOUBLE_EQ(coordinates[0], 0.);
+  EXPECT_DOUBLE_EQ(coordinates[1], 20.);
+
+  EXPECT_EQ(map.GetColumnIndex("sum"), 0);
+  EXPECT_THROW(map.GetColumnIndex("product"), std::out_of_range);
+  EXPECT_THROW(OperatingMap({{"z", {}}}, {"sum"}), std::invalid_argument);
+
+  auto sum_map = BuildOperatingMap({axis, {"y", {10., 20., 30.}}}, {"sum", "product"},
+                                   [](const double *x, double *values) {
+                                     values[0] = x[0] + x[1];
+                                     values[1] = x[0] * x[1];
+                                   }, 3);
+  for (std::size_t point = 0; point < sum_map.GetNbPoints(); point++) {
+    sum_map.GetCoordinates(point, coordinates);
+    EXPECT_DOUBLE_EQ(sum_map.GetColumn(0)[point], coordinates[0] + coordinates[1]);
+    EXPECT_DOUBLE_EQ(sum_map.GetColumn(1)[point], coordinates[0] * coordinates[1]);
+  }
+
+}
+
+TEST(OperatingMap, propeller) {
+
+  FPP1Q propeller(propeller_params(fpp1q_perf_data()));
+  propeller.Initialize();
+
+  PropellerInput operating_point{1025., 0., 0., 0., 0.};
+  auto map = BuildPropellerMap(propeller, operating_point,
+                               {GridAxis::Linspace("u_NWU", 0., 8., 33), GridAxis::Linspace("rpm", 20., 120., 41)}, 2);
+  ASSERT_EQ(map.GetNbPoints(), 33 * 41);
+
+  auto thrust = map.GetColumn(map.GetColumnIndex("thrust_N"));
+  auto power = map.GetColumn(map.GetColumnIndex("power_W"));
+  double coordinates[2];
+  std::size_t nb_rejected = 0;
+  for (std::size_t point = 0; point < map.GetNbPoints(); point++) {
+    map.GetCoordinates(point, coordinates);
+    auto input = operating_point;
+    input.m_u_NWU = coordinates[0];
+    input.m_rpm = coordinates[1];
+    try {
+      auto expected = propeller.Compute(input);
+      EXPECT_DOUBLE_EQ(thrust[point], expected.m_thrust_N);
+      EXPECT_DOUBLE_EQ(power[point], expected.m_power_W);
+    } catch (const std::exception &) {
+      // Advance ratio out of the open water data
+      EXPECT_TRUE(std::isnan(thrust[point]));
+      nb_rejected++;
+    }
+  }
+  EXPECT_GT(nb_rejected, 0);
+
+  EXPECT_THROW(BuildPropellerMap(propeller, operating_point, {{"speed", {1.}}}), std::invalid_argument);
+
+  // Binary file round trip
+  auto path = std::string(testing::TempDir()) + "acme_propeller_map.bin";
+  map.Write(path);
+  auto read_map = OperatingMap::Read(path);
+  std::remove(path.c_str());
+
+  ASSERT_EQ(read_map.GetNbPoints(), map.GetNbPoints());
+  ASSERT_EQ(read_map.GetColumnNames(), map.GetColumnNames());
+  ASSERT_EQ(read_map.GetAxes().size(), 2);
+  EXPECT_EQ(read_map.GetAxes()[1].m_name, "rpm");
+  EXPECT_EQ(read_map.GetAxes()[1].m_values, map.GetAxes()[1].m_values);
+  for (std::size_t column = 0; column < map.GetColumnNames().size(); column++) {
+    for (std::size_t point = 0; point < map.GetNbPoints(); point++) {
+      auto value = map.GetColumn(column)[point];
+      if (std::isnan(value)) {
+        EXPECT_TRUE(std::isnan(read_map.GetColumn(column)[point]));
+      } else {
+        EXPECT_EQ(read_map.GetColumn(column)[point], value);
+      }
+    }
+  }
+
+  EXPECT_THROW(OperatingMap::Read(path), std::runtime_error);
+
+}
+
+TEST(OperatingMap, propeller_rudder) {
+
+  BrixPropellerRudder<FPP1Q, BrixRudderModel> propeller_rudder(propeller_params(fpp1q_perf_data()), rudder_params());
+  propeller_rudder.Initialize();
+
+  PropellerRudderInput operating_point{1025., 0., 0., 0., 0., 0., 5., 50., 100., 0., 0.};
+  auto map = BuildPropellerRudderMap(propeller_rudder, operating_point,
+                                     {GridAxis::Linspace("speed_ms", 1., 6., 6),
+                                      GridAxis::Linspace("rudder_angle_deg", -35., 35., 15)});
+
+  auto fy = map.GetColumn(map.GetColumnIndex("fy_N"));
+  auto mz = map.GetColumn(map.GetColumnIndex("mz_Nm"));
+  double coordinates[2];
+  for (std::size_t point = 0; point < map.GetNbPoints(); point++) {
+    map.GetCoordinates(point, coordinates);
+    auto input = operating_point;
+    input.m_u_NWU_propeller_ms = coordinates[0];
+    input.m_u_NWU_ship_ms = coordinates[0];
+    input.m_rudder_angle_deg = coordinates[1];
+    auto expected = propeller_rudder.Compute(input);
+    EXPECT_DOUBLE_EQ(fy[point], expected.m_fy_N);
+    EXPECT_DOUBLE_EQ(mz[point], expected.m_mz_Nm);
+  }
+
+}
+
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,651 @@
+// ==========================================================================
+// FRyDoM - frydom-ce.org
+//
+// Copyright (c) Ecole Centrale de Nantes (LHEEA lab.) and D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+#include "acme/acme.h"
+#include "gtest/gtest.h"
+
+using namespace acme;
+
+TEST(TestPerformanceTable1D, fused_evaluation) {
+
+  PerformanceTable1D table;
+  table.SetX({0., 0.5, 1., 2.});
+  auto a = table.AddY("a", {1., 0.5, 0., -1.});
+  auto b = table.AddY("b", {0., 1., 4., 2.});
+
+  EXPECT_EQ(table.GetColumnHandle("a"), a);
+  EXPECT_EQ(table.GetColumnHandle("b"), b);
+  EXPECT_THROW(table.GetColumnHandle("c"), std::out_of_range);
+
+  // Interval location
+  auto interval = table.Locate(0.75);
+  EXPECT_EQ(interval.m_index, 1);
+  EXPECT_NEAR(interval.m_weight, 0.5, 1E-12);
+
+  EXPECT_NEAR(table.Eval(interval, a), 0.25, 1E-12);
+  EXPECT_NEAR(table.Eval(interval, b), 2.5, 1E-12);
+
+  // Fused evaluation of both columns
+  double values[2];
+  interval = table.Eval(1.5, {a, b}, values);
+  EXPECT_EQ(interval.m_index, 2);
+  EXPECT_NEAR(values[0], -0.5, 1E-12);
+  EXPECT_NEAR(values[1], 3., 1E-12);
+
+  // Bounds are part of the range
+  EXPECT_NEAR(table.Eval("a", 0.), 1., 1E-12);
+  EXPECT_NEAR(table.Eval("b", 2.), 2., 1E-12);
+
+  // Out of range
+  EXPECT_THROW(table.Locate(-0.1), std::out_of_range);
+  EXPECT_THROW(table.Locate(2.1), std::out_of_range);
+
+  // Inconsistent inputs
+  EXPECT_THROW(table.AddY("c", {1., 2.}), std::runtime_error);
+  EXPECT_THROW(table.AddY("a", {1., 2., 3., 4.}), std::runtime_error);
+  EXPECT_THROW(table.SetX({0., 1., 1.}), std::runtime_error);
+
+}
+
+TEST(TestTableAxis, uniform_detection) {
+
+  // Uniform axis, with nodes rounded as they usually are in json files
+  std::vector<double> j;
+  for (int i = 0; i < 85; i++) j.push_back(std::round(i / 99. * 1E8) * 1E-8);
+
+  TableAxis uniform_axis;
+  uniform_axis.SetValues(j);
+  EXPECT_TRUE(uniform_axis.IsUniform());
+
+  // Same nodes with one displaced node
+  j[40] += 0.004;
+  TableAxis non_uniform_axis;
+  non_uniform_axis.SetValues(j);
+  EXPECT_FALSE(non_uniform_axis.IsUniform());
+
+  // Both location modes must give the interval containing x, nodes included
+  for (int i = 0; i <= 1000; i++) {
+    double x = j.back() * i / 1000.;
+    for (auto axis : {&uniform_axis, &non_uniform_axis}) {
+      auto interval = axis->Locate(x);
+      auto &values = axis->GetValues();
+      EXPECT_LE(values[interval.m_index], x);
+      EXPECT_LE(x, values[interval.m_index + 1]);
+      EXPECT_GE(interval.m_weight, 0.);
+      EXPECT_LE(interval.m_weight, 1.);
+    }
+  }
+  for (std::size_t i = 0; i < j.size() - 1; i++) {
+    EXPECT_EQ(non_uniform_axis.Locate(j[i]).m_index, i);
+  }
+  EXPECT_EQ(uniform_axis.Locate(uniform_axis.GetMax()).m_index, j.size() - 2);
+
+  EXPECT_THROW(uniform_axis.Locate(-1E-3), std::out_of_range);
+  EXPECT_THROW(uniform_axis.Locate(1.), std::out_of_range);
+
+}
+
+TEST(TestTableAxis, hunt) {
+
+  // Non uniform axis
+  std::vector<double> values;
+  for (int i = 0; i < 200; i++) values.push_back(i * i * 1E-3);
+
+  TableAxis axis;
+  axis.SetValues(values);
+  ASSERT_FALSE(axis.IsUniform());
+
+  // Whatever the hint and the direction of the jump, the hunt must find an interval containing x (on a node, both
+  // adjacent intervals are valid)
+  AxisHint hint;
+  std::vector<double> inputs = {0., 1.2, 1.21, 39.601, 0.5, 20., 19.9, 39.5, 3E-4, 0.001, 39.601, 10.};
+  for (int i = 0; i <= 500; i++) inputs.push_back(39.601 * i / 500.);
+  for (int i = 500; i >= 0; i--) inputs.push_back(39.601 * i / 500.);
+
+  for (auto &x : inputs) {
+    auto interval = axis.Locate(x, hint);
+    EXPECT_LE(values[interval.m_index], x);
+    EXPECT_LE(x, values[interval.m_index + 1]);
+    EXPECT_NEAR(values[interval.m_index] + interval.m_weight * (values[interval.m_index + 1] - values[interval.m_index]),
+                x, 1E-12);
+    EXPECT_EQ(hint.Get(), interval.m_index);
+  }
+
+  // Invalid hint
+  hint.Set(1000);
+  EXPECT_EQ(axis.Locate(0.5, hint).m_index, axis.Locate(0.5).m_index);
+
+  EXPECT_THROW(axis.Locate(40., hint), std::out_of_range);
+
+}
+
+TEST(TestTableAxis, out_of_range) {
+
+  TableAxis axis;
+  axis.SetValues({0., 1., 3.});
+  AxisHint hint;
+  bool is_out_of_range;
+
+  auto interval = axis.Locate(2., hint, false, is_out_of_range);
+  EXPECT_FALSE(is_out_of_range);
+  EXPECT_EQ(interval.m_index, 1);
+  EXPECT_DOUBLE_EQ(interval.m_weight, 0.5);
+
+  // Clamped on the bounds
+  interval = axis.Locate(5., hint, false, is_out_of_range);
+  EXPECT_TRUE(is_out_of_range);
+  EXPECT_EQ(interval.m_index, 1);
+  EXPECT_EQ(interval.m_weight, 1.);
+  EXPECT_EQ(hint.Get(), 1);
+
+  interval = axis.Locate(-1., hint, false, is_out_of_range);
+  EXPECT_TRUE(is_out_of_range);
+  EXPECT_EQ(interval.m_index, 0);
+  EXPECT_EQ(interval.m_weight, 0.);
+
+  // Extrapolated from the first and last intervals
+  interval = axis.Locate(5., hint, true, is_out_of_range);
+  EXPECT_TRUE(is_out_of_range);
+  EXPECT_DOUBLE_EQ(interval.m_weight, 2.);
+  interval = axis.Locate(-1., hint, true, is_out_of_range);
+  EXPECT_DOUBLE_EQ(interval.m_weight, -1.);
+
+  interval = axis.Locate(std::nan(""), hint, true, is_out_of_range);
+  EXPECT_TRUE(is_out_of_range);
+  EXPECT_EQ(interval.m_index, 0);
+  EXPECT_EQ(interval.m_weight, 0.);
+
+  // Linear and cubic tables are extrapolated linearly from their bounds
+  for (auto interpolation : {E_LINEAR, E_MONOTONE_CUBIC, E_AKIMA}) {
+    PerformanceTable1D table;
+    table.SetX({0., 1., 2., 3.});
+    table.SetInterpolation(interpolation);
+    auto column = table.AddY("y", {0., 1., 4., 9.});
+    double slope;
+    table.EvalWithDerivative(table.Locate(3., hint), column, slope);
+    EXPECT_NEAR(table.Eval(table.Locate(4., hint, true, is_out_of_range), column), 9. + slope, 1E-12);
+    EXPECT_NEAR(table.Eval(table.Locate(4., hint, false, is_out_of_range), column), 9., 1E-12);
+  }
+
+}
+
+TEST(TestPerformanceTable2D, fused_evaluation) {
+
+  // f(x, y) = x + 10 y and g(x, y) = x * y are exactly reproduced by bilinear interpolation
+  std::vector<double> x = {-1., 0., 2., 3.};
+  std::vector<double> y = {0., 1., 5.};
+  std::vector<double> f, g;
+  for (auto &xi : x) {
+    for (auto &yj : y) {
+      f.push_back(xi + 10. * yj);
+      g.push_back(xi * yj);
+    }
+  }
+
+  PerformanceTable2D table;
+  table.SetX(x);
+  table.SetY(y);
+  auto f_column = table.AddData("f", f);
+  auto g_column = table.AddData("g", g);
+
+  EXPECT_EQ(table.GetColumnHandle("g"), g_column);
+  EXPECT_THROW(table.AddData("h", {1., 2.}), std::runtime_error);
+
+  AxisHint x_hint, y_hint;
+  for (double xi = -1.; xi <= 3.; xi += 0.25) {
+    for (double yj = 0.; yj <= 5.; yj += 0.5) {
+      double values[2];
+      table.Eval(xi, yj, {f_column, g_column}, values);
+      EXPECT_NEAR(values[0], xi + 10. * yj, 1E-12);
+      EXPECT_NEAR(values[1], xi * yj, 1E-12);
+
+      auto cell = table.Locate(xi, yj, x_hint, y_hint);
+      EXPECT_NEAR(table.Eval(cell, f_column), values[0], 1E-12);
+      EXPECT_NEAR(table.Eval(cell, g_column), values[1], 1E-12);
+    }
+  }
+
+  EXPECT_NEAR(table.Eval("g", 3., 5.), 15., 1E-12);
+  EXPECT_THROW(table.Eval("g", 3.1, 5.), std::out_of_range);
+  EXPECT_THROW(table.Eval("g", 0., -0.1), std::out_of_range);
+
+}
+
+TEST(TestFourierSeries, evaluation) {
+
+  FourierSeries series;
+  auto f = series.AddSeries("f", {1., 0.5, 0., 0.25}, {0., -1.});
+  auto g = series.AddSeries("g", {0.}, {0., 0., 0., 0., 2.});
+
+  EXPECT_EQ(series.GetNbTerms(), 5);
+  EXPECT_EQ(series.GetColumnHandle("g"), g);
+
+  for (double angle = -MU_PI; angle <= MU_PI; angle += 0.01) {
+    double expected_f = 1. + 0.5 * std::cos(angle) + 0.25 * std::cos(3. * angle) - std::sin(angle);
+    double expected_g = 2. * std::sin(4. * angle);
+
+    double values[2];
+    series.Eval(angle, values);
+    EXPECT_NEAR(values[f], expected_f, 1E-12);
+    EXPECT_NEAR(values[g], expected_g, 1E-12);
+    EXPECT_NEAR(series.Eval(angle, f), expected_f, 1E-12);
+    EXPECT_NEAR(series.Eval(angle, g), expected_g, 1E-12);
+  }
+
+}
+
+TEST(TestPerformanceTable1D, cubic_interpolation) {
+
+  // Lift-like curve : linear region followed by a stall, on a non uniform axis
+  std::vector<double> x = {-30., -20., -15., -10., -5., 0., 5., 10., 15., 20., 30.};
+  std::vector<double> y = {-0.9, -1.1, -1.2, -0.8, -0.4, 0., 0.4, 0.8, 1.2, 1.1, 0.9};
+
+  for (auto interpolation : {E_MONOTONE_CUBIC, E_AKIMA}) {
+
+    PerformanceTable1D table;
+    table.SetInterpolation(interpolation);
+    table.SetX(x);
+    auto cl = table.AddY("cl", y);
+    EXPECT_EQ(table.GetInterpolation(), interpolation);
+
+    // Nodes are reproduced
+    for (std::size_t i = 0; i < x.size(); i++) {
+      EXPECT_NEAR(table.Eval("cl", x[i]), y[i], 1E-12);
+    }
+
+    for (std::size_t i = 0; i < x.size() - 1; i++) {
+
+      // Continuous value and first derivative at the inner nodes
+      if (i > 0) {
+        double d_left, d_right;
+        auto v_left = table.EvalWithDerivative({i - 1, 1.}, cl, d_left);
+        auto v_right = table.EvalWithDerivative({i, 0.}, cl, d_right);
+        EXPECT_NEAR(v_left, v_right, 1E-12);
+        EXPECT_NEAR(d_left, d_right, 1E-12);
+      }
+
+      for (int k = 0; k < 100; k++) {
+        double xk = x[i] + (x[i + 1] - x[i]) * k / 100.;
+        auto interval = table.Locate(xk);
+
+        // Analytic derivative against finite differences
+        double derivative;
+        auto value = table.EvalWithDerivative(interval, cl, derivative);
+        EXPECT_NEAR(value, table.Eval(interval, cl), 1E-12);
+        double eps = 1E-6;
+        double fd = (table.Eval("cl", std::min(xk + eps, x.back())) - table.Eval("cl", std::max(xk - eps, x.front()))) /
+                    (std::min(xk + eps, x.back()) - std::max(xk - eps, x.front()));
+        EXPECT_NEAR(derivative, fd, 1E-6);
+
+        // No overshoot between the nodes for the monotone interpolation
+        if (interpolation == E_MONOTONE_CUBIC) {
+          EXPECT_GE(value, std::min(y[i], y[i + 1]) - 1E-12);
+          EXPECT_LE(value, std::max(y[i], y[i + 1]) + 1E-12);
+        }
+      }
+    }
+  }
+
+  // Linear data are exactly reproduced by both cubic interpolations
+  for (auto interpolation : {E_MONOTONE_CUBIC, E_AKIMA}) {
+    PerformanceTable1D table;
+    table.SetX({0., 0.1, 0.3, 0.35, 1.});
+    auto a = table.AddY("a", {1., 1.2, 1.6, 1.7, 3.});
+    table.SetInterpolation(interpolation);
+    for (double xk = 0.; xk <= 1.; xk += 0.01) {
+      double derivative;
+      EXPECT_NEAR(table.EvalWithDerivative(table.Locate(xk), a, derivative), 1. + 2. * xk, 1E-12);
+      EXPECT_NEAR(derivative, 2., 1E-12);
+    }
+  }
+
+  EXPECT_EQ(ParseInterpolationType("akima"), E_AKIMA);
+  EXPECT_THROW(ParseInterpolationType("spline"), std::runtime_error);
+
+}
+
+TEST(TestPerformanceTable1D, mirrored_half) {
+
+  // Positive half of an even drag-like curve and of an odd lift-like curve : the cubics match those of the whole
+  // table, zero slope at zero for the even column and no kink for the odd one
+  std::vector<double> x = {-30., -20., -10., -4., 0., 4., 10., 20., 30.};
+  std::vector<double> cd = {0.6, 0.05, 0.012, 0.006, 0.005, 0.006, 0.012, 0.05, 0.6};
+  std::vector<double> cl = {-1.2, -1.7, -1.1, -0.45, 0., 0.45, 1.1, 1.7, 1.2};
+
+  for (auto interpolation : {E_MONOTONE_CUBIC, E_AKIMA}) {
+    PerformanceTable1D whole;
+    whole.SetInterpolation(interpolation);
+    whole.SetX(x);
+    auto whole_cd = whole.AddY("cd", cd);
+    auto whole_cl = whole.AddY("cl", cl);
+
+    PerformanceTable1D half;
+    half.SetInterpolation(interpolation);
+    half.SetX({x.begin() + 4, x.end()});
+    auto half_cd = half.AddY("cd", {cd.begin() + 4, cd.end()});
+    auto half_cl = half.AddY("cl", {cl.begin() + 4, cl.end()});
+    half.SetMirrorParities({1., -1.});
+
+    for (double xk = 0.; xk <= 30.; xk += 0.25) {
+      double whole_derivative, half_derivative;
+      auto whole_interval = whole.Locate(xk);
+      auto half_interval = half.Locate(xk);
+      EXPECT_NEAR(half.EvalWithDerivative(half_interval, half_cd, half_derivative),
+                  whole.EvalWithDerivative(whole_interval, whole_cd, whole_derivative), 1E-12);
+      EXPECT_NEAR(half_derivative, whole_derivative, 1E-12);
+      EXPECT_NEAR(half.EvalWithDerivative(half_interval, half_cl, half_derivative),
+                  whole.EvalWithDerivative(whole_interval, whole_cl, whole_derivative), 1E-12);
+      EXPECT_NEAR(half_derivative, whole_derivative, 1E-12);
+    }
+    double derivative;
+    half.EvalWithDerivative({0, 0.}, half_cd, derivative);
+    EXPECT_EQ(derivative, 0.);
+  }
+
+  PerformanceTable1D table;
+  table.SetX({-1., 0., 1.});
+  table.AddY("a", {1., 0., 1.});
+  EXPECT_THROW(table.SetMirrorParities({1.}), std::runtime_error);
+  table.SetX({0., 1.});
+  table.AddY("a", {0., 1.});
+  EXPECT_THROW(table.SetMirrorParities({1., -1.}), std::runtime_error);
+  table.SetMirrorParities({-1.});
+  EXPECT_THROW(table.AddY("b", {0., 1.}), std::runtime_error);
+
+}
+
+TEST(TestPerformanceTable1D, single_precision) {
+
+  PerformanceTable1D table;
+  table.SetX({0., 0.1, 0.3, 0.6, 1.});
+  table.SetSinglePrecision(true);
+  auto a = table.AddY("a", {0.1, 0.2, 0.25, 0.2, 0.1});
+  auto b = table.AddY("b", {1., 2., 3., 4., 5.});
+  EXPECT_TRUE(table.IsSinglePrecision());
+
+  for (auto interpolation : {E_LINEAR, E_AKIMA}) {
+    PerformanceTable1D reference;
+    reference.SetX({0., 0.1, 0.3, 0.6, 1.});
+    reference.AddY("a", {0.1, 0.2, 0.25, 0.2, 0.1});
+    reference.AddY("b", {1., 2., 3., 4., 5.});
+    reference.SetInterpolation(interpolation);
+    table.SetInterpolation(interpolation);
+
+    for (double x = 0.; x <= 1.; x += 0.01) {
+      auto interval = table.Locate(x);
+      EXPECT_NEAR(table.Eval(interval, a), reference.Eval(interval, a), 1E-7 * 0.25);
+      EXPECT_NEAR(table.Eval(interval, b), reference.Eval(interval, b), 1E-7 * 5.);
+    }
+  }
+
+  // Back to double precision, nodes keep their single precision rounding
+  table.SetSinglePrecision(false);
+  EXPECT_EQ(table.Eval("a", 0.1), double(0.2f));
+
+}
+
+TEST(TestPerformanceTable2D, single_precision) {
+
+  PerformanceTable2D table, reference;
+  for (auto t : {&table, &reference}) {
+    t->SetX({0., 1., 2.});
+    t->SetY({-1., 1.});
+  }
+  table.SetSinglePrecision(true);
+  auto f = table.AddData("f", {0.1, 0.2, 0.3, 0.4, 0.5, 0.6});
+  reference.AddData("f", {0.1, 0.2, 0.3, 0.4, 0.5, 0.6});
+
+  for (double x = 0.; x <= 2.; x += 0.1) {
+    for (double y = -1.; y <= 1.; y += 0.1) {
+      auto cell = table.Locate(x, y);
+      EXPECT_NEAR(table.Eval(cell, f), reference.Eval(cell, f), 1E-7 * 0.6);
+    }
+  }
+
+}
+
+TEST(TestChebyshevSeries, fit) {
+
+  // A cubic is exactly represented by a higher degree expansion
+  std::vector<double> x, cubic, smooth;
+  for (int i = 0; i <= 40; i++) {
+    double xi = 0.2 + 0.6 * i / 40.;
+    x.push_back(xi);
+    cubic.push_back(0.3 - 0.2 * xi + 0.5 * xi * xi - xi * xi * xi);
+    smooth.push_back(std::exp(-xi) * std::sin(3. * xi));
+  }
+
+  ChebyshevSeries series;
+  auto c = series.Fit("cubic", x, cubic, 5);
+  auto s = series.Fit("smooth", x, smooth, 10);
+  EXPECT_EQ(series.GetDegree(), 10);
+  EXPECT_EQ(series.GetColumnHandle("smooth"), s);
+  EXPECT_EQ(series.GetMin(), 0.2);
+  EXPECT_EQ(series.GetMax(), 0.8);
+  EXPECT_LT(series.GetMaxResidual(c), 1E-14);
+  EXPECT_LT(series.GetMaxResidual(s), 1E-10);
+
+  for (double xi = 0.2; xi <= 0.8; xi += 0.001) {
+    double values[2];
+    series.Eval(xi, values);
+    EXPECT_NEAR(values[c], 0.3 - 0.2 * xi + 0.5 * xi * xi - xi * xi * xi, 1E-14);
+    EXPECT_NEAR(values[s], std::exp(-xi) * std::sin(3. * xi), 1E-10);
+    EXPECT_EQ(series.Eval(xi, s), values[s]);
+  }
+
+  // Not enough points, curves out of the interval
+  EXPECT_THROW(series.Fit("short", {0.2, 0.5, 0.8}, {1., 2., 3.}, 3), std::runtime_error);
+  EXPECT_THROW(series.Fit("wide", {0., 0.5, 0.8}, {1., 2., 3.}, 1), std::runtime_error);
+
+}
+
+TEST(TestTableSimplification, table_1D) {
+
+  // CFD-like dense curves : straight up to x = 0.5, then curved
+  std::vector<double> x, a, b;
+  for (int i = 0; i <= 1000; i++) {
+    double xi = i / 1000.;
+    x.push_back(xi);
+    a.push_back(xi < 0.5 ? 0.3 - 0.2 * xi : 0.2 - 0.4 * (xi - 0.5) * (xi - 0.5) - 0.2 * (xi - 0.5));
+    b.push_back(0.04 - 0.02 * xi);
+  }
+  auto original_x = x;
+  auto original_a = a;
+  auto original_b = b;
+
+  double tolerance = 1E-4;
+  auto report = SimplifyTable1D(x, {&a, &b}, tolerance);
+
+  EXPECT_EQ(report.m_nb_nodes_before, 1001);
+  EXPECT_EQ(report.m_nb_nodes_after, x.size());
+  EXPECT_EQ(a.size(), x.size());
+  EXPECT_EQ(b.size(), x.size());
+  EXPECT_LT(x.size(), 50);
+  EXPECT_GT(report.GetCompressionRatio(), 20.);
+  EXPECT_LE(report.m_max_error, tolerance);
+  EXPECT_EQ(x.front(), original_x.front());
+  EXPECT_EQ(x.back(), original_x.back());
+
+  // The guarantee holds everywhere, not only on the original nodes
+  PerformanceTable1D simplified, original;
+  simplified.SetX(x);
+  auto sa = simplified.AddY("a", a);
+  auto sb = simplified.AddY("b", b);
+  original.SetX(original_x);
+  original.AddY("a", original_a);
+  original.AddY("b", original_b);
+  double max_error = 0.;
+  for (int i = 0; i <= 10000; i++) {
+    double xi = i / 10000.;
+    auto interval = simplified.Locate(xi);
+    max_error = std::max(max_error, std::abs(simplified.Eval(interval, sa) - original.Eval("a", xi)));
+    max_error = std::max(max_error, std::abs(simplified.Eval(interval, sb) - original.Eval("b", xi)));
+  }
+  EXPECT_LE(max_error, tolerance + 1E-12);
+  EXPECT_NEAR(max_error, report.m_max_error, 1E-12);
+
+}
+
+TEST(TestTableSimplification, cubic_interpolations) {
+
+  // A straight part followed by a curved one : on the long intervals of the linear node selection, the cubics deviate
+  // from the cubics on every node by more than the tolerance
+  std::vector<double> x, a;
+  for (int i = 0; i <= 1000; i++) {
+    double xi = i / 1000.;
+    x.push_back(xi);
+    a.push_back(xi < 0.5 ? 0.3 - 0.2 * xi : 0.2 - 0.6 * (xi - 0.5) * (xi - 0.5) - 0.2 * (xi - 0.5));
+  }
+
+  double tolerance = 1E-4;
+  for (auto interpolation : {E_LINEAR, E_MONOTONE_CUBIC, E_AKIMA}) {
+    auto simplified_x = x;
+    auto simplified_a = a;
+    auto report = SimplifyTable1D(simplified_x, {&simplified_a}, tolerance, interpolation);
+    EXPECT_LT(simplified_x.size(), 200);
+    EXPECT_LE(report.m_max_error, tolerance);
+
+    // Real error of the interpolation used by the models, between the original nodes too
+    PerformanceTable1D simplified, original;
+    simplified.SetX(simplified_x);
+    simplified.SetInterpolation(interpolation);
+    auto column = simplified.AddY("a", simplified_a);
+    original.SetX(x);
+    original.SetInterpolation(interpolation);
+    original.AddY("a", a);
+    double max_error = 0.;
+    for (int i = 0; i <= 10000; i++) {
+      double xi = i / 10000.;
+      max_error = std::max(max_error, std::abs(simplified.Eval(simplified.Locate(xi), column) - original.Eval("a", xi)));
+    }
+    EXPECT_LE(max_error, tolerance + 1E-12) << "interpolation " << interpolation;
+    EXPECT_NEAR(max_error, report.m_max_error, 1E-9) << "interpolation " << interpolation;
+  }
+
+}
+
+TEST(TestTableSimplification, table_2D) {
+
+  // f is bilinear, hence removable down to the corners, g is curved along x
+  std::vector<double> x, y, f, g;
+  for (int i = 0; i <= 200; i++) x.push_back(i * 0.01);
+  for (int j = 0; j <= 20; j++) y.push_back(0.5 + j * 0.05);
+  for (auto xi : x) {
+    for (auto yj : y) {
+      f.push_back(1. + xi * yj - 2. * yj);
+      g.push_back(std::sin(xi) * yj);
+    }
+  }
+  auto original_x = x;
+  auto original_y = y;
+  auto original_f = f;
+  auto original_g = g;
+
+  double tolerance = 1E-3;
+  auto report = SimplifyTable2D(x, y, {&f, &g}, tolerance);
+
+  EXPECT_EQ(report.m_nb_nodes_before, 201 * 21);
+  EXPECT_EQ(report.m_nb_nodes_after, x.size() * y.size());
+  EXPECT_EQ(y.size(), 2);
+  EXPECT_LT(x.size(), 40);
+  EXPECT_LE(report.m_max_error, tolerance);
+
+  PerformanceTable2D simplified;
+  simplified.SetX(x);
+  simplified.SetY(y);
+  auto sf = simplified.AddData("f", f);
+  auto sg = simplified.AddData("g", g);
+  double max_error = 0.;
+  for (std::size_t i = 0; i < original_x.size(); i++) {
+    for (std::size_t j = 0; j < original_y.size(); j++) {
+      auto cell = simplified.Locate(original_x[i], original_y[j]);
+      auto k = i * original_y.size() + j;
+      max_error = std::max(max_error, std::abs(simplified.Eval(cell, sf) - original_f[k]));
+      max_error = std::max(max_error, std::abs(simplified.Eval(cell, sg) - original_g[k]));
+    }
+  }
+  EXPECT_NEAR(max_error, report.m_max_error, 1E-12);
+
+}
+
+
+TEST(TestPerformanceDataParser, streaming) {
+
+  std::vector<double> x, y, a, m;
+  std::string name;
+  bool flag = false;
+  unsigned int degree = 2;
+
+  auto declare = [&](PerformanceDataParser &parser) {
+    parser.AddOption("name", name);
+    parser.AddOption("flag", flag);
+    parser.AddOption("degree", degree);
+    parser.AddAxis("x", x, 10.);
+    parser.AddAxis("y", y);
+    parser.AddArray("a", a, "x");
+    parser.AddMatrix("m", m, "x", "y");
+  };
+
+  // Matrix given as one row per y node, stored with y varying fastest, whatever the order of the entries
+  std::vector<double> expected = {1., 4., 2., 5., 3., 6.};
+  for (const auto &json_string : {
+      R"({"x": [0, 0.5, 1], "y": [-1, 1], "m": [[1, 2, 3], [4, 5, 6]], "a": [1, 2, 3], "name": "n", "flag": true})",
+      R"({"m": [[1, 2, 3], [4, 5, 6]], "a": [1, 2, 3], "y": [-1, 1], "x": [0, 0.5, 1], "name": "n", "flag": true})"}) {
+    PerformanceDataParser parser("test parser");
+    declare(parser);
+    parser.Parse(json_string);
+
+    EXPECT_EQ(x, std::vector<double>({0., 5., 10.}));
+    EXPECT_EQ(a, std::vector<double>({1., 2., 3.}));
+    EXPECT_EQ(m, expected);
+    EXPECT_EQ(name, "n");
+    EXPECT_TRUE(flag);
+    EXPECT_EQ(degree, 2);
+    EXPECT_TRUE(parser.Has("flag"));
+    EXPECT_FALSE(parser.Has("degree"));
+  }
+
+  // Undeclared entries are skipped, nested keys are joined with '/'
+  std::vector<double> nested;
+  PerformanceDataParser parser("test parser");
+  parser.AddArray("series/a", nested);
+  parser.AddOption("degree", degree);
+  parser.Parse(R"({"comment": "data", "other": [[1, [2]], {"b": 3}], "series": {"a": [1.5, -2]}, "degree": 4})");
+  EXPECT_EQ(nested, std::vector<double>({1.5, -2.}));
+  EXPECT_EQ(degree, 4);
+
+  // Errors
+  for (const auto &json_string : {
+      R"({"x": [0, 0.5, 1], "y": [-1, 1], "m": [[1, 2, 3], [4, 5, 6]]})",                         // no a
+      R"({"x": [0, 1, 0.5], "y": [-1, 1], "m": [[1, 2, 3], [4, 5, 6]], "a": [1, 2, 3]})",          // x not sorted
+      R"({"x": [0, 0.5, 0.5, 1], "y": [-1, 1], "m": [[1, 2, 3, 4], [5, 6, 7, 8]], "a": [1, 2, 3, 4]})", // repeated x
+      R"({"x": [0, 0.5, 1], "y": [-1, 1], "m": [[1, 2, 3], [4, 5, 6]], "a": [1, 2]})",             // a size
+      R"({"x": [0, 0.5, 1], "y": [-1, 1], "m": [[1, 2, 3], [4, 5, 6]], "a": [1, 2, 3, 4]})",       // a size
+      R"({"x": [0, 0.5, 1], "y": [-1, 1], "m": [[1, 2, 3], [4, 5]], "a": [1, 2, 3]})",             // row size
+      R"({"x": [0, 0.5, 1], "y": [-1, 1], "m": [[1, 2, 3]], "a": [1, 2, 3]})",                     // rows
+      R"({"m": [[1, 2], [4, 5]], "x": [0, 0.5, 1], "y": [-1, 1], "a": [1, 2, 3]})",                // row size
+      R"({"m": [[1, 2, 3], [4, 5, 6], [7, 8, 9]], "x": [0, 0.5, 1], "y": [-1, 1], "a": [1, 2, 3]})",  // rows
+      R"({"x": [0, 0.5, 1], "y": [-1, 1], "m": [1, 2, 3, 4, 5, 6], "a": [1, 2, 3]})",              // not a matrix
+      R"({"x": [0, 0.5, 1], "y": [-1, 1], "m": [[1, 2, 3], [4, 5, 6]], "a": [1, "2", 3]})",        // not a number
+      R"({"x": [0, 0.5, 1], "y": [-1, 1], "m": [[1, 2, 3], [4, 5, 6]], "a": [1, 2, 3], "degree": 1.5})",
+      R"({"x": [0, 0.5, 1], "y": [-1, 1], "m": [[1, 2, 3], [4, 5, 6]], "a": [1, 2, 3], "flag": 1})",
+      R"({"x": [0, 0.5, 1], "y": [-1, 1], "m": [[1, 2, 3], [4, 5, 6]], "a": [1, 2, 3])",           // invalid json
+      R"([1, 2, 3])"}) {
+    PerformanceDataParser invalid("test parser");
+    declare(invalid);
+    EXPECT_THROW(invalid.Parse(json_string), std::runtime_error) << json_string;
+  }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -9,6 +9,8 @@
 //
 // ==========================================================================
 
+#include <thread>
+
 #include "acme/acme.h"
 #include "gtest/gtest.h"
 
@@ -30,9 +32,7 @@ std::string str(T begin, T end) {
 }
 
 
-TEST(TestRudder, forces) {
-
-
+std::string simple_rudder_perf_data() {
   std::vector<double> flow_incidence_on_main_rudder_deg = {-28, -26, -24.0, -22.0, -20.0, -18.0, -16.0, -14.0, -12.0,
                                                            -10.0, -8.0, -6.0, -4.0, -2.0, 0.0, 2.0, 4.0, 6.0, 8.0, 10.0,
                                                            12.0, 14.0, 16.0, 18.0, 20.0, 22.0, 24.0, 26.0, 28.0};
@@ -71,13 +71,18 @@ TEST(TestRudder, forces) {
      << R"(, "cn": )" << str(cn.begin(), cn.end())
      << "}";
 
+  return ss.str();
+}
+
+
+TEST(TestRudder, forces) {
 
   acme::RudderParams params;
   params.m_hull_wake_fraction_0 = 0.;
   params.m_chord_m = 2.;
   params.m_lateral_area_m2 = 4.;
   params.m_flap_slope = 0.; //NA
-  params.m_perf_data_json_string = ss.str();
+  params.m_perf_data_json_string = simple_rudder_perf_data();
 
   auto acme_rudder = SimpleRudderModel(params);
   acme_rudder.Initialize();
@@ -113,7 +118,7 @@ TEST(TestRudder, forces) {
   EXPECT_NEAR(acme_rudder.GetMz(), 515.344, 1E-3);
 
   // Intepolators evaluated outside of their range
-  EXPECT_EXIT(acme_rudder.Compute(1025, 1., 0., 30, 0., 0., 0., 0.), testing::ExitedWithCode(1), "");
+  EXPECT_THROW(acme_rudder.Compute(1025, 1., 0., 30, 0., 0., 0., 0.), std::runtime_error);
 
   // u = cos(-20), v = sin(-20), delta = 0
   acme_rudder.Compute(1025, std::cos(-20 * DEG2RAD), std::sin(-20 * DEG2RAD), 0., 0., 0., 0., 0.);
@@ -173,6 +178,317 @@ TEST(TestRudder, forces) {
 
 }
 
+TEST(TestRudder, single_precision_tables) {
+
+  acme::RudderParams params;
+  params.m_hull_wake_fraction_0 = 0.;
+  params.m_chord_m = 2.;
+  params.m_lateral_area_m2 = 4.;
+  params.m_perf_data_json_string = simple_rudder_perf_data();
+
+  auto rudder = SimpleRudderModel(params);
+  rudder.Initialize();
+
+  params.m_table_single_precision = true;
+  auto single_precision_rudder = SimpleRudderModel(params);
+  single_precision_rudder.Initialize();
+
+  // Max deviation on the lift and the torque over the whole attack angle range
+  double max_lift = 0., max_lift_deviation = 0., max_torque = 0., max_torque_deviation = 0.;
+  for (double delta = -28.; delta <= 28.; delta += 0.1) {
+    rudder.Compute(1025, 2., 0., delta, 0., 0., 0., 0.);
+    single_precision_rudder.Compute(1025, 2., 0., delta, 0., 0., 0., 0.);
+    max_lift = std::max(max_lift, std::abs(rudder.GetLift()));
+    max_lift_deviation = std::max(max_lift_deviation, std::abs(single_precision_rudder.GetLift() - rudder.GetLift()));
+    max_torque = std::max(max_torque, std::abs(rudder.GetTorque()));
+    max_torque_deviation = std::max(max_torque_deviation,
+                                    std::abs(single_precision_rudder.GetTorque() - rudder.GetTorque()));
+  }
+
+  std::cout << "Single precision tables, max relative deviation : lift " << max_lift_deviation / max_lift
+            << ", torque " << max_torque_deviation / max_torque << std::endl;
+
+  // float has 24 bits of mantissa : relative rounding error below 6E-8 on each node
+  EXPECT_LT(max_lift_deviation, 1E-7 * max_lift);
+  EXPECT_LT(max_torque_deviation, 1E-7 * max_torque);
+
+}
+
+TEST(TestRudder, symmetric_table) {
+
+  acme::RudderParams params;
+  params.m_hull_wake_fraction_0 = 0.;
+  params.m_chord_m = 2.;
+  params.m_lateral_area_m2 = 4.;
+  params.m_perf_data_json_string = simple_rudder_perf_data();
+
+  // The polar of the forces test is symmetric, up to cl = 2.7E-5 at zero attack angle. With the cubic
+  // interpolations, the slopes at zero attack angle are those of the whole table : no kink at zero.
+  for (auto interpolation : {E_LINEAR, E_MONOTONE_CUBIC, E_AKIMA}) {
+    params.m_table_interpolation = interpolation;
+    params.m_symmetric_table = false;
+    auto rudder = SimpleRudderModel(params);
+    rudder.Initialize();
+
+    params.m_symmetric_table = true;
+    auto symmetric_rudder = SimpleRudderModel(params);
+    symmetric_rudder.Initialize();
+
+    double q = 0.5 * 1025 * params.m_lateral_area_m2;
+    double max_drag_deviation = 0.;
+    for (double delta = -28.; delta <= 28.; delta += 0.1) {
+      rudder.Compute(1025, 1., 0., delta, 0., 0., 0., 0.);
+      symmetric_rudder.Compute(1025, 1., 0., delta, 0., 0., 0., 0.);
+      EXPECT_NEAR(symmetric_rudder.GetLift(), rudder.GetLift(), 3E-5 * q);
+      EXPECT_NEAR(symmetric_rudder.GetTorque(), rudder.GetTorque(), 1E-5 * q * params.m_chord_m);
+      max_drag_deviation = std::max(max_drag_deviation, std::abs(symmetric_rudder.GetDrag() - rudder.GetDrag()));
+    }
+    EXPECT_LT(max_drag_deviation, 1E-12 * q);
+
+    // Odd symmetry holds exactly
+    symmetric_rudder.Compute(1025, 1., 0., 13.3, 0., 0., 0., 0.);
+    auto lift = symmetric_rudder.GetLift();
+    symmetric_rudder.Compute(1025, 1., 0., -13.3, 0., 0., 0., 0.);
+    EXPECT_EQ(symmetric_rudder.GetLift(), -lift);
+  }
+
+  // A cambered polar is rejected
+  params.m_perf_data_json_string = R"({"symmetric": true, "angle_of_attack_deg": [-10, 0, 10],
+      "cd": [0.01, 0.005, 0.01], "cl": [-0.7, 0.1, 0.9], "cn": [0, 0, 0]})";
+  auto cambered_rudder = SimpleRudderModel(params);
+  EXPECT_THROW(cambered_rudder.Initialize(), std::runtime_error);
+
+}
+
+TEST(TestRudder, concurrent_compute) {
+
+  acme::RudderParams params;
+  params.m_hull_wake_fraction_0 = 0.2;
+  params.m_chord_m = 2.;
+  params.m_lateral_area_m2 = 4.;
+  params.m_perf_data_json_string = simple_rudder_perf_data();
+
+  auto rudder = SimpleRudderModel(params);
+  rudder.Initialize();
+
+  // Reference results from the getters API
+  std::vector<RudderInput> inputs;
+  std::vector<RudderOutput> outputs;
+  for (double delta = -20.; delta <= 20.; delta += 0.5) {
+    inputs.push_back({1025., 3., 0.2, delta});
+    rudder.Compute(1025., 3., 0.2, delta, 0., 0., 0., 0.);
+    outputs.push_back(rudder.GetOutput());
+  }
+
+  // The same model evaluated by several threads, each one sweeping the rudder angles in a different order
+  const int nb_threads = 4;
+  std::vector<int> nb_mismatches(nb_threads, 0);
+  std::vector<std::thread> threads;
+  for (int k = 0; k < nb_threads; k++) {
+    threads.emplace_back([&, k]() {
+      for (int repeat = 0; repeat < 50; repeat++) {
+        for (std::size_t i = 0; i < inputs.size(); i++) {
+          auto index = (k % 2 == 0) ? i : inputs.size() - 1 - i;
+          auto output = rudder.Compute(inputs[index]);
+          if (output.m_fx_N != outputs[index].m_fx_N || output.m_fy_N != outputs[index].m_fy_N ||
+              output.m_torque_Nm != outputs[index].m_torque_Nm ||
+              output.m_attack_angle_rad != outputs[index].m_attack_angle_rad) {
+            nb_mismatches[k]++;
+          }
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) thread.join();
+
+  for (int k = 0; k < nb_threads; k++) EXPECT_EQ(nb_mismatches[k], 0);
+
+}
+
+TEST(TestRudder, reload_performance_data) {
+
+  acme::RudderParams params;
+  params.m_hull_wake_fraction_0 = 0.2;
+  params.m_chord_m = 2.;
+  params.m_lateral_area_m2 = 4.;
+  params.m_perf_data_json_string = simple_rudder_perf_data();
+
+  auto rudder = SimpleRudderModel(params);
+  rudder.Initialize();
+
+  // Recalibrated polar, on a coarser attack angle axis
+  const std::string recalibrated_data = R"({"angle_of_attack_deg": [-30, -15, 0, 15, 30],
+      "cd": [0.3, 0.02, 0.005, 0.02, 0.3], "cl": [-1.2, -1.5, 0, 1.5, 1.2], "cn": [0.1, 0.05, 0, -0.05, -0.1]})";
+  params.m_perf_data_json_string = recalibrated_data;
+  auto recalibrated_rudder = SimpleRudderModel(params);
+  recalibrated_rudder.Initialize();
+
+  rudder.ReloadPerformanceData(recalibrated_data);
+  for (double delta = -25.; delta <= 25.; delta += 2.5) {
+    auto output = rudder.Compute(RudderInput{1025., 3., 0.2, delta});
+    auto expected = recalibrated_rudder.Compute(RudderInput{1025., 3., 0.2, delta});
+    EXPECT_EQ(output.m_fx_N, expected.m_fx_N);
+    EXPECT_EQ(output.m_fy_N, expected.m_fy_N);
+    EXPECT_EQ(output.m_torque_Nm, expected.m_torque_Nm);
+  }
+  EXPECT_EQ(rudder.ReleaseRetiredCurves(), 1);
+
+  // Invalid data : the rudder keeps its curves
+  EXPECT_THROW(rudder.ReloadPerformanceData(R"({"angle_of_attack_deg": [0, 10], "cd": [0.01]})"),
+               std::runtime_error);
+  EXPECT_EQ(rudder.GetNbRetiredCurves(), 0);
+  EXPECT_EQ(rudder.Compute(RudderInput{1025., 3., 0.2, 10.}).m_fy_N,
+            recalibrated_rudder.Compute(RudderInput{1025., 3., 0.2, 10.}).m_fy_N);
+
+  // No performance data to reload
+  auto brix_rudder = BrixRudderModel(params);
+  brix_rudder.Initialize();
+  EXPECT_THROW(brix_rudder.ReloadPerformanceData(recalibrated_data), std::runtime_error);
+
+}
+
+TEST(TestRudder, batch_compute) {
+
+  acme::RudderParams params;
+  params.m_hull_wake_fraction_0 = 0.2;
+  params.m_has_hull_influence_transverse_velocity = true;
+  params.m_tR = 0.3;
+  params.m_aH = 0.2;
+  params.m_xR = -50.;
+  params.m_xH = -45.;
+  params.m_chord_m = 2.;
+  params.m_lateral_area_m2 = 4.;
+  params.m_perf_data_json_string = simple_rudder_perf_data();
+
+  auto rudder = SimpleRudderModel(params);
+  rudder.Initialize();
+
+  // Rudders of a traffic, the ship drift angles covering every branch of the hull straightening function
+  std::vector<double> rho, u, v, delta, u_ship, v_ship, r_ship, x_r;
+  for (double delta_i = -20.; delta_i <= 20.; delta_i += 2.5) {
+    for (double v_ship_i : {-8., -2., -0.5, 0., 0.5, 2., 8.}) {
+      rho.push_back(1025.);
+      u.push_back(3.);
+      v.push_back(0.1 * delta_i / 20.);
+      delta.push_back(delta_i);
+      u_ship.push_back(3.);
+      v_ship.push_back(v_ship_i);
+      r_ship.push_back(0.01);
+      x_r.push_back(-50.);
+    }
+  }
+  auto size = u.size();
+
+  std::vector<double> uRA(size), vRA(size), rudder_angle(size), drift(size), attack(size), lift(size), drag(size),
+      torque(size), fx(size), fy(size);
+  rudder.ComputeBatch({size, rho.data(), u.data(), v.data(), delta.data(), u_ship.data(), v_ship.data(),
+                       r_ship.data(), x_r.data()},
+                      {uRA.data(), vRA.data(), rudder_angle.data(), drift.data(), attack.data(), lift.data(),
+                       drag.data(), torque.data(), fx.data(), fy.data()});
+
+  for (std::size_t i = 0; i < size; i++) {
+    auto output = rudder.Compute(RudderInput{rho[i], u[i], v[i], delta[i], u_ship[i], v_ship[i], r_ship[i], x_r[i]});
+    EXPECT_DOUBLE_EQ(uRA[i], output.m_uRA);
+    EXPECT_DOUBLE_EQ(vRA[i], output.m_vRA);
+    EXPECT_DOUBLE_EQ(rudder_angle[i], output.m_rudder_angle_rad);
+    EXPECT_DOUBLE_EQ(drift[i], output.m_drift_angle_rad);
+    EXPECT_DOUBLE_EQ(attack[i], output.m_attack_angle_rad);
+    EXPECT_DOUBLE_EQ(lift[i], output.m_lift_N);
+    EXPECT_DOUBLE_EQ(drag[i], output.m_drag_N);
+    EXPECT_DOUBLE_EQ(torque[i], output.m_torque_Nm);
+    EXPECT_DOUBLE_EQ(fx[i], output.m_fx_N);
+    EXPECT_DOUBLE_EQ(fy[i], output.m_fy_N);
+  }
+
+  // The ship velocities are required for the hull straightening
+  EXPECT_THROW(rudder.ComputeBatch({size, rho.data(), u.data(), v.data(), delta.data()},
+                                   {uRA.data(), vRA.data(), rudder_angle.data(), drift.data(), attack.data(),
+                                    lift.data(), drag.data(), torque.data(), fx.data(), fy.data()}),
+               std::invalid_argument);
+
+}
+
+TEST(TestRudder, out_of_range_policies) {
+
+  acme::RudderParams params;
+  params.m_hull_wake_fraction_0 = 0.;
+  params.m_chord_m = 2.;
+  params.m_lateral_area_m2 = 4.;
+  params.m_has_hull_influence = false;
+  params.m_perf_data_json_string = simple_rudder_perf_data();
+
+  // 30 deg attack angle, beyond the performance data (|alpha| <= 28 deg)
+  RudderInput input{1025., 1., 0., 30.};
+  double cl, cd, cn, cl_max, cd_max, cn_max, cl_prev, cd_prev, cn_prev;
+
+  params.m_out_of_range_policy = E_OUT_OF_RANGE_CLAMP;
+  auto clamp = SimpleRudderModel(params);
+  clamp.Initialize();
+  clamp.GetClCdCn(28. * DEG2RAD, 0., cl_max, cd_max, cn_max);
+  clamp.GetClCdCn(26. * DEG2RAD, 0., cl_prev, cd_prev, cn_prev);
+
+  EXPECT_EQ(clamp.GetClCdCn(30. * DEG2RAD, 0., cl, cd, cn), E_STATUS_OUT_OF_RANGE);
+  EXPECT_DOUBLE_EQ(cl, cl_max);
+  EXPECT_DOUBLE_EQ(cd, cd_max);
+  EXPECT_DOUBLE_EQ(cn, cn_max);
+  auto output = clamp.Compute(input);
+  EXPECT_EQ(output.m_status, E_STATUS_OUT_OF_RANGE);
+  EXPECT_NEAR(output.m_lift_N, 0.5 * 1025. * 4. * cl_max, 1E-8);
+
+  params.m_out_of_range_policy = E_OUT_OF_RANGE_EXTRAPOLATE;
+  auto extrapolate = SimpleRudderModel(params);
+  extrapolate.Initialize();
+  EXPECT_EQ(extrapolate.GetClCdCn(30. * DEG2RAD, 0., cl, cd, cn), E_STATUS_OUT_OF_RANGE);
+  EXPECT_NEAR(cl, 2. * cl_max - cl_prev, 1E-12);
+  EXPECT_NEAR(cd, 2. * cd_max - cd_prev, 1E-12);
+  EXPECT_NEAR(cn, 2. * cn_max - cn_prev, 1E-12);
+  extrapolate.GetClCdCn(-30. * DEG2RAD, 0., cl, cd, cn);
+  EXPECT_NEAR(cl, -(2. * cl_max - cl_prev), 1E-12);
+
+  params.m_out_of_range_policy = E_OUT_OF_RANGE_ZERO;
+  auto zero = SimpleRudderModel(params);
+  zero.Initialize();
+  output = zero.Compute(input);
+  EXPECT_EQ(output.m_status, E_STATUS_OUT_OF_RANGE);
+  EXPECT_EQ(output.m_lift_N, 0.);
+  EXPECT_EQ(output.m_drag_N, 0.);
+  EXPECT_EQ(output.m_torque_Nm, 0.);
+  EXPECT_EQ(zero.Compute(RudderInput{1025., 1., 0., 10.}).m_status, E_STATUS_OK);
+
+  // Batch statuses, as obtained by Compute
+  std::vector<double> rho(4, 1025.), u(4, 1.), v(4, 0.), delta = {10., 30., -35., 0.};
+  std::vector<std::vector<double>> results(10, std::vector<double>(4));
+  std::vector<unsigned int> status(4);
+  zero.ResetStatusCounts();
+  zero.ComputeBatch({4, rho.data(), u.data(), v.data(), delta.data()},
+                    {results[0].data(), results[1].data(), results[2].data(), results[3].data(), results[4].data(),
+                     results[5].data(), results[6].data(), results[7].data(), results[8].data(), results[9].data(),
+                     status.data()});
+  for (std::size_t i = 0; i < 4; i++) {
+    EXPECT_EQ(status[i], zero.Compute(RudderInput{rho[i], u[i], v[i], delta[i]}).m_status);
+  }
+  EXPECT_EQ(status[1], E_STATUS_OUT_OF_RANGE);
+  EXPECT_EQ(status[2], E_STATUS_OUT_OF_RANGE);
+  EXPECT_EQ(zero.GetStatusCounts().m_nb_out_of_range, 4);
+
+  // Uninitialized model
+  EXPECT_THROW(SimpleRudderModel(params).Compute(input), std::runtime_error);
+
+}
+
+TEST(TestRudder, hull_straightening_function) {
+
+  // kappa = min(0.45 |beta|, 0.5) below 1.3 rad, linear up to 1 at pi/2, 1 beyond, even in beta
+  EXPECT_DOUBLE_EQ(RudderBaseModel::HullStraighteningFunction(0.), 0.);
+  EXPECT_DOUBLE_EQ(RudderBaseModel::HullStraighteningFunction(0.5), 0.225);
+  EXPECT_DOUBLE_EQ(RudderBaseModel::HullStraighteningFunction(-0.5), 0.225);
+  EXPECT_DOUBLE_EQ(RudderBaseModel::HullStraighteningFunction(1.2), 0.5);
+  EXPECT_NEAR(RudderBaseModel::HullStraighteningFunction(1.3), 0.5, 1E-12);
+  EXPECT_NEAR(RudderBaseModel::HullStraighteningFunction(-0.5 * (1.3 + MU_PI_2)), 0.75, 1E-12);
+  EXPECT_DOUBLE_EQ(RudderBaseModel::HullStraighteningFunction(2.), 1.);
+  EXPECT_DOUBLE_EQ(RudderBaseModel::HullStraighteningFunction(-3.), 1.);
+
+}
 
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
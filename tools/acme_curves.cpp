@@ -0,0 +1,141 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+// Performance curve converter : writes the json performance data of a model as a binary curve file (see CurveFile),
+// which the models map in memory at initialization instead of parsing the json, and checks curve files.
+//
+//   acme_curves convert <type> <perf data json file> <output curve file>
+//   acme_curves check <curve file> [<curve file> ...]
+//
+// type : "FPP1Q" | "FPP4Q" | "CPP" | "simple" | "flap", as in the acme_map configuration.
+//
+// The converted file is read back and compared value by value to the json data. Both commands check the header and
+// the checksum of the curve files, and that a model of their type initializes from them.
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "acme/acme.h"
+
+using namespace acme;
+
+std::string read_file(const std::string &path) {
+  std::ifstream file(path);
+  if (!file) throw std::runtime_error("can not read " + path);
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  return buffer.str();
+}
+
+CurveData curve_data(const std::string &type, const std::string &json_string) {
+  if (type == "FPP1Q") return FPP1QCurveData(json_string);
+  if (type == "FPP4Q") return FPP4QCurveData(json_string);
+  if (type == "CPP") return CPPCurveData(json_string);
+  if (type == "simple") return SimpleRudderCurveData(json_string);
+  if (type == "flap") return FlapRudderCurveData(json_string);
+  throw std::runtime_error("unknown model type " + type);
+}
+
+void compare(const std::vector<CurveValues> &expected, const std::vector<CurveValues> &actual,
+             const std::string &path) {
+  if (expected.size() != actual.size()) throw std::runtime_error(path + " does not match the json data");
+  for (std::size_t i = 0; i < expected.size(); i++) {
+    if (expected[i].m_name != actual[i].m_name || expected[i].m_values != actual[i].m_values) {
+      throw std::runtime_error(path + " : " + expected[i].m_name + " does not match the json data");
+    }
+  }
+}
+
+// Initialize a model of the type of the file from it
+void initialize_model(const CurveFile &file) {
+  const auto &model = file.GetModel();
+
+  if (model == "FPP1Q" || model == "FPP4Q" || model == "CPP") {
+    PropellerParams params;
+    params.m_diameter_m = 1.;
+    params.m_screw_direction = RIGHT_HANDED;
+    params.m_hull_wake_fraction_0 = 0.;
+    params.m_thrust_deduction_factor_0 = 0.;
+    params.m_thruster_perf_data_curve_file = file.GetPath();
+
+    std::unique_ptr<PropellerBaseModel> propeller;
+    if (model == "FPP1Q") propeller = std::make_unique<FPP1Q>(params);
+    if (model == "FPP4Q") propeller = std::make_unique<FPP4Q>(params);
+    if (model == "CPP") propeller = std::make_unique<CPP>(params);
+    propeller->Initialize();
+
+  } else if (model == "SimpleRudder" || model == "FlapRudder") {
+    RudderParams params;
+    params.m_lateral_area_m2 = 1.;
+    params.m_chord_m = 1.;
+    params.m_height_m = 1.;
+    params.m_perf_data_curve_file = file.GetPath();
+
+    std::unique_ptr<RudderBaseModel> rudder;
+    if (model == "SimpleRudder") rudder = std::make_unique<SimpleRudderModel>(params);
+    if (model == "FlapRudder") rudder = std::make_unique<FlapRudderModel>(params);
+    rudder->Initialize();
+
+  } else {
+    throw std::runtime_error(file.GetPath() + " : unknown model type " + model);
+  }
+}
+
+void print(const CurveFile &file) {
+  std::cout << file.GetPath() << " : " << file.GetModel() << ", " << file.GetNbNodes() << " nodes (";
+  for (std::size_t axis = 0; axis < file.GetNbAxes(); axis++) {
+    std::cout << (axis > 0 ? " x " : "") << file.GetAxisSize(axis) << " " << file.GetAxisName(axis);
+  }
+  std::cout << "), " << file.GetColumnNames().size() << " columns, checksum " << std::hex << std::setw(16)
+            << std::setfill('0') << file.GetChecksum() << std::dec << std::endl;
+}
+
+int main(int argc, char **argv) {
+
+  std::string command = argc > 1 ? argv[1] : "";
+  if (!(command == "convert" && argc == 5) && !(command == "check" && argc > 2)) {
+    std::cerr << "usage : " << argv[0] << " convert <type> <perf data json file> <output curve file>" << std::endl
+              << "        " << argv[0] << " check <curve file> [<curve file> ...]" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  try {
+    if (command == "convert") {
+      auto data = curve_data(argv[2], read_file(argv[3]));
+      data.Write(argv[4]);
+
+      auto file = CurveFile::Open(argv[4]);
+      auto written = file->GetCurveData();
+      if (written.m_model != data.m_model || written.m_options != data.m_options) {
+        throw std::runtime_error(std::string(argv[4]) + " does not match the json data");
+      }
+      compare(data.m_axes, written.m_axes, argv[4]);
+      compare(data.m_columns, written.m_columns, argv[4]);
+      initialize_model(*file);
+      print(*file);
+
+    } else {
+      for (int i = 2; i < argc; i++) {
+        auto file = CurveFile::Open(argv[i]);
+        initialize_model(*file);
+        print(*file);
+      }
+    }
+
+  } catch (const std::exception &e) {
+    std::cerr << "acme_curves : " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
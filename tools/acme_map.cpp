@@ -0,0 +1,123 @@
+// ==========================================================================
+// ACME
+//
+// Copyright (c) D-ICE Engineering.
+// All rights reserved.
+//
+// Use of this source code is governed by a GPLv3 license that can be found
+// in the LICENSE file of FRyDoM.
+//
+// ==========================================================================
+
+// Operating map generator : evaluates a propeller or a propeller rudder over a grid of operating points and writes
+// the results in the binary columnar layout of OperatingMap.
+//
+//   acme_map <config.json> <output map file>
+//
+// Configuration (model sections, see ParseModelConfig) :
+//
+//   {
+//     "propeller": {"type": "FPP1Q" | "FPP4Q" | "CPP", "diameter_m": 4.0, "screw_direction": "right" | "left",
+//                   "hull_wake_fraction_0": 0.2, "thrust_deduction_factor_0": 0.15,
+//                   "out_of_range": "throw" | "clamp" | "extrapolate" | "zero",
+//                   "perf_data": {...} | "<path to the open water json file or curve file>"},
+//     "rudder": {"type": "simple" | "flap" | "fujii" | "brix", "lateral_area_m2": 12.0, "chord_m": 3.0,
+//                "height_m": 4.0, ..., "out_of_range": "clamp", "perf_data": {...} | "<path>"},   (optional)
+//     "interaction": "brix" | "mmg",                                    (with a rudder, brix by default)
+//     "operating_point": {"rpm": 100.0, ...},                           (fields of the model input)
+//     "grid": {"speed_ms": {"min": 0.0, "max": 8.0, "n": 81}, "rudder_angle_deg": [-35, 0, 35], ...},
+//     "threads": 0
+//   }
+//
+// The grid axes and operating point fields are the ones of BuildPropellerMap (propeller alone) or
+// BuildPropellerRudderMap (with a rudder). With the default "throw" out of range policy, the grid points outside of
+// the performance data are NaN in the map. Performance data paths may be curve files written by acme_curves.
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+#include "acme/acme.h"
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+using namespace acme;
+
+std::vector<GridAxis> grid_axes(const json &node) {
+  std::vector<GridAxis> axes;
+  for (auto axis = node.begin(); axis != node.end(); ++axis) {
+    if (axis->is_array()) {
+      axes.push_back({axis.key(), axis->get<std::vector<double>>()});
+    } else {
+      axes.push_back(GridAxis::Linspace(axis.key(), axis->at("min"), axis->at("max"), axis->at("n")));
+    }
+  }
+  return axes;
+}
+
+int main(int argc, char **argv) {
+
+  if (argc != 3) {
+    std::cerr << "usage : " << argv[0] << " <config.json> <output map file>" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  try {
+    std::ifstream config_file(argv[1]);
+    if (!config_file) throw std::runtime_error(std::string("can not read ") + argv[1]);
+    auto config = json::parse(config_file);
+
+    auto axes = grid_axes(config.at("grid"));
+    unsigned int nb_threads = config.value("threads", 0u);
+    auto operating_point = config.value("operating_point", json::object());
+
+    // Model sections of the configuration, see ParseModelConfig
+    auto model = ParseModelConfig(config.dump());
+    if (!model.m_has_propeller) throw std::runtime_error("no propeller in " + std::string(argv[1]));
+
+    OperatingMap map;
+    auto start = std::chrono::steady_clock::now();
+
+    if (!model.m_has_rudder) {
+      auto propeller = BuildPropeller(model.m_propeller_type, model.m_propeller_params);
+      propeller->Initialize();
+
+      PropellerInput input{operating_point.value("water_density", 1025.), operating_point.value("u_NWU", 0.),
+                           operating_point.value("v_NWU", 0.), operating_point.value("rpm", 0.),
+                           operating_point.value("pitch_ratio", 0.)};
+      map = BuildPropellerMap(*propeller, input, axes, nb_threads);
+
+    } else {
+      auto propeller_rudder = BuildPropellerRudder(model.m_interaction, model.m_propeller_type,
+                                                   model.m_propeller_params, model.m_rudder_type,
+                                                   model.m_rudder_params);
+      propeller_rudder->Initialize();
+
+      auto speed = operating_point.value("speed_ms", 0.);
+      PropellerRudderInput input{operating_point.value("water_density", 1025.),
+                                 operating_point.value("u_NWU_propeller_ms", speed),
+                                 operating_point.value("v_NWU_propeller_ms", 0.),
+                                 operating_point.value("u_NWU_ship_ms", speed),
+                                 operating_point.value("v_NWU_ship_ms", 0.),
+                                 operating_point.value("r_rads", 0.),
+                                 operating_point.value("x_pr_m", 0.),
+                                 operating_point.value("x_gr_m", 0.),
+                                 operating_point.value("rpm", 0.),
+                                 operating_point.value("pitch_ratio", 0.),
+                                 operating_point.value("rudder_angle_deg", 0.)};
+      map = BuildPropellerRudderMap(*propeller_rudder, input, axes, nb_threads);
+    }
+
+    auto stop = std::chrono::steady_clock::now();
+    map.Write(argv[2]);
+
+    std::cout << map.GetNbPoints() << " grid points evaluated in "
+              << std::chrono::duration<double>(stop - start).count() << " s, written to " << argv[2] << std::endl;
+
+  } catch (const std::exception &e) {
+    std::cerr << "acme_map : " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}